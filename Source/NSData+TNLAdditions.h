@@ -6,7 +6,7 @@
 //  Copyright © 2020 Twitter. All rights reserved.
 //
 
-#import <Foundation/Foundation.h>
+#import "TNL_ProjectCommon.h"
 
 /*
  * NOTE: this header is private to TNL
@@ -21,4 +21,28 @@ NS_ASSUME_NONNULL_BEGIN
 - (NSString *)tnl_hexStringValue;
 @end
 
+/**
+ Accumulates data segments without copying their bytes.
+
+ Each appended `NSData` is retained as-is (immutable data is not copied) and `data` exposes all
+ segments as a single concatenated `NSData` (a `dispatch_data_t` on 64-bit).
+ Segments are only concatenated when `data` is called, not on every append.
+ The bytes are only flattened into a contiguous buffer if/when `-[NSData bytes]` is accessed on
+ the returned data, so consumers that enumerate byte ranges or write to disk never pay for a copy.
+
+ Not thread safe.
+ */
+TNL_OBJC_FINAL
+@interface TNLSegmentedDataBuffer : NSObject
+
+/** total number of bytes appended */
+@property (nonatomic, readonly) NSUInteger length;
+/** number of non-empty segments appended */
+@property (nonatomic, readonly) NSUInteger segmentCount;
+
+- (void)appendData:(NSData *)data;
+- (NSData *)data;
+
+@end
+
 NS_ASSUME_NONNULL_END
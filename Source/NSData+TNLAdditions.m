@@ -140,5 +140,79 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+@implementation TNLSegmentedDataBuffer
+{
+#if __LP64__
+    NSMutableArray<dispatch_data_t> *_regions;
+#else
+    NSMutableData *_mutableData;
+#endif
+}
+
+- (void)appendData:(NSData *)data
+{
+    const NSUInteger length = data.length;
+    if (!length) {
+        return;
+    }
+
+    // mutable data could change out from under us, immutable data (including dispatch data) is just retained
+    data = [data copy];
+
+#if __LP64__
+    if (!_regions) {
+        _regions = [[NSMutableArray alloc] init];
+    }
+    if ([data conformsToProtocol:@protocol(OS_dispatch_data)]) {
+        // NSURLSession delivers dispatch data, retain it without re-wrapping
+        [_regions addObject:(dispatch_data_t)data];
+    } else {
+        NSMutableArray<dispatch_data_t> *regions = _regions;
+        [data enumerateByteRangesUsingBlock:^(const void * _Nonnull bytes, NSRange byteRange, BOOL * _Nonnull stop) {
+            // wrap the bytes as-is, the destructor keeps the source data alive for as long as the region is referenced
+            dispatch_data_t region = dispatch_data_create(bytes, byteRange.length, NULL, ^{
+                (void)data;
+            });
+            [regions addObject:region];
+        }];
+    }
+#else // 32 bit
+    if (!_mutableData) {
+        _mutableData = [[NSMutableData alloc] initWithData:data];
+    } else {
+        [_mutableData appendData:data];
+    }
+#endif
+
+    _length += length;
+    _segmentCount++;
+}
+
+- (NSData *)data
+{
+#if __LP64__
+    // concatenating one region at a time copies the growing list of regions on every step,
+    // so concatenate pairwise instead and keep the result for any further appends
+    NSMutableArray<dispatch_data_t> *regions = _regions;
+    while (regions.count > 1) {
+        NSMutableArray<dispatch_data_t> *concatenatedRegions = [[NSMutableArray alloc] initWithCapacity:(regions.count + 1) / 2];
+        for (NSUInteger i = 0; i < regions.count; i += 2) {
+            if (i + 1 < regions.count) {
+                [concatenatedRegions addObject:dispatch_data_create_concat(regions[i], regions[i + 1])];
+            } else {
+                [concatenatedRegions addObject:regions[i]];
+            }
+        }
+        regions = concatenatedRegions;
+    }
+    _regions = regions;
+    return (NSData *)(regions.firstObject ?: dispatch_data_empty);
+#else // 32 bit
+    return [_mutableData copy] ?: [NSData data];
+#endif
+}
+
+@end
+
 NS_ASSUME_NONNULL_END
 
@@ -116,6 +116,10 @@ NS_ASSUME_NONNULL_BEGIN
 @property(nonatomic, readonly) NSTimeInterval requestEncodingLatency;
 - (BOOL)hasRequestEncodingLatency;
 
+/** Time the request body spent waiting to be encoded (queued behind other coding work) */
+@property(nonatomic, readonly) NSTimeInterval requestEncodingQueueLatency;
+- (BOOL)hasRequestEncodingQueueLatency;
+
 /** Request's original Content-Length before encoding */
 @property (nonatomic, readonly) SInt64 requestOriginalContentLength;
 - (BOOL)hasRequestOriginalContentLength;
@@ -128,6 +132,10 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, readonly) NSTimeInterval responseDecodingLatency;
 - (BOOL)hasResponseDecodingLatency;
 
+/** Total time the response body chunks spent waiting to be decoded (queued behind other coding work) */
+@property (nonatomic, readonly) NSTimeInterval responseDecodingQueueLatency;
+- (BOOL)hasResponseDecodingQueueLatency;
+
 /** The Content-Length of the response body after being decoded */
 @property (nonatomic, readonly) SInt64 responseDecodedContentLength;
 - (BOOL)hasResponseDecodedContentLength;
@@ -54,10 +54,12 @@ PRIMITIVE_FIELD(taskWithoutMetricsCompletionLatency, TaskWithoutMetricsCompletio
 \
 PRIMITIVE_FIELD(requestContentLength, RequestContentLength, SInt64, longLongValue) \
 PRIMITIVE_FIELD(requestEncodingLatency, RequestEncodingLatency, NSTimeInterval, doubleValue) \
+PRIMITIVE_FIELD(requestEncodingQueueLatency, RequestEncodingQueueLatency, NSTimeInterval, doubleValue) \
 PRIMITIVE_FIELD(requestOriginalContentLength, RequestOriginalContentLength, SInt64, longLongValue) \
 \
 PRIMITIVE_FIELD(responseContentLength, ResponseContentLength, SInt64, longLongValue) \
 PRIMITIVE_FIELD(responseDecodingLatency, ResponseDecodingLatency, NSTimeInterval, doubleValue) \
+PRIMITIVE_FIELD(responseDecodingQueueLatency, ResponseDecodingQueueLatency, NSTimeInterval, doubleValue) \
 PRIMITIVE_FIELD(responseDecodedContentLength, ResponseDecodedContentLength, SInt64, longLongValue) \
 PRIMITIVE_FIELD(responseContentDownloadDuration, ResponseContentDownloadDuration, NSTimeInterval, doubleValue) \
 
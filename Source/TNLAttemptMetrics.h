@@ -23,11 +23,13 @@ typedef NS_ENUM(NSInteger, TNLAttemptType) {
     TNLAttemptTypeRedirect,
     /** Retry Attempt */
     TNLAttemptTypeRetry,
+    /** Hedge Attempt, run in parallel with the attempt before it (see `[TNLRequestConfiguration hedgeDelayPercentile]`) */
+    TNLAttemptTypeHedge,
 
     // NOTE: be sure to update TNLAttemptTypeCount if you add values to this enum
 };
 
-static const NSInteger TNLAttemptTypeCount = 3;
+static const NSInteger TNLAttemptTypeCount = 4;
 FOUNDATION_EXTERN NSString * __nullable TNLAttemptTypeToString(TNLAttemptType type);
 
 /**
@@ -48,9 +50,11 @@ typedef NS_ENUM(NSInteger, TNLAttemptCompleteDisposition) {
     TNLAttemptCompleteDispositionRedirecting = TNLAttemptTypeRedirect,
     /** The attempt yielded a retry.  There will be a follow up attempt to retry. */
     TNLAttemptCompleteDispositionRetrying = TNLAttemptTypeRetry,
+    /** The attempt lost a hedging race and was cancelled.  The parallel attempt that won continues. */
+    TNLAttemptCompleteDispositionHedged = TNLAttemptTypeHedge,
 };
 
-static const NSInteger TNLAttemptCompleteDispositionCount = 3;
+static const NSInteger TNLAttemptCompleteDispositionCount = 4;
 
 /**
  Base class for encapsulating the metrics related to the underlying attempt of a `TNLRequestOperation`.
@@ -35,18 +35,18 @@ typedef struct TNLBackoffBehavior_T {
      how long requests being enqueued will continue to execute serially after the backoff signal was
      encountered (based on the `TNLGlobalConfigurationBackoffMode`).
 
-     Once this duration expires (or if `<= 0.0`),
-     serialization of requests will continue as long as there are requests in the queue that were serialized
-     (which will continue to enqueue serially while there is an outstanding "backoff" duration running).
+     Serialized requests are started at a fixed rate (see `serialDelayDuration`) rather than waiting on
+     one another to complete.
+     Serialization always lasts at least as long as the "Backoff" duration.
      Requests being sent after both "Serialize Requests" and "Backoff" durations have expired will
-     wait for the existing serially enqueued requests to complete before executing concurrently.
+     start immediately, while requests that were already serialized continue to start at the serial rate.
 
      Default == `0.0`
      */
     NSTimeInterval serializeDuration;
     /**
      The minimum amount of time to elapse between the _start_ of each serial request.
-     This does not indicate the duration between serial requests...that will vary based on the duration of any given request's duration.
+     Values less than `0.1` seconds are treated as `0.1` seconds.
 
      Default == `0.0`
      */
@@ -75,6 +75,10 @@ NS_INLINE TNLBackoffBehavior TNLBackoffBehaviorMake(NSTimeInterval backoff,
  `TNLBackoffBehavior` for an encountered backoff signal.
 
  Due to opaque nature of signaling backoffs, only the _URL_ and _headers_ are provided.
+
+ __Threading:__ the callback is made from a background queue internal to __TNL__ and may run
+ concurrently with requests being executed (and with any other provider callbacks), so
+ implementations must be thread safe and should return quickly.
  */
 @protocol TNLBackoffBehaviorProvider <NSObject>
 
@@ -91,6 +95,10 @@ NS_INLINE TNLBackoffBehavior TNLBackoffBehaviorMake(NSTimeInterval backoff,
 
 /**
  The `TNLBackoffSignaler` protocol provides an abstraction point for deciding if a backoff signal should be raised or not.
+
+ __Threading:__ the callback is made from the network lane of each request operation as its response
+ is received, so it can be called concurrently from multiple threads for different requests.
+ Implementations must be thread safe and should return quickly.
  */
 @protocol TNLBackoffSignaler <NSObject>
 
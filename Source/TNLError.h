@@ -179,6 +179,13 @@ typedef NS_ERROR_ENUM(TNLErrorDomain, TNLErrorCode) {
     /** The operation could not authorize its request. */
     TNLErrorCodeRequestOperationFailedToAuthorizeRequest = 216,
 
+    /**
+     The retry policy wanted to retry, but the global retry budget is spent
+     (see `[TNLGlobalConfiguration retryBudgetRatio]`).
+     The `NSUnderlyingError` will be set to the error of the last attempt, if there was one.
+     */
+    TNLErrorCodeRequestOperationRetryBudgetExhausted = 217,
+
 
 
 
@@ -60,6 +60,7 @@ case TNLErrorCode##m : { return @"" #m ; }
             ERROR_CASE(RequestOperationRequestContentEncodingFailed)
             ERROR_CASE(RequestOperationRequestContentDecodingFailed)
             ERROR_CASE(RequestOperationFailedToAuthorizeRequest)
+            ERROR_CASE(RequestOperationRetryBudgetExhausted)
 
             ERROR_CASE(GlobalGenericError)
             ERROR_CASE(GlobalHostWasBlocked)
@@ -99,6 +100,7 @@ BOOL TNLErrorCodeIsTerminal(TNLErrorCode code)
         case TNLErrorCodeRequestOperationFailedToHydrateRequest:
         case TNLErrorCodeRequestOperationInvalidHydratedRequest:
         case TNLErrorCodeRequestOperationFailedToAuthorizeRequest:
+        case TNLErrorCodeRequestOperationRetryBudgetExhausted:
             return YES;
         case TNLErrorCodeOtherHostCannotBeEmpty:
             return YES;
@@ -119,8 +119,16 @@ typedef NS_OPTIONS(NSUInteger, TNLGlobalConfigurationURLSessionPruneOptions)
     TNLGlobalConfigurationURLSessionPruneOptionNow = NSUIntegerMax,
 };
 
+/**
+ Callback for `[TNLGlobalConfiguration getAdaptiveConcurrencyLimits:]`
+ @param limitsByBackoffKey the current concurrency limit for each backoff key that has one
+ */
+typedef void(^TNLGlobalConfigurationGetAdaptiveConcurrencyLimitsCallback)(NSDictionary<NSString *, NSNumber *> *limitsByBackoffKey);
+
 //! The default duration for an unused `NSURLSession` to become considered _inactive_
 FOUNDATION_EXTERN NSTimeInterval const TNLGlobalConfigurationURLSessionInactivityThresholdDefault;
+//! The default maximum number of in app `NSURLSession` instances __TNL__ will keep around
+FOUNDATION_EXTERN NSUInteger const TNLGlobalConfigurationMaximumURLSessionCountDefault;
 
 /**
  `TNLGlobalConfiguration` is where the settings that affect all of TNL are maintained.
@@ -208,6 +216,8 @@ FOUNDATION_EXTERN NSTimeInterval const TNLGlobalConfigurationURLSessionInactivit
 /**
  The threshold where operations above the threshold will be considered "dependencies" for all
  operations that enqueue below the threshold.
+ An operation below the threshold only waits on the operations above the threshold that were
+ already enqueued (and not yet finished) when it was enqueued.
 
  Default == `NSIntegerMax`, which disables the feature.
  `TNLPriorityVeryHigh` is a good choice as it would require explicitely setting the operation to a
@@ -216,6 +226,60 @@ FOUNDATION_EXTERN NSTimeInterval const TNLGlobalConfigurationURLSessionInactivit
  */
 @property (nonatomic) TNLPriority operationAutomaticDependencyPriorityThreshold;
 
+/**
+ The maximum number of `TNLRequestOperation` instances that can run concurrently.
+ Operations beyond the limit wait (after their dependencies are satisfied) to be admitted by the
+ global admission scheduler, see `TNLRequestOperationAdmissionStatistics`.
+
+ Default == `0`, which is unlimited.
+ */
+@property (atomic) NSUInteger maximumConcurrentRequestOperationCount;
+
+/**
+ The maximum number of `TNLRequestOperation` instances that can run concurrently for any one host
+ (as provided by the original request's `URL`).
+
+ Default == `0`, which is unlimited.
+ */
+@property (atomic) NSUInteger maximumConcurrentRequestOperationCountPerHost;
+
+/**
+ How long an operation can wait for admission before it is admitted ahead of higher priority
+ operations, which prevents `TNLPriorityVeryLow` operations from being starved.
+
+ Set to `0` to disable aging.
+ Default == `3` seconds.
+ */
+@property (atomic) NSTimeInterval requestOperationAdmissionAgingInterval;
+
+#pragma mark Retry Budget
+
+/**
+ The maximum ratio of retries to requests started over the `retryBudgetWindow`, shared by all
+ `TNLRequestOperation` instances.
+ When a backend degrades, every operation's `TNLRequestRetryPolicyProvider` independently asks for
+ retries; the budget keeps those retries from multiplying the load.
+ A retry beyond the budget is not started and the operation fails with
+ `TNLErrorCodeRequestOperationRetryBudgetExhausted`, see `TNLRequestOperationRetryBudgetStatistics`.
+
+ `0.1` permits retries of at most 10% of requests.
+ Default == `0`, which disables the budget.
+ */
+@property (atomic) double retryBudgetRatio;
+
+/**
+ The sliding window the `retryBudgetRatio` is measured over.
+ Default == `10` seconds.
+ */
+@property (atomic) NSTimeInterval retryBudgetWindow;
+
+/**
+ The number of retries always permitted per `retryBudgetWindow`, so that apps making few requests
+ can still retry.
+ Default == `10`.
+ */
+@property (atomic) NSUInteger retryBudgetMinimumRetryCount;
+
 /**
  The backoff mode when a backoff signal is encountered.
 
@@ -226,6 +290,8 @@ FOUNDATION_EXTERN NSTimeInterval const TNLGlobalConfigurationURLSessionInactivit
 /**
  The backoff behavior provider when a backoff signal is encountered and `backoffMode` is not `Disabled`.
  Setting to `nil` will reset to an instance of `TNLSimpleBackoffBehaviorProvider`.
+ The provider is called from a background queue concurrently with requests executing,
+ so it must be thread safe (see `TNLBackoffBehaviorProvider`).
  Default == an instance of `TNLSimpleBackoffBehaviorProvider`.
  */
 @property (atomic, null_resettable) id<TNLBackoffBehaviorProvider> backoffBehaviorProvider;
@@ -233,6 +299,8 @@ FOUNDATION_EXTERN NSTimeInterval const TNLGlobalConfigurationURLSessionInactivit
 /**
  The backoff signaler for when an HTTP response should trigger a backoff signal.
  Setting to `nil` will reset to an instance of `TNLSimpleBackoffSignaler`.
+ The signaler is called concurrently from the threads of the requests being executed,
+ so it must be thread safe (see `TNLBackoffSignaler`).
  Default == an instance of `TNLSimpleBackoffSignaler`
  */
 @property (atomic, null_resettable) id<TNLBackoffSignaler> backoffSignaler;
@@ -244,6 +312,28 @@ FOUNDATION_EXTERN NSTimeInterval const TNLGlobalConfigurationURLSessionInactivit
  */
 @property (atomic) BOOL shouldBackoffUseOriginalRequestHost;
 
+/**
+ Whether to limit the number of concurrent requests per backoff key with an adaptive limit.
+ The key is derived the same way backoff keys are (see `backoffMode`), so this has no effect
+ when `backoffMode` is `TNLGlobalConfigurationBackoffModeDisabled`.
+
+ Each key's limit grows additively while requests complete successfully and close to the fastest
+ observed latency, and shrinks multiplicatively when requests fail (error, 5xx or 429) or take
+ much longer than that baseline.  An overloaded backend receives less traffic before it has to
+ signal a backoff.  Long polling requests are not limited.
+ Changing this value resets all backoffs.
+
+ Default == `NO`
+ */
+@property (atomic, getter=isAdaptiveConcurrencyEnabled) BOOL adaptiveConcurrencyEnabled;
+
+/**
+ Get the current adaptive concurrency limit for each backoff key (see `adaptiveConcurrencyEnabled`).
+ Useful for surfacing in dashboards.
+ @param callback the callback with the limits, called on a background queue
+ */
+- (void)getAdaptiveConcurrencyLimits:(TNLGlobalConfigurationGetAdaptiveConcurrencyLimitsCallback)callback;
+
 #pragma mark Pruning inactive NSURLSession instances
 
 /**
@@ -262,6 +352,19 @@ FOUNDATION_EXTERN NSTimeInterval const TNLGlobalConfigurationURLSessionInactivit
  */
 @property (atomic) NSTimeInterval URLSessionInactivityThreshold;
 
+/**
+ The maximum number of in app `NSURLSession` instances to keep around.
+ When exceeded, the least recently used sessions without active operations are invalidated.
+ Sessions are also budgeted by their resource use (each session plus each of its outstanding
+ operations counts toward a budget of 8 per `maximumURLSessionCount`), so idle sessions are
+ invalidated sooner while many operations are running.
+ Can be lowered at any time (such as under memory pressure) and takes effect immediately.
+ Does not apply to background `NSURLSession` instances.
+ Setting `0` will reset to `TNLGlobalConfigurationMaximumURLSessionCountDefault`.
+ Default == `TNLGlobalConfigurationMaximumURLSessionCountDefault`
+ */
+@property (atomic) NSUInteger maximumURLSessionCount;
+
 /**
  Method to explicitely prune an `NSURLSession` if it has no active operations.
  @param config The `TNLRequestConfiguration` to match with an underlying `NSURLSession`
@@ -6,6 +6,8 @@
 //  Copyright © 2020 Twitter. All rights reserved.
 //
 
+#include <os/lock.h>
+
 #import "TNL_Project.h"
 #import "TNLBackoff.h"
 #import "TNLGlobalConfiguration_Project.h"
@@ -15,6 +17,7 @@
 NS_ASSUME_NONNULL_BEGIN
 
 NSTimeInterval const TNLGlobalConfigurationURLSessionInactivityThresholdDefault = 60.0 * 4.0; // four minutes
+NSUInteger const TNLGlobalConfigurationMaximumURLSessionCountDefault = 12;
 const TNLBackgroundTaskIdentifier TNLBackgroundTaskInvalid = 0;
 static const TNLBackgroundTaskIdentifier TNLBackgroundTaskInitial = 1;
 
@@ -38,7 +41,8 @@ TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
     NSMutableDictionary<NSNumber *, TNLBackgroundTaskHandleInternal *> *_runningBackgroundTasks;
     dispatch_queue_t _backgroundTaskQueue;
     NSArray<id<TNLAuthenticationChallengeHandler>> *_authHandlers;
-    id<TNLBackoffSignaler> _backoffSignaler;
+    id<TNLBackoffSignaler> _backoffSignaler; // guarded by _backoffSignalerLock
+    os_unfair_lock _backoffSignalerLock;
 
 #if TARGET_OS_IOS || TARGET_OS_TV
     UIBackgroundTaskIdentifier _sharedUIApplicationBackgroundTaskIdentifier;
@@ -79,6 +83,7 @@ TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
         _operationAutomaticDependencyPriorityThreshold = (TNLPriority)NSIntegerMax;
         _internalURLSessionInactivityThreshold = TNLGlobalConfigurationURLSessionInactivityThresholdDefault;
         _backoffSignaler = [[TNLSimpleBackoffSignaler alloc] init];
+        _backoffSignalerLock = OS_UNFAIR_LOCK_INIT;
 
 #if TARGET_OS_IOS || TARGET_OS_TV
         _sharedUIApplicationBackgroundTaskIdentifier = 0;
@@ -226,6 +231,91 @@ TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
     [TNLURLSessionManager sharedInstance].backoffMode = mode;
 }
 
+- (BOOL)isAdaptiveConcurrencyEnabled
+{
+    return [TNLURLSessionManager sharedInstance].isAdaptiveConcurrencyEnabled;
+}
+
+- (void)setAdaptiveConcurrencyEnabled:(BOOL)enabled
+{
+    [TNLURLSessionManager sharedInstance].adaptiveConcurrencyEnabled = enabled;
+}
+
+- (void)getAdaptiveConcurrencyLimits:(TNLGlobalConfigurationGetAdaptiveConcurrencyLimitsCallback)callback
+{
+    [[TNLURLSessionManager sharedInstance] getAdaptiveConcurrencyLimits:callback];
+}
+
+- (NSUInteger)maximumURLSessionCount
+{
+    return [TNLURLSessionManager sharedInstance].maximumURLSessionCount;
+}
+
+- (void)setMaximumURLSessionCount:(NSUInteger)count
+{
+    [TNLURLSessionManager sharedInstance].maximumURLSessionCount = count ?: TNLGlobalConfigurationMaximumURLSessionCountDefault;
+}
+
+- (NSUInteger)maximumConcurrentRequestOperationCount
+{
+    return TNLRequestOperationQueue.admissionGlobalLimit;
+}
+
+- (void)setMaximumConcurrentRequestOperationCount:(NSUInteger)count
+{
+    TNLRequestOperationQueue.admissionGlobalLimit = count;
+}
+
+- (NSUInteger)maximumConcurrentRequestOperationCountPerHost
+{
+    return TNLRequestOperationQueue.admissionPerHostLimit;
+}
+
+- (void)setMaximumConcurrentRequestOperationCountPerHost:(NSUInteger)count
+{
+    TNLRequestOperationQueue.admissionPerHostLimit = count;
+}
+
+- (NSTimeInterval)requestOperationAdmissionAgingInterval
+{
+    return TNLRequestOperationQueue.admissionAgingInterval;
+}
+
+- (void)setRequestOperationAdmissionAgingInterval:(NSTimeInterval)interval
+{
+    TNLRequestOperationQueue.admissionAgingInterval = interval;
+}
+
+- (double)retryBudgetRatio
+{
+    return TNLRequestOperationQueue.retryBudgetRatio;
+}
+
+- (void)setRetryBudgetRatio:(double)ratio
+{
+    TNLRequestOperationQueue.retryBudgetRatio = ratio;
+}
+
+- (NSTimeInterval)retryBudgetWindow
+{
+    return TNLRequestOperationQueue.retryBudgetWindow;
+}
+
+- (void)setRetryBudgetWindow:(NSTimeInterval)window
+{
+    TNLRequestOperationQueue.retryBudgetWindow = window;
+}
+
+- (NSUInteger)retryBudgetMinimumRetryCount
+{
+    return TNLRequestOperationQueue.retryBudgetMinimumRetryCount;
+}
+
+- (void)setRetryBudgetMinimumRetryCount:(NSUInteger)count
+{
+    TNLRequestOperationQueue.retryBudgetMinimumRetryCount = count;
+}
+
 - (id<TNLBackoffBehaviorProvider>)backoffBehaviorProvider
 {
     return [TNLURLSessionManager sharedInstance].backoffBehaviorProvider;
@@ -238,14 +328,11 @@ TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
 
 - (id<TNLBackoffSignaler>)backoffSignaler
 {
-    if (dispatch_queue_get_label(tnl_network_queue()) == dispatch_queue_get_label(DISPATCH_CURRENT_QUEUE_LABEL)) {
-        return _backoffSignaler;
-    }
-
-    __block id<TNLBackoffSignaler> signaler = nil;
-    dispatch_sync(tnl_network_queue(), ^{
-        signaler = self->_backoffSignaler;
-    });
+    // read for every completed attempt from each operation's lane, keep it off the network queue
+    id<TNLBackoffSignaler> signaler;
+    os_unfair_lock_lock(&_backoffSignalerLock);
+    signaler = _backoffSignaler;
+    os_unfair_lock_unlock(&_backoffSignalerLock);
     return signaler;
 }
 
@@ -255,14 +342,9 @@ TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
         backoffSignaler = [[TNLSimpleBackoffSignaler alloc] init];
     }
 
-    if (dispatch_queue_get_label(tnl_network_queue()) == dispatch_queue_get_label(DISPATCH_CURRENT_QUEUE_LABEL)) {
-        _backoffSignaler = backoffSignaler;
-        return;
-    }
-
-    dispatch_async(tnl_network_queue(), ^{
-        self->_backoffSignaler = backoffSignaler;
-    });
+    os_unfair_lock_lock(&_backoffSignalerLock);
+    _backoffSignaler = backoffSignaler;
+    os_unfair_lock_unlock(&_backoffSignalerLock);
 }
 
 - (TNLGlobalConfigurationURLSessionPruneOptions)URLSessionPruneOptions
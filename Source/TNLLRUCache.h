@@ -8,11 +8,29 @@
 
 #import <Foundation/Foundation.h>
 
+@protocol TNLConcurrentLRUCacheDelegate;
 @protocol TNLLRUCacheDelegate;
 @protocol TNLLRUEntry;
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ How a `TNLLRUCache` keeps its LRU order
+ */
+typedef NS_ENUM(NSInteger, TNLLRUCacheStorageMode) {
+    /**
+     The entries are linked to each other via `[TNLLRUEntry nextLRUEntry]` (strong) and
+     `[TNLLRUEntry previousLRUEntry]` (weak).
+     */
+    TNLLRUCacheStorageModeLinkedEntries = 0,
+    /**
+     The cache keeps a contiguous array of nodes linked by index, holding a single strong reference
+     per entry.  This avoids the retain/release and weak reference traffic of relinking entries.
+     `[TNLLRUEntry nextLRUEntry]` and `[TNLLRUEntry previousLRUEntry]` are not used.
+     */
+    TNLLRUCacheStorageModeIndexedNodes = 1,
+};
+
 /**
  `TNLLRUCache` is a collection object that maintains a set of `TNLLRUEntry` objects.
  You can look up an entry by identifier in constant time and it maintains the entries so that you
@@ -47,9 +65,57 @@ NS_ASSUME_NONNULL_BEGIN
 /** the number of entries in the manfiest.  Execution time is constant, O(1) */
 - (NSUInteger)numberOfEntries;
 
+/**
+ The total cost of all entries in the cache (see `[TNLLRUEntry LRUEntryCost]`).
+ Execution time is constant, O(1)
+ */
+@property (nonatomic, readonly) NSUInteger totalCost;
+
+/**
+ The maximum number of entries the cache should hold.
+ When exceeded, least recently used entries are evicted (honoring `tnl_cache:canEvictEntry:`)
+ until the cache is within budget.
+ The most recently used entry is never evicted to satisfy a budget.
+ Can be changed at any time, lowering the limit evicts immediately.
+ Default is `0`, which is no limit.
+ */
+@property (nonatomic) NSUInteger countLimit;
+
+/**
+ The maximum total cost the cache should hold.
+ Enforced the same way as `countLimit`.
+ Default is `0`, which is no limit.
+ */
+@property (nonatomic) NSUInteger totalCostLimit;
+
+/** Number of `entryWithIdentifier:` lookups that found an entry */
+@property (nonatomic, readonly) NSUInteger hitCount;
+/** Number of `entryWithIdentifier:` lookups that did not find an entry */
+@property (nonatomic, readonly) NSUInteger missCount;
+/** Number of entries evicted by `removeTailEntry` or to satisfy `countLimit` / `totalCostLimit` */
+@property (nonatomic, readonly) NSUInteger evictionCount;
+
+/** Reset `hitCount`, `missCount` and `evictionCount` to `0` */
+- (void)resetStatistics;
+
+/**
+ Evict least recently used entries until the cache is within its budgets.
+ Budgets are enforced automatically when entries are added or limits change,
+ call this when `tnl_cache:canEvictEntry:` may have changed its answer for an entry.
+ */
+- (void)enforceBudgets;
+
+/** The storage mode of the cache */
+@property (nonatomic, readonly) TNLLRUCacheStorageMode storageMode;
+
+/** initialize with `TNLLRUCacheStorageModeLinkedEntries` */
+- (instancetype)initWithEntries:(nullable NSArray<id<TNLLRUEntry>> *)arrayOfLRUEntries
+                       delegate:(nullable id<TNLLRUCacheDelegate>)delegate;
+
 /** designted initializer */
 - (instancetype)initWithEntries:(nullable NSArray<id<TNLLRUEntry>> *)arrayOfLRUEntries
-                       delegate:(nullable id<TNLLRUCacheDelegate>)delegate NS_DESIGNATED_INITIALIZER;
+                       delegate:(nullable id<TNLLRUCacheDelegate>)delegate
+                    storageMode:(TNLLRUCacheStorageMode)storageMode NS_DESIGNATED_INITIALIZER;
 
 /**
  Access an entry by identifier.
@@ -76,10 +142,19 @@ NS_ASSUME_NONNULL_BEGIN
  If _entry_ was not in the cache, it is added to the cache.
  If _entry_ was in the cache, it is just moved to the head if
  `[TNLLRUEntry shouldAccessMoveLRUEntryToHead]` returns `YES`.
- Execution time is constant, O(1)
+ The cost of the _entry_ is (re)captured and budgets are enforced.
+ Execution time is constant, O(1) (plus any evictions)
  */
 - (void)addEntry:(id<TNLLRUEntry>)entry;
 
+/**
+ Recaptures the cost of the given _entry_ without changing its position in the cache and enforces budgets.
+ Does nothing if _entry_ is not in the cache.
+ Use this instead of `addEntry:` when an entry's `LRUEntryCost` changes without the entry being accessed.
+ Execution time is constant, O(1) (plus any evictions)
+ */
+- (void)updateCostOfEntry:(id<TNLLRUEntry>)entry;
+
 /**
  Adds the given _entry_ as the tail entry.
  Execution time is constant, O(1)
@@ -118,6 +193,124 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/**
+ `TNLConcurrentLRUCache` is a thread safe variant of `TNLLRUCache`.
+
+ Entries are spread over shards by identifier, each shard approximates LRU with a CLOCK
+ (second chance) sweep instead of a linked list.
+ - Lookups are lock free: they read an immutable snapshot of the shard and only set a
+ "referenced" bit on the entry they find.
+ - Promotion is batched: referenced entries are given their second chance by the eviction sweep,
+ so a hit never takes a lock.
+ - Mutations lock only their shard and publish a new snapshot, which copies the shard's table.
+ This favors read heavy workloads (with the default shard count, a shard holds a small fraction of the entries).
+
+ Budgets (`countLimit` and `totalCostLimit`) are split evenly across shards.
+ `[TNLLRUEntry nextLRUEntry]` and `[TNLLRUEntry previousLRUEntry]` are not used, so an entry can
+ be in a `TNLLRUCache` and a `TNLConcurrentLRUCache` at the same time.
+
+ @warning Same caveat as `TNLLRUCache`, this class may move to a shared core utilities library.
+ */
+@interface TNLConcurrentLRUCache : NSObject
+
+/** Optional delegate */
+@property (atomic, weak, nullable) id<TNLConcurrentLRUCacheDelegate> delegate;
+
+/** The number of shards, always a power of 2 */
+@property (nonatomic, readonly) NSUInteger shardCount;
+
+/** The number of entries in the cache */
+- (NSUInteger)numberOfEntries;
+/** The total cost of all entries in the cache (see `[TNLLRUEntry LRUEntryCost]`) */
+@property (nonatomic, readonly) NSUInteger totalCost;
+
+/**
+ The maximum number of entries the cache should hold, split evenly across shards.
+ Can be changed at any time, lowering the limit evicts immediately.
+ Default is `0`, which is no limit.
+ */
+@property (atomic) NSUInteger countLimit;
+/**
+ The maximum total cost the cache should hold, split evenly across shards.
+ Default is `0`, which is no limit.
+ */
+@property (atomic) NSUInteger totalCostLimit;
+
+/** Number of `entryWithIdentifier:` lookups that found an entry */
+@property (nonatomic, readonly) NSUInteger hitCount;
+/** Number of `entryWithIdentifier:` lookups that did not find an entry */
+@property (nonatomic, readonly) NSUInteger missCount;
+/** Number of entries evicted to satisfy `countLimit` / `totalCostLimit` */
+@property (nonatomic, readonly) NSUInteger evictionCount;
+
+/** Reset `hitCount`, `missCount` and `evictionCount` to `0` */
+- (void)resetStatistics;
+
+/** Initialize with a shard count derived from the number of active processors */
+- (instancetype)init;
+/** Designated initializer, _shardCount_ is rounded up to a power of 2 */
+- (instancetype)initWithShardCount:(NSUInteger)shardCount
+                          delegate:(nullable id<TNLConcurrentLRUCacheDelegate>)delegate NS_DESIGNATED_INITIALIZER;
+
+/**
+ Find an entry by _identifier_ without taking a lock.
+ Marks the entry as recently used if `[TNLLRUEntry shouldAccessMoveLRUEntryToHead]` returns `YES`.
+ */
+- (nullable id<TNLLRUEntry>)entryWithIdentifier:(NSString *)identifier;
+
+/** A snapshot of all entries, in no particular order */
+- (NSArray<id<TNLLRUEntry>> *)allEntries;
+
+/**
+ Add the given _entry_, replacing any entry with the same identifier.
+ The cost of the _entry_ is captured and budgets are enforced (the added _entry_ is never evicted
+ to satisfy a budget).
+ */
+- (void)addEntry:(id<TNLLRUEntry>)entry;
+
+/**
+ Recapture the cost of the given _entry_ if it is in the cache and enforce budgets.
+ Unlike `addEntry:`, this does not count as an access (the _entry_ gets no second chance).
+ */
+- (void)updateCostOfEntry:(id<TNLLRUEntry>)entry;
+
+/** Remove the given _entry_ if it is in the cache, calls `tnl_concurrentCache:didEvictEntry:` */
+- (void)removeEntry:(id<TNLLRUEntry>)entry;
+
+/**
+ Clear all entries in the cache.
+ @note This does NOT trigger the `[TNLConcurrentLRUCacheDelegate tnl_concurrentCache:didEvictEntry:]` callback
+ */
+- (void)clearAllEntries;
+
+@end
+
+/**
+ Delegate protocol for `TNLConcurrentLRUCache`.
+ Callbacks can happen on any thread.
+ */
+@protocol TNLConcurrentLRUCacheDelegate <NSObject>
+
+@optional
+
+/**
+ Optional callback for when a specific _entry_ is evicted from the _cache_.
+ Called after the shard is unlocked, so it is safe to access the _cache_.
+ */
+- (void)tnl_concurrentCache:(TNLConcurrentLRUCache *)cache
+              didEvictEntry:(id<TNLLRUEntry>)entry;
+
+/**
+ Optional callback to check if a specific _entry_ can be evicted from the _cache_.
+ Return `NO` to prevent eviction.
+ Default when unimplemented is `YES`.
+ @warning Called while the entry's shard is locked, do not mutate the _cache_ from this callback.
+ */
+- (BOOL)tnl_concurrentCache:(TNLConcurrentLRUCache *)cache
+              canEvictEntry:(id<TNLLRUEntry>)entry;
+
+@end
+
 /**
  Delegate protocol for `TNLLRUCache`
  */
@@ -135,7 +328,7 @@ NS_ASSUME_NONNULL_BEGIN
  Optional callback to check if a specific _entry_ can be evicted from the _cache_.
  Return `NO` to prevent eviction.
  Default when unimplemented is `YES`.
- Only used in conjuction with `removeTailEntry`.
+ Only used in conjuction with `removeTailEntry` and when enforcing budgets.
  */
 - (BOOL)tnl_cache:(TNLLRUCache *)cache
     canEvictEntry:(id<TNLLRUEntry>)entry;
@@ -158,15 +351,28 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (BOOL)shouldAccessMoveLRUEntryToHead;
 
+@optional
+
+/**
+ The cost of the entry toward `[TNLLRUCache totalCostLimit]`, such as its memory footprint.
+ Captured when the entry is added (re-adding the entry updates it).
+ Default when unimplemented is `0`.
+ */
+- (NSUInteger)LRUEntryCost;
+
+@required
+
 /**
  A property to store the strong reference to the next entry.
  This property will be managed by the `TNLLRUManfiest` and should not be manipulated.
+ Unused by `TNLLRUCacheStorageModeIndexedNodes`.
  */
 @property (nonatomic, nullable) id<TNLLRUEntry> nextLRUEntry;
 
 /**
  A property to store the weak reference to the previous entry.
  This property will be managed by the `TNLLRUManfiest` and should not be manipulated.
+ Unused by `TNLLRUCacheStorageModeIndexedNodes`.
  */
 @property (nonatomic, nullable, weak) id<TNLLRUEntry> previousLRUEntry;
 
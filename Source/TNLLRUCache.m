@@ -6,17 +6,36 @@
 //  Copyright © 2020 Twitter. All rights reserved.
 //
 
+#include <os/lock.h>
+#include <sched.h>
+#include <stdatomic.h>
+
 #import "TNL_Project.h"
 #import "TNLLRUCache.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
 @interface TNLLRUCache ()
+{
+@protected
+    struct {
+        BOOL delegateSupportsDidEvictSelector;
+        BOOL delegateSupportsCanEvictSelector;
+        BOOL isEnforcingBudgets;
+    } _flags;
+    NSInteger _mutationCheckInteger;
+    NSUInteger _totalCost;
+    NSUInteger _hitCount;
+    NSUInteger _missCount;
+    NSUInteger _evictionCount;
+}
 
 @property (nonatomic, readonly) NSMutableDictionary<NSString *, id<TNLLRUEntry>> *cache;
 
 - (void)clearEntry:(id<TNLLRUEntry>)entry;
 - (void)moveEntryToFront:(id<TNLLRUEntry>)entry;
+- (void)updateCostOfEntry:(id<TNLLRUEntry>)entry identifier:(NSString *)identifier;
+- (BOOL)isOverBudget;
 
 @end
 
@@ -33,13 +52,14 @@ NS_INLINE void TNLLRUCacheAssertHeadAndTail(TNLLRUCache *cache)
     }
 }
 
+// TNLLRUCacheStorageModeIndexedNodes
+TNL_OBJC_FINAL
+@interface TNLIndexedLRUCache : TNLLRUCache
+@end
+
 @implementation TNLLRUCache
 {
-    struct {
-        BOOL delegateSupportsDidEvictSelector;
-        BOOL delegateSupportsCanEvictSelector;
-    } _flags;
-    NSInteger _mutationCheckInteger;
+    NSMutableDictionary<NSString *, NSNumber *> *_costs; // only entries with a non-zero cost
 }
 
 - (instancetype)init
@@ -49,8 +69,25 @@ NS_INLINE void TNLLRUCacheAssertHeadAndTail(TNLLRUCache *cache)
 
 - (instancetype)initWithEntries:(nullable NSArray *)arrayOfLRUEntries delegate:(nullable id<TNLLRUCacheDelegate>)delegate
 {
+    return [self initWithEntries:arrayOfLRUEntries
+                        delegate:delegate
+                     storageMode:TNLLRUCacheStorageModeLinkedEntries];
+}
+
+- (instancetype)initWithEntries:(nullable NSArray *)arrayOfLRUEntries
+                       delegate:(nullable id<TNLLRUCacheDelegate>)delegate
+                    storageMode:(TNLLRUCacheStorageMode)storageMode
+{
+    if (TNLLRUCacheStorageModeIndexedNodes == storageMode && [self class] == [TNLLRUCache class]) {
+        return [[TNLIndexedLRUCache alloc] initWithEntries:arrayOfLRUEntries
+                                                  delegate:delegate
+                                               storageMode:storageMode];
+    }
+
     if (self = [super init]) {
+        _storageMode = storageMode;
         _cache = [[NSMutableDictionary alloc] init];
+        _costs = [[NSMutableDictionary alloc] init];
         [self internalSetDelegate:delegate];
         for (id<TNLLRUEntry> entry in arrayOfLRUEntries) {
             [self appendEntry:entry];
@@ -97,8 +134,23 @@ NS_INLINE void TNLLRUCacheAssertHeadAndTail(TNLLRUCache *cache)
 
     [self moveEntryToFront:entry];
     _cache[identifier] = entry;
+    [self updateCostOfEntry:entry identifier:identifier];
 
     TNLLRUCacheAssertHeadAndTail(self);
+    [self enforceBudgets];
+}
+
+- (void)updateCostOfEntry:(id<TNLLRUEntry>)entry
+{
+    TNLAssert(entry != nil);
+    NSString *identifier = entry.LRUEntryIdentifier;
+    TNLAssert(identifier != nil);
+    if (!identifier || (id)_cache[identifier] != (id)entry) {
+        return;
+    }
+
+    [self updateCostOfEntry:entry identifier:identifier];
+    [self enforceBudgets];
 }
 
 - (void)appendEntry:(id<TNLLRUEntry>)entry
@@ -135,9 +187,11 @@ NS_INLINE void TNLLRUCacheAssertHeadAndTail(TNLLRUCache *cache)
     if (!_headEntry) {
         _headEntry = _tailEntry;
     }
+    [self updateCostOfEntry:entry identifier:identifier];
 
     _mutationCheckInteger++;
     TNLLRUCacheAssertHeadAndTail(self);
+    [self enforceBudgets];
 }
 
 #pragma mark Getting
@@ -150,8 +204,13 @@ NS_INLINE void TNLLRUCacheAssertHeadAndTail(TNLLRUCache *cache)
 - (nullable id<TNLLRUEntry>)entryWithIdentifier:(NSString *)identifier canMutate:(BOOL)canMutate
 {
     id<TNLLRUEntry> entry = _cache[identifier];
-    if (canMutate && entry) {
-        [self moveEntryToFront:entry];
+    if (entry) {
+        _hitCount++;
+        if (canMutate) {
+            [self moveEntryToFront:entry];
+        }
+    } else {
+        _missCount++;
     }
     return entry;
 }
@@ -193,6 +252,11 @@ NS_INLINE void TNLLRUCacheAssertHeadAndTail(TNLLRUCache *cache)
 
     [self clearEntry:entry];
     [_cache removeObjectForKey:identifier];
+    NSNumber *cost = _costs[identifier];
+    if (cost) {
+        _totalCost -= cost.unsignedIntegerValue;
+        [_costs removeObjectForKey:identifier];
+    }
 
     TNLLRUCacheAssertHeadAndTail(self);
 
@@ -208,10 +272,34 @@ NS_INLINE void TNLLRUCacheAssertHeadAndTail(TNLLRUCache *cache)
     while (entry && _flags.delegateSupportsCanEvictSelector && ![delegate tnl_cache:self canEvictEntry:entry]) {
         entry = entry.previousLRUEntry;
     }
+    if (entry) {
+        _evictionCount++;
+    }
     [self removeEntry:entry];
     return entry;
 }
 
+#pragma mark Budgets
+
+- (void)setCountLimit:(NSUInteger)countLimit
+{
+    _countLimit = countLimit;
+    [self enforceBudgets];
+}
+
+- (void)setTotalCostLimit:(NSUInteger)totalCostLimit
+{
+    _totalCostLimit = totalCostLimit;
+    [self enforceBudgets];
+}
+
+- (void)resetStatistics
+{
+    _hitCount = 0;
+    _missCount = 0;
+    _evictionCount = 0;
+}
+
 #pragma mark Other
 
 - (void)clearAllEntries
@@ -220,6 +308,8 @@ NS_INLINE void TNLLRUCacheAssertHeadAndTail(TNLLRUCache *cache)
     _tailEntry = nil;
     _headEntry = nil;
     [_cache removeAllObjects];
+    [_costs removeAllObjects];
+    _totalCost = 0;
     _mutationCheckInteger++;
 }
 
@@ -318,6 +408,50 @@ NS_INLINE void TNLLRUCacheAssertHeadAndTail(TNLLRUCache *cache)
     TNLAssert(!_headEntry == !_tailEntry);
 }
 
+- (void)updateCostOfEntry:(id<TNLLRUEntry>)entry identifier:(NSString *)identifier
+{
+    const NSUInteger cost = [entry respondsToSelector:@selector(LRUEntryCost)] ? entry.LRUEntryCost : 0;
+    const NSUInteger oldCost = _costs[identifier].unsignedIntegerValue;
+    if (cost == oldCost) {
+        return;
+    }
+
+    _totalCost = _totalCost - oldCost + cost;
+    _costs[identifier] = (cost) ? @(cost) : nil;
+}
+
+- (BOOL)isOverBudget
+{
+    if (_countLimit && self.numberOfEntries > _countLimit) {
+        return YES;
+    }
+    if (_totalCostLimit && _totalCost > _totalCostLimit) {
+        return YES;
+    }
+    return NO;
+}
+
+- (void)enforceBudgets
+{
+    if (_flags.isEnforcingBudgets) {
+        // a delegate callback mutated the cache
+        return;
+    }
+
+    _flags.isEnforcingBudgets = YES;
+    id<TNLLRUCacheDelegate> delegate = self.delegate;
+    id<TNLLRUEntry> candidate = _tailEntry;
+    while ([self isOverBudget] && candidate && candidate != _headEntry) {
+        id<TNLLRUEntry> previous = candidate.previousLRUEntry;
+        if (!_flags.delegateSupportsCanEvictSelector || [delegate tnl_cache:self canEvictEntry:candidate]) {
+            _evictionCount++;
+            [self removeEntry:candidate];
+        }
+        candidate = previous;
+    }
+    _flags.isEnforcingBudgets = NO;
+}
+
 - (void)nullifyEntryLinks
 {
     // removing all entries via weak dealloc chaining
@@ -334,5 +468,947 @@ NS_INLINE void TNLLRUCacheAssertHeadAndTail(TNLLRUCache *cache)
 
 @end
 
-NS_ASSUME_NONNULL_END
+#pragma mark - TNLIndexedLRUCache
+
+typedef uint32_t TNLLRUNodeIndex;
+static const TNLLRUNodeIndex kTNLLRUNullNodeIndex = UINT32_MAX;
+static const TNLLRUNodeIndex kTNLLRUInitialNodeCapacity = 16;
+
+typedef struct _TNLLRUNode {
+    void * __nullable entry; // +1 id<TNLLRUEntry>, NULL while on the free list
+    NSUInteger cost;
+    TNLLRUNodeIndex previous; // toward the head
+    TNLLRUNodeIndex next; // toward the tail, or the next free node
+} _TNLLRUNode;
+
+@implementation TNLIndexedLRUCache
+{
+    _TNLLRUNode *_nodes;
+    TNLLRUNodeIndex _capacity;
+    TNLLRUNodeIndex _freeIndex;
+    TNLLRUNodeIndex _headIndex;
+    TNLLRUNodeIndex _tailIndex;
+    NSUInteger _count;
+    CFMutableDictionaryRef _indexes; // NSString -> TNLLRUNodeIndex
+}
+
+- (instancetype)initWithEntries:(nullable NSArray *)arrayOfLRUEntries
+                       delegate:(nullable id<TNLLRUCacheDelegate>)delegate
+                    storageMode:(TNLLRUCacheStorageMode)storageMode
+{
+    TNLAssert(TNLLRUCacheStorageModeIndexedNodes == storageMode);
+    if (self = [super initWithEntries:nil delegate:delegate storageMode:TNLLRUCacheStorageModeIndexedNodes]) {
+        _freeIndex = kTNLLRUNullNodeIndex;
+        _headIndex = kTNLLRUNullNodeIndex;
+        _tailIndex = kTNLLRUNullNodeIndex;
+        _indexes = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, &kCFTypeDictionaryKeyCallBacks, NULL);
+        for (id<TNLLRUEntry> entry in arrayOfLRUEntries) {
+            [self appendEntry:entry];
+        }
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [self _releaseAllNodes];
+    free(_nodes);
+    if (_indexes) {
+        CFRelease(_indexes);
+    }
+}
+
+#pragma mark Nodes
+
+- (BOOL)_getIndex:(TNLLRUNodeIndex *)indexOut forIdentifier:(NSString *)identifier TNL_OBJC_DIRECT
+{
+    const void *value = NULL;
+    if (!CFDictionaryGetValueIfPresent(_indexes, (__bridge CFStringRef)identifier, &value)) {
+        return NO;
+    }
+    *indexOut = (TNLLRUNodeIndex)(uintptr_t)value;
+    return YES;
+}
+
+- (TNLLRUNodeIndex)_allocateNode TNL_OBJC_DIRECT
+{
+    if (kTNLLRUNullNodeIndex == _freeIndex) {
+        if (_capacity >= kTNLLRUNullNodeIndex / 2) {
+            return kTNLLRUNullNodeIndex;
+        }
+
+        const TNLLRUNodeIndex capacity = (_capacity) ? _capacity * 2 : kTNLLRUInitialNodeCapacity;
+        _TNLLRUNode *nodes = (_TNLLRUNode *)realloc(_nodes, capacity * sizeof(_TNLLRUNode));
+        if (!nodes) {
+            return kTNLLRUNullNodeIndex;
+        }
+
+        for (TNLLRUNodeIndex i = _capacity; i < capacity; i++) {
+            nodes[i].entry = NULL;
+            nodes[i].next = (i + 1 < capacity) ? i + 1 : kTNLLRUNullNodeIndex;
+        }
+        _freeIndex = _capacity;
+        _nodes = nodes;
+        _capacity = capacity;
+    }
+
+    const TNLLRUNodeIndex index = _freeIndex;
+    _freeIndex = _nodes[index].next;
+    return index;
+}
+
+- (void)_unlinkNode:(TNLLRUNodeIndex)index TNL_OBJC_DIRECT
+{
+    _TNLLRUNode *node = &_nodes[index];
+    if (node->previous != kTNLLRUNullNodeIndex) {
+        _nodes[node->previous].next = node->next;
+    } else {
+        _headIndex = node->next;
+    }
+    if (node->next != kTNLLRUNullNodeIndex) {
+        _nodes[node->next].previous = node->previous;
+    } else {
+        _tailIndex = node->previous;
+    }
+}
+
+- (void)_linkNodeAtHead:(TNLLRUNodeIndex)index TNL_OBJC_DIRECT
+{
+    _TNLLRUNode *node = &_nodes[index];
+    node->previous = kTNLLRUNullNodeIndex;
+    node->next = _headIndex;
+    if (_headIndex != kTNLLRUNullNodeIndex) {
+        _nodes[_headIndex].previous = index;
+    } else {
+        _tailIndex = index;
+    }
+    _headIndex = index;
+}
+
+- (void)_linkNodeAtTail:(TNLLRUNodeIndex)index TNL_OBJC_DIRECT
+{
+    _TNLLRUNode *node = &_nodes[index];
+    node->next = kTNLLRUNullNodeIndex;
+    node->previous = _tailIndex;
+    if (_tailIndex != kTNLLRUNullNodeIndex) {
+        _nodes[_tailIndex].next = index;
+    } else {
+        _headIndex = index;
+    }
+    _tailIndex = index;
+}
+
+- (void)_updateCostOfNode:(TNLLRUNodeIndex)index entry:(id<TNLLRUEntry>)entry TNL_OBJC_DIRECT
+{
+    const NSUInteger cost = [entry respondsToSelector:@selector(LRUEntryCost)] ? entry.LRUEntryCost : 0;
+    _totalCost = _totalCost - _nodes[index].cost + cost;
+    _nodes[index].cost = cost;
+}
+
+- (TNLLRUNodeIndex)_insertEntry:(id<TNLLRUEntry>)entry
+                     identifier:(NSString *)identifier
+                         atHead:(BOOL)atHead TNL_OBJC_DIRECT
+{
+    const TNLLRUNodeIndex index = [self _allocateNode];
+    TNLAssert(index != kTNLLRUNullNodeIndex);
+    if (kTNLLRUNullNodeIndex == index) {
+        return index;
+    }
+
+    _nodes[index].entry = (void *)CFBridgingRetain(entry);
+    _nodes[index].cost = 0;
+    if (atHead) {
+        [self _linkNodeAtHead:index];
+    } else {
+        [self _linkNodeAtTail:index];
+    }
+    CFDictionarySetValue(_indexes, (__bridge CFStringRef)[identifier copy], (const void *)(uintptr_t)index);
+    _count++;
+    _mutationCheckInteger++;
+    return index;
+}
+
+- (void)_removeNode:(TNLLRUNodeIndex)index identifier:(NSString *)identifier TNL_OBJC_DIRECT
+{
+    [self _unlinkNode:index];
+    CFDictionaryRemoveValue(_indexes, (__bridge CFStringRef)identifier);
+    _totalCost -= _nodes[index].cost;
+    _count--;
+    _mutationCheckInteger++;
+
+    void *entry = _nodes[index].entry;
+    _nodes[index].entry = NULL;
+    _nodes[index].cost = 0;
+    _nodes[index].next = _freeIndex;
+    _freeIndex = index;
+    CFRelease(entry);
+}
+
+- (void)_releaseAllNodes TNL_OBJC_DIRECT
+{
+    TNLLRUNodeIndex index = _headIndex;
+    while (index != kTNLLRUNullNodeIndex) {
+        const TNLLRUNodeIndex next = _nodes[index].next;
+        CFRelease(_nodes[index].entry);
+        _nodes[index].entry = NULL;
+        index = next;
+    }
+}
+
+#pragma mark Setting
+
+- (void)addEntry:(id<TNLLRUEntry>)entry
+{
+    TNLAssert(entry != nil);
+    if (entry == nil) {
+        return;
+    }
+
+    NSString *identifier = entry.LRUEntryIdentifier;
+    TNLAssert(identifier != nil);
+    if (!identifier) {
+        return;
+    }
+
+    TNLLRUNodeIndex index;
+    if ([self _getIndex:&index forIdentifier:identifier]) {
+        TNLAssert((__bridge id)_nodes[index].entry == (id)entry);
+        if (index == _headIndex) {
+            return;
+        }
+        if (entry.shouldAccessMoveLRUEntryToHead) {
+            [self _unlinkNode:index];
+            [self _linkNodeAtHead:index];
+            _mutationCheckInteger++;
+        }
+    } else {
+        index = [self _insertEntry:entry identifier:identifier atHead:YES];
+        if (kTNLLRUNullNodeIndex == index) {
+            return;
+        }
+    }
+
+    [self _updateCostOfNode:index entry:entry];
+    [self enforceBudgets];
+}
+
+- (void)updateCostOfEntry:(id<TNLLRUEntry>)entry
+{
+    TNLAssert(entry != nil);
+    NSString *identifier = entry.LRUEntryIdentifier;
+    TNLAssert(identifier != nil);
+    if (!identifier) {
+        return;
+    }
+
+    TNLLRUNodeIndex index;
+    if (![self _getIndex:&index forIdentifier:identifier] || (__bridge id)_nodes[index].entry != (id)entry) {
+        return;
+    }
+
+    [self _updateCostOfNode:index entry:entry];
+    [self enforceBudgets];
+}
+
+- (void)appendEntry:(id<TNLLRUEntry>)entry
+{
+    TNLAssert(entry != nil);
+    if (entry == nil) {
+        return;
+    }
+
+    NSString *identifier = entry.LRUEntryIdentifier;
+    TNLAssert(identifier != nil);
+    if (!identifier) {
+        return;
+    }
+
+    TNLLRUNodeIndex index;
+    if ([self _getIndex:&index forIdentifier:identifier]) {
+        TNLAssert((__bridge id)_nodes[index].entry == (id)entry);
+        if (index == _tailIndex) {
+            return;
+        }
+        [self _unlinkNode:index];
+        [self _linkNodeAtTail:index];
+        _mutationCheckInteger++;
+    } else {
+        index = [self _insertEntry:entry identifier:identifier atHead:NO];
+        if (kTNLLRUNullNodeIndex == index) {
+            return;
+        }
+    }
+
+    [self _updateCostOfNode:index entry:entry];
+    [self enforceBudgets];
+}
+
+#pragma mark Getting
+
+- (nullable id<TNLLRUEntry>)headEntry
+{
+    return (_headIndex != kTNLLRUNullNodeIndex) ? (__bridge id<TNLLRUEntry>)_nodes[_headIndex].entry : nil;
+}
+
+- (nullable id<TNLLRUEntry>)tailEntry
+{
+    return (_tailIndex != kTNLLRUNullNodeIndex) ? (__bridge id<TNLLRUEntry>)_nodes[_tailIndex].entry : nil;
+}
+
+- (NSUInteger)numberOfEntries
+{
+    return _count;
+}
+
+- (nullable id<TNLLRUEntry>)entryWithIdentifier:(NSString *)identifier canMutate:(BOOL)canMutate
+{
+    TNLLRUNodeIndex index;
+    if (![self _getIndex:&index forIdentifier:identifier]) {
+        _missCount++;
+        return nil;
+    }
+
+    _hitCount++;
+    id<TNLLRUEntry> entry = (__bridge id<TNLLRUEntry>)_nodes[index].entry;
+    if (canMutate && index != _headIndex && entry.shouldAccessMoveLRUEntryToHead) {
+        [self _unlinkNode:index];
+        [self _linkNodeAtHead:index];
+        _mutationCheckInteger++;
+    }
+    return entry;
+}
+
+- (NSArray *)allEntries
+{
+    NSMutableArray *entries = [[NSMutableArray alloc] initWithCapacity:_count];
+    for (TNLLRUNodeIndex index = _headIndex; index != kTNLLRUNullNodeIndex; index = _nodes[index].next) {
+        [entries addObject:(__bridge id<TNLLRUEntry>)_nodes[index].entry];
+    }
+    return entries;
+}
+
+#pragma mark Removal
+
+- (void)removeEntry:(nullable id<TNLLRUEntry>)entry
+{
+    if (!entry) {
+        return;
+    }
+
+    NSString *identifier = entry.LRUEntryIdentifier;
+    TNLAssert(identifier != nil);
+    if (!identifier) {
+        return;
+    }
+
+    TNLLRUNodeIndex index;
+    if (![self _getIndex:&index forIdentifier:identifier]) {
+        return;
+    }
+    TNLAssert((__bridge id)_nodes[index].entry == (id)entry);
+
+    [self _removeNode:index identifier:identifier];
+
+    if (_flags.delegateSupportsDidEvictSelector) {
+        [self.delegate tnl_cache:self didEvictEntry:entry];
+    }
+}
+
+- (nullable id<TNLLRUEntry>)removeTailEntry
+{
+    id<TNLLRUCacheDelegate> delegate = self.delegate;
+    TNLLRUNodeIndex index = _tailIndex;
+    while (index != kTNLLRUNullNodeIndex && _flags.delegateSupportsCanEvictSelector && ![delegate tnl_cache:self canEvictEntry:(__bridge id<TNLLRUEntry>)_nodes[index].entry]) {
+        index = _nodes[index].previous;
+    }
+    if (kTNLLRUNullNodeIndex == index) {
+        return nil;
+    }
+
+    id<TNLLRUEntry> entry = (__bridge id<TNLLRUEntry>)_nodes[index].entry;
+    _evictionCount++;
+    [self removeEntry:entry];
+    return entry;
+}
 
+#pragma mark Budgets
+
+- (void)enforceBudgets
+{
+    if (_flags.isEnforcingBudgets) {
+        // a delegate callback mutated the cache
+        return;
+    }
+
+    _flags.isEnforcingBudgets = YES;
+    id<TNLLRUCacheDelegate> delegate = self.delegate;
+    TNLLRUNodeIndex candidate = _tailIndex;
+    while ([self isOverBudget] && candidate != kTNLLRUNullNodeIndex && candidate != _headIndex) {
+        const TNLLRUNodeIndex previous = _nodes[candidate].previous;
+        id<TNLLRUEntry> entry = (__bridge id<TNLLRUEntry>)_nodes[candidate].entry;
+        if (!_flags.delegateSupportsCanEvictSelector || [delegate tnl_cache:self canEvictEntry:entry]) {
+            _evictionCount++;
+            [self removeEntry:entry];
+        }
+        candidate = previous;
+    }
+    _flags.isEnforcingBudgets = NO;
+}
+
+#pragma mark Other
+
+- (void)clearAllEntries
+{
+    [self _releaseAllNodes];
+    for (TNLLRUNodeIndex i = 0; i < _capacity; i++) {
+        _nodes[i].cost = 0;
+        _nodes[i].next = (i + 1 < _capacity) ? i + 1 : kTNLLRUNullNodeIndex;
+    }
+    _freeIndex = (_capacity) ? 0 : kTNLLRUNullNodeIndex;
+    _headIndex = kTNLLRUNullNodeIndex;
+    _tailIndex = kTNLLRUNullNodeIndex;
+    _count = 0;
+    _totalCost = 0;
+    CFDictionaryRemoveAllValues(_indexes);
+    _mutationCheckInteger++;
+}
+
+- (NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state objects:(id __unsafe_unretained __nullable [__nonnull])buffer count:(NSUInteger)len
+{
+    NSUInteger count = 0;
+
+    // state->state is the index of the next node + 1, kTNLLRUNullNodeIndex + 1 ends the enumeration
+    if (!state->state && !state->extra[0]) {
+        state->mutationsPtr = (void *)&_mutationCheckInteger;
+        state->state = (unsigned long)_headIndex + 1UL;
+        state->extra[0] = 1UL;
+    }
+
+    state->itemsPtr = buffer;
+
+    for ( ; state->state != (unsigned long)kTNLLRUNullNodeIndex + 1UL && count < len; count++) {
+        const TNLLRUNodeIndex index = (TNLLRUNodeIndex)(state->state - 1UL);
+        buffer[count] = (__bridge id<TNLLRUEntry>)_nodes[index].entry;
+        state->state = (unsigned long)_nodes[index].next + 1UL;
+    }
+
+    return count; // count of 0 ends the enumeration
+}
+
+@end
+
+#pragma mark - TNLConcurrentLRUCache
+
+static const NSUInteger kConcurrentLRUCacheMaxShardCount = 64;
+
+TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
+@interface TNLConcurrentLRUCacheNode : NSObject
+{
+@package
+    id<TNLLRUEntry> _entry;
+    NSString *_identifier;
+    NSUInteger _cost;
+    NSUInteger _clockIndex;
+    atomic_bool _referenced;
+}
+@end
+
+/**
+ A shard publishes its table as an immutable snapshot that readers use without a lock.
+
+ Readers announce themselves on one of two counters (picked by the epoch parity) while they look
+ up the snapshot.  A writer swaps in a new snapshot, then flips the epoch twice, waiting for the
+ counter of the previous parity to drain each time, before the old snapshot is released.
+ New readers always land on the other counter, so the waits are bounded by in flight lookups.
+ */
+TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
+@interface TNLConcurrentLRUCacheShard : NSObject
+{
+@package
+    // read side
+    _Atomic(void *) _table; // +1 NSDictionary<NSString *, TNLConcurrentLRUCacheNode *>
+    atomic_uint _epoch;
+    atomic_uint_fast32_t _readers[2];
+    atomic_uint_fast64_t _count;
+    atomic_uint_fast64_t _totalCost;
+    atomic_uint_fast64_t _hitCount;
+    atomic_uint_fast64_t _missCount;
+    atomic_uint_fast64_t _evictionCount;
+
+    // write side, protected by _lock
+    os_unfair_lock _lock;
+    NSMutableDictionary<NSString *, TNLConcurrentLRUCacheNode *> *_mutableTable;
+    NSMutableArray<TNLConcurrentLRUCacheNode *> *_clock;
+    NSUInteger _hand;
+    NSUInteger _countLimit;
+    NSUInteger _totalCostLimit;
+}
+
+- (nullable TNLConcurrentLRUCacheNode *)nodeWithIdentifier:(NSString *)identifier;
+- (NSArray<TNLConcurrentLRUCacheNode *> *)allNodes;
+
+// the following must be called with _lock held
+- (void)locked_addNode:(TNLConcurrentLRUCacheNode *)node;
+- (void)locked_removeNode:(TNLConcurrentLRUCacheNode *)node;
+- (void)locked_enforceBudgetsWithCache:(TNLConcurrentLRUCache *)cache
+                         protectedNode:(nullable TNLConcurrentLRUCacheNode *)protectedNode
+                       evictedEntries:(NSMutableArray<id<TNLLRUEntry>> *)evictedEntries;
+- (void *)locked_publish; // returns the retired +1 snapshot, release it after unlocking
+
+@end
+
+NS_INLINE NSUInteger _ConcurrentLRUCacheShardCount(NSUInteger requestedCount)
+{
+    NSUInteger count = 1;
+    while (count < requestedCount && count < kConcurrentLRUCacheMaxShardCount) {
+        count <<= 1;
+    }
+    return count;
+}
+
+NS_INLINE NSUInteger _ConcurrentLRUCacheShardLimit(NSUInteger limit, NSUInteger shardCount)
+{
+    return (limit) ? ((limit + shardCount - 1) / shardCount) : 0;
+}
+
+static void _ConcurrentLRUCacheReleaseRetiredTable(void * __nullable table)
+{
+    if (table) {
+        CFRelease(table);
+    }
+}
+
+@implementation TNLConcurrentLRUCacheNode
+@end
+
+@implementation TNLConcurrentLRUCacheShard
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        atomic_init(&_table, (void *)CFBridgingRetain([NSDictionary dictionary]));
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _mutableTable = [[NSMutableDictionary alloc] init];
+        _clock = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    _ConcurrentLRUCacheReleaseRetiredTable(atomic_load(&_table));
+}
+
+- (nullable TNLConcurrentLRUCacheNode *)nodeWithIdentifier:(NSString *)identifier
+{
+    const unsigned int parity = atomic_load(&_epoch) & 1;
+    atomic_fetch_add(&_readers[parity], 1);
+    __unsafe_unretained NSDictionary<NSString *, TNLConcurrentLRUCacheNode *> *table = (__bridge NSDictionary *)atomic_load(&_table);
+    TNLConcurrentLRUCacheNode *node = table[identifier]; // retained while the snapshot is protected
+    atomic_fetch_sub(&_readers[parity], 1);
+    return node;
+}
+
+- (NSArray<TNLConcurrentLRUCacheNode *> *)allNodes
+{
+    const unsigned int parity = atomic_load(&_epoch) & 1;
+    atomic_fetch_add(&_readers[parity], 1);
+    NSDictionary<NSString *, TNLConcurrentLRUCacheNode *> *table = (__bridge NSDictionary *)atomic_load(&_table);
+    atomic_fetch_sub(&_readers[parity], 1);
+    return table.allValues;
+}
+
+- (void)locked_addNode:(TNLConcurrentLRUCacheNode *)node
+{
+    TNLConcurrentLRUCacheNode *existingNode = _mutableTable[node->_identifier];
+    if (existingNode) {
+        // replace in place, keeping the clock position
+        node->_clockIndex = existingNode->_clockIndex;
+        _clock[node->_clockIndex] = node;
+        atomic_fetch_sub_explicit(&_totalCost, existingNode->_cost, memory_order_relaxed);
+        atomic_store_explicit(&node->_referenced, true, memory_order_relaxed);
+    } else {
+        node->_clockIndex = _clock.count;
+        [_clock addObject:node];
+    }
+    _mutableTable[node->_identifier] = node;
+    atomic_fetch_add_explicit(&_totalCost, node->_cost, memory_order_relaxed);
+}
+
+- (void)locked_removeNode:(TNLConcurrentLRUCacheNode *)node
+{
+    TNLAssert(_clock[node->_clockIndex] == node);
+
+    // swap remove, the clock order is only an approximation anyway
+    const NSUInteger index = node->_clockIndex;
+    TNLConcurrentLRUCacheNode *lastNode = _clock.lastObject;
+    _clock[index] = lastNode;
+    lastNode->_clockIndex = index;
+    [_clock removeLastObject];
+
+    [_mutableTable removeObjectForKey:node->_identifier];
+    atomic_fetch_sub_explicit(&_totalCost, node->_cost, memory_order_relaxed);
+}
+
+- (BOOL)locked_isOverBudget
+{
+    if (_countLimit && _clock.count > _countLimit) {
+        return YES;
+    }
+    if (_totalCostLimit && atomic_load_explicit(&_totalCost, memory_order_relaxed) > _totalCostLimit) {
+        return YES;
+    }
+    return NO;
+}
+
+- (void)locked_enforceBudgetsWithCache:(TNLConcurrentLRUCache *)cache
+                         protectedNode:(nullable TNLConcurrentLRUCacheNode *)protectedNode
+                       evictedEntries:(NSMutableArray<id<TNLLRUEntry>> *)evictedEntries
+{
+    if (![self locked_isOverBudget]) {
+        return;
+    }
+
+    id<TNLConcurrentLRUCacheDelegate> delegate = cache.delegate;
+    const BOOL delegateSupportsCanEvict = [delegate respondsToSelector:@selector(tnl_concurrentCache:canEvictEntry:)];
+
+    // every node is visited at most twice: once to clear its referenced bit, once to evict it.
+    // after a full lap, referenced bits are ignored so that concurrent hits cannot starve the sweep.
+    const NSUInteger lapLength = _clock.count;
+    NSUInteger visits = 0;
+    while (visits < lapLength * 2 && _clock.count > 0 && [self locked_isOverBudget]) {
+        visits++;
+        if (_hand >= _clock.count) {
+            _hand = 0;
+        }
+
+        TNLConcurrentLRUCacheNode *node = _clock[_hand];
+        if (node == protectedNode) {
+            _hand++;
+        } else if (visits <= lapLength && atomic_exchange_explicit(&node->_referenced, false, memory_order_relaxed)) {
+            // second chance, this is where hits are (lazily) promoted
+            _hand++;
+        } else if (delegateSupportsCanEvict && ![delegate tnl_concurrentCache:cache canEvictEntry:node->_entry]) {
+            _hand++;
+        } else {
+            // the last node is swapped into _hand, so don't advance
+            [self locked_removeNode:node];
+            [evictedEntries addObject:node->_entry];
+            atomic_fetch_add_explicit(&_evictionCount, 1, memory_order_relaxed);
+        }
+    }
+}
+
+- (void *)locked_publish
+{
+    NSDictionary<NSString *, TNLConcurrentLRUCacheNode *> *table = [_mutableTable copy];
+    void *retiredTable = atomic_exchange(&_table, (void *)CFBridgingRetain(table));
+    atomic_store_explicit(&_count, table.count, memory_order_relaxed);
+
+    // wait out readers that could still be looking at the retired snapshot
+    for (int i = 0; i < 2; i++) {
+        const unsigned int parity = atomic_fetch_add(&_epoch, 1) & 1;
+        while (atomic_load(&_readers[parity]) != 0) {
+            sched_yield();
+        }
+    }
+
+    return retiredTable;
+}
+
+@end
+
+@implementation TNLConcurrentLRUCache
+{
+    NSArray<TNLConcurrentLRUCacheShard *> *_shards;
+    NSUInteger _shardMask;
+    os_unfair_lock _limitsLock;
+    NSUInteger _countLimit;
+    NSUInteger _totalCostLimit;
+}
+
+- (instancetype)init
+{
+    return [self initWithShardCount:[NSProcessInfo processInfo].activeProcessorCount * 2
+                           delegate:nil];
+}
+
+- (instancetype)initWithShardCount:(NSUInteger)shardCount
+                          delegate:(nullable id<TNLConcurrentLRUCacheDelegate>)delegate
+{
+    if (self = [super init]) {
+        _shardCount = _ConcurrentLRUCacheShardCount(shardCount);
+        _shardMask = _shardCount - 1;
+        NSMutableArray<TNLConcurrentLRUCacheShard *> *shards = [[NSMutableArray alloc] initWithCapacity:_shardCount];
+        for (NSUInteger i = 0; i < _shardCount; i++) {
+            [shards addObject:[[TNLConcurrentLRUCacheShard alloc] init]];
+        }
+        _shards = [shards copy];
+        _limitsLock = OS_UNFAIR_LOCK_INIT;
+        self.delegate = delegate;
+    }
+    return self;
+}
+
+- (TNLConcurrentLRUCacheShard *)_shardForIdentifier:(NSString *)identifier TNL_OBJC_DIRECT
+{
+    return _shards[identifier.hash & _shardMask];
+}
+
+- (void)_notifyEvictedEntries:(NSArray<id<TNLLRUEntry>> *)evictedEntries TNL_OBJC_DIRECT
+{
+    if (!evictedEntries.count) {
+        return;
+    }
+
+    id<TNLConcurrentLRUCacheDelegate> delegate = self.delegate;
+    if ([delegate respondsToSelector:@selector(tnl_concurrentCache:didEvictEntry:)]) {
+        for (id<TNLLRUEntry> entry in evictedEntries) {
+            [delegate tnl_concurrentCache:self didEvictEntry:entry];
+        }
+    }
+}
+
+#pragma mark Properties
+
+- (NSUInteger)numberOfEntries
+{
+    NSUInteger count = 0;
+    for (TNLConcurrentLRUCacheShard *shard in _shards) {
+        count += (NSUInteger)atomic_load_explicit(&shard->_count, memory_order_relaxed);
+    }
+    return count;
+}
+
+- (NSUInteger)totalCost
+{
+    NSUInteger cost = 0;
+    for (TNLConcurrentLRUCacheShard *shard in _shards) {
+        cost += (NSUInteger)atomic_load_explicit(&shard->_totalCost, memory_order_relaxed);
+    }
+    return cost;
+}
+
+- (NSUInteger)hitCount
+{
+    NSUInteger count = 0;
+    for (TNLConcurrentLRUCacheShard *shard in _shards) {
+        count += (NSUInteger)atomic_load_explicit(&shard->_hitCount, memory_order_relaxed);
+    }
+    return count;
+}
+
+- (NSUInteger)missCount
+{
+    NSUInteger count = 0;
+    for (TNLConcurrentLRUCacheShard *shard in _shards) {
+        count += (NSUInteger)atomic_load_explicit(&shard->_missCount, memory_order_relaxed);
+    }
+    return count;
+}
+
+- (NSUInteger)evictionCount
+{
+    NSUInteger count = 0;
+    for (TNLConcurrentLRUCacheShard *shard in _shards) {
+        count += (NSUInteger)atomic_load_explicit(&shard->_evictionCount, memory_order_relaxed);
+    }
+    return count;
+}
+
+- (void)resetStatistics
+{
+    for (TNLConcurrentLRUCacheShard *shard in _shards) {
+        atomic_store_explicit(&shard->_hitCount, 0, memory_order_relaxed);
+        atomic_store_explicit(&shard->_missCount, 0, memory_order_relaxed);
+        atomic_store_explicit(&shard->_evictionCount, 0, memory_order_relaxed);
+    }
+}
+
+#pragma mark Budgets
+
+- (NSArray<id<TNLLRUEntry>> *)_limitsLocked_applyLimits TNL_OBJC_DIRECT
+{
+    const NSUInteger shardCountLimit = _ConcurrentLRUCacheShardLimit(_countLimit, _shardCount);
+    const NSUInteger shardCostLimit = _ConcurrentLRUCacheShardLimit(_totalCostLimit, _shardCount);
+    NSMutableArray<id<TNLLRUEntry>> *evictedEntries = [[NSMutableArray alloc] init];
+    for (TNLConcurrentLRUCacheShard *shard in _shards) {
+        void *retiredTable = NULL;
+        os_unfair_lock_lock(&shard->_lock);
+        shard->_countLimit = shardCountLimit;
+        shard->_totalCostLimit = shardCostLimit;
+        const NSUInteger evictedCount = evictedEntries.count;
+        [shard locked_enforceBudgetsWithCache:self protectedNode:nil evictedEntries:evictedEntries];
+        if (evictedEntries.count != evictedCount) {
+            retiredTable = [shard locked_publish];
+        }
+        os_unfair_lock_unlock(&shard->_lock);
+        _ConcurrentLRUCacheReleaseRetiredTable(retiredTable);
+    }
+    return evictedEntries;
+}
+
+- (NSUInteger)countLimit
+{
+    os_unfair_lock_lock(&_limitsLock);
+    const NSUInteger limit = _countLimit;
+    os_unfair_lock_unlock(&_limitsLock);
+    return limit;
+}
+
+- (void)setCountLimit:(NSUInteger)countLimit
+{
+    os_unfair_lock_lock(&_limitsLock);
+    _countLimit = countLimit;
+    NSArray<id<TNLLRUEntry>> *evictedEntries = [self _limitsLocked_applyLimits];
+    os_unfair_lock_unlock(&_limitsLock);
+    [self _notifyEvictedEntries:evictedEntries];
+}
+
+- (NSUInteger)totalCostLimit
+{
+    os_unfair_lock_lock(&_limitsLock);
+    const NSUInteger limit = _totalCostLimit;
+    os_unfair_lock_unlock(&_limitsLock);
+    return limit;
+}
+
+- (void)setTotalCostLimit:(NSUInteger)totalCostLimit
+{
+    os_unfair_lock_lock(&_limitsLock);
+    _totalCostLimit = totalCostLimit;
+    NSArray<id<TNLLRUEntry>> *evictedEntries = [self _limitsLocked_applyLimits];
+    os_unfair_lock_unlock(&_limitsLock);
+    [self _notifyEvictedEntries:evictedEntries];
+}
+
+#pragma mark Access
+
+- (nullable id<TNLLRUEntry>)entryWithIdentifier:(NSString *)identifier
+{
+    TNLConcurrentLRUCacheShard *shard = [self _shardForIdentifier:identifier];
+    TNLConcurrentLRUCacheNode *node = [shard nodeWithIdentifier:identifier];
+    if (!node) {
+        atomic_fetch_add_explicit(&shard->_missCount, 1, memory_order_relaxed);
+        return nil;
+    }
+
+    atomic_fetch_add_explicit(&shard->_hitCount, 1, memory_order_relaxed);
+    id<TNLLRUEntry> entry = node->_entry;
+    // only write the bit when it changes to avoid bouncing the cache line between readers
+    if (!atomic_load_explicit(&node->_referenced, memory_order_relaxed) && [entry shouldAccessMoveLRUEntryToHead]) {
+        atomic_store_explicit(&node->_referenced, true, memory_order_relaxed);
+    }
+    return entry;
+}
+
+- (NSArray<id<TNLLRUEntry>> *)allEntries
+{
+    NSMutableArray<id<TNLLRUEntry>> *entries = [[NSMutableArray alloc] init];
+    for (TNLConcurrentLRUCacheShard *shard in _shards) {
+        for (TNLConcurrentLRUCacheNode *node in [shard allNodes]) {
+            [entries addObject:node->_entry];
+        }
+    }
+    return entries;
+}
+
+#pragma mark Mutation
+
+- (void)addEntry:(id<TNLLRUEntry>)entry
+{
+    NSString *identifier = entry.LRUEntryIdentifier;
+    TNLAssert(identifier != nil);
+    if (!identifier) {
+        return;
+    }
+
+    TNLConcurrentLRUCacheNode *node = [[TNLConcurrentLRUCacheNode alloc] init];
+    node->_entry = entry;
+    node->_identifier = [identifier copy];
+    node->_cost = [entry respondsToSelector:@selector(LRUEntryCost)] ? entry.LRUEntryCost : 0;
+
+    TNLConcurrentLRUCacheShard *shard = [self _shardForIdentifier:identifier];
+    NSMutableArray<id<TNLLRUEntry>> *evictedEntries = [[NSMutableArray alloc] init];
+    os_unfair_lock_lock(&shard->_lock);
+    [shard locked_addNode:node];
+    [shard locked_enforceBudgetsWithCache:self protectedNode:node evictedEntries:evictedEntries];
+    void *retiredTable = [shard locked_publish];
+    os_unfair_lock_unlock(&shard->_lock);
+
+    _ConcurrentLRUCacheReleaseRetiredTable(retiredTable);
+    [self _notifyEvictedEntries:evictedEntries];
+}
+
+- (void)updateCostOfEntry:(id<TNLLRUEntry>)entry
+{
+    NSString *identifier = entry.LRUEntryIdentifier;
+    TNLAssert(identifier != nil);
+    if (!identifier) {
+        return;
+    }
+
+    const NSUInteger cost = [entry respondsToSelector:@selector(LRUEntryCost)] ? entry.LRUEntryCost : 0;
+    TNLConcurrentLRUCacheShard *shard = [self _shardForIdentifier:identifier];
+    NSMutableArray<id<TNLLRUEntry>> *evictedEntries = [[NSMutableArray alloc] init];
+    void *retiredTable = NULL;
+    os_unfair_lock_lock(&shard->_lock);
+    TNLConcurrentLRUCacheNode *node = shard->_mutableTable[identifier];
+    if (node && node->_entry == entry && node->_cost != cost) {
+        // the referenced bit is left alone, a cost change is not an access
+        atomic_fetch_sub_explicit(&shard->_totalCost, node->_cost, memory_order_relaxed);
+        node->_cost = cost;
+        atomic_fetch_add_explicit(&shard->_totalCost, cost, memory_order_relaxed);
+        [shard locked_enforceBudgetsWithCache:self protectedNode:nil evictedEntries:evictedEntries];
+        if (evictedEntries.count > 0) {
+            retiredTable = [shard locked_publish];
+        }
+    }
+    os_unfair_lock_unlock(&shard->_lock);
+
+    _ConcurrentLRUCacheReleaseRetiredTable(retiredTable);
+    [self _notifyEvictedEntries:evictedEntries];
+}
+
+- (void)removeEntry:(id<TNLLRUEntry>)entry
+{
+    NSString *identifier = entry.LRUEntryIdentifier;
+    if (!identifier) {
+        return;
+    }
+
+    TNLConcurrentLRUCacheShard *shard = [self _shardForIdentifier:identifier];
+    void *retiredTable = NULL;
+    os_unfair_lock_lock(&shard->_lock);
+    TNLConcurrentLRUCacheNode *node = shard->_mutableTable[identifier];
+    if (node && node->_entry == entry) {
+        [shard locked_removeNode:node];
+        retiredTable = [shard locked_publish];
+    } else {
+        node = nil;
+    }
+    os_unfair_lock_unlock(&shard->_lock);
+
+    _ConcurrentLRUCacheReleaseRetiredTable(retiredTable);
+    if (node) {
+        [self _notifyEvictedEntries:@[entry]];
+    }
+}
+
+- (void)clearAllEntries
+{
+    for (TNLConcurrentLRUCacheShard *shard in _shards) {
+        os_unfair_lock_lock(&shard->_lock);
+        [shard->_mutableTable removeAllObjects];
+        [shard->_clock removeAllObjects];
+        shard->_hand = 0;
+        atomic_store_explicit(&shard->_totalCost, 0, memory_order_relaxed);
+        void *retiredTable = [shard locked_publish];
+        os_unfair_lock_unlock(&shard->_lock);
+        _ConcurrentLRUCacheReleaseRetiredTable(retiredTable);
+    }
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
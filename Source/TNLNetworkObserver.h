@@ -47,7 +47,7 @@ NS_ASSUME_NONNULL_BEGIN
 
  @param op The source `TNLRequestOperation` for the attempt
  @param response The intermediate `TNLResponse` for the attempt
- @param disposition The disposition of the _response_ (`Completing`, `Redirecting` or `Retrying`)
+ @param disposition The disposition of the _response_ (`Completing`, `Redirecting`, `Retrying` or `Hedged`)
  */
 - (void)tnl_requestOperation:(TNLRequestOperation *)op
         didCompleteAttemptWithIntermediateResponse:(TNLResponse *)response
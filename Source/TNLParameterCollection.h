@@ -150,6 +150,10 @@ typedef NS_ENUM(NSInteger, TNLParameterCollectionAddParametersFromDictionaryMode
 /**
  init with parameters parsed from the provided _URL_ given the provided _options_.
  Filter what parameter type(s) to parse with the provided _types_.
+ @note Parsing is lazy for `TNLParameterCollection` (unless `TNLURLDecodingOptionCombineRepeatingKeysIntoArray` is provided).
+ The encoded parameters are only indexed, `parameterValueForKey:` decodes just the value it returns and
+ the collection is fully parsed the first time it is enumerated, counted, encoded or copied mutably.
+ The same applies to `initWithURLEncodedString:options:`.
  */
 - (instancetype)initWithURL:(nullable NSURL *)URL
       parsingParameterTypes:(TNLParameterTypes)types
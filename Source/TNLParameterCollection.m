@@ -6,6 +6,8 @@
 //  Copyright © 2020 Twitter. All rights reserved.
 //
 
+#include <os/lock.h>
+
 #import "TNL_Project.h"
 #import "TNLParameterCollection.h"
 #import "TNLURLCoding.h"
@@ -16,12 +18,27 @@ NSString * const kParametersCodingKey = @"parameters";
 
 typedef NSString *(^TNLParameterCollectionUpdateKeysAndValuesIterativeKeyBlock)(NSString *key, id obj);
 
+// A key/value pair of the raw encoded parameters of a lazily parsed collection
+typedef struct _TNLEncodedParameterEntry {
+    size_t keyOffset;
+    size_t keyLength;
+    size_t valueOffset;
+    size_t valueLength;
+    BOOL keyNeedsDecoding;
+} _TNLEncodedParameterEntry;
+
+static NSArray<NSString *> *_EncodedParameterStringsFromURL(NSURL * __nullable URL,
+                                                            TNLParameterTypes types);
+
 TNL_OBJC_DIRECT_MEMBERS
 @interface TNLParameterCollection ()
 
 @property (nonatomic, readonly) NSDictionary *parameters;
 
 - (instancetype)initWithDirectlyAssignedDictionary:(nullable NSDictionary<NSString *, id> *)dict;
+- (instancetype)initWithEncodedParameterStrings:(NSArray<NSString *> *)encodedStrings
+                                        options:(TNLURLDecodingOptions)options;
+- (nullable id)_lazy_parameterValueForKey:(NSString *)key;
 
 @end
 
@@ -30,15 +47,29 @@ TNL_OBJC_DIRECT_MEMBERS
 {
     @protected
     NSDictionary<NSString *, id> *_parameters;
-}
 
-@synthesize parameters = _parameters;
+    // Lazy parsing (immutable collections parsed from a URL or URL encoded string)
+    // The raw encoded parameters are kept as a byte span with an index of the pairs.
+    // Lookups decode only the value they need, anything else materializes `_parameters` once.
+    NSArray<NSString *> *_lazyEncodedStrings;
+    id _lazyByteStorage; // owns `_lazyBytes`
+    const char *_lazyBytes;
+    _TNLEncodedParameterEntry *_lazyEntries;
+    size_t _lazyEntryCount;
+    TNLURLDecodingOptions _lazyOptions;
+    os_unfair_lock _lazyLock;
+}
 
 - (instancetype)init
 {
     return [super init];
 }
 
+- (void)dealloc
+{
+    free(_lazyEntries);
+}
+
 - (instancetype)initWithDirectlyAssignedDictionary:(nullable NSDictionary<NSString *, id> *)dict
 {
     if (self = [self init]) {
@@ -55,9 +86,8 @@ TNL_OBJC_DIRECT_MEMBERS
 - (instancetype)initWithURLEncodedString:(nullable NSString *)params
                                  options:(TNLURLDecodingOptions)options
 {
-    TNLMutableParameterCollection *mCollection = [[TNLMutableParameterCollection alloc] initWithURLEncodedString:params
-                                                                                                         options:options];
-    return [self initWithParameterCollection:mCollection];
+    return [self initWithEncodedParameterStrings:(params) ? @[params] : @[]
+                                         options:options];
 }
 
 - (instancetype)initWithDictionary:(nullable NSDictionary<NSString *, id> *)dictionary
@@ -78,10 +108,92 @@ TNL_OBJC_DIRECT_MEMBERS
       parsingParameterTypes:(TNLParameterTypes)types
                     options:(TNLURLDecodingOptions)options
 {
-    TNLMutableParameterCollection *mCollection = [[TNLMutableParameterCollection alloc] initWithURL:URL
-                                                                              parsingParameterTypes:types
-                                                                                            options:options];
-    return [self initWithParameterCollection:mCollection];
+    return [self initWithEncodedParameterStrings:_EncodedParameterStringsFromURL(URL, types)
+                                         options:options];
+}
+
+- (instancetype)initWithEncodedParameterStrings:(NSArray<NSString *> *)encodedStrings
+                                        options:(TNLURLDecodingOptions)options
+{
+    NSString *joinedString = (encodedStrings.count > 1) ? [encodedStrings componentsJoinedByString:@"&"] : encodedStrings.firstObject;
+
+    // Keep the bytes without copying when the string is backed by them (the common case for URLs)
+    id byteStorage = joinedString;
+    const char *bytes = (joinedString) ? CFStringGetCStringPtr((__bridge CFStringRef)joinedString, kCFStringEncodingUTF8) : NULL;
+    size_t length = (bytes) ? strlen(bytes) : 0;
+    if (!bytes && joinedString.length) {
+        NSData *data = [joinedString dataUsingEncoding:NSUTF8StringEncoding];
+        byteStorage = data;
+        bytes = data.bytes;
+        length = data.length;
+    }
+
+    // Combining needs every occurrence of a key and strings that are not UTF-8 need special handling,
+    // parse those eagerly
+    if (!bytes || TNL_BITMASK_HAS_SUBSET_FLAGS(options, TNLURLDecodingOptionCombineRepeatingKeysIntoArray)) {
+        TNLMutableParameterCollection *mCollection = [[TNLMutableParameterCollection alloc] init];
+        for (NSString *encodedString in encodedStrings) {
+            [mCollection addParametersWithURLEncodedString:encodedString options:options];
+        }
+        return [self initWithParameterCollection:mCollection];
+    }
+
+    if (self = [self init]) {
+        // Index the pairs (the same splitting as `TNLURLDecodeDictionary`), nothing is decoded yet
+        const BOOL replacePlusses = TNL_BITMASK_EXCLUDES_FLAGS(options, TNLURLDecodingOptionPreservePlusses);
+        size_t entryCapacity = 8;
+        _lazyEntries = malloc(entryCapacity * sizeof(_TNLEncodedParameterEntry));
+        size_t pairStart = 0;
+        while (pairStart < length && _lazyEntries) {
+            const char *pairEnd = memchr(bytes + pairStart, '&', length - pairStart);
+            const size_t pairLength = (pairEnd) ? (size_t)(pairEnd - (bytes + pairStart)) : (length - pairStart);
+            const char *delimiter = memchr(bytes + pairStart, '=', pairLength);
+            const size_t keyLength = (delimiter) ? (size_t)(delimiter - (bytes + pairStart)) : pairLength;
+            if (keyLength > 0) {
+                if (_lazyEntryCount == entryCapacity) {
+                    entryCapacity *= 2;
+                    _TNLEncodedParameterEntry *entries = realloc(_lazyEntries, entryCapacity * sizeof(_TNLEncodedParameterEntry));
+                    if (!entries) {
+                        free(_lazyEntries);
+                    }
+                    _lazyEntries = entries;
+                    if (!_lazyEntries) {
+                        break;
+                    }
+                }
+
+                _TNLEncodedParameterEntry *entry = &_lazyEntries[_lazyEntryCount++];
+                entry->keyOffset = pairStart;
+                entry->keyLength = keyLength;
+                entry->valueOffset = pairStart + keyLength + ((delimiter) ? 1 : 0);
+                entry->valueLength = pairLength - keyLength - ((delimiter) ? 1 : 0);
+                entry->keyNeedsDecoding = (NULL != memchr(bytes + pairStart, '%', keyLength)) || (replacePlusses && NULL != memchr(bytes + pairStart, '+', keyLength));
+            }
+            pairStart += pairLength + 1;
+        }
+
+        if (!_lazyEntries) {
+            TNLLogError(@"Out of memory, parsing parameters eagerly");
+            _lazyEntryCount = 0;
+            TNLMutableParameterCollection *mCollection = [[TNLMutableParameterCollection alloc] init];
+            for (NSString *encodedString in encodedStrings) {
+                [mCollection addParametersWithURLEncodedString:encodedString options:options];
+            }
+            _parameters = [mCollection.parameters copy];
+        } else if (!_lazyEntryCount) {
+            // nothing to parse
+            free(_lazyEntries);
+            _lazyEntries = NULL;
+            _parameters = @{};
+        } else {
+            _lazyEncodedStrings = [encodedStrings copy];
+            _lazyByteStorage = byteStorage;
+            _lazyBytes = bytes;
+            _lazyOptions = options;
+            _lazyLock = OS_UNFAIR_LOCK_INIT;
+        }
+    }
+    return self;
 }
 
 - (instancetype)initWithParameterCollection:(nullable TNLParameterCollection *)otherCollection
@@ -92,6 +204,77 @@ TNL_OBJC_DIRECT_MEMBERS
     return self;
 }
 
+#pragma mark Lazy Parsing
+
+- (NSDictionary *)parameters
+{
+    if (!_lazyEntries) {
+        return _parameters;
+    }
+
+    NSDictionary *parameters;
+    os_unfair_lock_lock(&_lazyLock);
+    if (!_parameters) {
+        // materialize exactly as an eager parse would have
+        TNLMutableParameterCollection *mCollection = [[TNLMutableParameterCollection alloc] init];
+        for (NSString *encodedString in _lazyEncodedStrings) {
+            [mCollection addParametersWithURLEncodedString:encodedString options:_lazyOptions];
+        }
+        _parameters = [mCollection.parameters copy];
+    }
+    parameters = _parameters;
+    os_unfair_lock_unlock(&_lazyLock);
+    return parameters;
+}
+
+- (nullable id)_lazy_parameterValueForKey:(NSString *)key
+{
+    if (![key isKindOfClass:[NSString class]]) {
+        return nil;
+    }
+
+    const char *keyBytes = CFStringGetCStringPtr((__bridge CFStringRef)key, kCFStringEncodingUTF8) ?: key.UTF8String;
+    if (!keyBytes) {
+        return nil;
+    }
+    const size_t keyLength = strlen(keyBytes);
+
+    const BOOL replacePlusses = TNL_BITMASK_EXCLUDES_FLAGS(_lazyOptions, TNLURLDecodingOptionPreservePlusses);
+    const BOOL preserveEmptyValues = TNL_BITMASK_EXCLUDES_FLAGS(_lazyOptions, TNLURLDecodingOptionOmitEmptyValues);
+
+    // the last valid occurrence of a key wins
+    for (size_t i = _lazyEntryCount; i > 0; i--) {
+        const _TNLEncodedParameterEntry *entry = &_lazyEntries[i - 1];
+        if (entry->keyNeedsDecoding) {
+            NSString *encodedKey = [[NSString alloc] initWithBytes:_lazyBytes + entry->keyOffset
+                                                            length:entry->keyLength
+                                                          encoding:NSUTF8StringEncoding];
+            if (![TNLURLDecodeString(encodedKey, replacePlusses) isEqualToString:key]) {
+                continue;
+            }
+        } else if (entry->keyLength != keyLength || 0 != memcmp(_lazyBytes + entry->keyOffset, keyBytes, keyLength)) {
+            continue;
+        }
+
+        if (!entry->valueLength) {
+            if (preserveEmptyValues) {
+                return @"";
+            }
+            continue;
+        }
+
+        NSString *encodedValue = [[NSString alloc] initWithBytes:_lazyBytes + entry->valueOffset
+                                                          length:entry->valueLength
+                                                        encoding:NSUTF8StringEncoding];
+        NSString *value = TNLURLDecodeString(encodedValue, replacePlusses);
+        if (value) {
+            return value;
+        }
+    }
+
+    return nil;
+}
+
 #pragma mark NSCopying
 
 - (id)copyWithZone:(nullable NSZone *)zone
@@ -110,7 +293,7 @@ TNL_OBJC_DIRECT_MEMBERS
 
 - (NSUInteger)count
 {
-    return _parameters.count;
+    return self.parameters.count;
 }
 
 #pragma mark NSSecureCoding
@@ -129,7 +312,7 @@ TNL_OBJC_DIRECT_MEMBERS
 
 - (void)encodeWithCoder:(NSCoder *)aCoder
 {
-    [aCoder encodeObject:_parameters forKey:kParametersCodingKey];
+    [aCoder encodeObject:self.parameters forKey:kParametersCodingKey];
 }
 
 #pragma mark NSFastEnumeration
@@ -138,7 +321,7 @@ TNL_OBJC_DIRECT_MEMBERS
                                   objects:(id __unsafe_unretained __nullable [__nonnull])buffer
                                     count:(NSUInteger)len
 {
-    return [_parameters countByEnumeratingWithState:state objects:buffer count:len];
+    return [self.parameters countByEnumeratingWithState:state objects:buffer count:len];
 }
 
 #pragma mark Keyed Subscripting
@@ -152,6 +335,13 @@ TNL_OBJC_DIRECT_MEMBERS
 
 - (nullable id)parameterValueForKey:(NSString *)key
 {
+    if (_lazyEntries) {
+        os_unfair_lock_lock(&_lazyLock);
+        NSDictionary *parameters = _parameters;
+        os_unfair_lock_unlock(&_lazyLock);
+        return (parameters) ? parameters[key] : [self _lazy_parameterValueForKey:key];
+    }
+
     return _parameters[key];
 }
 
@@ -159,18 +349,18 @@ TNL_OBJC_DIRECT_MEMBERS
 
 - (NSArray *)allKeys
 {
-    return _parameters.allKeys;
+    return self.parameters.allKeys;
 }
 
 - (void)enumerateParameterKeysAndValuesUsingBlock:(void (^)(NSString *, id, BOOL *))block
 {
-    [_parameters enumerateKeysAndObjectsUsingBlock:block];
+    [self.parameters enumerateKeysAndObjectsUsingBlock:block];
 }
 
 - (void)enumerateParameterKeysAndValuesWithOptions:(NSEnumerationOptions)opts
                                         usingBlock:(void (^)(NSString *, id, BOOL *))block
 {
-    [_parameters enumerateKeysAndObjectsWithOptions:opts usingBlock:block];
+    [self.parameters enumerateKeysAndObjectsWithOptions:opts usingBlock:block];
 }
 
 #pragma mark URL Params
@@ -187,7 +377,7 @@ TNL_OBJC_DIRECT_MEMBERS
 
 - (NSDictionary<NSString *, id> *)underlyingDictionaryValue
 {
-    return [_parameters copy];
+    return [self.parameters copy];
 }
 
 - (NSDictionary<NSString *, id> *)encodableDictionaryValue
@@ -199,7 +389,7 @@ TNL_OBJC_DIRECT_MEMBERS
 
 - (NSDictionary<NSString *, id> *)encodableDictionaryValueWithOptions:(TNLURLEncodableDictionaryOptions)options
 {
-    return TNLURLEncodableDictionary(_parameters, options);
+    return TNLURLEncodableDictionary(self.parameters, options);
 }
 
 + (NSString *)stringByCombiningParameterString:(nullable TNLParameterCollection *)parameterStringCollection
@@ -244,7 +434,7 @@ TNL_OBJC_DIRECT_MEMBERS
 
 - (NSString *)URLEncodedStringValueWithOptions:(TNLURLEncodingOptions)options
 {
-    return TNLURLEncodeDictionary(_parameters, options);
+    return TNLURLEncodeDictionary(self.parameters, options);
 }
 
 #pragma mark Description
@@ -258,7 +448,7 @@ TNL_OBJC_DIRECT_MEMBERS
 
 - (NSUInteger)hash
 {
-    return _parameters.hash;
+    return self.parameters.hash;
 }
 
 - (BOOL)isEqual:(id)object
@@ -268,7 +458,7 @@ TNL_OBJC_DIRECT_MEMBERS
     }
 
     if ([object isKindOfClass:[TNLParameterCollection class]]) {
-        return [_parameters isEqualToDictionary:((TNLParameterCollection *)object)->_parameters];
+        return [self.parameters isEqualToDictionary:((TNLParameterCollection *)object).parameters];
     }
 
     return NO;
@@ -366,30 +556,8 @@ TNL_OBJC_DIRECT_MEMBERS
        parsingParameterTypes:(TNLParameterTypes)types
                      options:(TNLURLDecodingOptions)options
 {
-    if (TNL_BITMASK_HAS_SUBSET_FLAGS(types, TNLParameterTypeURLParameterString)) {
-        NSString *parameterString;
-        if (tnl_available_ios_13) {
-            // parameter string is no longer considered valid according to Apple, which is wise
-            // ... but we'll still support parsing it
-            NSString *path = URL.path;
-            if (path) {
-                NSRange range = [path rangeOfString:@";"];
-                if (range.location != NSNotFound) {
-                    parameterString = [path substringFromIndex:range.location + 1];
-                }
-            }
-#if !TARGET_OS_MACCATALYST
-        } else {
-            parameterString = URL.parameterString;
-#endif
-        }
-        [self addParametersWithURLEncodedString:parameterString options:options];
-    }
-    if (TNL_BITMASK_HAS_SUBSET_FLAGS(types, TNLParameterTypeURLQuery)) {
-        [self addParametersWithURLEncodedString:URL.query options:options];
-    }
-    if (TNL_BITMASK_HAS_SUBSET_FLAGS(types, TNLParameterTypeURLFragment)) {
-        [self addParametersWithURLEncodedString:URL.fragment options:options];
+    for (NSString *encodedString in _EncodedParameterStringsFromURL(URL, types)) {
+        [self addParametersWithURLEncodedString:encodedString options:options];
     }
 }
 
@@ -560,6 +728,46 @@ TNL_OBJC_DIRECT_MEMBERS
 
 @end
 
+static NSArray<NSString *> *_EncodedParameterStringsFromURL(NSURL * __nullable URL,
+                                                            TNLParameterTypes types)
+{
+    NSMutableArray<NSString *> *encodedStrings = [[NSMutableArray alloc] initWithCapacity:3];
+    if (TNL_BITMASK_HAS_SUBSET_FLAGS(types, TNLParameterTypeURLParameterString)) {
+        NSString *parameterString;
+        if (tnl_available_ios_13) {
+            // parameter string is no longer considered valid according to Apple, which is wise
+            // ... but we'll still support parsing it
+            NSString *path = URL.path;
+            if (path) {
+                NSRange range = [path rangeOfString:@";"];
+                if (range.location != NSNotFound) {
+                    parameterString = [path substringFromIndex:range.location + 1];
+                }
+            }
+#if !TARGET_OS_MACCATALYST
+        } else {
+            parameterString = URL.parameterString;
+#endif
+        }
+        if (parameterString) {
+            [encodedStrings addObject:parameterString];
+        }
+    }
+    if (TNL_BITMASK_HAS_SUBSET_FLAGS(types, TNLParameterTypeURLQuery)) {
+        NSString *query = URL.query;
+        if (query) {
+            [encodedStrings addObject:query];
+        }
+    }
+    if (TNL_BITMASK_HAS_SUBSET_FLAGS(types, TNLParameterTypeURLFragment)) {
+        NSString *fragment = URL.fragment;
+        if (fragment) {
+            [encodedStrings addObject:fragment];
+        }
+    }
+    return encodedStrings;
+}
+
 @implementation NSURL (Parameters)
 
 - (TNLParameterCollection *)tnl_parameterStringCollection
@@ -6,13 +6,14 @@
 //  Copyright © 2020 Twitter. All rights reserved.
 //
 
-#import <Foundation/Foundation.h>
+#import <TwitterNetworkLayer/TNLNetworkObserver.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
 FOUNDATION_EXTERN NSString * const TNLPseudoURLProtocolErrorDomain;
 
 @class TNLPseudoURLResponseConfig;
+@class TNLResponse;
 
 /**
  TNLPseudoURLProtocol
@@ -22,6 +23,11 @@ FOUNDATION_EXTERN NSString * const TNLPseudoURLProtocolErrorDomain;
  Set up by registering an origin with a given `NSHTTPURLResponse`, `TNLPseudoURLResponseConfig` (optional)
  and `NSData` (optional).  The protocol will kick in whenever a request matching the registered
  origin is requested (as long as the protocol has been registered appropriately).
+
+ Endpoints can also be registered by URL prefix or regular expression, which together with
+ randomized latency, a shared bandwidth pool and failure injection (see `TNLPseudoURLResponseConfig`)
+ can be used to generate load that behaves like a congested network.
+ Lookup order is: exact endpoint, then the longest matching prefix, then patterns in registration order.
  */
 @interface TNLPseudoURLProtocol : NSURLProtocol
 
@@ -45,22 +51,93 @@ FOUNDATION_EXTERN NSString * const TNLPseudoURLProtocolErrorDomain;
                        body:(nullable NSData *)body
                withEndpoint:(NSURL *)endpoint;
 
+/**
+ Register a response for every URL that starts with _endpointPrefix_ (compared case insensitively).
+ The response's URL is replaced with the requested URL.
+
+ @param response        the HTTP Response to use when a matching URL is encountered
+ @param body            the body (or `nil`) to use when a matching URL is encountered
+ @param config          the config to use for customizing the response behavior
+ @param endpointPrefix  the prefix of the URLs to handle
+ */
++ (void)registerURLResponse:(NSHTTPURLResponse *)response
+                       body:(nullable NSData *)body
+                     config:(nullable TNLPseudoURLResponseConfig *)config
+         withEndpointPrefix:(NSURL *)endpointPrefix;
+
+/**
+ Register a response for every URL that matches _endpointPattern_.
+ The pattern is matched against the lowercased absolute URL string.
+ The response's URL is replaced with the requested URL.
+
+ @param response        the HTTP Response to use when a matching URL is encountered
+ @param body            the body (or `nil`) to use when a matching URL is encountered
+ @param config          the config to use for customizing the response behavior
+ @param endpointPattern the regular expression of the URLs to handle
+ */
++ (void)registerURLResponse:(NSHTTPURLResponse *)response
+                       body:(nullable NSData *)body
+                     config:(nullable TNLPseudoURLResponseConfig *)config
+        withEndpointPattern:(NSRegularExpression *)endpointPattern;
+
 /**
  Unregister an endpoint.  __See Also__ `registerURLResponse:body:withEndpoint:`
  */
 + (void)unregisterEndpoint:(NSURL *)endpoint;
 
 /**
- Unregisert all endpoints.
+ Unregister an endpoint prefix.  __See Also__ `registerURLResponse:body:config:withEndpointPrefix:`
+ */
++ (void)unregisterEndpointPrefix:(NSURL *)endpointPrefix;
+
+/**
+ Unregister an endpoint pattern.  __See Also__ `registerURLResponse:body:config:withEndpointPattern:`
+ */
++ (void)unregisterEndpointPattern:(NSRegularExpression *)endpointPattern;
+
+/**
+ Unregisert all endpoints (including prefixes and patterns).
  */
 + (void)unregisterAllEndpoints;
 
+/**
+ Bits per second shared by all concurrent pseudo loads, like a single congested link.
+ Each load still honors its own `[TNLPseudoURLResponseConfig bps]`.
+ `0` == no shared limit (default)
+ */
+@property (class, atomic) uint64_t sharedBandwidthPoolBPS;
+
 /**
  Check if an endpoint is registered.
  Goes through synchronization, so after this returns the _endpoint_ could async end up [un]registered.
  */
 + (BOOL)isEndpointRegistered:(NSURL *)endpoint;
 
+/**
+ Register a recorded `TNLResponse` to be replayed.
+
+ The endpoint is the URL of the response's first attempt and the body is `[TNLResponseInfo data]`.
+ The time to first byte and the download bandwidth of the final attempt (from `TNLAttemptMetrics`)
+ are replayed as the `delay` and `bps` of the response.
+ Responses without an `NSHTTPURLResponse` (such as failures) are ignored.
+ If the same endpoint is recorded more than once, the last response wins.
+
+ @param response the recorded `TNLResponse` to replay
+ @return `YES` if the _response_ was registered
+ */
++ (BOOL)registerRecordedResponse:(TNLResponse *)response;
+
+/**
+ Register all the responses archived by a `TNLPseudoURLTrafficRecorder`.
+ __See Also__ `registerRecordedResponse:`
+
+ @param archiveFilePath the path of the archive
+ @param error           the error if the archive could not be read
+ @return the number of registered responses, `0` on error
+ */
++ (NSUInteger)registerRecordedResponsesWithArchiveFilePath:(NSString *)archiveFilePath
+                                                     error:(out NSError * __nullable * __nullable)error;
+
 @end
 
 //! Behavior for how the pseudo protocol should handle an observed redirect
@@ -73,6 +150,16 @@ typedef NS_ENUM(NSUInteger, TNLPseudoURLProtocolRedirectBehavior) {
     TNLPseudoURLProtocolRedirectBehaviorFollowLocationIfRedirectResponseIsRegistered = 2,
 };
 
+//! How the latency of a pseudo response is randomized
+typedef NS_ENUM(NSInteger, TNLPseudoURLLatencyDistribution) {
+    /** Always use `latency` */
+    TNLPseudoURLLatencyDistributionFixed = 0,
+    /** Normal distribution with a mean of `latency` and a standard deviation of `latencyDeviation` (clamped at `0`) */
+    TNLPseudoURLLatencyDistributionNormal = 1,
+    /** Log-normal (long tail) distribution with a mean of `latency` and a standard deviation of `latencyDeviation` */
+    TNLPseudoURLLatencyDistributionLongTail = 2,
+};
+
 /**
  The configuration for how the response should behave when registering a pseudo-URLResponse with
  `TNLPseudoURLProtocol`
@@ -89,6 +176,15 @@ typedef NS_ENUM(NSUInteger, TNLPseudoURLProtocolRedirectBehavior) {
  (time between each response chunk of data)
  */
 @property (nonatomic) uint64_t latency;
+/**
+ How `latency` is randomized, sampled for the response and for every gap between chunks.
+ `TNLPseudoURLLatencyDistributionFixed` == default
+ */
+@property (nonatomic) TNLPseudoURLLatencyDistribution latencyDistribution;
+/**
+ milliseconds of standard deviation for the `latencyDistribution`
+ */
+@property (nonatomic) uint64_t latencyDeviation;
 /**
  milliseconds of delay
  (time before response chunks of data start being "received")
@@ -97,8 +193,21 @@ typedef NS_ENUM(NSUInteger, TNLPseudoURLProtocolRedirectBehavior) {
 /**
  the error to simulate as a failure
  `nil` == no error
+ When `failureRate` is `0`, a non-`nil` error always fails the load.
  */
 @property (nonatomic, nullable) NSError *failureError;
+/**
+ probability (`0.0` to `1.0`) of injecting a failure for each load.
+ An injected failure responds with `failureStatusCode` when it is non-zero, otherwise it fails with
+ `failureError` (or `NSURLErrorNetworkConnectionLost` when `failureError` is `nil`).
+ `0.0` == default
+ */
+@property (nonatomic) double failureRate;
+/**
+ The HTTP status code (such as `503`) to respond with, with no body, for injected failures.
+ `0` == fail with an error instead
+ */
+@property (nonatomic) NSInteger failureStatusCode;
 /**
  The HTTP status code to override with
  `0` == don't override the status code
@@ -130,5 +239,39 @@ typedef NS_ENUM(NSUInteger, TNLPseudoURLProtocolRedirectBehavior) {
 
 @end
 
+/**
+ TNLPseudoURLTrafficRecorder
+
+ A `TNLNetworkObserver` that records every completed `TNLResponse` with an HTTP response,
+ including the request, response headers, body and `TNLResponseMetrics` timings.
+ Save the recording to an archive and replay it in tests with
+ `[TNLPseudoURLProtocol registerRecordedResponsesWithArchiveFilePath:error:]`.
+
+ Add the recorder to `[TNLGlobalConfiguration addNetworkObserver:]` (or to
+ `[TNLRequestOperationQueue networkObserver]`) to start recording.
+ */
+@interface TNLPseudoURLTrafficRecorder : NSObject <TNLNetworkObserver>
+
+/** The path that `saveArchive:` writes to */
+@property (nonatomic, copy, readonly) NSString *archiveFilePath;
+/** The number of responses recorded so far */
+@property (nonatomic, readonly) NSUInteger recordedResponseCount;
+
+/** Designated initializer */
+- (instancetype)initWithArchiveFilePath:(NSString *)archiveFilePath NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+/**
+ Write all the responses recorded so far to `archiveFilePath`, replacing any previous archive.
+
+ @param error the error if the archive could not be written
+ @return `YES` on success
+ */
+- (BOOL)saveArchive:(out NSError * __nullable * __nullable)error;
+
+@end
+
 NS_ASSUME_NONNULL_END
 
@@ -6,10 +6,16 @@
 //  Copyright © 2020 Twitter. All rights reserved.
 //
 
+#include <os/lock.h>
+
 #import "NSData+TNLAdditions.h"
 #import "NSDictionary+TNLAdditions.h"
 #import "TNL_Project.h"
+#import "TNLAttemptMetaData.h"
+#import "TNLAttemptMetrics.h"
 #import "TNLPseudoURLProtocol.h"
+#import "TNLResponse.h"
+#import "TNLTiming.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -22,16 +28,64 @@ do { \
 
 NSString * const TNLPseudoURLProtocolErrorDomain = @"TNLPseudoURLProtocolErrorDomain";
 
-static NSMutableDictionary *sOriginToResponseDictionary;
+static NSString * const kConfigUserInfoKey = @"config";
+static NSString * const kMatchesMultipleURLsUserInfoKey = @"matchesMultipleURLs";
+
+// the minimum gap between chunks of data and the burst size of the shared bandwidth pool
+static const NSTimeInterval kMinimumChunkLatency = 0.25;
+
+@interface TNLPseudoURLPatternEndpoint : NSObject
+@property (nonatomic, readonly) NSRegularExpression *pattern;
+@property (nonatomic, readonly) NSCachedURLResponse *response;
+- (instancetype)initWithPattern:(NSRegularExpression *)pattern response:(NSCachedURLResponse *)response;
+@end
+
+// The pseudo chunk scheduler is a single timer wheel that paces the chunk delivery of all pseudo loads.
+// Fires are at most one tick plus the timer leeway late, and loads only pay for a dispatch_async when due.
+static const NSTimeInterval kChunkSchedulerTickInterval = 0.005;
+static const NSTimeInterval kChunkSchedulerTimerLeeway = 0.001;
+static const NSUInteger kChunkSchedulerSlotCount = 512; // 2.56 seconds per rotation
+
+TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
+@interface TNLPseudoURLChunkScheduler : NSObject
++ (instancetype)sharedInstance;
+- (void)scheduleBlock:(dispatch_block_t)block
+              onQueue:(dispatch_queue_t)queue
+           afterDelay:(NSTimeInterval)delay;
+@end
+
+@interface TNLPseudoURLChunkScheduler (Scheduler)
+- (uint64_t)_scheduler_tickForMachTime:(uint64_t)machTime;
+- (void)_scheduler_advance;
+@end
+
+static NSMutableDictionary<NSString *, NSCachedURLResponse *> *sOriginToResponseDictionary;
+static NSMutableDictionary<NSString *, NSCachedURLResponse *> *sPrefixToResponseDictionary;
+static NSMutableArray<TNLPseudoURLPatternEndpoint *> *sPatternEndpoints;
 static dispatch_queue_t sOriginQueue;
 
+static os_unfair_lock sBandwidthPoolLock = OS_UNFAIR_LOCK_INIT;
+static uint64_t sBandwidthPoolBPS = 0;
+static double sBandwidthPoolAvailableBytes = 0;
+static uint64_t sBandwidthPoolRefillMachTime = 0;
+
 static NSString * __nullable _UnderlyingURLString(NSURL * __nullable url);
+static NSCachedURLResponse *_CachedResponse(NSHTTPURLResponse *response,
+                                            NSData * __nullable body,
+                                            TNLPseudoURLResponseConfig * __nullable config,
+                                            BOOL matchesMultipleURLs);
+static NSCachedURLResponse * __nullable _sync_ResponseForURLString(NSString *url);
 static NSHTTPURLResponse * _UpdateResponse(NSHTTPURLResponse *response,
+                                           NSURL *URL,
                                            NSUInteger contentLength,
                                            NSInteger statusCode);
 static NSRange _RangeForRequest(NSURLRequest *request,
                                 NSUInteger dataLength,
                                 NSString *stringForIfRange);
+static NSTimeInterval _SampleLatency(TNLPseudoURLResponseConfig * __nullable config);
+static BOOL _ShouldInjectFailure(TNLPseudoURLResponseConfig * __nullable config);
+static NSUInteger _BandwidthPoolTakeBytes(NSUInteger requestedBytes);
+static TNLPseudoURLResponseConfig *_ReplayConfig(TNLResponse *response);
 
 typedef void(^TNLPseudoURLClientBlock)(id<NSURLProtocolClient> client);
 
@@ -50,7 +104,7 @@ TNL_OBJC_DIRECT_MEMBERS
 - (void)_chunkData:(NSData *)data
                bps:(NSUInteger)bps
          bytesSent:(NSUInteger)bytesSent
-           latency:(NSTimeInterval)latency;
+            config:(nullable TNLPseudoURLResponseConfig *)config;
 @end
 
 @implementation TNLPseudoURLProtocol
@@ -70,16 +124,39 @@ TNL_OBJC_DIRECT_MEMBERS
                      config:(nullable TNLPseudoURLResponseConfig *)config
                withEndpoint:(NSURL *)endpoint
 {
-    NSCachedURLResponse *cachedResponse = [[NSCachedURLResponse alloc] initWithResponse:response
-                                                                                   data:body
-                                                                               userInfo:(config) ? @{ @"config" : [config copy] } : nil
-                                                                          storagePolicy:NSURLCacheStorageAllowed];
+    NSCachedURLResponse *cachedResponse = _CachedResponse(response, body, config, NO /*matchesMultipleURLs*/);
 
     tnl_dispatch_barrier_async_autoreleasing(sOriginQueue, ^{
         sOriginToResponseDictionary[_UnderlyingURLString(endpoint)] = cachedResponse;
     });
 }
 
++ (void)registerURLResponse:(NSHTTPURLResponse *)response
+                       body:(nullable NSData *)body
+                     config:(nullable TNLPseudoURLResponseConfig *)config
+         withEndpointPrefix:(NSURL *)endpointPrefix
+{
+    NSCachedURLResponse *cachedResponse = _CachedResponse(response, body, config, YES /*matchesMultipleURLs*/);
+
+    tnl_dispatch_barrier_async_autoreleasing(sOriginQueue, ^{
+        sPrefixToResponseDictionary[_UnderlyingURLString(endpointPrefix)] = cachedResponse;
+    });
+}
+
++ (void)registerURLResponse:(NSHTTPURLResponse *)response
+                       body:(nullable NSData *)body
+                     config:(nullable TNLPseudoURLResponseConfig *)config
+        withEndpointPattern:(NSRegularExpression *)endpointPattern
+{
+    NSCachedURLResponse *cachedResponse = _CachedResponse(response, body, config, YES /*matchesMultipleURLs*/);
+    TNLPseudoURLPatternEndpoint *patternEndpoint = [[TNLPseudoURLPatternEndpoint alloc] initWithPattern:endpointPattern
+                                                                                               response:cachedResponse];
+
+    tnl_dispatch_barrier_async_autoreleasing(sOriginQueue, ^{
+        [sPatternEndpoints addObject:patternEndpoint];
+    });
+}
+
 + (void)unregisterEndpoint:(NSURL *)endpoint
 {
     tnl_dispatch_barrier_async_autoreleasing(sOriginQueue, ^{
@@ -87,13 +164,50 @@ TNL_OBJC_DIRECT_MEMBERS
     });
 }
 
++ (void)unregisterEndpointPrefix:(NSURL *)endpointPrefix
+{
+    tnl_dispatch_barrier_async_autoreleasing(sOriginQueue, ^{
+        [sPrefixToResponseDictionary removeObjectForKey:_UnderlyingURLString(endpointPrefix)];
+    });
+}
+
++ (void)unregisterEndpointPattern:(NSRegularExpression *)endpointPattern
+{
+    tnl_dispatch_barrier_async_autoreleasing(sOriginQueue, ^{
+        NSIndexSet *indexes = [sPatternEndpoints indexesOfObjectsPassingTest:^BOOL(TNLPseudoURLPatternEndpoint *patternEndpoint, NSUInteger idx, BOOL *stop) {
+            return [patternEndpoint.pattern isEqual:endpointPattern];
+        }];
+        [sPatternEndpoints removeObjectsAtIndexes:indexes];
+    });
+}
+
 + (void)unregisterAllEndpoints
 {
     tnl_dispatch_barrier_async_autoreleasing(sOriginQueue, ^{
         [sOriginToResponseDictionary removeAllObjects];
+        [sPrefixToResponseDictionary removeAllObjects];
+        [sPatternEndpoints removeAllObjects];
     });
 }
 
++ (uint64_t)sharedBandwidthPoolBPS
+{
+    os_unfair_lock_lock(&sBandwidthPoolLock);
+    const uint64_t bps = sBandwidthPoolBPS;
+    os_unfair_lock_unlock(&sBandwidthPoolLock);
+    return bps;
+}
+
++ (void)setSharedBandwidthPoolBPS:(uint64_t)bps
+{
+    os_unfair_lock_lock(&sBandwidthPoolLock);
+    sBandwidthPoolBPS = bps;
+    // start with a full burst
+    sBandwidthPoolAvailableBytes = ((double)bps / 8.0) * kMinimumChunkLatency;
+    sBandwidthPoolRefillMachTime = mach_absolute_time();
+    os_unfair_lock_unlock(&sBandwidthPoolLock);
+}
+
 + (BOOL)isEndpointRegistered:(NSURL *)endpoint
 {
     __block BOOL isRegistered = NO;
@@ -103,11 +217,71 @@ TNL_OBJC_DIRECT_MEMBERS
     return isRegistered;
 }
 
++ (BOOL)registerRecordedResponse:(TNLResponse *)response
+{
+    NSHTTPURLResponse *URLResponse = response.info.URLResponse;
+    NSURL *endpoint = response.metrics.attemptMetrics.firstObject.URLRequest.URL ?: response.info.finalURL;
+    if (!URLResponse || !endpoint) {
+        return NO;
+    }
+
+    [self registerURLResponse:URLResponse
+                         body:response.info.data
+                       config:_ReplayConfig(response)
+                 withEndpoint:endpoint];
+    return YES;
+}
+
++ (NSUInteger)registerRecordedResponsesWithArchiveFilePath:(NSString *)archiveFilePath
+                                                     error:(out NSError * __nullable * __nullable)error
+{
+    NSError *theError = nil;
+    NSData *archive = [NSData dataWithContentsOfFile:archiveFilePath
+                                             options:NSDataReadingMappedIfSafe
+                                               error:&theError];
+    NSArray<TNLResponse *> *responses = nil;
+    if (archive) {
+        if (tnl_available_ios_11) {
+            NSSet<Class> *classes = [NSSet setWithObjects:[NSArray class], [TNLResponse class], nil];
+            responses = [NSKeyedUnarchiver unarchivedObjectOfClasses:classes fromData:archive error:&theError];
+#if !TARGET_OS_MACCATALYST
+        } else {
+            responses = [NSKeyedUnarchiver unarchiveObjectWithData:archive];
+#endif
+        }
+        if (![responses isKindOfClass:[NSArray class]]) {
+            responses = nil;
+            if (!theError) {
+                theError = [NSError errorWithDomain:TNLPseudoURLProtocolErrorDomain
+                                               code:EFTYPE
+                                           userInfo:@{ NSFilePathErrorKey : archiveFilePath }];
+            }
+        }
+    }
+
+    if (!responses) {
+        if (error) {
+            *error = theError;
+        }
+        return 0;
+    }
+
+    NSUInteger count = 0;
+    for (TNLResponse *response in responses) {
+        if ([response isKindOfClass:[TNLResponse class]] && [self registerRecordedResponse:response]) {
+            count++;
+        }
+    }
+    return count;
+}
+
 + (void)initialize
 {
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
         sOriginToResponseDictionary = [[NSMutableDictionary alloc] init];
+        sPrefixToResponseDictionary = [[NSMutableDictionary alloc] init];
+        sPatternEndpoints = [[NSMutableArray alloc] init];
         sOriginQueue = dispatch_queue_create("tnl.pseudo.url.protocol.origin.queue", DISPATCH_QUEUE_CONCURRENT);
     });
 }
@@ -121,7 +295,7 @@ TNL_OBJC_DIRECT_MEMBERS
 
     __block BOOL originsMatch;
     dispatch_sync(sOriginQueue, ^{
-        originsMatch = sOriginToResponseDictionary[url] != nil;
+        originsMatch = _sync_ResponseForURLString(url) != nil;
     });
     return originsMatch;
 }
@@ -156,7 +330,7 @@ TNL_OBJC_DIRECT_MEMBERS
         TNLAssert(url);
         __block NSCachedURLResponse *response;
         dispatch_sync(sOriginQueue, ^{
-            response = sOriginToResponseDictionary[url];
+            response = _sync_ResponseForURLString(url);
         });
 
         if (response) {
@@ -176,7 +350,8 @@ TNL_OBJC_DIRECT_MEMBERS
                 });
             } else {
 
-                TNLPseudoURLResponseConfig *config = response.userInfo[@"config"];
+                TNLPseudoURLResponseConfig *config = response.userInfo[kConfigUserInfoKey];
+                NSURL *responseURL = ([response.userInfo[kMatchesMultipleURLsUserInfoKey] boolValue]) ? request.URL : response.response.URL;
 
                 if (config.extraRequestHeaders.count > 0) {
                     NSMutableDictionary *fullHeaders = [NSMutableDictionary dictionaryWithDictionary:config.extraRequestHeaders];
@@ -188,24 +363,32 @@ TNL_OBJC_DIRECT_MEMBERS
 
                 NSTimeInterval delay, latency;
                 delay = ((double)config.delay) / 1000.0;
-                latency = ((double)config.latency) / 1000.0;
+                latency = _SampleLatency(config);
 
                 dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)((delay + latency) * NSEC_PER_SEC)), self->_protocolQueue, ^{
                     @autoreleasepool {
                         ABORT_IF_NECESSARY();
 
-                        if (config.failureError) {
-                            self.stopped = YES;
-                            [self _executeClientBlock:^(id<NSURLProtocolClient> client){
-                                [client URLProtocol:self didFailWithError:config.failureError];
-                            }];
-                            return;
-                        }
-
                         NSHTTPURLResponse *httpResponse = (id)response.response;
                         NSData *data = response.data;
                         NSInteger statusCode = (config.statusCode > 0) ? config.statusCode : httpResponse.statusCode;
 
+                        if (_ShouldInjectFailure(config)) {
+                            if (config.failureRate > 0 && config.failureStatusCode > 0) {
+                                statusCode = config.failureStatusCode;
+                                data = [NSData data];
+                            } else {
+                                NSError *failureError = config.failureError ?: [NSError errorWithDomain:NSURLErrorDomain
+                                                                                                   code:NSURLErrorNetworkConnectionLost
+                                                                                               userInfo:nil];
+                                self.stopped = YES;
+                                [self _executeClientBlock:^(id<NSURLProtocolClient> client){
+                                    [client URLProtocol:self didFailWithError:failureError];
+                                }];
+                                return;
+                            }
+                        }
+
                         // See if we need to change to a 206
                         if (200 == statusCode && config.canProvideRange) {
 
@@ -213,7 +396,7 @@ TNL_OBJC_DIRECT_MEMBERS
                             if (range.location != NSNotFound) {
                                 // subrange requested, provide it
                                 statusCode = 206;
-                                data = [data subdataWithRange:range];
+                                data = [data tnl_safeSubdataNoCopyWithRange:range];
                             }
 
                         }
@@ -227,7 +410,7 @@ TNL_OBJC_DIRECT_MEMBERS
                             }
                         }
 
-                        httpResponse = _UpdateResponse(httpResponse, data.length, statusCode);
+                        httpResponse = _UpdateResponse(httpResponse, responseURL, data.length, statusCode);
 
                         tnl_dispatch_async_autoreleasing(self->_protocolQueue, ^{
                             ABORT_IF_NECESSARY();
@@ -237,21 +420,19 @@ TNL_OBJC_DIRECT_MEMBERS
                                  cacheStoragePolicy:response.storagePolicy];
                             }];
 
-                            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(latency * NSEC_PER_SEC)), self->_protocolQueue, ^{
-                                @autoreleasepool {
-                                    ABORT_IF_NECESSARY();
-
-                                    NSUInteger bps = NSUIntegerMax;
-                                    if (config.bps > 0) {
-                                        bps = (NSUInteger)MIN(config.bps / 8ULL, (uint64_t)NSUIntegerMax);
-                                    }
+                            [[TNLPseudoURLChunkScheduler sharedInstance] scheduleBlock:^{
+                                ABORT_IF_NECESSARY();
 
-                                    [self _chunkData:data
-                                                 bps:bps
-                                           bytesSent:0
-                                             latency:MAX(latency, 0.25)];
+                                NSUInteger bps = NSUIntegerMax;
+                                if (config.bps > 0) {
+                                    bps = (NSUInteger)MIN(config.bps / 8ULL, (uint64_t)NSUIntegerMax);
                                 }
-                            });
+
+                                [self _chunkData:data
+                                             bps:bps
+                                       bytesSent:0
+                                          config:config];
+                            } onQueue:self->_protocolQueue afterDelay:_SampleLatency(config)];
                         });
                     }
                 });
@@ -307,9 +488,12 @@ TNL_OBJC_DIRECT_MEMBERS
     // get the cached redirect response (if requested)
     __block NSCachedURLResponse *redirectCachedResponse;
     if (TNLPseudoURLProtocolRedirectBehaviorFollowLocationIfRedirectResponseIsRegistered == behavior) {
-        dispatch_sync(sOriginQueue, ^{
-            redirectCachedResponse = sOriginToResponseDictionary[_UnderlyingURLString(locationURL)];
-        });
+        NSString *locationURLString = _UnderlyingURLString(locationURL);
+        if (locationURLString) {
+            dispatch_sync(sOriginQueue, ^{
+                redirectCachedResponse = _sync_ResponseForURLString(locationURLString);
+            });
+        }
     }
 
     // if we have a cached response or we follow the redirect anyway, tell the client we redirected
@@ -337,12 +521,13 @@ TNL_OBJC_DIRECT_MEMBERS
 - (void)_chunkData:(NSData *)data
                bps:(NSUInteger)bps
          bytesSent:(NSUInteger)bytesSent
-           latency:(NSTimeInterval)latency
+            config:(nullable TNLPseudoURLResponseConfig *)config
 {
+    const NSTimeInterval latency = MAX(_SampleLatency(config), kMinimumChunkLatency);
     const NSUInteger bytesPerLatencyGap = (NSUInteger)MAX(bps * latency, 1UL);
     NSUInteger bytesToSend = 0;
     if (bytesSent < data.length) {
-        bytesToSend = MIN(bytesPerLatencyGap, data.length - bytesSent);
+        bytesToSend = _BandwidthPoolTakeBytes(MIN(bytesPerLatencyGap, data.length - bytesSent));
     }
 
     if (bytesToSend > 0) {
@@ -362,15 +547,13 @@ TNL_OBJC_DIRECT_MEMBERS
             }];
         });
     } else {
-        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(latency * NSEC_PER_SEC)), _protocolQueue, ^{
-            @autoreleasepool {
-                ABORT_IF_NECESSARY();
-                [self _chunkData:data
-                             bps:bps
-                       bytesSent:bytesSent
-                         latency:latency];
-            }
-        });
+        [[TNLPseudoURLChunkScheduler sharedInstance] scheduleBlock:^{
+            ABORT_IF_NECESSARY();
+            [self _chunkData:data
+                         bps:bps
+                   bytesSent:bytesSent
+                      config:config];
+        } onQueue:_protocolQueue afterDelay:latency];
     }
 }
 
@@ -421,8 +604,12 @@ TNL_OBJC_DIRECT_MEMBERS
 
     config.bps = self.bps;
     config.latency = self.latency;
+    config.latencyDistribution = self.latencyDistribution;
+    config.latencyDeviation = self.latencyDeviation;
     config.delay = self.delay;
     config.failureError = self.failureError;
+    config.failureRate = self.failureRate;
+    config.failureStatusCode = self.failureStatusCode;
     config.statusCode = self.statusCode;
     config.canProvideRange = self.canProvideRange;
     config.stringForIfRange = self.stringForIfRange;
@@ -434,17 +621,349 @@ TNL_OBJC_DIRECT_MEMBERS
 
 @end
 
+@implementation TNLPseudoURLPatternEndpoint
+
+- (instancetype)initWithPattern:(NSRegularExpression *)pattern response:(NSCachedURLResponse *)response
+{
+    if (self = [super init]) {
+        _pattern = pattern;
+        _response = response;
+    }
+    return self;
+}
+
+@end
+
+TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
+@interface TNLPseudoURLChunkTask : NSObject
+{
+@public
+    uint64_t _deadlineTick;
+    dispatch_queue_t _queue;
+    dispatch_block_t _block;
+}
+@end
+
+@implementation TNLPseudoURLChunkTask
+@end
+
+@implementation TNLPseudoURLChunkScheduler
+{
+    dispatch_queue_t _schedulerQueue;
+    dispatch_source_t _timerSource;
+    NSMutableArray<TNLPseudoURLChunkTask *> *_slots[kChunkSchedulerSlotCount];
+    uint64_t _startMachTime;
+    uint64_t _currentTick;
+    NSUInteger _taskCount;
+}
+
++ (instancetype)sharedInstance
+{
+    static TNLPseudoURLChunkScheduler *sScheduler;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sScheduler = [[TNLPseudoURLChunkScheduler alloc] init];
+    });
+    return sScheduler;
+}
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        _schedulerQueue = dispatch_queue_create("TNLPseudoURLProtocol.chunk.scheduler.queue", DISPATCH_QUEUE_SERIAL);
+        _startMachTime = mach_absolute_time();
+        for (NSUInteger i = 0; i < kChunkSchedulerSlotCount; i++) {
+            _slots[i] = [[NSMutableArray alloc] init];
+        }
+    }
+    return self;
+}
+
+- (uint64_t)_scheduler_tickForMachTime:(uint64_t)machTime
+{
+    return (uint64_t)(TNLComputeDuration(_startMachTime, machTime) / kChunkSchedulerTickInterval);
+}
+
+- (void)scheduleBlock:(dispatch_block_t)block
+              onQueue:(dispatch_queue_t)queue
+           afterDelay:(NSTimeInterval)delay
+{
+    TNLPseudoURLChunkTask *task = [[TNLPseudoURLChunkTask alloc] init];
+    task->_queue = queue;
+    task->_block = [block copy];
+    const uint64_t machTime = mach_absolute_time();
+
+    tnl_dispatch_async_autoreleasing(_schedulerQueue, ^{
+        if (!self->_taskCount) {
+            // idle, nothing to catch up on
+            self->_currentTick = [self _scheduler_tickForMachTime:mach_absolute_time()];
+        }
+
+        const uint64_t delayTicks = (uint64_t)ceil(MAX(delay, 0.0) / kChunkSchedulerTickInterval);
+        const uint64_t deadlineTick = [self _scheduler_tickForMachTime:machTime] + delayTicks;
+        task->_deadlineTick = MAX(deadlineTick, self->_currentTick + 1);
+        [self->_slots[task->_deadlineTick % kChunkSchedulerSlotCount] addObject:task];
+        self->_taskCount++;
+
+        if (!self->_timerSource) {
+            __weak typeof(self) weakSelf = self;
+            self->_timerSource = tnl_dispatch_timer_create_and_start(self->_schedulerQueue,
+                                                                     kChunkSchedulerTickInterval,
+                                                                     kChunkSchedulerTimerLeeway,
+                                                                     YES /*repeats*/,
+                                                                     ^{
+                [weakSelf _scheduler_advance];
+            });
+        }
+    });
+}
+
+- (void)_scheduler_advance
+{
+    const uint64_t targetTick = [self _scheduler_tickForMachTime:mach_absolute_time()];
+    while (_currentTick < targetTick && _taskCount > 0) {
+        _currentTick++;
+
+        NSMutableArray<TNLPseudoURLChunkTask *> *slot = _slots[_currentTick % kChunkSchedulerSlotCount];
+        if (!slot.count) {
+            continue;
+        }
+
+        NSMutableIndexSet *firedIndexes = [[NSMutableIndexSet alloc] init];
+        NSUInteger idx = 0;
+        for (TNLPseudoURLChunkTask *task in slot) {
+            if (task->_deadlineTick <= _currentTick) {
+                tnl_dispatch_async_autoreleasing(task->_queue, task->_block);
+                [firedIndexes addIndex:idx];
+            }
+            idx++;
+        }
+        [slot removeObjectsAtIndexes:firedIndexes];
+        _taskCount -= firedIndexes.count;
+    }
+
+    if (!_taskCount) {
+        tnl_dispatch_timer_invalidate(_timerSource);
+        _timerSource = nil;
+    }
+}
+
+@end
+
+@implementation TNLPseudoURLTrafficRecorder
+{
+    dispatch_queue_t _recorderQueue;
+    NSMutableArray<TNLResponse *> *_recordedResponses;
+}
+
+- (instancetype)initWithArchiveFilePath:(NSString *)archiveFilePath
+{
+    if (self = [super init]) {
+        _archiveFilePath = [archiveFilePath copy];
+        _recorderQueue = dispatch_queue_create("TNLPseudoURLTrafficRecorder.queue", DISPATCH_QUEUE_SERIAL);
+        _recordedResponses = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+- (NSUInteger)recordedResponseCount
+{
+    __block NSUInteger count;
+    dispatch_sync(_recorderQueue, ^{
+        count = self->_recordedResponses.count;
+    });
+    return count;
+}
+
+- (void)tnl_requestOperation:(TNLRequestOperation *)op
+     didCompleteWithResponse:(TNLResponse *)response
+{
+    if (!response.info.URLResponse) {
+        return;
+    }
+
+    tnl_dispatch_async_autoreleasing(_recorderQueue, ^{
+        [self->_recordedResponses addObject:response];
+    });
+}
+
+- (BOOL)saveArchive:(out NSError * __nullable * __nullable)error
+{
+    __block NSArray<TNLResponse *> *responses;
+    dispatch_sync(_recorderQueue, ^{
+        responses = [self->_recordedResponses copy];
+    });
+
+    NSError *theError = nil;
+    NSData *archive = nil;
+    if (tnl_available_ios_11) {
+        archive = [NSKeyedArchiver archivedDataWithRootObject:responses requiringSecureCoding:YES error:&theError];
+#if !TARGET_OS_MACCATALYST
+    } else {
+        archive = [NSKeyedArchiver archivedDataWithRootObject:responses];
+#endif
+    }
+
+    const BOOL success = archive && [archive writeToFile:_archiveFilePath
+                                                 options:NSDataWritingAtomic
+                                                   error:&theError];
+    if (!success && error) {
+        *error = theError;
+    }
+    return success;
+}
+
+@end
+
 static NSString * __nullable _UnderlyingURLString(NSURL * __nullable url)
 {
     return url.absoluteString.lowercaseString;
 }
 
-static NSHTTPURLResponse *_UpdateResponse(NSHTTPURLResponse *response, NSUInteger contentLength, NSInteger statusCode)
+static TNLPseudoURLResponseConfig *_ReplayConfig(TNLResponse *response)
+{
+    TNLPseudoURLResponseConfig *config = [[TNLPseudoURLResponseConfig alloc] init];
+    // the recorded response is final, redirects were already followed when it was recorded
+    config.redirectBehavior = TNLPseudoURLProtocolRedirectBehaviorDontFollowLocation;
+
+    TNLAttemptMetrics *attemptMetrics = response.metrics.attemptMetrics.lastObject;
+    if (!attemptMetrics.startDate || !attemptMetrics.endDate) {
+        return config;
+    }
+
+    // headers arrive after the time to first byte, then the body is paced at the recorded bandwidth
+    TNLAttemptMetaData *metaData = attemptMetrics.metaData;
+    const NSTimeInterval attemptDuration = MAX([attemptMetrics.endDate timeIntervalSinceDate:attemptMetrics.startDate], 0.0);
+    const NSTimeInterval downloadDuration = MIN((metaData.hasResponseContentDownloadDuration) ? metaData.responseContentDownloadDuration : 0.0, attemptDuration);
+    const NSUInteger bodyLength = response.info.data.length;
+
+    config.delay = (uint64_t)((attemptDuration - downloadDuration) * 1000.0);
+    if (downloadDuration > 0.0 && bodyLength > 0) {
+        config.bps = (uint64_t)((double)bodyLength * 8.0 / downloadDuration);
+    }
+    return config;
+}
+
+static NSCachedURLResponse *_CachedResponse(NSHTTPURLResponse *response,
+                                            NSData * __nullable body,
+                                            TNLPseudoURLResponseConfig * __nullable config,
+                                            BOOL matchesMultipleURLs)
+{
+    NSMutableDictionary *userInfo = [[NSMutableDictionary alloc] init];
+    userInfo[kConfigUserInfoKey] = [config copy];
+    if (matchesMultipleURLs) {
+        userInfo[kMatchesMultipleURLsUserInfoKey] = @YES;
+    }
+    return [[NSCachedURLResponse alloc] initWithResponse:response
+                                                    data:body
+                                                userInfo:(userInfo.count > 0) ? userInfo : nil
+                                           storagePolicy:NSURLCacheStorageAllowed];
+}
+
+static NSCachedURLResponse * __nullable _sync_ResponseForURLString(NSString *url)
+{
+    NSCachedURLResponse *response = sOriginToResponseDictionary[url];
+    if (response) {
+        return response;
+    }
+
+    NSUInteger longestPrefixLength = 0;
+    for (NSString *prefix in sPrefixToResponseDictionary) {
+        if (prefix.length > longestPrefixLength && [url hasPrefix:prefix]) {
+            longestPrefixLength = prefix.length;
+            response = sPrefixToResponseDictionary[prefix];
+        }
+    }
+    if (response) {
+        return response;
+    }
+
+    const NSRange fullRange = NSMakeRange(0, url.length);
+    for (TNLPseudoURLPatternEndpoint *patternEndpoint in sPatternEndpoints) {
+        if ([patternEndpoint.pattern firstMatchInString:url options:0 range:fullRange]) {
+            return patternEndpoint.response;
+        }
+    }
+
+    return nil;
+}
+
+static double _StandardNormalSample(void)
+{
+    // Box-Muller, u1 is in (0, 1] so the log is finite
+    const double u1 = ((double)arc4random() + 1.0) / ((double)UINT32_MAX + 1.0);
+    const double u2 = (double)arc4random() / ((double)UINT32_MAX + 1.0);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static NSTimeInterval _SampleLatency(TNLPseudoURLResponseConfig * __nullable config)
+{
+    const double latency = ((double)config.latency) / 1000.0;
+    const double deviation = ((double)config.latencyDeviation) / 1000.0;
+    if (latency <= 0.0 && TNLPseudoURLLatencyDistributionNormal != config.latencyDistribution) {
+        return 0.0;
+    }
+    if (deviation <= 0.0) {
+        return latency;
+    }
+
+    switch (config.latencyDistribution) {
+        case TNLPseudoURLLatencyDistributionNormal:
+            return MAX(0.0, latency + (deviation * _StandardNormalSample()));
+        case TNLPseudoURLLatencyDistributionLongTail:
+        {
+            // log-normal parameterized so the mean and standard deviation match the config
+            const double variance = log1p((deviation * deviation) / (latency * latency));
+            const double mu = log(latency) - (variance / 2.0);
+            return exp(mu + (sqrt(variance) * _StandardNormalSample()));
+        }
+        case TNLPseudoURLLatencyDistributionFixed:
+        default:
+            return latency;
+    }
+}
+
+static BOOL _ShouldInjectFailure(TNLPseudoURLResponseConfig * __nullable config)
+{
+    if (config.failureRate <= 0.0) {
+        // legacy behavior, always fail when there is an error
+        return config.failureError != nil;
+    }
+    if (config.failureRate >= 1.0) {
+        return YES;
+    }
+    return ((double)arc4random() / ((double)UINT32_MAX + 1.0)) < config.failureRate;
+}
+
+static NSUInteger _BandwidthPoolTakeBytes(NSUInteger requestedBytes)
+{
+    // A token bucket refilled at the pool rate.
+    // Loads poll at their own cadence, so each concurrent load gets about an even share on average.
+    os_unfair_lock_lock(&sBandwidthPoolLock);
+    if (!sBandwidthPoolBPS) {
+        os_unfair_lock_unlock(&sBandwidthPoolLock);
+        return requestedBytes;
+    }
+
+    const uint64_t machTime = mach_absolute_time();
+    const double bytesPerSecond = (double)sBandwidthPoolBPS / 8.0;
+    const double burstBytes = MAX(bytesPerSecond * kMinimumChunkLatency, 1.0);
+    const double elapsed = TNLComputeDuration(sBandwidthPoolRefillMachTime, machTime);
+    sBandwidthPoolRefillMachTime = machTime;
+    sBandwidthPoolAvailableBytes = MIN(burstBytes, sBandwidthPoolAvailableBytes + (elapsed * bytesPerSecond));
+
+    const NSUInteger grantedBytes = MIN(requestedBytes, (NSUInteger)sBandwidthPoolAvailableBytes);
+    sBandwidthPoolAvailableBytes -= (double)grantedBytes;
+    os_unfair_lock_unlock(&sBandwidthPoolLock);
+    return grantedBytes;
+}
+
+static NSHTTPURLResponse *_UpdateResponse(NSHTTPURLResponse *response, NSURL *URL, NSUInteger contentLength, NSInteger statusCode)
 {
     NSMutableDictionary *responseHeaderFields = [response.allHeaderFields mutableCopy];
     [responseHeaderFields tnl_setObject:[@(contentLength) stringValue]
                   forCaseInsensitiveKey:@"Content-Length"];
-    return [[NSHTTPURLResponse alloc] initWithURL:response.URL
+    return [[NSHTTPURLResponse alloc] initWithURL:URL
                                        statusCode:statusCode
                                       HTTPVersion:@"HTTP/1.1"
                                      headerFields:responseHeaderFields];
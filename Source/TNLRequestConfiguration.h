@@ -209,6 +209,7 @@ FOUNDATION_EXTERN NSTimeInterval TNLDeferrableIntervalForPriority(TNLPriority pr
     id<TNLRequestRetryPolicyProvider> _retryPolicyProvider;
     id<TNLContentEncoder> _contentEncoder;
     NSArray<id<TNLContentDecoder>> *_additionalContentDecoders;
+    NSSet<NSString *> *_requestCoalescingHTTPHeaderFieldAllowList;
 
     // NSURLSessionConfiguration settings
     NSString *_sharedContainerIdentifier;
@@ -233,6 +234,10 @@ FOUNDATION_EXTERN NSTimeInterval TNLDeferrableIntervalForPriority(TNLPriority pr
         NSTimeInterval operationTimeout;
         NSTimeInterval deferrableInterval;
 
+        // Hedging settings
+        double hedgeDelayPercentile;
+        NSTimeInterval hedgeMinimumDelay;
+
         // NSURLSessionConfiguration settings
         NSURLRequestCachePolicy cachePolicy:8;
         NSURLRequestNetworkServiceType networkServiceType:8;
@@ -242,6 +247,7 @@ FOUNDATION_EXTERN NSTimeInterval TNLDeferrableIntervalForPriority(TNLPriority pr
         // TNL BOOLs
         BOOL contributeToExecutingNetworkConnectionsCount:1;
         BOOL skipHostSanitization:1;
+        BOOL coalescesIdenticalRequests:1;
 
         // NSURLSessionConfiguration BOOLs
         BOOL allowsCellularAccess:1;
@@ -321,6 +327,58 @@ FOUNDATION_EXTERN NSTimeInterval TNLDeferrableIntervalForPriority(TNLPriority pr
  */
 @property (nonatomic, readonly) BOOL skipHostSanitization;
 
+/**
+ Whether the request operation can share its underlying network request with identical request
+ operations that are already in flight.
+
+ Only `GET` requests without a body, using `TNLResponseDataConsumptionModeStoreInMemory`, not executing
+ in the background and enqueued to the same `TNLRequestOperationQueue` with an equal configuration
+ are coalesced.  Requests are identical when `TNLRequestEqualToRequest` is satisfied, ignoring any
+ header fields in `requestCoalescingHTTPHeaderFieldAllowList`.
+ Each coalesced request operation gets its own `TNLResponse` (with its own metrics) and cancelling
+ one coalesced request operation does not cancel the others.
+
+ Default is `NO`
+ */
+@property (nonatomic, readonly) BOOL coalescesIdenticalRequests;
+
+/**
+ The HTTP header fields (case insensitive) that are permitted to differ between coalesced requests,
+ such as per request trace identifiers.
+
+ Default is `nil`
+ __See Also:__ `coalescesIdenticalRequests`
+ */
+@property (nonatomic, readonly, copy, nullable) NSSet<NSString *> *requestCoalescingHTTPHeaderFieldAllowList;
+
+/**
+ The percentile of recently observed response latency (time until response headers are received)
+ for the request's host after which a second, hedged, attempt is started in parallel if the first
+ attempt has not yet received its response headers.
+ Whichever attempt receives its response headers first is used and the other is cancelled.
+ Both are recorded in the `TNLResponseMetrics`, the hedged attempt with `TNLAttemptTypeHedge`.
+
+ Only requests with an HTTP method that the `retryPolicyProvider` permits retrying are hedged
+ (see `TNLConfiguringRetryPolicyProvider` and `[TNLRequestRetryPolicyConfiguration methodCanBeRetried:]`),
+ falling back to `[TNLRequestRetryPolicyConfiguration defaultConfiguration]` (`GET` only).
+ Background and coalesced requests are not hedged, nor are attempts that get redirected.
+
+ A value of `95.0` hedges the slowest ~5% of requests.
+ Values outside of `(0, 100)` disable hedging.
+ Default is `0.0` (disabled)
+ __See Also:__ `hedgeMinimumDelay`
+ */
+@property (nonatomic, readonly) double hedgeDelayPercentile;
+
+/**
+ The minimum delay before a hedged attempt is started (see `hedgeDelayPercentile`).
+ Until enough response latencies have been observed for the host to compute the percentile,
+ this delay is used on its own, and when it is `0.0` no hedging happens until then.
+
+ Default is `0.0`
+ */
+@property (nonatomic, readonly) NSTimeInterval hedgeMinimumDelay;
+
 /**
  The algorithm the request operation should compute a hash of the response body with.
  `executionMode` MUST NOT be `TNLRequestExecutionModeBackground` and
@@ -561,6 +619,10 @@ FOUNDATION_EXTERN NSTimeInterval TNLDeferrableIntervalForPriority(TNLPriority pr
 
 @property (nonatomic, readwrite) BOOL contributeToExecutingNetworkConnectionsCount;
 @property (nonatomic, readwrite) BOOL skipHostSanitization;
+@property (nonatomic, readwrite) BOOL coalescesIdenticalRequests;
+@property (nonatomic, readwrite, copy, nullable) NSSet<NSString *> *requestCoalescingHTTPHeaderFieldAllowList;
+@property (nonatomic, readwrite) double hedgeDelayPercentile;
+@property (nonatomic, readwrite) NSTimeInterval hedgeMinimumDelay;
 
 @property (nonatomic, readwrite) TNLRequestExecutionMode executionMode;
 @property (nonatomic, readwrite) TNLRequestRedirectPolicy redirectPolicy;
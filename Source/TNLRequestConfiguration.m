@@ -71,8 +71,14 @@ TNLStaticAssert(TNLResponseHashComputeAlgorithmSHA1 == 1936220465, ALGORITHM_SHA
 TNLStaticAssert(TNLResponseHashComputeAlgorithmSHA256 == 1932670262, ALGORITHM_SHA256_WRONG_VALUE);
 TNLStaticAssert(TNLResponseHashComputeAlgorithmSHA512 == 1932865842, ALGORITHM_SHA512_WRONG_VALUE);
 
+@interface TNLURLSessionIdentity ()
+- (instancetype)initWithRequestConfiguration:(TNLRequestConfiguration *)config NS_DESIGNATED_INITIALIZER;
+@end
+
 @interface TNLRequestConfiguration ()
 
+@property (atomic, nullable) TNLURLSessionIdentity *cachedURLSessionIdentity;
+
 - (instancetype)initWithConfiguration:(nullable TNLRequestConfiguration *)config;
 - (instancetype)initWithIdleTimeout:(NSTimeInterval)idleTimeout
                      attemptTimeout:(NSTimeInterval)attemptTimeout
@@ -87,6 +93,7 @@ TNLStaticAssert(TNLResponseHashComputeAlgorithmSHA512 == 1932865842, ALGORITHM_S
 @synthesize retryPolicyProvider = _retryPolicyProvider;
 @synthesize contentEncoder = _contentEncoder;
 @synthesize additionalContentDecoders = _additionalContentDecoders;
+@synthesize requestCoalescingHTTPHeaderFieldAllowList = _requestCoalescingHTTPHeaderFieldAllowList;
 @synthesize URLCredentialStorage = _URLCredentialStorage;
 @synthesize URLCache = _URLCache;
 @synthesize sharedContainerIdentifier = _sharedContainerIdentifier;
@@ -129,6 +136,21 @@ TNLStaticAssert(TNLResponseHashComputeAlgorithmSHA512 == 1932865842, ALGORITHM_S
     return _ivars.skipHostSanitization;
 }
 
+- (BOOL)coalescesIdenticalRequests
+{
+    return _ivars.coalescesIdenticalRequests;
+}
+
+- (double)hedgeDelayPercentile
+{
+    return _ivars.hedgeDelayPercentile;
+}
+
+- (NSTimeInterval)hedgeMinimumDelay
+{
+    return _ivars.hedgeMinimumDelay;
+}
+
 - (TNLResponseHashComputeAlgorithm)responseComputeHashAlgorithm
 {
     return _ivars.responseComputeHashAlgorithm;
@@ -234,6 +256,7 @@ TNLStaticAssert(TNLResponseHashComputeAlgorithmSHA512 == 1932865842, ALGORITHM_S
         _retryPolicyProvider = config->_retryPolicyProvider;
         _contentEncoder = config->_contentEncoder;
         _additionalContentDecoders = [config->_additionalContentDecoders copy];
+        _requestCoalescingHTTPHeaderFieldAllowList = [config->_requestCoalescingHTTPHeaderFieldAllowList copy];
         _URLCredentialStorage = config->_URLCredentialStorage;
         _URLCache = config->_URLCache;
         _cookieStorage = config->_cookieStorage;
@@ -304,12 +327,15 @@ TNLStaticAssert(TNLResponseHashComputeAlgorithmSHA512 == 1932865842, ALGORITHM_S
     D_SET(connectivityOptions);
     D_SET(contributeToExecutingNetworkConnectionsCount);
     D_SET(skipHostSanitization);
+    D_SET(coalescesIdenticalRequests);
     D_SET(responseComputeHashAlgorithm);
 
     D_SET(attemptTimeout);
     D_SET(idleTimeout);
     D_SET(operationTimeout);
     D_SET(deferrableInterval);
+    D_SET(hedgeDelayPercentile);
+    D_SET(hedgeMinimumDelay);
 
     D_SET(cachePolicy);
     D_SET(networkServiceType);
@@ -334,6 +360,7 @@ TNLStaticAssert(TNLResponseHashComputeAlgorithmSHA512 == 1932865842, ALGORITHM_S
     D_SET(retryPolicyProvider);
     D_SET(contentEncoder);
     D_SET(additionalContentDecoders);
+    D_SET(requestCoalescingHTTPHeaderFieldAllowList);
 
     D_SET(sharedContainerIdentifier);
     D_SET(URLCredentialStorage);
@@ -382,6 +409,10 @@ TNLStaticAssert(TNLResponseHashComputeAlgorithmSHA512 == 1932865842, ALGORITHM_S
         return NO;
     }
 
+    if (self.requestCoalescingHTTPHeaderFieldAllowList != other.requestCoalescingHTTPHeaderFieldAllowList && ![self.requestCoalescingHTTPHeaderFieldAllowList isEqualToSet:other.requestCoalescingHTTPHeaderFieldAllowList]) {
+        return NO;
+    }
+
     if (self.URLCredentialStorage != other.URLCredentialStorage) {
         return NO;
     }
@@ -405,6 +436,10 @@ TNLStaticAssert(TNLResponseHashComputeAlgorithmSHA512 == 1932865842, ALGORITHM_S
 
 @dynamic contributeToExecutingNetworkConnectionsCount;
 @dynamic skipHostSanitization;
+@dynamic coalescesIdenticalRequests;
+@dynamic requestCoalescingHTTPHeaderFieldAllowList;
+@dynamic hedgeDelayPercentile;
+@dynamic hedgeMinimumDelay;
 @dynamic responseComputeHashAlgorithm;
 
 @dynamic executionMode;
@@ -482,6 +517,33 @@ TNLStaticAssert(TNLResponseHashComputeAlgorithmSHA512 == 1932865842, ALGORITHM_S
     _ivars.skipHostSanitization = (skipHostSanitization != NO);
 }
 
+- (void)setCoalescesIdenticalRequests:(BOOL)coalescesIdenticalRequests
+{
+    _ivars.coalescesIdenticalRequests = (coalescesIdenticalRequests != NO);
+}
+
+- (void)setRequestCoalescingHTTPHeaderFieldAllowList:(nullable NSSet<NSString *> *)allowList
+{
+    NSMutableSet<NSString *> *lowercaseAllowList = nil;
+    if (allowList.count) {
+        lowercaseAllowList = [[NSMutableSet alloc] initWithCapacity:allowList.count];
+        for (NSString *field in allowList) {
+            [lowercaseAllowList addObject:field.lowercaseString];
+        }
+    }
+    _requestCoalescingHTTPHeaderFieldAllowList = [lowercaseAllowList copy];
+}
+
+- (void)setHedgeDelayPercentile:(double)hedgeDelayPercentile
+{
+    _ivars.hedgeDelayPercentile = (hedgeDelayPercentile > 0.0 && hedgeDelayPercentile < 100.0) ? hedgeDelayPercentile : 0.0;
+}
+
+- (void)setHedgeMinimumDelay:(NSTimeInterval)hedgeMinimumDelay
+{
+    _ivars.hedgeMinimumDelay = MAX(hedgeMinimumDelay, 0.0);
+}
+
 - (void)setResponseComputeHashAlgorithm:(TNLResponseHashComputeAlgorithm)responseComputeHashAlgorithm
 {
     _ivars.responseComputeHashAlgorithm = responseComputeHashAlgorithm;
@@ -708,6 +770,102 @@ PROP_RETAIN_ASSIGN_IMP(cookieStorage);
     _ivars.deferrableInterval = kConfigurationDeferrableIntervalDefault;
 }
 
+- (TNLURLSessionIdentity *)URLSessionIdentity
+{
+    TNLURLSessionIdentity *identity = self.cachedURLSessionIdentity;
+    if (!identity) {
+        identity = [[TNLURLSessionIdentity alloc] initWithRequestConfiguration:self];
+        if (![self isKindOfClass:[TNLMutableRequestConfiguration class]]) {
+            // only cache when immutable (racing to populate the cache is harmless, the values are equal)
+            self.cachedURLSessionIdentity = identity;
+        }
+    }
+    return identity;
+}
+
+@end
+
+#pragma mark - TNLURLSessionIdentity
+
+@implementation TNLURLSessionIdentity
+{
+    struct {
+        TNLRequestProtocolOptions protocolOptions;
+        NSURLRequestCachePolicy cachePolicy;
+        NSHTTPCookieAcceptPolicy cookieAcceptPolicy;
+        NSInteger multipathServiceType;
+        BOOL discretionary;
+        BOOL shouldSetCookies;
+        BOOL shouldUseExtendedBackgroundIdleMode;
+    } _fields;
+    NSString *_sharedContainerIdentifier;
+    NSUInteger _hash;
+}
+
+- (instancetype)initWithRequestConfiguration:(TNLRequestConfiguration *)config
+{
+    if (self = [super init]) {
+        // zero out first so padding doesn't break memcmp
+        memset(&_fields, 0, sizeof(_fields));
+
+        // Only the settings that are not stripped nor overridden for in-app NSURLSession instances
+        _fields.protocolOptions = config.protocolOptions;
+        _fields.cachePolicy = config.cachePolicy;
+        _fields.cookieAcceptPolicy = config.cookieAcceptPolicy;
+        _fields.multipathServiceType = config.multipathServiceType;
+        _fields.discretionary = (config.isDiscretionary != NO);
+        _fields.shouldSetCookies = (config.shouldSetCookies != NO);
+        _fields.shouldUseExtendedBackgroundIdleMode = (config.shouldUseExtendedBackgroundIdleMode != NO);
+        _sharedContainerIdentifier = [config.sharedContainerIdentifier copy];
+
+        // FNV-1a over the fields
+        uint64_t hash = 14695981039346656037ULL;
+        const uint8_t *bytes = (const uint8_t *)&_fields;
+        for (size_t i = 0; i < sizeof(_fields); i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        _hash = (NSUInteger)hash ^ _sharedContainerIdentifier.hash;
+    }
+    return self;
+}
+
+- (id)copyWithZone:(nullable NSZone *)zone
+{
+    return self;
+}
+
+- (NSUInteger)hash
+{
+    return _hash;
+}
+
+- (BOOL)isEqual:(id)object
+{
+    if (self == object) {
+        return YES;
+    }
+
+    if (![object isKindOfClass:[TNLURLSessionIdentity class]]) {
+        return NO;
+    }
+
+    TNLURLSessionIdentity *other = object;
+    if (_hash != other->_hash) {
+        return NO;
+    }
+
+    if (0 != memcmp(&_fields, &(other->_fields), sizeof(_fields))) {
+        return NO;
+    }
+
+    if (_sharedContainerIdentifier != other->_sharedContainerIdentifier && ![_sharedContainerIdentifier isEqualToString:other->_sharedContainerIdentifier]) {
+        return NO;
+    }
+
+    return YES;
+}
+
 @end
 
 #pragma mark - Functions
@@ -822,6 +980,10 @@ TNLMutableParameterCollection * __nullable TNLMutableParametersFromRequestConfig
      Note:
      config.contributeToExecutingNetworkConnectionsCount,
      config.skipHostSanitization,
+     config.coalescesIdenticalRequests,
+     config.requestCoalescingHTTPHeaderFieldAllowList,
+     config.hedgeDelayPercentile,
+     config.hedgeMinimumDelay,
      config.responseComputeHashAlgorithm,
      config.contentEncoder,
      config.additionContentDecoders,
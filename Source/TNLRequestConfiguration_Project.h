@@ -50,6 +50,20 @@ FOUNDATION_EXTERN NSURLCache *TNLGetURLCacheDemuxProxy(void);
 FOUNDATION_EXTERN NSURLCredentialStorage *TNLGetURLCredentialStorageDemuxProxy(void);
 FOUNDATION_EXTERN NSHTTPCookieStorage *TNLGetHTTPCookieStorageDemuxProxy(void);
 
+/**
+ Compact identity of the settings of a `TNLRequestConfiguration` that are relevant when selecting
+ an in-app (non-background) `NSURLSession`.
+ Two configurations with equal identities can share the same in-app `NSURLSession`.
+
+ @note the fields captured need to be kept in sync with what survives the
+ `TNLMutableParametersStrip*` functions in `TNLURLSessionManager.m`
+ */
+TNL_OBJC_FINAL
+@interface TNLURLSessionIdentity : NSObject <NSCopying>
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+@end
+
 @interface TNLRequestConfiguration (Project)
 
 + (nullable instancetype)parseConfigurationFromIdentifier:(nullable NSString *)identifier TNL_OBJC_DIRECT;
@@ -58,6 +72,13 @@ FOUNDATION_EXTERN NSHTTPCookieStorage *TNLGetHTTPCookieStorageDemuxProxy(void);
                                     version:(nullable NSString *)tnlVersion;
 - (void)applyDefaultTimeouts TNL_OBJC_DIRECT;
 
+/**
+ The identity of the in-app `NSURLSession` to use with this configuration.
+ Immutable configurations compute it once and cache it, mutable configurations compute it on
+ every access.
+ */
+- (TNLURLSessionIdentity *)URLSessionIdentity;
+
 @end
 
 NS_ASSUME_NONNULL_END
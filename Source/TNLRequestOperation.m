@@ -8,6 +8,7 @@
 
 #include <mach/mach_time.h>
 #include <objc/message.h>
+#include <os/lock.h>
 #include <stdatomic.h>
 
 #import "NSCachedURLResponse+TNLAdditions.h"
@@ -29,6 +30,7 @@
 #import "TNLRequestOperation_Project.h"
 #import "TNLRequestOperationCancelSource.h"
 #import "TNLRequestOperationQueue_Project.h"
+#import "TNLRequestRetryPolicyConfiguration.h"
 #import "TNLRequestRetryPolicyProvider.h"
 #import "TNLResponse_Project.h"
 #import "TNLSimpleRequestDelegate.h"
@@ -78,9 +80,60 @@ static dispatch_queue_t _URLSessionTaskOperationPropertyQueue()
     return sQueue;
 }
 
+#pragma mark Hedging
+
+// Recent response latencies (attempt start until response headers) per host, used for the hedge delay.
+// Each host keeps a window of the most recent samples, hosts are dropped wholesale past the cap.
+static const NSUInteger kHedgeLatencySampleCount = 64;
+static const NSUInteger kHedgeLatencyMinimumSampleCount = 16;
+static const NSUInteger kHedgeLatencyMaximumHostCount = 128;
+static os_unfair_lock sHedgeLatencyLock = OS_UNFAIR_LOCK_INIT;
+static NSMutableDictionary<NSString *, NSMutableArray<NSNumber *> *> *sHedgeLatencySamples = nil; // guarded by sHedgeLatencyLock
+
+static void _HedgeRecordResponseLatency(NSString *host, NSTimeInterval latency);
+static void _HedgeRecordResponseLatency(NSString *host, NSTimeInterval latency)
+{
+    os_unfair_lock_lock(&sHedgeLatencyLock);
+    if (!sHedgeLatencySamples) {
+        sHedgeLatencySamples = [[NSMutableDictionary alloc] init];
+    }
+    NSMutableArray<NSNumber *> *samples = sHedgeLatencySamples[host];
+    if (!samples) {
+        if (sHedgeLatencySamples.count >= kHedgeLatencyMaximumHostCount) {
+            [sHedgeLatencySamples removeAllObjects];
+        }
+        samples = [[NSMutableArray alloc] initWithCapacity:kHedgeLatencySampleCount];
+        sHedgeLatencySamples[host] = samples;
+    }
+    if (samples.count >= kHedgeLatencySampleCount) {
+        [samples removeObjectAtIndex:0];
+    }
+    [samples addObject:@(latency)];
+    os_unfair_lock_unlock(&sHedgeLatencyLock);
+}
+
+// returns a negative value when too few latencies have been recorded for the host
+static NSTimeInterval _HedgeResponseLatencyPercentile(NSString *host, double percentile);
+static NSTimeInterval _HedgeResponseLatencyPercentile(NSString *host, double percentile)
+{
+    NSArray<NSNumber *> *samples;
+    os_unfair_lock_lock(&sHedgeLatencyLock);
+    samples = [sHedgeLatencySamples[host] copy];
+    os_unfair_lock_unlock(&sHedgeLatencyLock);
+
+    if (samples.count < kHedgeLatencyMinimumSampleCount) {
+        return -1.0;
+    }
+
+    samples = [samples sortedArrayUsingSelector:@selector(compare:)];
+    NSUInteger index = (NSUInteger)ceil((percentile / 100.0) * (double)samples.count);
+    index = (index > 0) ? index - 1 : 0;
+    return samples[MIN(index, samples.count - 1)].doubleValue;
+}
+
 TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
 @interface TNLTimerOperation : TNLSafeOperation
-- (instancetype)initWithDelay:(NSTimeInterval)delay;
+- (instancetype)initWithDelay:(NSTimeInterval)delay queue:(dispatch_queue_t)queue;
 @end
 
 @interface TNLRequestOperation ()
@@ -110,7 +163,7 @@ TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
 TNL_OBJC_DIRECT_MEMBERS
 @interface TNLRequestOperation (Network)
 
-// Methods that can only be called from the tnl_network_queue()
+// Methods that can only be called from the operation's network lane
 
 #pragma mark NSOperation helpers
 
@@ -125,6 +178,7 @@ TNL_OBJC_DIRECT_MEMBERS
 - (void)_network_retryWithOldResponse:(TNLResponse *)oldResponse
                   retryPolicyProvider:(nullable id<TNLRequestRetryPolicyProvider>)retryPolicyProvider;
 - (void)_network_prepareToStart;
+- (void)_network_startAfterAdmission;
 - (void)_network_start:(BOOL)isRetry;
 - (void)_network_cleanupAfterComplete;
 
@@ -199,6 +253,21 @@ TNL_OBJC_DIRECT_MEMBERS
 - (void)_network_invalidateAttemptTimeoutTimer;
 - (void)_network_attemptTimeoutTimerDidFire;
 
+#pragma mark Hedging
+
+- (BOOL)_network_canHedge;
+- (void)_network_startHedgeTimerIfNeeded;
+- (void)_network_invalidateHedgeTimer;
+- (void)_network_hedgeTimerDidFire;
+- (void)_network_startHedgeURLSessionTaskOperation:(TNLURLSessionTaskOperation *)hedgeOp
+                    primaryURLSessionTaskOperation:(TNLURLSessionTaskOperation *)primaryOp;
+- (void)_network_hedgeURLSessionTaskOperation:(TNLURLSessionTaskOperation *)hedgeOp
+                         didTransitionToState:(TNLRequestOperationState)state
+                                 withResponse:(nullable TNLResponse *)response;
+- (void)_network_promoteHedgeURLSessionTaskOperation;
+- (void)_network_abandonHedgeWithError:(nullable NSError *)error;
+- (void)_network_attemptDidReceiveResponse;
+
 #pragma mark Application States (iOS only)
 
 #if TARGET_OS_IOS || TARGET_OS_TV
@@ -289,8 +358,11 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
     TNLRequestOperationState_AtomicT _state;
     NSMutableURLRequest *_scratchURLRequest;
     NSTimeInterval _scratchURLRequestEncodeLatency;
+    NSTimeInterval _scratchURLRequestEncodeQueueLatency;
     SInt64 _scratchURLRequestOriginalBodyLength;
     SInt64 _scratchURLRequestEncodedBodyLength;
+    dispatch_queue_t _networkLane;
+    dispatch_queue_t _codingLane; // created lazily from the network lane
     id<TNLHostSanitizer> _hostSanitizer;
     TNLResponseMetrics *_metrics;
 
@@ -300,6 +372,13 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
     dispatch_source_t _callbackTimeoutTimerSource;
     uint64_t _callbackTimeoutTimerStartMachTime;
     uint64_t _callbackTimeoutTimerPausedMachTime;
+    dispatch_source_t _hedgeTimerSource;
+
+    // Hedging
+    TNLURLSessionTaskOperation *_hedgeURLSessionTaskOperation;
+    NSDate *_hedgeStartDate;
+    uint64_t _hedgeStartMachTime;
+    uint64_t _hedgeLatencyStartMachTime; // 0 when the current attempt's latency isn't sampled
 
     // Retry
     uint64_t _activeRetryId;
@@ -314,6 +393,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
         BOOL isCallbackClogDetectionEnabled:1;
         BOOL isObservingApplicationStates:1;
         BOOL applicationIsInBackground:1;
+        BOOL didHedgeAttempt:1; // one hedge per attempt
         unsigned int invalidSessionRetryCount:4;
     } _backgroundFlags;
 
@@ -352,6 +432,8 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
 
         arc4random_buf(&_operationId, sizeof(int64_t));
 
+        _networkLane = tnl_network_lane_create();
+
         _backgroundTaskIdentifier = TNLBackgroundTaskInvalid;
 
         atomic_init(&_state, TNLRequestOperationStateIdle);
@@ -402,6 +484,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
     tnl_dispatch_timer_invalidate(_operationTimeoutTimerSource);
     tnl_dispatch_timer_invalidate(_attemptTimeoutTimerSource);
     tnl_dispatch_timer_invalidate(_callbackTimeoutTimerSource);
+    tnl_dispatch_timer_invalidate(_hedgeTimerSource);
     _activeRetryId = 0; // invalidate any pending retry
 
     TNLBackgroundTaskIdentifier backgroundTaskIdentifier = self.dealloc_backgroundTaskIdentifier;
@@ -432,7 +515,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
 {
     TNLAssert(!_requestOperationQueue);
     self.requestOperationQueue = operationQueue;
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         TNLAssert(!self->_backgroundFlags.didEnqueue);
         if (!self->_backgroundFlags.didEnqueue && atomic_load(&self->_state) == TNLRequestOperationStateIdle) {
             self->_enqueuedPriority = self.internalPriority;
@@ -489,10 +572,15 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
     return atomic_load(&_state);
 }
 
+- (dispatch_queue_t)networkLane
+{
+    return _networkLane;
+}
+
 - (void)setState:(TNLRequestOperationState)state async:(BOOL)async
 {
     if (async) {
-        tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+        tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
             [self _tnl_setState:state];
         });
     } else {
@@ -578,7 +666,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
 
 - (void)setPriority:(TNLPriority)priority
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         if (self.internalPriority != priority) {
 
             BOOL didEnqueue = self->_backgroundFlags.didEnqueue; // cannot modify other NSOperation priorities if we've already been enqueued
@@ -600,6 +688,9 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
                 [self didChangeValueForKey:@"queuePriority"];
             }
 
+            if (didEnqueue && !self->_backgroundFlags.didStart) {
+                [TNLRequestOperationQueue requestOperation:self didChangeAdmissionPriority:priority];
+            }
             [self.URLSessionTaskOperation network_priorityDidChangeForRequestOperation:self];
         }
     });
@@ -614,7 +705,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
 
 - (void)network_URLSessionTaskOperationIsWaitingForConnectivity:(TNLURLSessionTaskOperation *)taskOp
 {
-    TNLAssertIsNetworkQueue();
+    TNLAssertIsNetworkLane(_networkLane);
     if (![self _network_hasFailedOrFinished] && self.URLSessionTaskOperation == taskOp) {
 
         // Invalidate timeout timer if configured to do so
@@ -639,7 +730,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
 - (void)network_URLSessionTaskOperation:(TNLURLSessionTaskOperation *)taskOp
                   didReceiveURLResponse:(NSURLResponse *)URLResponse
 {
-    TNLAssertIsNetworkQueue();
+    TNLAssertIsNetworkLane(_networkLane);
     if (![self _network_hasFailedOrFinished] && self.URLSessionTaskOperation == taskOp) {
         id<TNLRequestEventHandler> eventHandler = self.internalDelegate;
         SEL callback = @selector(tnl_requestOperation:didReceiveURLResponse:);
@@ -661,7 +752,14 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
                               toRequest:(NSURLRequest *)toRequest
                              completion:(TNLRequestRedirectCompletionBlock)completion
 {
-    TNLAssertIsNetworkQueue();
+    TNLAssertIsNetworkLane(_networkLane);
+    if (taskOp == _hedgeURLSessionTaskOperation) {
+        // hedges don't follow redirects, the primary attempt will encounter the same redirect
+        [self _network_abandonHedgeWithError:nil];
+        completion(nil);
+        return;
+    }
+
     // provide the redirect policy
     [self _network_willPerformRedirectFromRequest:fromRequest
                                  withHTTPResponse:response
@@ -678,7 +776,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
                                  redirectPolicy:(TNLRequestRedirectPolicy)redirectPolicy
                                      completion:(TNLRequestRedirectCompletionBlock)completion TNL_OBJC_DIRECT
 {
-    TNLAssertIsNetworkQueue();
+    TNLAssertIsNetworkLane(_networkLane);
     if (![self _network_hasFailedOrFinished] && self.URLSessionTaskOperation == taskOp) {
         NSURLRequest *toRequest = providedToRequest;
         switch (redirectPolicy) {
@@ -707,8 +805,8 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
                                                toRequest:toRequest
                                               completion:^(id<TNLRequest> finalToRequest) {
                             [self _clearTag:tag];
-                            // all `TNLURLSessionTaskOperationDelegate` completion blocks must be called from tnl_network_queue
-                            tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+                            // all `TNLURLSessionTaskOperationDelegate` completion blocks must be called from the network lane
+                            tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
                                 completion(finalToRequest);
                             });
                         }];
@@ -739,9 +837,15 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
                                      to:(NSURLRequest *)toRequest
                                metaData:(TNLAttemptMetaData *)metaData
 {
-    TNLAssertIsNetworkQueue();
+    TNLAssertIsNetworkLane(_networkLane);
     if (![self _network_hasFailedOrFinished] && self.URLSessionTaskOperation == taskOp) {
 
+        // Redirected attempts are neither hedged nor sampled for hedging
+
+        [self _network_abandonHedgeWithError:nil];
+        _backgroundFlags.didHedgeAttempt = YES;
+        _hedgeLatencyStartMachTime = 0;
+
         // Capture info from attempt
 
         NSDate *dateNow = [NSDate date];
@@ -791,7 +895,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
 - (void)_network_notifySanitizedHost:(NSString *)oldHost
                               toHost:(NSString *)newHost TNL_OBJC_DIRECT
 {
-    TNLAssertIsNetworkQueue();
+    TNLAssertIsNetworkLane(_networkLane);
     id<TNLRequestEventHandler> eventHandler = self.internalDelegate;
     SEL callback = @selector(tnl_requestOperation:didSanitizeFromHost:toHost:);
     if ([eventHandler respondsToSelector:callback]) {
@@ -812,14 +916,14 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
                                      to:(NSURLRequest *)toRequest
                       completionHandler:(void (^)(NSURLRequest * __nullable, NSError * __nullable))completionHandler
 {
-    TNLAssertIsNetworkQueue();
-    if (_hostSanitizer) {
+    TNLAssertIsNetworkLane(_networkLane);
+    if (_hostSanitizer && taskOp != _hedgeURLSessionTaskOperation) {
         NSString *host = toRequest.URL.host;
         [_hostSanitizer tnl_host:host
      wasEncounteredForURLRequest:toRequest
                       asRedirect:YES
                       completion:^(TNLHostSanitizerBehavior behavior, NSString *newHost) {
-            tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+            tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
                 TNLAssert([host isEqualToString:toRequest.URL.host]);
                 NSError *error = nil;
                 NSMutableURLRequest *mRequest = [toRequest mutableCopy];
@@ -847,7 +951,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
 - (void)network_URLSessionTaskOperation:(TNLURLSessionTaskOperation *)taskOp
                 didUpdateUploadProgress:(float)progress
 {
-    TNLAssertIsNetworkQueue();
+    TNLAssertIsNetworkLane(_networkLane);
     // Progress can exceed 1.0, cap it
     if (progress > 1.0f) {
         progress = 1.0f;
@@ -876,7 +980,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
 - (void)network_URLSessionTaskOperation:(TNLURLSessionTaskOperation *)taskOp
               didUpdateDownloadProgress:(float)progress
 {
-    TNLAssertIsNetworkQueue();
+    TNLAssertIsNetworkLane(_networkLane);
     // Progress can exceed 1.0, cap it
     if (progress > 1.0f) {
         progress = 1.0f;
@@ -905,7 +1009,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
 - (void)network_URLSessionTaskOperation:(TNLURLSessionTaskOperation *)taskOp
                      appendReceivedData:(NSData *)data
 {
-    TNLAssertIsNetworkQueue();
+    TNLAssertIsNetworkLane(_networkLane);
     if (![self _network_hasFailedOrFinished] && self.URLSessionTaskOperation == taskOp) {
         switch (_requestConfiguration.responseDataConsumptionMode) {
             case TNLResponseDataConsumptionModeChunkToDelegateCallback: {
@@ -937,7 +1041,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
         sharedContainerIdentifier:(nullable NSString *)sharedContainerIdentifier
         isBackgroundRequest:(BOOL)isBackgroundRequest
 {
-    TNLAssertIsNetworkQueue();
+    TNLAssertIsNetworkLane(_networkLane);
     if (![self _network_hasFailedOrFinished] && self.URLSessionTaskOperation == taskOp) {
         TNLAssert((self.executionMode == TNLRequestExecutionModeBackground) == isBackgroundRequest);
         id<TNLRequestEventHandler> eventHandler = self.internalDelegate;
@@ -964,7 +1068,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
                             taskMetrics:(nullable NSURLSessionTaskMetrics *)taskMetrics
                              completion:(TNLRequestMakeFinalResponseCompletionBlock)completion
 {
-    TNLAssertIsNetworkQueue();
+    TNLAssertIsNetworkLane(_networkLane);
     if (self.URLSessionTaskOperation != taskOp || [self _network_hasFailedOrFinished]) {
         completion(nil);
         return;
@@ -981,8 +1085,14 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
                    didTransitionToState:(TNLRequestOperationState)state
                            withResponse:(nullable TNLResponse *)response
 {
-    TNLAssertIsNetworkQueue();
+    TNLAssertIsNetworkLane(_networkLane);
     TNLAssert(state != TNLRequestOperationStateIdle);
+    if (taskOp == _hedgeURLSessionTaskOperation && taskOp != nil) {
+        // promotes the hedge to be our task operation if it won the race
+        [self _network_hedgeURLSessionTaskOperation:taskOp
+                               didTransitionToState:state
+                                       withResponse:response];
+    }
     if (self.URLSessionTaskOperation != taskOp || [self _network_hasFailedOrFinished]) {
         return;
     }
@@ -993,7 +1103,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
 - (void)network_URLSessionTaskOperation:(TNLURLSessionTaskOperation *)taskOp
          didStartSessionTaskWithRequest:(NSURLRequest *)request
 {
-    TNLAssertIsNetworkQueue();
+    TNLAssertIsNetworkLane(_networkLane);
     if (self.URLSessionTaskOperation != taskOp || [self _network_hasFailedOrFinished]) {
         return;
     }
@@ -1001,6 +1111,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
     TNLRequestOperationState state = atomic_load(&_state);
     if (TNLRequestOperationStateStarting == state) {
         [_metrics updateCurrentRequest:request];
+        [self _network_startHedgeTimerIfNeeded];
     }
 }
 
@@ -1046,7 +1157,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
     // Clear our cached delegate class name so that we don't warn about the delegate being nil.
     self.cachedDelegateClassName = nil;
 
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         if (self->_cachedCancelError || [self _network_hasFailedOrFinished]) {
             return;
         }
@@ -1054,6 +1165,10 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
         NSError *error = TNLErrorFromCancelSource(source, optionalUnderlyingError);
         self->_cachedCancelError = error;
         [self _network_fail:error];
+        if (self->_backgroundFlags.didEnqueue && !self->_backgroundFlags.didStart) {
+            // don't make a cancelled operation wait its turn for admission
+            [TNLRequestOperationQueue expediteAdmissionOfRequestOperation:self];
+        }
     });
 }
 
@@ -1092,7 +1207,7 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
 
 - (void)start
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         TNLAssert(!self->_backgroundFlags.didStart);
         TNLAssert(self->_backgroundFlags.didEnqueue);
         TNLAssert(self->_requestOperationQueue);
@@ -1103,17 +1218,17 @@ TNLStaticAssert(sizeof(TNLRequestOperationState_Unaligned_AtomicT) == sizeof(TNL
             return;
         }
 
-        [self _network_prepareToStart];
-
-        self->_backgroundFlags.didStart = YES;
-        [self->_requestOperationQueue operationDidStart:self];
-        [self _network_startOperationTimeoutTimer:self->_requestConfiguration.operationTimeout];
-        TNLAssert(self->_metrics.attemptCount == 0);
-
-        if (self->_cachedCancelError) {
-            [self _network_fail:self->_cachedCancelError];
-        } else {
-            [self _network_start:NO /*isRetry*/];
+        // wait for the global admission scheduler (dependencies are satisfied at this point)
+        const BOOL admitted = [TNLRequestOperationQueue admitRequestOperation:self
+                                                                         host:self.originalRequest.URL.host
+                                                                     priority:self.internalPriority
+                                                                        block:^{
+            tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
+                [self _network_startAfterAdmission];
+            });
+        }];
+        if (admitted) {
+            [self _network_startAfterAdmission];
         }
     });
 }
@@ -1219,7 +1334,7 @@ static void _network_prepStep_hydrateRequest(TNLRequestOperation * __nullable co
                                 completion:^(id<TNLRequest> hydratedRequest, NSError *error) {
                 [self _clearTag:tag];
 
-                tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+                tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
                     if (![self _network_isPreparing]) {
                         return;
                     }
@@ -1233,7 +1348,7 @@ static void _network_prepStep_hydrateRequest(TNLRequestOperation * __nullable co
                 });
             }];
         } else {
-            tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+            tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
                 self.hydratedRequest = originalRequest;
                 nextBlock();
             });
@@ -1286,6 +1401,7 @@ static void _network_prepStep_convertHydratedRequestToScratchURLRequest(TNLReque
 
     self->_scratchURLRequest = mURLRequest;
     self->_scratchURLRequestEncodeLatency = 0;
+    self->_scratchURLRequestEncodeQueueLatency = 0;
     self->_scratchURLRequestOriginalBodyLength = 0;
     self->_scratchURLRequestEncodedBodyLength = 0;
     nextBlock();
@@ -1525,19 +1641,24 @@ static void _network_prepStep_applyContentEncodingToScratchURLRequest(TNLRequest
         return;
     }
 
-    // Jump to coding queue
-    tnl_dispatch_async_autoreleasing(tnl_coding_queue(), ^{
+    // Jump to coding lane
+    if (!self->_codingLane) {
+        self->_codingLane = tnl_coding_lane_create();
+    }
+    const uint64_t enqueueMachTime = mach_absolute_time();
+    tnl_dispatch_async_autoreleasing(self->_codingLane, ^{
 
         // Do encoding
         const uint64_t startMachTime = mach_absolute_time();
+        const NSTimeInterval encodeQueueLatency = TNLComputeDuration(enqueueMachTime, startMachTime);
         NSError *encoderError;
         NSData *encodedData = [encoder tnl_encodeHTTPBody:body error:&encoderError];
         const NSTimeInterval encodeLatency = TNLComputeDuration(startMachTime, mach_absolute_time());
         const BOOL skipEncoding = (encoderError.code == TNLContentEncodingErrorCodeSkipEncoding) &&
                                   [encoderError.domain isEqualToString:TNLContentEncodingErrorDomain];
 
-        // Back to network queue
-        tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+        // Back to network lane
+        tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
 
             // Error?
             if (!encodedData && !skipEncoding) {
@@ -1555,6 +1676,7 @@ static void _network_prepStep_applyContentEncodingToScratchURLRequest(TNLRequest
                 self->_scratchURLRequest.HTTPBody = encodedData;
                 [self->_scratchURLRequest setValue:encoderType forHTTPHeaderField:@"Content-Encoding"];
                 self->_scratchURLRequestEncodeLatency = encodeLatency;
+                self->_scratchURLRequestEncodeQueueLatency = encodeQueueLatency;
                 self->_scratchURLRequestOriginalBodyLength = (SInt64)originalLength;
                 self->_scratchURLRequestEncodedBodyLength = (SInt64)encodedLength;
 #if DEBUG
@@ -1585,7 +1707,7 @@ static void _network_prepStep_sanitizeHostForScratchURLRequest(TNLRequestOperati
            wasEncounteredForURLRequest:[self->_scratchURLRequest copy]
                             asRedirect:NO
                             completion:^(TNLHostSanitizerBehavior behavior, NSString *newHost) {
-            tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+            tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
                 TNLAssert([host isEqualToString:self->_scratchURLRequest.URL.host]);
                 NSError *error = nil;
                 const TNLHostReplacementResult hostReplacementResult = [self->_scratchURLRequest tnl_replaceURLHost:newHost
@@ -1632,7 +1754,7 @@ static void _network_prepStep_authorizeScratchURLRequest(TNLRequestOperation * _
                               completion:^(NSString *authHeader, NSError *error) {
             [self _clearTag:tag];
 
-            tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+            tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
                 if (![self _network_isPreparing]) {
                     return;
                 }
@@ -1679,6 +1801,9 @@ static void _network_prepStep_cementScratchURLRequest(TNLRequestOperation * __nu
     TNLAssert([self _network_isPreparing]);
 
     TNLAssertMessage(self.URLSessionTaskOperation == nil, @"Already have a TNLURLSessionTaskOperation? state = %@", TNLRequestOperationStateToString(self.state));
+    TNLAssert(_hedgeURLSessionTaskOperation == nil);
+    _backgroundFlags.didHedgeAttempt = NO;
+    _hedgeLatencyStartMachTime = 0;
 
     // Do not update the `.state` here.
     // The `.URLSessionTaskOperation` will update to `TNLRequestOperationStateStarting` once it starts
@@ -1686,7 +1811,7 @@ static void _network_prepStep_cementScratchURLRequest(TNLRequestOperation * __nu
 
     [self.requestOperationQueue findURLSessionTaskOperationForRequestOperation:self
                                                                       complete:^(TNLURLSessionTaskOperation *taskOp) {
-        tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+        tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
             [self _network_startURLSessionTaskOperation:taskOp isRetry:isRetry];
         });
     }];
@@ -1695,12 +1820,27 @@ static void _network_prepStep_cementScratchURLRequest(TNLRequestOperation * __nu
 - (void)_network_startURLSessionTaskOperation:(TNLURLSessionTaskOperation *)taskOp
                                       isRetry:(BOOL)isRetry
 {
+    const BOOL isCoalesced = (taskOp.requestOperation != self);
     if ([self _network_hasFailedOrFinished]) {
+        [taskOp dissassociateRequestOperation:self];
+        if (!isCoalesced) {
+            // other request operations may have already coalesced onto the task operation,
+            // enqueue it anyway: it runs for them, or cancels itself (releasing its coalescing
+            // entry) when there are none
+            [taskOp enqueueToOperationQueueIfNeeded:self.requestOperationQueue];
+        }
         return;
     }
 
     self.URLSessionTaskOperation = taskOp;
 
+    if (isCoalesced) {
+        // coalesced with an identical request that is already in flight,
+        // the task operation is (or will be) enqueued by the request operation that created it
+        [taskOp coalescedRequestOperationDidAttach:self];
+        return;
+    }
+
     id<TNLRequestEventHandler> eventHandler = self.internalDelegate;
     SEL callback = @selector(tnl_requestOperation:readyToEnqueueUnderlyingNetworkingOperation:enqueueBlock:);
     if (![eventHandler respondsToSelector:callback]) {
@@ -1722,8 +1862,8 @@ static void _network_prepStep_cementScratchURLRequest(TNLRequestOperation * __nu
                     [taskOp addDependency:op];
                 }
             }
-            // dispatch to network queue to start the op
-            tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+            // dispatch to network lane to start the op
+            tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
                 [taskOp enqueueToOperationQueueIfNeeded:self.requestOperationQueue];
             });
         }];
@@ -1858,6 +1998,31 @@ static void _network_prepStep_cementScratchURLRequest(TNLRequestOperation * __nu
     }
 }
 
+- (void)_network_startAfterAdmission
+{
+    TNLAssertIsNetworkLane(_networkLane);
+    TNLAssert(!_backgroundFlags.didStart);
+
+    if ([self _network_hasFailedOrFinished]) {
+        // failed while waiting for admission
+        [TNLRequestOperationQueue requestOperationDidFinishAdmission:self];
+        return;
+    }
+
+    [self _network_prepareToStart];
+
+    _backgroundFlags.didStart = YES;
+    [_requestOperationQueue operationDidStart:self];
+    [self _network_startOperationTimeoutTimer:_requestConfiguration.operationTimeout];
+    TNLAssert(_metrics.attemptCount == 0);
+
+    if (_cachedCancelError) {
+        [self _network_fail:_cachedCancelError];
+    } else {
+        [self _network_start:NO /*isRetry*/];
+    }
+}
+
 - (void)_network_start:(BOOL)isRetry
 {
     if ([self _network_hasFailedOrFinished]) {
@@ -1875,7 +2040,7 @@ static void _network_prepStep_cementScratchURLRequest(TNLRequestOperation * __nu
     [self _network_startAttemptTimeoutTimer:_requestConfiguration.attemptTimeout];
 
     // add to queue in case there are existing executions backed up
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         [self _network_prepareToConnectThenConnect:isRetry];
     });
 }
@@ -1932,10 +2097,13 @@ static void _network_prepStep_cementScratchURLRequest(TNLRequestOperation * __nu
             }
         }
 
-        if (TNLRequestOperationStateIsFinal(state)) {
+        if (TNLRequestOperationStateRunning == state) {
+            [self _network_attemptDidReceiveResponse];
+        } else if (TNLRequestOperationStateIsFinal(state)) {
             // Finished the attempt
             // we are done with the attempt timer (for now)
             [self _network_invalidateAttemptTimeoutTimer];
+            [self _network_abandonHedgeWithError:nil];
         }
 
         // either start the retry or complete the state transition
@@ -2003,6 +2171,7 @@ static void _network_prepStep_cementScratchURLRequest(TNLRequestOperation * __nu
     }
     if (finishedDidChange) {
         [self didChangeValueForKey:@"isFinished"];
+        [TNLRequestOperationQueue requestOperationDidFinishAdmission:self];
     }
 
     // Log the transition
@@ -2084,6 +2253,7 @@ static void _network_prepStep_cementScratchURLRequest(TNLRequestOperation * __nu
                 [_metrics addInitialStartWithDate:dateNow
                                          machTime:machTime
                                           request:request];
+                [TNLRequestOperationQueue retryBudgetRequestOperationDidStart:self];
                 [self.requestOperationQueue operation:self
                            didStartAttemptWithMetrics:_metrics.attemptMetrics.lastObject];
             } else {
@@ -2178,7 +2348,7 @@ static void _network_prepStep_cementScratchURLRequest(TNLRequestOperation * __nu
             [self _clearTag:tag];
         }
         [self _finalizeCompletion]; // finalize from the completion queue
-        tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+        tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
             [self _network_endBackgroundTask];
         });
     };
@@ -2351,6 +2521,8 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
                                           metadata:(nullable TNLAttemptMetaData *)metadata
                                        taskMetrics:(nullable NSURLSessionTaskMetrics *)taskMetrics
 {
+    // a hedge still racing at this point lost, record it before the metrics are copied into the response
+    [self _network_abandonHedgeWithError:nil];
     [self _network_applyEncodingMetricsToInfo:responseInfo withMetaData:metadata];
     [_metrics addMetaData:metadata taskMetrics:taskMetrics];
 
@@ -2422,6 +2594,7 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
             metadata.requestContentLength = _scratchURLRequestEncodedBodyLength;
             metadata.requestOriginalContentLength = _scratchURLRequestOriginalBodyLength;
             metadata.requestEncodingLatency = _scratchURLRequestEncodeLatency;
+            metadata.requestEncodingQueueLatency = _scratchURLRequestEncodeQueueLatency;
         }
     }
 }
@@ -2622,6 +2795,23 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
 
             // Only retry if the attempt won't be too far into the future
             if (!hasOperationTimeout || ((elapsedTime + retryDelay) < operationTimeout)) {
+
+                // Only retry if the global retry budget permits it,
+                // a cancelled operation won't retry so it neither withdraws from the budget nor counts as denied
+                if (!hasCachedCancel && ![TNLRequestOperationQueue retryBudgetWithdrawRetryForRequestOperation:self]) {
+                    NSError *budgetError = TNLErrorCreateWithCodeAndUnderlyingError(TNLErrorCodeRequestOperationRetryBudgetExhausted, attemptResponse.operationError);
+                    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
+                        self->_backgroundFlags.inRetryCheck = NO;
+                        if ([self _network_hasFailedOrFinished]) {
+                            return;
+                        }
+
+                        // a cancel that arrived while checking the budget takes precedence
+                        [self _network_fail:self->_cachedCancelError ?: budgetError];
+                    });
+                    return;
+                }
+
                 TNLLogDebug(@"Retry will start in %.3f seconds", retryDelay);
 
                 NSTimeInterval newOperationTimeout = -1.0; // negative won't update timeout
@@ -2644,7 +2834,7 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
         }
 
         // won't retry
-        tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+        tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
             self->_backgroundFlags.inRetryCheck = NO;
             if ([self _network_isStateFinished]) {
                 return;
@@ -2726,7 +2916,7 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
         }
     }
 
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         self->_backgroundFlags.inRetryCheck = NO;
         if ([self _network_hasFailedOrFinished]) {
             return;
@@ -2777,7 +2967,7 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
             }
 
             // Finish with dispatch to background queue to start retry timer
-            tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+            tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
                 [self _network_startRetryWithDelay:retryDelay
                                        oldResponse:attemptResponse
                                retryPolicyProvider:retryPolicyProvider];
@@ -2817,11 +3007,12 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
 
     // Set up operation to gate the retry on
     NSOperation *retryDependencyOperation = [[TNLSafeOperation alloc] init];
+    dispatch_queue_t networkLane = _networkLane;
     retryDependencyOperation.completionBlock = ^{
-        if (dispatch_queue_get_label(tnl_network_queue()) == dispatch_queue_get_label(DISPATCH_CURRENT_QUEUE_LABEL)) {
+        if (tnl_network_lane_is_current(networkLane)) {
             tryRetryBlock();
         } else {
-            dispatch_async(tnl_network_queue(), tryRetryBlock);
+            dispatch_async(networkLane, tryRetryBlock);
         }
     };
 
@@ -2834,7 +3025,7 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
     if (retryDelay >= MIN_TIMER_INTERVAL) {
         // the retry delay is concurrent with the other dependencies, so it doesn't need the other
         // dependencies itself and simply be added to our dependency operation
-        NSOperation *delayOp = [[TNLTimerOperation alloc] initWithDelay:retryDelay];
+        NSOperation *delayOp = [[TNLTimerOperation alloc] initWithDelay:retryDelay queue:networkLane];
         [retryDependencyOperation addDependency:delayOp];
         [TNLNetworkOperationQueue() addOperation:delayOp];
     }
@@ -2865,7 +3056,7 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
 {
     if (!_operationTimeoutTimerSource && timeInterval >= MIN_TIMER_INTERVAL) {
         __weak typeof(self) weakSelf = self;
-        _operationTimeoutTimerSource = tnl_dispatch_timer_create_and_start(tnl_network_queue(),
+        _operationTimeoutTimerSource = tnl_dispatch_timer_create_and_start(self->_networkLane,
                                                                            timeInterval,
                                                                            TIMER_LEEWAY_WITH_FIRE_INTERVAL(timeInterval),
                                                                            NO /*repeats*/,
@@ -2921,7 +3112,7 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
 #endif // IOS + TV
 
         __weak typeof(self) weakSelf = self;
-        _callbackTimeoutTimerSource = tnl_dispatch_timer_create_and_start(tnl_network_queue(),
+        _callbackTimeoutTimerSource = tnl_dispatch_timer_create_and_start(self->_networkLane,
                                                                           _cloggedCallbackTimeout - alreadyElapsedTime,
                                                                           TIMER_LEEWAY_WITH_FIRE_INTERVAL(_cloggedCallbackTimeout),
                                                                           NO /*repeats*/,
@@ -2982,7 +3173,7 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
 {
     if (!_attemptTimeoutTimerSource && timeInterval >= MIN_TIMER_INTERVAL) {
         __weak typeof(self) weakSelf = self;
-        _attemptTimeoutTimerSource = tnl_dispatch_timer_create_and_start(tnl_network_queue(),
+        _attemptTimeoutTimerSource = tnl_dispatch_timer_create_and_start(self->_networkLane,
                                                                          timeInterval,
                                                                          TIMER_LEEWAY_WITH_FIRE_INTERVAL(timeInterval),
                                                                          NO /*repeats*/,
@@ -3013,6 +3204,224 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
     }
 }
 
+#pragma mark Hedging
+
+- (BOOL)_network_canHedge
+{
+    if (_requestConfiguration.hedgeDelayPercentile <= 0.0) {
+        return NO;
+    }
+    if (TNLRequestExecutionModeBackground == _requestConfiguration.executionMode) {
+        return NO;
+    }
+    if (_requestConfiguration.coalescesIdenticalRequests) {
+        return NO;
+    }
+
+    // only hedge what would be safe to retry
+    id<TNLRequestRetryPolicyProvider> retryPolicyProvider = _requestConfiguration.retryPolicyProvider;
+    TNLRequestRetryPolicyConfiguration *retryConfig = nil;
+    if ([retryPolicyProvider conformsToProtocol:@protocol(TNLConfiguringRetryPolicyProvider)]) {
+        retryConfig = [(id<TNLConfiguringRetryPolicyProvider>)retryPolicyProvider configuration];
+    }
+    if (!retryConfig) {
+        retryConfig = [TNLRequestRetryPolicyConfiguration defaultConfiguration];
+    }
+    NSString *method = self.hydratedURLRequest.HTTPMethod ?: @"GET";
+    return [retryConfig methodCanBeRetried:TNLHTTPMethodFromString(method)];
+}
+
+- (void)_network_startHedgeTimerIfNeeded
+{
+    if (_hedgeTimerSource || _backgroundFlags.didHedgeAttempt) {
+        return;
+    }
+    _backgroundFlags.didHedgeAttempt = YES;
+
+    if (![self _network_canHedge]) {
+        return;
+    }
+
+    NSString *host = self.hydratedURLRequest.URL.host.lowercaseString;
+    if (!host) {
+        return;
+    }
+
+    _hedgeLatencyStartMachTime = mach_absolute_time();
+
+    NSTimeInterval delay = _requestConfiguration.hedgeMinimumDelay;
+    const NSTimeInterval percentileLatency = _HedgeResponseLatencyPercentile(host, _requestConfiguration.hedgeDelayPercentile);
+    if (percentileLatency > delay) {
+        delay = percentileLatency;
+    }
+    if (delay <= 0.0) {
+        // not enough latencies to go on yet
+        return;
+    }
+
+    __weak typeof(self) weakSelf = self;
+    _hedgeTimerSource = tnl_dispatch_timer_create_and_start(self->_networkLane,
+                                                            delay,
+                                                            TIMER_LEEWAY_WITH_FIRE_INTERVAL(delay),
+                                                            NO /*repeats*/,
+                                                            ^{
+        [weakSelf _network_hedgeTimerDidFire];
+    });
+}
+
+- (void)_network_invalidateHedgeTimer
+{
+    tnl_dispatch_timer_invalidate(_hedgeTimerSource);
+    _hedgeTimerSource = NULL;
+}
+
+- (void)_network_hedgeTimerDidFire
+{
+    if (!_hedgeTimerSource) {
+        return;
+    }
+
+    [self _network_invalidateHedgeTimer];
+    if ([self _network_hasFailedOrFinished] || TNLRequestOperationStateStarting != atomic_load(&_state)) {
+        return;
+    }
+
+    TNLURLSessionTaskOperation *primaryOp = self.URLSessionTaskOperation;
+    if (!primaryOp || _hedgeURLSessionTaskOperation) {
+        return;
+    }
+
+    TNLLogInformation(@"%@::_network_hedgeTimerDidFire", self);
+
+    _hedgeStartDate = [NSDate date];
+    _hedgeStartMachTime = mach_absolute_time();
+    [self.requestOperationQueue createHedgeURLSessionTaskOperationForRequestOperation:self
+                                                                            complete:^(TNLURLSessionTaskOperation *hedgeOp) {
+        tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
+            [self _network_startHedgeURLSessionTaskOperation:hedgeOp
+                              primaryURLSessionTaskOperation:primaryOp];
+        });
+    }];
+}
+
+- (void)_network_startHedgeURLSessionTaskOperation:(TNLURLSessionTaskOperation *)hedgeOp
+                    primaryURLSessionTaskOperation:(TNLURLSessionTaskOperation *)primaryOp
+{
+    if ([self _network_hasFailedOrFinished] || self.URLSessionTaskOperation != primaryOp || TNLRequestOperationStateStarting != atomic_load(&_state)) {
+        // the primary attempt moved on while the hedge was being created
+        [hedgeOp dissassociateRequestOperation:self];
+        return;
+    }
+
+    _hedgeURLSessionTaskOperation = hedgeOp;
+    [hedgeOp enqueueToOperationQueueIfNeeded:self.requestOperationQueue];
+}
+
+- (void)_network_hedgeURLSessionTaskOperation:(TNLURLSessionTaskOperation *)hedgeOp
+                         didTransitionToState:(TNLRequestOperationState)state
+                                 withResponse:(nullable TNLResponse *)response
+{
+    TNLAssert(hedgeOp == _hedgeURLSessionTaskOperation);
+    if ([self _network_hasFailedOrFinished]) {
+        [self _network_abandonHedgeWithError:nil];
+    } else if (TNLRequestOperationStateRunning == state) {
+        // the hedge received its response first
+        TNLAssert(TNLRequestOperationStateStarting == atomic_load(&_state));
+        [self _network_promoteHedgeURLSessionTaskOperation];
+    } else if (TNLRequestOperationStateIsFinal(state)) {
+        // the hedge finished without a response, the primary attempt carries on
+        [self _network_abandonHedgeWithError:response.operationError];
+    }
+}
+
+- (void)_network_promoteHedgeURLSessionTaskOperation
+{
+    TNLURLSessionTaskOperation *hedgeOp = _hedgeURLSessionTaskOperation;
+    _hedgeURLSessionTaskOperation = nil;
+    [self _network_invalidateHedgeTimer];
+
+    NSDate *dateNow = [NSDate date];
+    const uint64_t machTime = mach_absolute_time();
+    NSURLRequest *request = self.hydratedURLRequest;
+    NSError *hedgedError = TNLErrorCreateWithCode(TNLErrorCodeRequestOperationCancelled);
+
+    // Complete the losing attempt
+
+    [_metrics addEndDate:dateNow
+                machTime:machTime
+                response:nil
+          operationError:hedgedError];
+    TNLResponseMetrics *metrics = [_metrics deepCopyAndTrimIncompleteAttemptMetrics:YES];
+    TNLResponseInfo *info = [[TNLResponseInfo alloc] initWithFinalURLRequest:request
+                                                                 URLResponse:nil
+                                                                      source:TNLResponseSourceNetworkRequest
+                                                                        data:nil
+                                                          temporarySavedFile:nil];
+    TNLResponse *placeholderResponse = [self.responseClass responseWithRequest:self.originalRequest
+                                                                operationError:hedgedError
+                                                                          info:info
+                                                                       metrics:metrics];
+
+    // Start the hedge attempt from when it actually started
+
+    [self willChangeValueForKey:@"attemptCount"];
+    [_metrics addHedgeStartWithDate:_hedgeStartDate
+                           machTime:_hedgeStartMachTime
+                            request:request];
+    [self didChangeValueForKey:@"attemptCount"];
+    _hedgeLatencyStartMachTime = _hedgeStartMachTime;
+
+    [self _network_didCompleteAttemptWithResponse:placeholderResponse
+                                      disposition:TNLAttemptCompleteDispositionHedged];
+    [self.requestOperationQueue operation:self
+               didStartAttemptWithMetrics:_metrics.attemptMetrics.lastObject];
+
+    TNLLogInformation(@"%@ hedged %@ with %@", self, self.URLSessionTaskOperation, hedgeOp);
+
+    // swapping the task operation dissassociates the loser, which cancels it
+    self.URLSessionTaskOperation = hedgeOp;
+}
+
+- (void)_network_abandonHedgeWithError:(nullable NSError *)error
+{
+    [self _network_invalidateHedgeTimer];
+
+    TNLURLSessionTaskOperation *hedgeOp = _hedgeURLSessionTaskOperation;
+    if (!hedgeOp) {
+        return;
+    }
+
+    _hedgeURLSessionTaskOperation = nil;
+    [self willChangeValueForKey:@"attemptCount"];
+    [_metrics addAbandonedHedgeWithStartDate:_hedgeStartDate
+                               startMachTime:_hedgeStartMachTime
+                                     endDate:[NSDate date]
+                                 endMachTime:mach_absolute_time()
+                                     request:self.hydratedURLRequest
+                              operationError:error ?: TNLErrorCreateWithCode(TNLErrorCodeRequestOperationCancelled)];
+    [self didChangeValueForKey:@"attemptCount"];
+
+    // dissassociating cancels the hedge
+    [hedgeOp dissassociateRequestOperation:self];
+}
+
+- (void)_network_attemptDidReceiveResponse
+{
+    // sample the latency of whichever attempt responded (primary or promoted hedge),
+    // but not a redirect since the attempt continues with the redirected request
+    const BOOL isRedirect = TNLHTTPStatusCodeIsRedirection(self.URLSessionTaskOperation.URLResponse.statusCode);
+    if (_hedgeLatencyStartMachTime && !isRedirect) {
+        NSString *host = self.hydratedURLRequest.URL.host.lowercaseString;
+        if (host) {
+            _HedgeRecordResponseLatency(host, TNLComputeDuration(_hedgeLatencyStartMachTime, mach_absolute_time()));
+        }
+        _hedgeLatencyStartMachTime = 0;
+    }
+
+    // the primary attempt responded first
+    [self _network_abandonHedgeWithError:nil];
+}
+
 #pragma mark Background (iOS)
 
 - (void)_noop TNL_OBJC_DIRECT
@@ -3027,7 +3436,7 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
         // capture self
         [self _noop];
     }];
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         [self _network_willResignActive];
         [config endBackgroundTaskWithIdentifier:taskID];
     });
@@ -3035,7 +3444,7 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
 
 - (void)_private_didBecomeActive:(NSNotification *)note
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         [self _network_didBecomeActive];
     });
 }
@@ -3108,7 +3517,7 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
 
     _backgroundTaskIdentifier = [[TNLGlobalConfiguration sharedInstance] startBackgroundTaskWithName:@"tnl.request.op"
                                                                                    expirationHandler:^{
-        dispatch_sync(tnl_network_queue(), ^{
+        dispatch_sync(self->_networkLane, ^{
             self->_backgroundTaskIdentifier = TNLBackgroundTaskInvalid;
         });
     }];
@@ -3199,7 +3608,7 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
 
 - (void)_updateTag:(NSString *)tag
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         if (!self->_mach_callbackTagTime) {
             self->_mach_callbackTagTime = mach_absolute_time();
         }
@@ -3210,7 +3619,7 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
 
 - (void)_clearTag:(NSString *)tag
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         [self->_callbackTagStack removeObject:tag];
         if (self->_callbackTagStack.count == 0) {
             self->_mach_callbackTagTime = 0;
@@ -3226,14 +3635,16 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
 @implementation TNLTimerOperation
 {
     NSTimeInterval _delay;
+    dispatch_queue_t _queue;
     volatile atomic_bool _finished;
     volatile atomic_bool _executing;
 }
 
-- (instancetype)initWithDelay:(NSTimeInterval)delay
+- (instancetype)initWithDelay:(NSTimeInterval)delay queue:(dispatch_queue_t)queue
 {
     if (self = [self init]) {
         _delay = delay;
+        _queue = queue;
     }
     return self;
 }
@@ -3264,7 +3675,7 @@ static NSDictionary<NSString *, NSString *> *_redactHeaderFields(NSDictionary *h
 
 - (void)run
 {
-    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(_delay * NSEC_PER_SEC)), tnl_network_queue(), ^{
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(_delay * NSEC_PER_SEC)), _queue, ^{
         [self completeOperation];
     });
 }
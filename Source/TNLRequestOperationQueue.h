@@ -171,6 +171,87 @@ FOUNDATION_EXTERN NSString * const TNLBackgroundRequestURLSessionSharedContainer
 
 @end
 
+/**
+ __TNLRequestOperationAdmissionStatistics__
+
+ A snapshot of the global admission scheduler that all `TNLRequestOperation` instances pass
+ through once their dependencies are satisfied.
+
+ Admission is limited by `[TNLGlobalConfiguration maximumConcurrentRequestOperationCount]` and
+ `[TNLGlobalConfiguration maximumConcurrentRequestOperationCountPerHost]`.
+ Queued operations are admitted with weighted fair queuing across the five `TNLPriority` levels
+ (each level getting twice the share of the level below it) and operations that have waited longer
+ than `[TNLGlobalConfiguration requestOperationAdmissionAgingInterval]` are admitted first.
+ */
+@interface TNLRequestOperationAdmissionStatistics : NSObject
+
+/** number of operations waiting to be admitted */
+@property (nonatomic, readonly) NSUInteger queuedOperationCount;
+/** number of operations currently admitted (running) */
+@property (nonatomic, readonly) NSUInteger admittedOperationCount;
+/** total number of operations admitted since launch */
+@property (nonatomic, readonly) NSUInteger totalAdmittedOperationCount;
+/** total time operations have spent waiting for admission since launch */
+@property (nonatomic, readonly) NSTimeInterval totalWaitTime;
+/** longest time an operation has spent waiting for admission since launch */
+@property (nonatomic, readonly) NSTimeInterval maximumWaitTime;
+/** average time an operation spends waiting for admission */
+@property (nonatomic, readonly) NSTimeInterval averageWaitTime;
+
+/** number of operations waiting to be admitted at the given _priority_ */
+- (NSUInteger)queuedOperationCountForPriority:(TNLPriority)priority;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+@end
+
+/**
+ __TNLRequestOperationQueue (Admission)__
+
+ Introspection of the global admission scheduler
+ */
+@interface TNLRequestOperationQueue (Admission)
+
+/** Snapshot the global admission scheduler. See `TNLRequestOperationAdmissionStatistics` */
++ (TNLRequestOperationAdmissionStatistics *)admissionStatistics;
+
+@end
+
+/**
+ __TNLRequestOperationRetryBudgetStatistics__
+
+ A snapshot of the global retry budget, see `[TNLGlobalConfiguration retryBudgetRatio]`.
+ Counts are over the current `[TNLGlobalConfiguration retryBudgetWindow]`.
+ */
+@interface TNLRequestOperationRetryBudgetStatistics : NSObject
+
+/** number of operations that started in the window */
+@property (nonatomic, readonly) NSUInteger requestCount;
+/** number of retries that started in the window */
+@property (nonatomic, readonly) NSUInteger retryCount;
+/** number of retries the budget would permit right now, `NSUIntegerMax` when there is no budget */
+@property (nonatomic, readonly) NSUInteger availableRetryCount;
+/** total number of retries denied since launch (see `TNLErrorCodeRequestOperationRetryBudgetExhausted`) */
+@property (nonatomic, readonly) NSUInteger totalDeniedRetryCount;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+@end
+
+/**
+ __TNLRequestOperationQueue (RetryBudget)__
+
+ Introspection of the global retry budget
+ */
+@interface TNLRequestOperationQueue (RetryBudget)
+
+/** Snapshot the global retry budget. See `TNLRequestOperationRetryBudgetStatistics` */
++ (TNLRequestOperationRetryBudgetStatistics *)retryBudgetStatistics;
+
+@end
+
 #if TARGET_OS_IPHONE // == IOS + WATCH + TV
 /**
  __TNLRequestOperationQueue (Background)__
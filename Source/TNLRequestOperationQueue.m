@@ -7,6 +7,7 @@
 //
 
 #include <objc/message.h>
+#include <os/lock.h>
 #include <stdatomic.h>
 
 #import "NSURLResponse+TNLAdditions.h"
@@ -23,6 +24,8 @@
 #import "TNLRequestOperation_Project.h"
 #import "TNLRequestOperationQueue_Project.h"
 #import "TNLResponse.h"
+#import "TNLSafeOperation.h"
+#import "TNLTiming.h"
 #import "TNLURLSessionTaskOperation.h"
 
 NS_ASSUME_NONNULL_BEGIN
@@ -40,7 +43,63 @@ static volatile atomic_int_fast64_t __attribute__((aligned(8))) sGlobalExecuting
 static NSMapTable<NSString *, TNLRequestOperationQueue *> *sGlobalRequestOperationQueueMapTable = nil;
 static NSMutableSet<id<TNLNetworkObserver>> *sGlobalNetworkObservers = nil;
 static NSOperationQueue *sGlobalRequestOperationQueue = nil;
-static NSHashTable<TNLRequestOperation *> *sGlobalAutoDependencyOperations = nil;
+
+// Auto dependencies are gated by "epoch":
+// high priority operations join the open epoch, and a low priority operation depends on the gate
+// operation of the latest epoch, closing it so that high priority operations enqueued afterwards
+// start a new epoch (and don't hold up the low priority operation).
+// Each gate depends on the gate of the epoch before it and is enqueued (and thus finishes) once the
+// last high priority operation of its own epoch finishes, so a gate finishes only once every high
+// priority operation enqueued before it was closed has finished.
+@class TNLAutoDependencyEpoch;
+static volatile atomic_int_fast64_t __attribute__((aligned(8))) sGlobalAutoDependencyInFlightCount = ATOMIC_VAR_INIT(0);
+static os_unfair_lock sGlobalAutoDependencyGateLock = OS_UNFAIR_LOCK_INIT;
+// guarded by sGlobalAutoDependencyGateLock
+static TNLAutoDependencyEpoch *sGlobalAutoDependencyOpenEpoch = nil;
+static NSOperation *sGlobalAutoDependencyLatestGate = nil;
+
+// Admission is the last gate before an operation starts (after its dependencies are satisfied).
+// Waiting operations are held in one FIFO per TNLPriority level (ordered by enqueue time) and
+// are admitted via weighted round robin across the levels, with aged operations jumping the line.
+#define TNL_ADMISSION_LEVEL_COUNT (5)
+static const NSUInteger kAdmissionLevelWeights[TNL_ADMISSION_LEVEL_COUNT] = { 1, 2, 4, 8, 16 };
+static const NSTimeInterval kAdmissionAgingIntervalDefault = 3.0;
+
+@class TNLAdmissionEntry;
+
+static os_unfair_lock sAdmissionLock = OS_UNFAIR_LOCK_INIT;
+// all guarded by sAdmissionLock
+static NSMutableArray<TNLAdmissionEntry *> *sAdmissionQueues[TNL_ADMISSION_LEVEL_COUNT] = { nil };
+static NSUInteger sAdmissionCredits[TNL_ADMISSION_LEVEL_COUNT] = { 0 };
+static NSMapTable<TNLRequestOperation *, TNLAdmissionEntry *> *sAdmissionQueuedEntries = nil;
+static NSMapTable<TNLRequestOperation *, TNLAdmissionEntry *> *sAdmissionAdmittedEntries = nil;
+static NSCountedSet<NSString *> *sAdmissionAdmittedHosts = nil;
+static NSUInteger sAdmissionGlobalLimit = 0;
+static NSUInteger sAdmissionPerHostLimit = 0;
+static NSTimeInterval sAdmissionAgingInterval = kAdmissionAgingIntervalDefault;
+static NSUInteger sAdmissionTotalAdmittedCount = 0;
+static NSTimeInterval sAdmissionTotalWaitTime = 0;
+static NSTimeInterval sAdmissionMaximumWaitTime = 0;
+
+// The retry budget caps retries at a ratio of the requests started over a sliding window.
+// The window is split into buckets (keyed by their epoch) so that sliding it is just dropping stale buckets.
+#define TNL_RETRY_BUDGET_BUCKET_COUNT (10)
+static const NSTimeInterval kRetryBudgetWindowDefault = 10.0;
+static const NSUInteger kRetryBudgetMinimumRetryCountDefault = 10;
+
+typedef struct {
+    uint64_t epoch; // 0 == unused
+    NSUInteger requestCount;
+    NSUInteger retryCount;
+} TNLRetryBudgetBucket;
+
+static os_unfair_lock sRetryBudgetLock = OS_UNFAIR_LOCK_INIT;
+// all guarded by sRetryBudgetLock
+static TNLRetryBudgetBucket sRetryBudgetBuckets[TNL_RETRY_BUDGET_BUCKET_COUNT] = { { 0, 0, 0 } };
+static double sRetryBudgetRatio = 0.0;
+static NSTimeInterval sRetryBudgetWindow = kRetryBudgetWindowDefault;
+static NSUInteger sRetryBudgetMinimumRetryCount = kRetryBudgetMinimumRetryCountDefault;
+static NSUInteger sRetryBudgetTotalDeniedRetryCount = 0;
 
 //use NSMutableArray instead of NSMutableOrderedSet as it avoids an expensive class load when accessed during +(void)load,
 //which for a collection with only a few elements and a few lookups is a worthwhile tradeoff
@@ -68,33 +127,84 @@ static void _GlobalEnqueueOperation(NSOperation *op)
     }
 }
 
-static NSArray<TNLRequestOperation *> * __nullable _GlobalAutoDependencyOperations(void);
-static NSArray<TNLRequestOperation *> * __nullable _GlobalAutoDependencyOperations()
+TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
+@interface TNLAutoDependencyEpoch : NSObject
 {
-    __block NSArray<TNLRequestOperation *> *ops = nil;
-    tnl_dispatch_sync_autoreleasing(_GlobalOperationQueueQueue(), ^{
-        ops = [sGlobalAutoDependencyOperations allObjects];
-    });
-    return ops;
+@public
+    NSOperation *_gate;
+    NSUInteger _inFlightCount; // guarded by sGlobalAutoDependencyGateLock
 }
+@end
 
-static void _GlobalAddAutoDependencyOperation(TNLRequestOperation *op);
-static void _GlobalAddAutoDependencyOperation(TNLRequestOperation *op)
+@implementation TNLAutoDependencyEpoch
+@end
+
+static NSOperation * __nullable _GlobalAutoDependencyCloseEpochAndGetGate(void);
+static NSOperation * __nullable _GlobalAutoDependencyCloseEpochAndGetGate()
 {
-    tnl_dispatch_async_autoreleasing(_GlobalOperationQueueQueue(), ^{
-        [sGlobalAutoDependencyOperations addObject:op];
-    });
+    if (atomic_load(&sGlobalAutoDependencyInFlightCount) == 0) {
+        // common case: no high priority operations in flight, no lock needed
+        return nil;
+    }
+
+    NSOperation *gate;
+    os_unfair_lock_lock(&sGlobalAutoDependencyGateLock);
+    gate = sGlobalAutoDependencyLatestGate;
+    // only high priority operations that are already in flight are waited on
+    sGlobalAutoDependencyOpenEpoch = nil;
+    os_unfair_lock_unlock(&sGlobalAutoDependencyGateLock);
+    return gate.isFinished ? nil : gate;
 }
 
-#if 0 // no use case a.t.m.
-static void _GlobalRemoveAutoDependencyOperation(TNLRequestOperation *op);
-static void _GlobalRemoveAutoDependencyOperation(TNLRequestOperation *op)
+static void _GlobalAutoDependencyOperationDidFinish(TNLAutoDependencyEpoch *epoch);
+static void _GlobalAutoDependencyOperationDidFinish(TNLAutoDependencyEpoch *epoch)
 {
-    tnl_dispatch_async_autoreleasing(_GlobalOperationQueueQueue(), ^{
-        [sGlobalAutoDependencyOperations removeObject:op];
-    });
+    NSOperation *gate = nil;
+    os_unfair_lock_lock(&sGlobalAutoDependencyGateLock);
+    atomic_fetch_sub(&sGlobalAutoDependencyInFlightCount, 1);
+    if (--epoch->_inFlightCount == 0) {
+        // last high priority operation of the epoch
+        gate = epoch->_gate;
+        if (sGlobalAutoDependencyOpenEpoch == epoch) {
+            sGlobalAutoDependencyOpenEpoch = nil;
+        }
+    }
+    os_unfair_lock_unlock(&sGlobalAutoDependencyGateLock);
+
+    if (gate) {
+        // enqueuing the gate finishes it (once the prior epoch's gate has finished),
+        // releasing every operation that was waiting on this epoch
+        _GlobalEnqueueOperation(gate);
+    }
+}
+
+static void _GlobalAddAutoDependencyOperation(TNLRequestOperation *op);
+static void _GlobalAddAutoDependencyOperation(TNLRequestOperation *op)
+{
+    os_unfair_lock_lock(&sGlobalAutoDependencyGateLock);
+    TNLAutoDependencyEpoch *epoch = sGlobalAutoDependencyOpenEpoch;
+    if (!epoch) {
+        // start a new epoch, chained to the previous one
+        epoch = [[TNLAutoDependencyEpoch alloc] init];
+        epoch->_gate = [[TNLSafeOperation alloc] init];
+        NSOperation *previousGate = sGlobalAutoDependencyLatestGate;
+        if (previousGate && !previousGate.isFinished) {
+            [epoch->_gate addDependency:previousGate];
+        }
+        sGlobalAutoDependencyLatestGate = epoch->_gate;
+        sGlobalAutoDependencyOpenEpoch = epoch;
+    }
+    epoch->_inFlightCount++;
+    atomic_fetch_add(&sGlobalAutoDependencyInFlightCount, 1);
+    os_unfair_lock_unlock(&sGlobalAutoDependencyGateLock);
+
+    // track when the operation finishes (a single dependency, regardless of how many operations are gated)
+    NSOperation *tracker = [NSBlockOperation blockOperationWithBlock:^{
+        _GlobalAutoDependencyOperationDidFinish(epoch);
+    }];
+    [tracker addDependency:op];
+    _GlobalEnqueueOperation(tracker);
 }
-#endif
 
 static void _GlobalApplyAutoDependenciesToOperation(TNLRequestOperation *op);
 static void _GlobalApplyAutoDependenciesToOperation(TNLRequestOperation *op)
@@ -105,16 +215,252 @@ static void _GlobalApplyAutoDependenciesToOperation(TNLRequestOperation *op)
             // Auto dependency operation encountered!
             _GlobalAddAutoDependencyOperation(op);
         } else {
-            // Add outstanding auto dependency operations as dependencies
-            NSArray<TNLRequestOperation *> *autoDependencies = _GlobalAutoDependencyOperations();
-            if (autoDependencies.count > 0) {
-                TNLLogInformation(@"Marking %@ dependent on %tu higher priority operations", op, autoDependencies.count);
-                for (TNLRequestOperation *depOp in autoDependencies) {
-                    [op addDependency:depOp];
+            // Wait on the outstanding higher priority operations (if any)
+            NSOperation *gate = _GlobalAutoDependencyCloseEpochAndGetGate();
+            if (gate) {
+                TNLLogInformation(@"Marking %@ dependent on %lli higher priority operations", op, (long long)atomic_load(&sGlobalAutoDependencyInFlightCount));
+                [op addDependency:gate];
+            }
+        }
+    }
+}
+
+#pragma mark Admission
+
+TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
+@interface TNLAdmissionEntry : NSObject
+{
+@public
+    TNLRequestOperation *_op;
+    NSString *_host;
+    dispatch_block_t _block;
+    uint64_t _enqueueMachTime;
+    NSUInteger _level;
+}
+@end
+
+@implementation TNLAdmissionEntry
+@end
+
+@interface TNLRequestOperationAdmissionStatistics ()
+- (instancetype)initWithQueuedCounts:(const NSUInteger *)queuedCounts
+                       admittedCount:(NSUInteger)admittedCount
+                  totalAdmittedCount:(NSUInteger)totalAdmittedCount
+                       totalWaitTime:(NSTimeInterval)totalWaitTime
+                     maximumWaitTime:(NSTimeInterval)maximumWaitTime;
+@end
+
+static NSUInteger _AdmissionLevelForPriority(TNLPriority priority);
+static NSUInteger _AdmissionLevelForPriority(TNLPriority priority)
+{
+    if (priority < TNLPriorityVeryLow) {
+        priority = TNLPriorityVeryLow;
+    } else if (priority > TNLPriorityVeryHigh) {
+        priority = TNLPriorityVeryHigh;
+    }
+    return (NSUInteger)(priority - TNLPriorityVeryLow);
+}
+
+static void _AdmissionPrepare_locked(void);
+static void _AdmissionPrepare_locked()
+{
+    if (!sAdmissionQueuedEntries) {
+        for (NSUInteger level = 0; level < TNL_ADMISSION_LEVEL_COUNT; level++) {
+            sAdmissionQueues[level] = [[NSMutableArray alloc] init];
+            sAdmissionCredits[level] = kAdmissionLevelWeights[level];
+        }
+        sAdmissionQueuedEntries = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                                        valueOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality];
+        sAdmissionAdmittedEntries = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                                          valueOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality];
+        sAdmissionAdmittedHosts = [[NSCountedSet alloc] init];
+    }
+}
+
+static void _AdmissionInsertEntry_locked(TNLAdmissionEntry *entry);
+static void _AdmissionInsertEntry_locked(TNLAdmissionEntry *entry)
+{
+    // keep each level ordered by enqueue time (re-prioritized entries retain their place in line)
+    NSMutableArray<TNLAdmissionEntry *> *queue = sAdmissionQueues[entry->_level];
+    NSUInteger index = queue.count;
+    while (index > 0 && queue[index - 1]->_enqueueMachTime > entry->_enqueueMachTime) {
+        index--;
+    }
+    [queue insertObject:entry atIndex:index];
+}
+
+static BOOL _AdmissionCanAdmitHost_locked(NSString * __nullable host);
+static BOOL _AdmissionCanAdmitHost_locked(NSString * __nullable host)
+{
+    return !host || !sAdmissionPerHostLimit || [sAdmissionAdmittedHosts countForObject:host] < sAdmissionPerHostLimit;
+}
+
+static void _AdmissionAdmitEntry_locked(TNLAdmissionEntry *entry, uint64_t machTime);
+static void _AdmissionAdmitEntry_locked(TNLAdmissionEntry *entry, uint64_t machTime)
+{
+    [sAdmissionQueuedEntries removeObjectForKey:entry->_op];
+    [sAdmissionAdmittedEntries setObject:entry forKey:entry->_op];
+    if (entry->_host) {
+        [sAdmissionAdmittedHosts addObject:entry->_host];
+    }
+
+    const NSTimeInterval wait = TNLComputeDuration(entry->_enqueueMachTime, machTime);
+    sAdmissionTotalAdmittedCount++;
+    sAdmissionTotalWaitTime += wait;
+    if (wait > sAdmissionMaximumWaitTime) {
+        sAdmissionMaximumWaitTime = wait;
+    }
+}
+
+static TNLAdmissionEntry * __nullable _AdmissionDequeueNextEntry_locked(uint64_t machTime);
+static TNLAdmissionEntry * __nullable _AdmissionDequeueNextEntry_locked(uint64_t machTime)
+{
+    // find the oldest admissible entry of each level (skipping entries whose host is at its limit)
+    NSUInteger candidateIndexes[TNL_ADMISSION_LEVEL_COUNT];
+    TNLAdmissionEntry *oldest = nil;
+    BOOL hasCandidate = NO;
+    for (NSUInteger level = 0; level < TNL_ADMISSION_LEVEL_COUNT; level++) {
+        candidateIndexes[level] = NSNotFound;
+        NSMutableArray<TNLAdmissionEntry *> *queue = sAdmissionQueues[level];
+        const NSUInteger count = queue.count;
+        for (NSUInteger i = 0; i < count; i++) {
+            TNLAdmissionEntry *entry = queue[i];
+            if (_AdmissionCanAdmitHost_locked(entry->_host)) {
+                candidateIndexes[level] = i;
+                hasCandidate = YES;
+                if (!oldest || entry->_enqueueMachTime < oldest->_enqueueMachTime) {
+                    oldest = entry;
                 }
+                break;
             }
         }
     }
+
+    if (!hasCandidate) {
+        return nil;
+    }
+
+    // aging: an entry that has waited too long is admitted first, regardless of its priority
+    if (sAdmissionAgingInterval > 0 && TNLComputeDuration(oldest->_enqueueMachTime, machTime) >= sAdmissionAgingInterval) {
+        [sAdmissionQueues[oldest->_level] removeObjectAtIndex:candidateIndexes[oldest->_level]];
+        return oldest;
+    }
+
+    // weighted round robin: highest level with credit remaining wins, refill once all candidates are out of credit
+    for (NSUInteger pass = 0; pass < 2; pass++) {
+        for (NSUInteger i = TNL_ADMISSION_LEVEL_COUNT; i > 0; i--) {
+            const NSUInteger level = i - 1;
+            if (candidateIndexes[level] != NSNotFound && sAdmissionCredits[level] > 0) {
+                sAdmissionCredits[level]--;
+                TNLAdmissionEntry *entry = sAdmissionQueues[level][candidateIndexes[level]];
+                [sAdmissionQueues[level] removeObjectAtIndex:candidateIndexes[level]];
+                return entry;
+            }
+        }
+        for (NSUInteger level = 0; level < TNL_ADMISSION_LEVEL_COUNT; level++) {
+            sAdmissionCredits[level] = kAdmissionLevelWeights[level];
+        }
+    }
+
+    TNLAssertNever();
+    return nil;
+}
+
+// admit as many queued entries as permitted, returns the blocks to execute (outside the lock)
+static NSArray<dispatch_block_t> * __nullable _AdmissionPump_locked(void);
+static NSArray<dispatch_block_t> * __nullable _AdmissionPump_locked()
+{
+    if (!sAdmissionQueuedEntries.count) {
+        return nil;
+    }
+
+    NSMutableArray<dispatch_block_t> *blocks = nil;
+    const uint64_t machTime = mach_absolute_time();
+    while (sAdmissionQueuedEntries.count > 0 && (!sAdmissionGlobalLimit || sAdmissionAdmittedEntries.count < sAdmissionGlobalLimit)) {
+        TNLAdmissionEntry *entry = _AdmissionDequeueNextEntry_locked(machTime);
+        if (!entry) {
+            break;
+        }
+        _AdmissionAdmitEntry_locked(entry, machTime);
+        if (!blocks) {
+            blocks = [[NSMutableArray alloc] init];
+        }
+        [blocks addObject:entry->_block];
+        entry->_block = nil;
+    }
+    return blocks;
+}
+
+static void _AdmissionRunBlocks(NSArray<dispatch_block_t> * __nullable blocks);
+static void _AdmissionRunBlocks(NSArray<dispatch_block_t> * __nullable blocks)
+{
+    for (dispatch_block_t block in blocks) {
+        block();
+    }
+}
+
+#pragma mark Retry Budget
+
+@interface TNLRequestOperationRetryBudgetStatistics ()
+- (instancetype)initWithRequestCount:(NSUInteger)requestCount
+                          retryCount:(NSUInteger)retryCount
+                 availableRetryCount:(NSUInteger)availableRetryCount
+               totalDeniedRetryCount:(NSUInteger)totalDeniedRetryCount;
+@end
+
+static uint64_t _RetryBudgetEpoch_locked(uint64_t machTime);
+static uint64_t _RetryBudgetEpoch_locked(uint64_t machTime)
+{
+    const NSTimeInterval bucketDuration = sRetryBudgetWindow / TNL_RETRY_BUDGET_BUCKET_COUNT;
+    return (uint64_t)(TNLAbsoluteToTimeInterval(machTime) / bucketDuration) + 1;
+}
+
+static TNLRetryBudgetBucket *_RetryBudgetCurrentBucket_locked(uint64_t machTime);
+static TNLRetryBudgetBucket *_RetryBudgetCurrentBucket_locked(uint64_t machTime)
+{
+    const uint64_t epoch = _RetryBudgetEpoch_locked(machTime);
+    TNLRetryBudgetBucket *bucket = &sRetryBudgetBuckets[epoch % TNL_RETRY_BUDGET_BUCKET_COUNT];
+    if (bucket->epoch != epoch) {
+        bucket->epoch = epoch;
+        bucket->requestCount = 0;
+        bucket->retryCount = 0;
+    }
+    return bucket;
+}
+
+static void _RetryBudgetSum_locked(uint64_t machTime, NSUInteger *requestCountOut, NSUInteger *retryCountOut);
+static void _RetryBudgetSum_locked(uint64_t machTime, NSUInteger *requestCountOut, NSUInteger *retryCountOut)
+{
+    const uint64_t epoch = _RetryBudgetEpoch_locked(machTime);
+    NSUInteger requestCount = 0;
+    NSUInteger retryCount = 0;
+    for (NSUInteger i = 0; i < TNL_RETRY_BUDGET_BUCKET_COUNT; i++) {
+        const TNLRetryBudgetBucket *bucket = &sRetryBudgetBuckets[i];
+        if (bucket->epoch && bucket->epoch <= epoch && (epoch - bucket->epoch) < TNL_RETRY_BUDGET_BUCKET_COUNT) {
+            requestCount += bucket->requestCount;
+            retryCount += bucket->retryCount;
+        }
+    }
+    *requestCountOut = requestCount;
+    *retryCountOut = retryCount;
+}
+
+static NSUInteger _RetryBudgetAvailableRetryCount_locked(NSUInteger requestCount, NSUInteger retryCount);
+static NSUInteger _RetryBudgetAvailableRetryCount_locked(NSUInteger requestCount, NSUInteger retryCount)
+{
+    if (sRetryBudgetRatio <= 0.0) {
+        return NSUIntegerMax;
+    }
+    const NSUInteger budget = MAX(sRetryBudgetMinimumRetryCount, (NSUInteger)(sRetryBudgetRatio * (double)requestCount));
+    return (budget > retryCount) ? budget - retryCount : 0;
+}
+
+static void _RetryBudgetReset_locked(void);
+static void _RetryBudgetReset_locked()
+{
+    for (NSUInteger i = 0; i < TNL_RETRY_BUDGET_BUCKET_COUNT; i++) {
+        sRetryBudgetBuckets[i] = (TNLRetryBudgetBucket){ 0, 0, 0 };
+    }
 }
 
 @interface TNLRequestOperationQueue (NSURLSessionDelegate) <NSURLSessionDataDelegate, NSURLSessionDownloadDelegate>
@@ -139,7 +485,6 @@ TNL_OBJC_DIRECT_MEMBERS
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
         sGlobalRequestOperationQueueMapTable = [NSMapTable strongToWeakObjectsMapTable];
-        sGlobalAutoDependencyOperations = [NSHashTable weakObjectsHashTable];
 
         sGlobalRequestOperationQueue = [[NSOperationQueue alloc] init];
         sGlobalRequestOperationQueue.name = @"com.TNL.global.request.operation.queue";
@@ -434,6 +779,14 @@ TNL_OBJC_DIRECT_MEMBERS
                                                                                       complete:complete];
 }
 
+- (void)createHedgeURLSessionTaskOperationForRequestOperation:(TNLRequestOperation *)op
+                                                     complete:(TNLRequestOperationQueueFindTaskOperationCompleteBlock)complete
+{
+    [[TNLURLSessionManager sharedInstance] createHedgeURLSessionTaskOperationForRequestOperationQueue:self
+                                                                                     requestOperation:op
+                                                                                             complete:complete];
+}
+
 #pragma mark Request Events
 
 - (void)operationDidStart:(TNLRequestOperation *)op
@@ -522,6 +875,344 @@ static void _GlobalRequestOperationQueueAddOperation(TNLRequestOperation *op)
     _GlobalEnqueueOperation(op);
 }
 
+#pragma mark - TNLRequestOperationQueue (Admission)
+
+@implementation TNLRequestOperationQueue (Admission)
+
++ (TNLRequestOperationAdmissionStatistics *)admissionStatistics
+{
+    NSUInteger queuedCounts[TNL_ADMISSION_LEVEL_COUNT] = { 0 };
+    NSUInteger admittedCount;
+    NSUInteger totalAdmittedCount;
+    NSTimeInterval totalWaitTime;
+    NSTimeInterval maximumWaitTime;
+
+    os_unfair_lock_lock(&sAdmissionLock);
+    for (NSUInteger level = 0; level < TNL_ADMISSION_LEVEL_COUNT; level++) {
+        queuedCounts[level] = sAdmissionQueues[level].count;
+    }
+    admittedCount = sAdmissionAdmittedEntries.count;
+    totalAdmittedCount = sAdmissionTotalAdmittedCount;
+    totalWaitTime = sAdmissionTotalWaitTime;
+    maximumWaitTime = sAdmissionMaximumWaitTime;
+    os_unfair_lock_unlock(&sAdmissionLock);
+
+    return [[TNLRequestOperationAdmissionStatistics alloc] initWithQueuedCounts:queuedCounts
+                                                                  admittedCount:admittedCount
+                                                             totalAdmittedCount:totalAdmittedCount
+                                                                  totalWaitTime:totalWaitTime
+                                                                maximumWaitTime:maximumWaitTime];
+}
+
++ (NSUInteger)admissionGlobalLimit
+{
+    os_unfair_lock_lock(&sAdmissionLock);
+    const NSUInteger limit = sAdmissionGlobalLimit;
+    os_unfair_lock_unlock(&sAdmissionLock);
+    return limit;
+}
+
++ (void)setAdmissionGlobalLimit:(NSUInteger)limit
+{
+    os_unfair_lock_lock(&sAdmissionLock);
+    sAdmissionGlobalLimit = limit;
+    NSArray<dispatch_block_t> *blocks = _AdmissionPump_locked();
+    os_unfair_lock_unlock(&sAdmissionLock);
+    _AdmissionRunBlocks(blocks);
+}
+
++ (NSUInteger)admissionPerHostLimit
+{
+    os_unfair_lock_lock(&sAdmissionLock);
+    const NSUInteger limit = sAdmissionPerHostLimit;
+    os_unfair_lock_unlock(&sAdmissionLock);
+    return limit;
+}
+
++ (void)setAdmissionPerHostLimit:(NSUInteger)limit
+{
+    os_unfair_lock_lock(&sAdmissionLock);
+    sAdmissionPerHostLimit = limit;
+    NSArray<dispatch_block_t> *blocks = _AdmissionPump_locked();
+    os_unfair_lock_unlock(&sAdmissionLock);
+    _AdmissionRunBlocks(blocks);
+}
+
++ (NSTimeInterval)admissionAgingInterval
+{
+    os_unfair_lock_lock(&sAdmissionLock);
+    const NSTimeInterval interval = sAdmissionAgingInterval;
+    os_unfair_lock_unlock(&sAdmissionLock);
+    return interval;
+}
+
++ (void)setAdmissionAgingInterval:(NSTimeInterval)interval
+{
+    os_unfair_lock_lock(&sAdmissionLock);
+    sAdmissionAgingInterval = MAX(interval, 0.0);
+    os_unfair_lock_unlock(&sAdmissionLock);
+}
+
++ (BOOL)admitRequestOperation:(TNLRequestOperation *)op
+                         host:(nullable NSString *)host
+                     priority:(TNLPriority)priority
+                        block:(dispatch_block_t)block
+{
+    TNLAdmissionEntry *entry = [[TNLAdmissionEntry alloc] init];
+    entry->_op = op;
+    entry->_host = [host lowercaseString];
+    entry->_block = [block copy];
+    entry->_enqueueMachTime = mach_absolute_time();
+    entry->_level = _AdmissionLevelForPriority(priority);
+
+    BOOL admitted = NO;
+    NSArray<dispatch_block_t> *blocks = nil;
+    os_unfair_lock_lock(&sAdmissionLock);
+    _AdmissionPrepare_locked();
+    if (!sAdmissionQueuedEntries.count && (!sAdmissionGlobalLimit || sAdmissionAdmittedEntries.count < sAdmissionGlobalLimit) && _AdmissionCanAdmitHost_locked(entry->_host)) {
+        // fast path: nothing waiting and capacity available
+        _AdmissionAdmitEntry_locked(entry, entry->_enqueueMachTime);
+        entry->_block = nil;
+        admitted = YES;
+    } else {
+        [sAdmissionQueuedEntries setObject:entry forKey:op];
+        _AdmissionInsertEntry_locked(entry);
+        blocks = _AdmissionPump_locked();
+    }
+    os_unfair_lock_unlock(&sAdmissionLock);
+
+    if (!admitted) {
+        TNLLogDebug(@"%@ waiting for admission (%@)", op, entry->_host);
+    }
+
+    // the blocks may include the given block (if it was admitted by the pump), treat it the same
+    _AdmissionRunBlocks(blocks);
+    return admitted;
+}
+
++ (void)requestOperation:(TNLRequestOperation *)op
+        didChangeAdmissionPriority:(TNLPriority)priority
+{
+    const NSUInteger level = _AdmissionLevelForPriority(priority);
+    os_unfair_lock_lock(&sAdmissionLock);
+    TNLAdmissionEntry *entry = [sAdmissionQueuedEntries objectForKey:op];
+    if (entry && entry->_level != level) {
+        [sAdmissionQueues[entry->_level] removeObjectIdenticalTo:entry];
+        entry->_level = level;
+        _AdmissionInsertEntry_locked(entry);
+    }
+    os_unfair_lock_unlock(&sAdmissionLock);
+}
+
++ (void)expediteAdmissionOfRequestOperation:(TNLRequestOperation *)op
+{
+    dispatch_block_t block = nil;
+    os_unfair_lock_lock(&sAdmissionLock);
+    TNLAdmissionEntry *entry = [sAdmissionQueuedEntries objectForKey:op];
+    if (entry) {
+        [sAdmissionQueues[entry->_level] removeObjectIdenticalTo:entry];
+        _AdmissionAdmitEntry_locked(entry, mach_absolute_time());
+        block = entry->_block;
+        entry->_block = nil;
+    }
+    os_unfair_lock_unlock(&sAdmissionLock);
+
+    if (block) {
+        block();
+    }
+}
+
++ (void)requestOperationDidFinishAdmission:(TNLRequestOperation *)op
+{
+    NSArray<dispatch_block_t> *blocks = nil;
+    os_unfair_lock_lock(&sAdmissionLock);
+    TNLAdmissionEntry *entry = [sAdmissionAdmittedEntries objectForKey:op];
+    if (entry) {
+        [sAdmissionAdmittedEntries removeObjectForKey:op];
+        if (entry->_host) {
+            [sAdmissionAdmittedHosts removeObject:entry->_host];
+        }
+        blocks = _AdmissionPump_locked();
+    }
+    os_unfair_lock_unlock(&sAdmissionLock);
+    _AdmissionRunBlocks(blocks);
+}
+
+@end
+
+#pragma mark - TNLRequestOperationQueue (RetryBudget)
+
+@implementation TNLRequestOperationQueue (RetryBudget)
+
++ (TNLRequestOperationRetryBudgetStatistics *)retryBudgetStatistics
+{
+    NSUInteger requestCount;
+    NSUInteger retryCount;
+    NSUInteger availableRetryCount;
+    NSUInteger totalDeniedRetryCount;
+
+    os_unfair_lock_lock(&sRetryBudgetLock);
+    _RetryBudgetSum_locked(mach_absolute_time(), &requestCount, &retryCount);
+    availableRetryCount = _RetryBudgetAvailableRetryCount_locked(requestCount, retryCount);
+    totalDeniedRetryCount = sRetryBudgetTotalDeniedRetryCount;
+    os_unfair_lock_unlock(&sRetryBudgetLock);
+
+    return [[TNLRequestOperationRetryBudgetStatistics alloc] initWithRequestCount:requestCount
+                                                                       retryCount:retryCount
+                                                              availableRetryCount:availableRetryCount
+                                                            totalDeniedRetryCount:totalDeniedRetryCount];
+}
+
++ (double)retryBudgetRatio
+{
+    os_unfair_lock_lock(&sRetryBudgetLock);
+    const double ratio = sRetryBudgetRatio;
+    os_unfair_lock_unlock(&sRetryBudgetLock);
+    return ratio;
+}
+
++ (void)setRetryBudgetRatio:(double)ratio
+{
+    os_unfair_lock_lock(&sRetryBudgetLock);
+    sRetryBudgetRatio = MAX(0.0, ratio);
+    os_unfair_lock_unlock(&sRetryBudgetLock);
+}
+
++ (NSTimeInterval)retryBudgetWindow
+{
+    os_unfair_lock_lock(&sRetryBudgetLock);
+    const NSTimeInterval window = sRetryBudgetWindow;
+    os_unfair_lock_unlock(&sRetryBudgetLock);
+    return window;
+}
+
++ (void)setRetryBudgetWindow:(NSTimeInterval)window
+{
+    os_unfair_lock_lock(&sRetryBudgetLock);
+    const NSTimeInterval newWindow = (window > 0.0) ? window : kRetryBudgetWindowDefault;
+    if (newWindow != sRetryBudgetWindow) {
+        // the buckets' epochs are relative to the window, start over
+        sRetryBudgetWindow = newWindow;
+        _RetryBudgetReset_locked();
+    }
+    os_unfair_lock_unlock(&sRetryBudgetLock);
+}
+
++ (NSUInteger)retryBudgetMinimumRetryCount
+{
+    os_unfair_lock_lock(&sRetryBudgetLock);
+    const NSUInteger count = sRetryBudgetMinimumRetryCount;
+    os_unfair_lock_unlock(&sRetryBudgetLock);
+    return count;
+}
+
++ (void)setRetryBudgetMinimumRetryCount:(NSUInteger)count
+{
+    os_unfair_lock_lock(&sRetryBudgetLock);
+    sRetryBudgetMinimumRetryCount = count;
+    os_unfair_lock_unlock(&sRetryBudgetLock);
+}
+
++ (void)retryBudgetRequestOperationDidStart:(TNLRequestOperation *)op
+{
+    os_unfair_lock_lock(&sRetryBudgetLock);
+    _RetryBudgetCurrentBucket_locked(mach_absolute_time())->requestCount++;
+    os_unfair_lock_unlock(&sRetryBudgetLock);
+}
+
++ (BOOL)retryBudgetWithdrawRetryForRequestOperation:(TNLRequestOperation *)op
+{
+    BOOL withdrew = NO;
+    const uint64_t machTime = mach_absolute_time();
+    NSUInteger requestCount;
+    NSUInteger retryCount;
+
+    os_unfair_lock_lock(&sRetryBudgetLock);
+    _RetryBudgetSum_locked(machTime, &requestCount, &retryCount);
+    if (_RetryBudgetAvailableRetryCount_locked(requestCount, retryCount) > 0) {
+        _RetryBudgetCurrentBucket_locked(machTime)->retryCount++;
+        withdrew = YES;
+    } else {
+        sRetryBudgetTotalDeniedRetryCount++;
+    }
+    os_unfair_lock_unlock(&sRetryBudgetLock);
+
+    if (!withdrew) {
+        TNLLogWarning(@"Retry budget exhausted (%tu retries for %tu requests), not retrying %@", retryCount, requestCount, op);
+    }
+    return withdrew;
+}
+
+@end
+
+#pragma mark - TNLRequestOperationRetryBudgetStatistics
+
+@implementation TNLRequestOperationRetryBudgetStatistics
+
+- (instancetype)initWithRequestCount:(NSUInteger)requestCount
+                          retryCount:(NSUInteger)retryCount
+                 availableRetryCount:(NSUInteger)availableRetryCount
+               totalDeniedRetryCount:(NSUInteger)totalDeniedRetryCount
+{
+    if (self = [super init]) {
+        _requestCount = requestCount;
+        _retryCount = retryCount;
+        _availableRetryCount = availableRetryCount;
+        _totalDeniedRetryCount = totalDeniedRetryCount;
+    }
+    return self;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@ %p: requests=%tu, retries=%tu, available=%tu, totalDenied=%tu>", NSStringFromClass([self class]), self, _requestCount, _retryCount, _availableRetryCount, _totalDeniedRetryCount];
+}
+
+@end
+
+#pragma mark - TNLRequestOperationAdmissionStatistics
+
+@implementation TNLRequestOperationAdmissionStatistics
+{
+    NSUInteger _queuedCounts[TNL_ADMISSION_LEVEL_COUNT];
+}
+
+- (instancetype)initWithQueuedCounts:(const NSUInteger *)queuedCounts
+                       admittedCount:(NSUInteger)admittedCount
+                  totalAdmittedCount:(NSUInteger)totalAdmittedCount
+                       totalWaitTime:(NSTimeInterval)totalWaitTime
+                     maximumWaitTime:(NSTimeInterval)maximumWaitTime
+{
+    if (self = [super init]) {
+        for (NSUInteger level = 0; level < TNL_ADMISSION_LEVEL_COUNT; level++) {
+            _queuedCounts[level] = queuedCounts[level];
+            _queuedOperationCount += queuedCounts[level];
+        }
+        _admittedOperationCount = admittedCount;
+        _totalAdmittedOperationCount = totalAdmittedCount;
+        _totalWaitTime = totalWaitTime;
+        _maximumWaitTime = maximumWaitTime;
+    }
+    return self;
+}
+
+- (NSTimeInterval)averageWaitTime
+{
+    return (_totalAdmittedOperationCount > 0) ? _totalWaitTime / _totalAdmittedOperationCount : 0;
+}
+
+- (NSUInteger)queuedOperationCountForPriority:(TNLPriority)priority
+{
+    return _queuedCounts[_AdmissionLevelForPriority(priority)];
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@ %p: queued=%tu, admitted=%tu, totalAdmitted=%tu, averageWait=%.3fs, maximumWait=%.3fs>", NSStringFromClass([self class]), self, _queuedOperationCount, _admittedOperationCount, _totalAdmittedOperationCount, self.averageWaitTime, _maximumWaitTime];
+}
+
+@end
+
 @implementation TNLNetwork
 
 + (BOOL)hasExecutingNetworkConnections
@@ -36,6 +36,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)findURLSessionTaskOperationForRequestOperation:(TNLRequestOperation *)op
                                               complete:(TNLRequestOperationQueueFindTaskOperationCompleteBlock)complete; // always yields a task operation
+- (void)createHedgeURLSessionTaskOperationForRequestOperation:(TNLRequestOperation *)op
+                                                     complete:(TNLRequestOperationQueueFindTaskOperationCompleteBlock)complete; // always yields a new task operation
 
 #pragma mark Network Observer
 
@@ -60,6 +62,39 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)taskOperation:(TNLURLSessionTaskOperation *)op
    didCompleteAttempt:(TNLResponse *)response;
 
+#pragma mark Admission
+
+// limits of the global admission scheduler (backing the TNLGlobalConfiguration settings)
+@property (class, atomic) NSUInteger admissionGlobalLimit; // 0 == unlimited
+@property (class, atomic) NSUInteger admissionPerHostLimit; // 0 == unlimited
+@property (class, atomic) NSTimeInterval admissionAgingInterval; // 0 == no aging
+
+// returns YES if the operation was admitted immediately (the _block_ will not be called),
+// otherwise the _block_ is called (on an arbitrary queue) once the operation is admitted
++ (BOOL)admitRequestOperation:(TNLRequestOperation *)op
+                         host:(nullable NSString *)host
+                     priority:(TNLPriority)priority
+                        block:(dispatch_block_t)block;
+// re-order the operation if it is still waiting for admission
++ (void)requestOperation:(TNLRequestOperation *)op
+        didChangeAdmissionPriority:(TNLPriority)priority;
+// admit the operation now if it is still waiting (regardless of limits), such as on cancel
++ (void)expediteAdmissionOfRequestOperation:(TNLRequestOperation *)op;
+// release the operation's admission slot (safe to call multiple times)
++ (void)requestOperationDidFinishAdmission:(TNLRequestOperation *)op;
+
+#pragma mark Retry Budget
+
+// the retry budget (backing the TNLGlobalConfiguration settings)
+@property (class, atomic) double retryBudgetRatio; // 0 == no budget
+@property (class, atomic) NSTimeInterval retryBudgetWindow;
+@property (class, atomic) NSUInteger retryBudgetMinimumRetryCount;
+
+// count the operation's first attempt towards the budget
++ (void)retryBudgetRequestOperationDidStart:(TNLRequestOperation *)op;
+// returns YES if the budget permits the operation's retry (counting it), NO if exhausted
++ (BOOL)retryBudgetWithdrawRetryForRequestOperation:(TNLRequestOperation *)op;
+
 @end
 
 NS_ASSUME_NONNULL_END
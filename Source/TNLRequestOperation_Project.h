@@ -44,6 +44,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property (atomic, nullable, readonly) TNLURLSessionTaskOperation *URLSessionTaskOperation;
 @property (atomic, copy, nullable, readonly) NSDictionary<NSString *, id<TNLContentDecoder>> *additionalDecoders;
 @property (atomic, copy, nullable, readonly) NSURLRequest *hydratedURLRequest;
+@property (nonatomic, readonly) dispatch_queue_t networkLane; // serializes all `network_` work for the operation (and its `URLSessionTaskOperation`)
 
 @end
 
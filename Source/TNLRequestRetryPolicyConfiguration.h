@@ -6,7 +6,7 @@
 //  Copyright © 2020 Twitter, Inc. All rights reserved.
 //
 
-#import <Foundation/Foundation.h>
+#import <TwitterNetworkLayer/TNLRequestRetryPolicyProvider.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -137,4 +137,50 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/**
+ A concrete `TNLConfiguringRetryPolicyProvider` that retries with exponential backoff and
+ decorrelated jitter.
+
+ Whether a response is retriable is decided by the `configuration`, with the number of attempts
+ capped at `maximumAttemptCount`.
+ Each retry of an operation waits a random delay between `baseDelay` and 3x its previous delay,
+ capped at `maximumDelay`.  The jitter keeps the operations that failed together (such as after a
+ network flap) from retrying together.
+ When the response has a `Retry-After` header, the delay is at least the `Retry-After` delay
+ (even beyond `maximumDelay`, the `operationTimeout` still applies).
+
+ The provider can be shared by many operations.
+ */
+@interface TNLBackoffRetryPolicyProvider : NSObject <TNLConfiguringRetryPolicyProvider>
+
+/** the configuration for which responses can be retried */
+@property (nonatomic, readonly, copy) TNLRequestRetryPolicyConfiguration *configuration;
+/** the minimum delay of a retry.  Default == `0.5` seconds */
+@property (nonatomic, readonly) NSTimeInterval baseDelay;
+/** the maximum delay of a retry (unless `Retry-After` says otherwise).  Default == `30` seconds */
+@property (nonatomic, readonly) NSTimeInterval maximumDelay;
+/** the maximum number of attempts, the initial attempt plus its retries (redirects and hedges don't count).  Default == `4` */
+@property (nonatomic, readonly) NSUInteger maximumAttemptCount;
+
+/**
+ Designated initializer
+
+ @param config              the configuration, `nil` will use `[TNLRequestRetryPolicyConfiguration standardConfiguration]`
+ @param baseDelay           the minimum delay of a retry (at least `0.1` seconds)
+ @param maximumDelay        the maximum delay of a retry (at least _baseDelay_)
+ @param maximumAttemptCount the maximum number of attempts including the initial attempt, `1` will never retry
+ */
+- (instancetype)initWithConfiguration:(nullable TNLRequestRetryPolicyConfiguration *)config
+                            baseDelay:(NSTimeInterval)baseDelay
+                         maximumDelay:(NSTimeInterval)maximumDelay
+                  maximumAttemptCount:(NSUInteger)maximumAttemptCount NS_DESIGNATED_INITIALIZER;
+
+/** Initialize with the default delays and attempt count */
+- (instancetype)initWithConfiguration:(nullable TNLRequestRetryPolicyConfiguration *)config;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+@end
+
 NS_ASSUME_NONNULL_END
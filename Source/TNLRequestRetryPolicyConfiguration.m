@@ -6,6 +6,8 @@
 //  Copyright © 2020 Twitter, Inc. All rights reserved.
 //
 
+#include <os/lock.h>
+
 #import "TNL_Project.h"
 #import "TNLRequest.h"
 #import "TNLRequestOperation.h"
@@ -331,6 +333,88 @@ NS_INLINE NSUInteger _HTTPStatusCodeToIndex(TNLHTTPStatusCode code)
 
 @end
 
+#pragma mark - TNLBackoffRetryPolicyProvider
+
+#define kBackoffBaseDelayDefault (0.5)
+#define kBackoffMaximumDelayDefault (30.0)
+#define kBackoffMaximumAttemptCountDefault (4)
+
+@implementation TNLBackoffRetryPolicyProvider
+{
+    os_unfair_lock _lock;
+    NSMapTable<TNLRequestOperation *, NSNumber *> *_previousDelays; // weak op -> delay
+}
+
+- (instancetype)initWithConfiguration:(nullable TNLRequestRetryPolicyConfiguration *)config
+{
+    return [self initWithConfiguration:config
+                             baseDelay:kBackoffBaseDelayDefault
+                          maximumDelay:kBackoffMaximumDelayDefault
+                   maximumAttemptCount:kBackoffMaximumAttemptCountDefault];
+}
+
+- (instancetype)initWithConfiguration:(nullable TNLRequestRetryPolicyConfiguration *)config
+                            baseDelay:(NSTimeInterval)baseDelay
+                         maximumDelay:(NSTimeInterval)maximumDelay
+                  maximumAttemptCount:(NSUInteger)maximumAttemptCount
+{
+    if (self = [super init]) {
+        _configuration = [config copy] ?: [TNLRequestRetryPolicyConfiguration standardConfiguration];
+        _baseDelay = MAX(MIN_TIMER_INTERVAL, baseDelay);
+        _maximumDelay = MAX(_baseDelay, maximumDelay);
+        _maximumAttemptCount = maximumAttemptCount;
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _previousDelays = [NSMapTable weakToStrongObjectsMapTable];
+    }
+    return self;
+}
+
+- (BOOL)tnl_shouldRetryRequestOperation:(TNLRequestOperation *)op
+                           withResponse:(TNLResponse *)response
+{
+    // redirect and hedge attempts don't count, only the initial attempt and its retries
+    if (op.retryCount + 1 >= _maximumAttemptCount) {
+        return NO;
+    }
+
+    return [_configuration requestCanBeRetriedForResponse:response];
+}
+
+- (NSTimeInterval)tnl_delayBeforeRetryForRequestOperation:(TNLRequestOperation *)op
+                                             withResponse:(TNLResponse *)response
+{
+    // decorrelated jitter: uniformly random between the base delay and 3x the previous delay
+
+    os_unfair_lock_lock(&_lock);
+    const NSTimeInterval previousDelay = [_previousDelays objectForKey:op].doubleValue ?: _baseDelay;
+    const double random = (double)arc4random() / ((double)UINT32_MAX + 1.0);
+    const NSTimeInterval upperBound = MAX(_baseDelay, previousDelay * 3.0);
+    const NSTimeInterval delay = MIN(_maximumDelay, _baseDelay + (random * (upperBound - _baseDelay)));
+    [_previousDelays setObject:@(delay) forKey:op];
+    os_unfair_lock_unlock(&_lock);
+
+    if (response.info.hasRetryAfterHeader) {
+        const NSTimeInterval retryAfterDelay = [response.info retryAfterDelayFromNow];
+        if (retryAfterDelay != NSTimeIntervalSince1970 && retryAfterDelay > delay) {
+            return retryAfterDelay;
+        }
+    }
+
+    return delay;
+}
+
+- (nullable NSString *)tnl_retryPolicyIdentifier
+{
+    return @"tnl.backoff";
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@ %p: base=%.3fs, max=%.3fs, attempts=%tu, config=%@>", NSStringFromClass([self class]), self, _baseDelay, _maximumDelay, _maximumAttemptCount, _configuration];
+}
+
+@end
+
 static NSArray<NSString *> *_GenerateMethodStrings(NSUInteger methodMask)
 {
     NSMutableArray<NSString *> *methods = [[NSMutableArray alloc] init];
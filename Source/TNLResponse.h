@@ -295,8 +295,19 @@ NS_SWIFT_NAME(response(request:operationError:info:metrics:));
 @property (nonatomic, readonly) NSUInteger retryCount;
 /** The number of redirects that occurred */
 @property (nonatomic, readonly) NSUInteger redirectCount;
+/** The number of hedged attempts that occurred (see `[TNLRequestConfiguration hedgeDelayPercentile]`) */
+@property (nonatomic, readonly) NSUInteger hedgeCount;
 
-/** The underlying attempt metrics as `TNLAttemptMetrics` objects */
+/**
+ The underlying attempt metrics as `TNLAttemptMetrics` objects.
+
+ Attempts are ordered by when they became the operation's attempt, which is not strictly by start time.
+ A hedge that lost its race is inserted just before the attempt it raced against (which started
+ earlier), so that the attempt that produced the response is always the last object.
+ A hedge that won its race follows the attempt it replaced, as that attempt is completed with a
+ disposition of `TNLAttemptCompleteDispositionHedged`.
+ Use `startDate` on each `TNLAttemptMetrics` to order attempts chronologically.
+ */
 @property (nonatomic, readonly, nullable) NSArray<TNLAttemptMetrics *> *attemptMetrics;
 
 /** A description of the response metrics as a serializable dictionary object */
@@ -581,6 +581,17 @@
     return count;
 }
 
+- (NSUInteger)hedgeCount
+{
+    NSUInteger count = 0;
+    for (TNLAttemptMetrics *metrics in _attemptMetrics) {
+        if (TNLAttemptTypeHedge == metrics.attemptType) {
+            count++;
+        }
+    }
+    return count;
+}
+
 - (void)didEnqueue
 {
     if (_final && _enqueueMachTime) {
@@ -662,6 +673,38 @@
     [self _addAttemptStart:TNLAttemptTypeRedirect date:date machTime:machTime request:request];
 }
 
+- (void)addHedgeStartWithDate:(NSDate *)date machTime:(uint64_t)machTime request:(NSURLRequest *)request
+{
+    [self _addAttemptStart:TNLAttemptTypeHedge date:date machTime:machTime request:request];
+}
+
+- (void)addAbandonedHedgeWithStartDate:(NSDate *)startDate
+                         startMachTime:(uint64_t)startMachTime
+                               endDate:(NSDate *)endDate
+                           endMachTime:(uint64_t)endMachTime
+                               request:(NSURLRequest *)request
+                        operationError:(nullable NSError *)error
+{
+    if (_final) {
+        return;
+    }
+
+    TNLAssert(_attemptMetrics.count > 0);
+    TNLAttemptMetrics *metrics = [[TNLAttemptMetrics alloc] initWithType:TNLAttemptTypeHedge
+                                                               startDate:startDate
+                                                           startMachTime:startMachTime
+                                                                 endDate:endDate
+                                                             endMachTime:endMachTime
+                                                                metaData:nil
+                                                              URLRequest:request
+                                                             URLResponse:nil
+                                                          operationError:error];
+
+    // the hedge ran in parallel with the current attempt, which stays the current (last) attempt
+    const NSUInteger index = (_attemptMetrics.count > 0) ? _attemptMetrics.count - 1 : 0;
+    [(NSMutableArray *)_attemptMetrics insertObject:metrics atIndex:index];
+}
+
 - (void)_addAttemptStart:(TNLAttemptType)type
                     date:(NSDate *)date
                 machTime:(uint64_t)machTime
@@ -966,6 +1009,8 @@ NSString *TNLAttemptTypeToString(TNLAttemptType type)
             return @"redirect";
         case TNLAttemptTypeRetry:
             return @"retry";
+        case TNLAttemptTypeHedge:
+            return @"hedge";
     }
     return nil;
 }
@@ -54,6 +54,16 @@ TNL_OBJC_DIRECT_MEMBERS
 - (void)addRedirectStartWithDate:(NSDate *)date
                         machTime:(uint64_t)machTime
                          request:(NSURLRequest *)request;
+- (void)addHedgeStartWithDate:(NSDate *)date
+                     machTime:(uint64_t)machTime
+                      request:(NSURLRequest *)request;
+// inserts a completed hedge attempt before the current attempt
+- (void)addAbandonedHedgeWithStartDate:(NSDate *)startDate
+                         startMachTime:(uint64_t)startMachTime
+                               endDate:(NSDate *)endDate
+                           endMachTime:(uint64_t)endMachTime
+                               request:(NSURLRequest *)request
+                        operationError:(nullable NSError *)error;
 - (void)addEndDate:(NSDate *)date
           machTime:(uint64_t)time
           response:(nullable NSHTTPURLResponse *)response
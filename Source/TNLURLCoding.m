@@ -20,27 +20,33 @@ static id __nullable TNLURLEncodableValue(id value,
                                           TNLURLEncodableDictionaryOptions options,
                                           NSString * __nullable contextKey);
 
-static void TNLAppendKeyValuePairToMutableString(NSMutableString *string,
-                                                 NSString *key,
-                                                 NSString *value,
-                                                 TNLURLEncodingOptions options);
-static void TNLAppendParameterDelimeterIfNecessary(NSMutableString *parameterString,
-                                                   BOOL *inoutIsFirstEntry);
-static void TNLAppendEncodedKeyValuePair(NSMutableString *parameterString,
-                                         NSString *encodedKey,
-                                         NSString *encodedValue,
-                                         TNLURLEncodingOptions options,
-                                         BOOL *inoutIsFirstEntry);
-static void TNLAppendArrayOfParameterValues(NSMutableString *parameterString,
-                                            NSString *encodedKey,
-                                            NSArray *values,
-                                            TNLURLEncodingOptions options,
-                                            BOOL *inoutIsFirstEntry);
-static void TNLAppendParameterValue(NSMutableString *parameterString,
-                                    NSString *encodedKey,
-                                    id value,
-                                    TNLURLEncodingOptions options,
-                                    BOOL *inoutIsFirstEntry);
+typedef struct _TNLURLEncodedSpan {
+    size_t offset;
+    size_t length;
+} _TNLURLEncodedSpan;
+
+// State for encoding a dictionary in a single pass into one byte buffer
+typedef struct _TNLURLDictionaryEncoder {
+    TNLURLEncodingBuffer output;
+    TNLURLEncodingBuffer encodedKey; // the current key, reused for each of its values
+    TNLURLEncodingBuffer encodedValues; // scratch for sorting array values (`TNLURLEncodingOptionStableOrder`)
+    _TNLURLEncodedSpan *valueSpans;
+    size_t valueSpanCapacity;
+    TNLURLEncodingOptions options;
+    BOOL isFirstEntry;
+} _TNLURLDictionaryEncoder;
+
+static void TNLURLDictionaryEncoderFree(_TNLURLDictionaryEncoder *encoder);
+static size_t TNLURLDictionaryEncoderBeginPair(_TNLURLDictionaryEncoder *encoder);
+static void TNLURLDictionaryEncoderCommitPair(_TNLURLDictionaryEncoder *encoder,
+                                              size_t pairOffset,
+                                              size_t valueOffset);
+static void TNLURLDictionaryEncoderAppendArrayOfParameterValues(_TNLURLDictionaryEncoder *encoder,
+                                                                NSString *key,
+                                                                NSArray *values);
+static void TNLURLDictionaryEncoderAppendParameterValue(_TNLURLDictionaryEncoder *encoder,
+                                                        NSString *key,
+                                                        id value);
 
 static NSArray *TNLURLConvertArrayToArrayOfEncodableStrings(NSArray * __nullable sourceArray,
                                                             TNLURLEncodableDictionaryOptions options,
@@ -54,109 +60,152 @@ static NSDictionary *TNLURLConvertDictionaryToDictionaryOfEncodableStrings(NSDic
 // See TNLURLStringCoding.m
 // NSString *TNLURLDecodeString(NSString *string, BOOL replacePlussesWithSpaces)
 
-static void TNLAppendKeyValuePairToMutableString(NSMutableString *string,
-                                                 NSString *key,
-                                                 NSString *value,
-                                                 TNLURLEncodingOptions options)
+static void TNLURLDictionaryEncoderFree(_TNLURLDictionaryEncoder *encoder)
 {
-    TNLAssert(string != nil);
-    TNLAssert(key != nil);
-    TNLAssert(value != nil);
-    if (key && string) {
-        [string appendString:key];
-        if ((value.length > 0) || TNL_BITMASK_EXCLUDES_FLAGS(options, TNLURLEncodingOptionTrimEmptyValueDelimiter)) {
-            [string appendString:@"="];
-            if (value) {
-                [string appendString:value];
-            }
-        }
-    }
+    TNLURLEncodingBufferFree(&encoder->output);
+    TNLURLEncodingBufferFree(&encoder->encodedKey);
+    TNLURLEncodingBufferFree(&encoder->encodedValues);
+    free(encoder->valueSpans);
+    encoder->valueSpans = NULL;
+    encoder->valueSpanCapacity = 0;
 }
 
-static void TNLAppendParameterDelimeterIfNecessary(NSMutableString *parameterString,
-                                                   BOOL *inoutIsFirstEntry)
+// Writes the delimiter (if necessary), the encoded key and the `=`, returns the offset of the pair
+static size_t TNLURLDictionaryEncoderBeginPair(_TNLURLDictionaryEncoder *encoder)
 {
-    if (!(*inoutIsFirstEntry)) {
-        [parameterString appendString:@"&"];
-    } else {
-        *inoutIsFirstEntry = NO;
+    const size_t pairOffset = encoder->output.length;
+    if (!encoder->isFirstEntry) {
+        TNLURLEncodingBufferAppendBytes(&encoder->output, "&", 1);
     }
+    TNLURLEncodingBufferAppendBytes(&encoder->output, encoder->encodedKey.bytes, encoder->encodedKey.length);
+    TNLURLEncodingBufferAppendBytes(&encoder->output, "=", 1);
+    return pairOffset;
 }
 
-static void TNLAppendEncodedKeyValuePair(NSMutableString *parameterString,
-                                         NSString *encodedKey,
-                                         NSString *encodedValue,
-                                         TNLURLEncodingOptions options,
-                                         BOOL *inoutIsFirstEntry)
+// Applies the empty value options to the pair that was just written
+static void TNLURLDictionaryEncoderCommitPair(_TNLURLDictionaryEncoder *encoder,
+                                              size_t pairOffset,
+                                              size_t valueOffset)
 {
-    if (TNL_BITMASK_EXCLUDES_FLAGS(options, TNLURLEncodingOptionDiscardEmptyValues) || (encodedValue.length > 0)) {
-        TNLAppendParameterDelimeterIfNecessary(parameterString, inoutIsFirstEntry);
-        TNLAppendKeyValuePairToMutableString(parameterString, encodedKey, encodedValue, options);
+    if (encoder->output.length == valueOffset) {
+        if (TNL_BITMASK_HAS_SUBSET_FLAGS(encoder->options, TNLURLEncodingOptionDiscardEmptyValues)) {
+            encoder->output.length = pairOffset;
+            return;
+        }
+        if (TNL_BITMASK_HAS_SUBSET_FLAGS(encoder->options, TNLURLEncodingOptionTrimEmptyValueDelimiter)) {
+            encoder->output.length = valueOffset - 1; // drop the '='
+        }
     }
+    encoder->isFirstEntry = NO;
 }
 
-static void TNLAppendArrayOfParameterValues(NSMutableString *parameterString,
-                                            NSString *encodedKey,
-                                            NSArray *values,
-                                            TNLURLEncodingOptions options,
-                                            BOOL *inoutIsFirstEntry)
+static void TNLURLDictionaryEncoderAppendArrayOfParameterValues(_TNLURLDictionaryEncoder *encoder,
+                                                                NSString *key,
+                                                                NSArray *values)
 {
-    NSMutableArray *encodedValues = [NSMutableArray arrayWithCapacity:[values count]];
-    for (id subvalue in values) {
-        NSString *stringValue = TNLStringValue(subvalue, options, encodedKey);
-        if (stringValue) {
-            stringValue = TNLURLEncodeString(stringValue);
+    const TNLURLEncodingOptions options = encoder->options;
+    if (TNL_BITMASK_EXCLUDES_FLAGS(options, TNLURLEncodingOptionStableOrder)) {
+        for (id subvalue in values) {
+            NSString *stringValue = TNLStringValue(subvalue, options, key);
             if (stringValue) {
-                [encodedValues addObject:stringValue];
+                const size_t pairOffset = TNLURLDictionaryEncoderBeginPair(encoder);
+                const size_t valueOffset = encoder->output.length;
+                if (TNLURLEncodingBufferAppendEncodedString(&encoder->output, stringValue)) {
+                    TNLURLDictionaryEncoderCommitPair(encoder, pairOffset, valueOffset);
+                } else {
+                    encoder->output.length = pairOffset;
+                }
             }
         }
+        return;
     }
 
-    if (TNL_BITMASK_HAS_SUBSET_FLAGS(options, TNLURLEncodingOptionStableOrder)) {
-        [encodedValues sortUsingSelector:@selector(compare:)];
+    // Encode the values into scratch space so they can be sorted by their encoded bytes
+    // (the same order as `compare:` on the encoded strings since they are ASCII)
+
+    const size_t count = values.count;
+    if (encoder->valueSpanCapacity < count) {
+        _TNLURLEncodedSpan *spans = realloc(encoder->valueSpans, count * sizeof(_TNLURLEncodedSpan));
+        if (!spans) {
+            TNLLogError(@"Out of memory");
+            return;
+        }
+        encoder->valueSpans = spans;
+        encoder->valueSpanCapacity = count;
     }
 
-    for (NSString *encodedValue in encodedValues) {
-        TNLAppendEncodedKeyValuePair(parameterString, encodedKey, encodedValue, options, inoutIsFirstEntry);
+    encoder->encodedValues.length = 0;
+    size_t spanCount = 0;
+    for (id subvalue in values) {
+        NSString *stringValue = TNLStringValue(subvalue, options, key);
+        if (stringValue) {
+            const size_t offset = encoder->encodedValues.length;
+            if (TNLURLEncodingBufferAppendEncodedString(&encoder->encodedValues, stringValue)) {
+                encoder->valueSpans[spanCount++] = (_TNLURLEncodedSpan){ offset, encoder->encodedValues.length - offset };
+            } else {
+                encoder->encodedValues.length = offset;
+            }
+        }
+    }
+
+    const char *valueBytes = encoder->encodedValues.bytes;
+    qsort_b(encoder->valueSpans, spanCount, sizeof(_TNLURLEncodedSpan), ^int(const void *lhs, const void *rhs) {
+        const _TNLURLEncodedSpan *span1 = lhs;
+        const _TNLURLEncodedSpan *span2 = rhs;
+        const int result = memcmp(valueBytes + span1->offset, valueBytes + span2->offset, MIN(span1->length, span2->length));
+        if (result != 0) {
+            return result;
+        }
+        return (span1->length < span2->length) ? -1 : ((span1->length > span2->length) ? 1 : 0);
+    });
+
+    for (size_t i = 0; i < spanCount; i++) {
+        const _TNLURLEncodedSpan span = encoder->valueSpans[i];
+        const size_t pairOffset = TNLURLDictionaryEncoderBeginPair(encoder);
+        const size_t valueOffset = encoder->output.length;
+        TNLURLEncodingBufferAppendBytes(&encoder->output, encoder->encodedValues.bytes + span.offset, span.length);
+        TNLURLDictionaryEncoderCommitPair(encoder, pairOffset, valueOffset);
     }
 }
 
-static void TNLAppendParameterValue(NSMutableString *parameterString,
-                                    NSString *encodedKey,
-                                    id value,
-                                    TNLURLEncodingOptions options,
-                                    BOOL *inoutIsFirstEntry)
+static void TNLURLDictionaryEncoderAppendParameterValue(_TNLURLDictionaryEncoder *encoder,
+                                                        NSString *key,
+                                                        id value)
 {
-    TNLAssert(encodedKey != nil);
-    NSString *stringValue = TNLStringValue(value, options, encodedKey);
+    const TNLURLEncodingOptions options = encoder->options;
+    NSString *stringValue = TNLStringValue(value, options, key);
     if (stringValue) {
-        NSString *encodedValue = TNLURLEncodeString(stringValue);
-        if (!encodedValue) {
-            TNLLogError(@"Could not encode value for encoded key '%@': '%@'", encodedKey, stringValue);
-            TNLAssertMessage(encodedValue != nil, @"Could not encode value for encoded key '%@': '%@'", encodedKey, stringValue);
+        const size_t pairOffset = TNLURLDictionaryEncoderBeginPair(encoder);
+        const size_t valueOffset = encoder->output.length;
+        if (!TNLURLEncodingBufferAppendEncodedString(&encoder->output, stringValue)) {
+            encoder->output.length = valueOffset;
+            TNLLogError(@"Could not encode value for key '%@': '%@'", key, stringValue);
+            TNLAssertMessage(NO, @"Could not encode value for key '%@': '%@'", key, stringValue);
 
             // Handle the unexpected encoding of the value as an unsupported value
 
-            if (TNL_BITMASK_HAS_SUBSET_FLAGS(options, TNLURLEncodingOptionTreatUnsupportedValuesAsEmpty)) {
-                encodedValue = @"";
-            } else if (TNL_BITMASK_EXCLUDES_FLAGS(options, TNLURLEncodingOptionIgnoreUnsupportedValues)) {
-                NSString *reason = [NSString stringWithFormat:@"parameter object cannot be URL Encoded (options=%@, object=%@, stringValue=%@, key=%@)", @(options), value, stringValue, encodedKey];
-                @throw [NSException exceptionWithName:NSInvalidArgumentException
-                                               reason:reason
-                                             userInfo:@{ @"object" : (value) ?: [NSNull null], @"encodingOptions" : @(options) }];
+            if (TNL_BITMASK_EXCLUDES_FLAGS(options, TNLURLEncodingOptionTreatUnsupportedValuesAsEmpty)) {
+                encoder->output.length = pairOffset;
+                if (TNL_BITMASK_EXCLUDES_FLAGS(options, TNLURLEncodingOptionIgnoreUnsupportedValues)) {
+                    NSString *reason = [NSString stringWithFormat:@"parameter object cannot be URL Encoded (options=%@, object=%@, stringValue=%@, key=%@)", @(options), value, stringValue, key];
+                    @throw [NSException exceptionWithName:NSInvalidArgumentException
+                                                   reason:reason
+                                                 userInfo:@{ @"object" : (value) ?: [NSNull null], @"encodingOptions" : @(options) }];
+                }
+                return;
             }
         }
 
-        if (encodedKey && encodedValue) {
-            TNLAppendEncodedKeyValuePair(parameterString, encodedKey, encodedValue, options, inoutIsFirstEntry);
-        }
+        TNLURLDictionaryEncoderCommitPair(encoder, pairOffset, valueOffset);
     }
 }
 
 NSString *TNLURLEncodeDictionary(NSDictionary * __nullable params,
                                  TNLURLEncodingOptions options)
 {
-    NSMutableString *parameterString = [NSMutableString string];
+    if (!params.count) {
+        return @"";
+    }
 
     NSArray *allKeys = params.allKeys;
 
@@ -164,20 +213,30 @@ NSString *TNLURLEncodeDictionary(NSDictionary * __nullable params,
         allKeys = [allKeys sortedArrayUsingSelector:@selector(compare:)];
     }
 
+    _TNLURLDictionaryEncoder encoder = { .options = options, .isFirstEntry = YES };
+    // most query parameters are short, start with enough room to avoid growing the buffer
+    TNLURLEncodingBufferReserve(&encoder.output, allKeys.count * 32);
+
     const BOOL specialCaseArrays = TNL_BITMASK_HAS_SUBSET_FLAGS(options, TNLURLEncodingOptionDuplicateEntriesForArrayValues);
-    BOOL firstEntry = YES;
-    for (NSString *key in allKeys) {
-        NSString *encodedKey = TNLURLEncodeString(key);
-        if (encodedKey.length > 0) {
-            id value = params[key];
-            if (specialCaseArrays && [value isKindOfClass:[NSArray class]] && [value count] > 0) {
-                TNLAppendArrayOfParameterValues(parameterString, encodedKey, value, options, &firstEntry);
-            } else {
-                TNLAppendParameterValue(parameterString, encodedKey, value, options, &firstEntry);
+    @try {
+        for (NSString *key in allKeys) {
+            encoder.encodedKey.length = 0;
+            if (TNLURLEncodingBufferAppendEncodedString(&encoder.encodedKey, key) && encoder.encodedKey.length > 0) {
+                id value = params[key];
+                if (specialCaseArrays && [value isKindOfClass:[NSArray class]] && [value count] > 0) {
+                    TNLURLDictionaryEncoderAppendArrayOfParameterValues(&encoder, key, value);
+                } else {
+                    TNLURLDictionaryEncoderAppendParameterValue(&encoder, key, value);
+                }
             }
         }
+    } @catch (NSException *exception) {
+        TNLURLDictionaryEncoderFree(&encoder);
+        @throw;
     }
 
+    NSString *parameterString = TNLURLEncodingBufferCopyString(&encoder.output);
+    TNLURLDictionaryEncoderFree(&encoder);
     return parameterString;
 }
 
@@ -16,6 +16,7 @@ NS_ASSUME_NONNULL_BEGIN
  * NOTE: this header is private to TNL
  */
 
+@class TNLAttemptMetrics;
 @class TNLMutableParameterCollection;
 @class TNLRequestOperationQueue;
 @class TNLResponse;
@@ -46,6 +47,9 @@ typedef void(^TNLURLSessionManagerGetAllSessionsCallback)(NSArray<NSURLSession *
 - (void)findURLSessionTaskOperationForRequestOperationQueue:(TNLRequestOperationQueue *)queue
                                            requestOperation:(TNLRequestOperation *)op
                                                    complete:(TNLRequestOperationQueueFindTaskOperationCompleteBlock)complete;
+- (void)createHedgeURLSessionTaskOperationForRequestOperationQueue:(TNLRequestOperationQueue *)queue
+                                                  requestOperation:(TNLRequestOperation *)op
+                                                          complete:(TNLRequestOperationQueueFindTaskOperationCompleteBlock)complete;
 - (void)getAllURLSessions:(TNLURLSessionManagerGetAllSessionsCallback)callback;
 - (BOOL)handleBackgroundURLSessionEvents:(NSString *)identifier
                        completionHandler:(dispatch_block_t)completionHandler;
@@ -57,6 +61,9 @@ typedef void(^TNLURLSessionManagerGetAllSessionsCallback)(NSArray<NSURLSession *
                                    response:(TNLResponse *)response;
 
 - (void)syncAddURLSessionTaskOperation:(TNLURLSessionTaskOperation *)op;
+- (void)syncURLSessionTaskOperation:(TNLURLSessionTaskOperation *)op
+                      didChangeTask:(nullable NSURLSessionTask *)oldTask
+                             toTask:(NSURLSessionTask *)newTask;
 - (void)applyBackoffDependenciesToOperation:(NSOperation *)op
                                     withURL:(NSURL *)URL
                                        host:(nullable NSString *)host
@@ -66,6 +73,11 @@ typedef void(^TNLURLSessionManagerGetAllSessionsCallback)(NSArray<NSURLSession *
                    responseHTTPHeaders:(nullable NSDictionary<NSString *, NSString *> *)headers;
 @property (atomic) TNLGlobalConfigurationBackoffMode backoffMode;
 @property (atomic, null_resettable) id<TNLBackoffBehaviorProvider> backoffBehaviorProvider;
+@property (atomic, getter=isAdaptiveConcurrencyEnabled) BOOL adaptiveConcurrencyEnabled;
+- (void)getAdaptiveConcurrencyLimits:(TNLGlobalConfigurationGetAdaptiveConcurrencyLimitsCallback)callback;
+- (void)URLSessionTaskOperation:(TNLURLSessionTaskOperation *)op
+  didCompleteAttemptWithMetrics:(nullable TNLAttemptMetrics *)metrics;
+@property (atomic) NSUInteger maximumURLSessionCount;
 
 - (void)pruneUnusedURLSessions;
 - (void)pruneURLSessionMatchingRequestConfiguration:(TNLRequestConfiguration *)config
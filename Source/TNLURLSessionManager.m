@@ -16,13 +16,16 @@
 #import "NSURLSessionConfiguration+TNLAdditions.h"
 #import "NSURLSessionTaskMetrics+TNLAdditions.h"
 #import "TNL_Project.h"
+#import "TNLAttemptMetrics.h"
 #import "TNLAuthenticationChallengeHandler.h"
 #import "TNLBackgroundURLSessionTaskOperationManager.h"
 #import "TNLBackoff.h"
 #import "TNLGlobalConfiguration_Project.h"
+#import "TNLHTTP.h"
 #import "TNLLRUCache.h"
 #import "TNLNetwork.h"
 #import "TNLRequestOperation_Project.h"
+#import "TNLRequestConfiguration_Project.h"
 #import "TNLRequestOperationQueue_Project.h"
 #import "TNLTimeoutOperation.h"
 #import "TNLTiming.h"
@@ -31,42 +34,53 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class TNLURLSessionContext;
 @class TNLURLSessionContextLRUCacheDelegate;
 
 #pragma mark - Constants
 
-static const NSUInteger kMaxURLSessionContextCount = 12;
+// In app session contexts cost 1 for the session plus 1 per outstanding operation (see LRUEntryCost),
+// the cost budget scales with the session count budget.
+// 8 covers the session plus a saturated default HTTPMaximumConnectionsPerHost (4 on iOS, 6 on macOS)
+// with a request or so queued, so only sessions busier than that push idle sessions out early.
+static const NSUInteger kURLSessionContextCostLimitPerSession = 8;
 
 static NSString * const kInAppURLSessionContextIdentifier = @"tnl.op.queue";
 static NSString * const kManagerVersionKey = @"smv";
+static const char kURLSessionContextQueueKey[] = "tnl.session.context.queue";
 
 #pragma mark - Static Functions
 
 static NSString *_GenerateReuseIdentifier(NSString * __nullable operationQueueId, NSString *URLSessionConfigurationIdentificationString, TNLRequestExecutionMode executionmode);
 static void _ConfigureSessionConfigurationWithRequestConfiguration(NSURLSessionConfiguration * __nullable sessionConfig, TNLRequestConfiguration * requestConfig);
 static NSString * __nullable _BackoffKeyFromURL(const TNLGlobalConfigurationBackoffMode mode, NSURL *URL, NSString * __nullable host);
+static NSTimeInterval _BackoffLatencyFromAttemptMetrics(TNLAttemptMetrics *metrics);
 static void TNLMutableParametersStripNonURLSessionProperties(TNLMutableParameterCollection *params);
 static void TNLMutableParametersStripNonBackgroundURLSessionProperties(TNLMutableParameterCollection *params);
 static void TNLMutableParametersStripOverriddenURLSessionProperties(TNLMutableParameterCollection *params);
-typedef BOOL (^_FilterBlock)(id obj);
-static NSArray *_FilterArray(NSArray *source, _FilterBlock filterBlock);
+typedef void (^_URLSessionContextBlock)(TNLURLSessionContext * __nullable context);
+static void _ExecuteOnURLSessionContextQueue(NSURLSession *session, _URLSessionContextBlock block);
+static NSString * __nullable _CoalescingKeyForRequestOperation(TNLRequestOperation *op, TNLRequestOperationQueue *queue);
+static BOOL _CoalescingRequestsAreIdentical(NSURLRequest *request1, NSURLRequest *request2, NSSet<NSString *> * __nullable allowList);
 
 #pragma mark - Global Session Management
 
+@class TNLBackoffLimiter;
+
 static void _PrepareSessionManagement(void);
 
 static dispatch_queue_t sSynchronizeQueue;
-static NSOperationQueue *sSynchronizeOperationQueue;
 static NSOperationQueue *sURLSessionTaskOperationQueue;
 static TNLURLSessionContextLRUCacheDelegate *sSessionContextsDelegate;
 static TNLLRUCache *sAppSessionContexts;
+static NSMutableDictionary<TNLURLSessionIdentity *, TNLURLSessionContext *> *sAppSessionContextsByIdentity;
 static TNLLRUCache *sBackgroundSessionContexts;
 static NSMutableSet<TNLURLSessionTaskOperation *> *sActiveURLSessionTaskOperations;
+static NSMutableDictionary<NSString *, NSMutableArray<TNLURLSessionTaskOperation *> *> *sCoalescableURLSessionTaskOperations;
 static NSMutableDictionary<NSString *, dispatch_block_t> *sBackgroundSessionCompletionHandlerDictionary;
-static NSMutableDictionary<NSString *, NSHashTable<NSOperation *> *> *sOutstandingBackoffOperations = nil;
-static NSMutableDictionary<NSString *, NSHashTable<NSOperation *> *> *sOutstandingSerializeOperations = nil;
-static NSTimeInterval sSerialDelayDuration = 0.0;
+static NSMutableDictionary<NSString *, TNLBackoffLimiter *> *sBackoffLimiters = nil;
 static TNLGlobalConfigurationBackoffMode sBackoffMode = TNLGlobalConfigurationBackoffModeDisabled;
+static BOOL sAdaptiveConcurrencyEnabled = NO;
 static id<TNLBackoffBehaviorProvider> sBackoffBehaviorProvider = nil;
 
 #pragma mark - Session Context
@@ -76,8 +90,10 @@ TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
 
 @property (nonatomic, readonly) NSURLSession *URLSession;
 @property (nonatomic, readonly, copy) NSString *reuseId;
+@property (nonatomic, readonly, nullable) TNLURLSessionIdentity *identity; // nil for background sessions
 @property (nonatomic, readonly) TNLRequestExecutionMode executionMode;
-@property (nonatomic, readonly) NSArray<TNLURLSessionTaskOperation *> *URLSessionTaskOperations;
+@property (nonatomic, readonly) dispatch_queue_t queue; // the shard queue, also the URLSession's delegate queue
+@property (nonatomic, readonly) NSArray<TNLURLSessionTaskOperation *> *URLSessionTaskOperations; // only access from the context's queue
 @property (nonatomic, readonly) uint64_t lastOperationRemovedMachTime;
 
 - (instancetype)init NS_UNAVAILABLE;
@@ -88,7 +104,7 @@ TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
 - (void)removeOperation:(TNLURLSessionTaskOperation *)op;
 - (nullable TNLURLSessionTaskOperation *)operationForTask:(NSURLSessionTask *)task;
 - (void)changeOperation:(TNLURLSessionTaskOperation *)op
-               fromTask:(NSURLSessionTask *)oldTask
+               fromTask:(nullable NSURLSessionTask *)oldTask
                  toTask:(NSURLSessionTask *)newTask;
 
 @end
@@ -96,7 +112,9 @@ TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
 TNL_OBJC_DIRECT_MEMBERS
 @interface TNLURLSessionContext () <TNLLRUEntry>
 - (instancetype)initWithURLSession:(NSURLSession *)URLSession
+                             queue:(dispatch_queue_t)queue
                            reuseId:(NSString *)reuseId
+                          identity:(nullable TNLURLSessionIdentity *)identity
                      executionMode:(TNLRequestExecutionMode)mode NS_DESIGNATED_INITIALIZER;
 @end
 
@@ -104,6 +122,77 @@ TNL_OBJC_DIRECT_MEMBERS
 @interface TNLURLSessionContextLRUCacheDelegate : NSObject <TNLLRUCacheDelegate>
 @end
 
+// Weak reference to a context, stored as the context's queue specific data
+TNL_OBJC_FINAL
+@interface TNLURLSessionContextReference : NSObject
+@property (atomic, weak, nullable) TNLURLSessionContext *context;
+@end
+
+#pragma mark - Backoff Limiter
+
+// Serialized requests are admitted at most once per this interval, even when `serialDelayDuration` is `0`
+static const NSTimeInterval kBackoffMinimumSerialAdmissionInterval = 0.1;
+
+// Adaptive concurrency (AIMD) tuning
+static const double kAdaptiveConcurrencyInitialLimit = 8.0;
+static const double kAdaptiveConcurrencyMinimumLimit = 1.0;
+static const double kAdaptiveConcurrencyMaximumLimit = 64.0;
+static const double kAdaptiveConcurrencyDecreaseFactor = 0.75;
+static const double kAdaptiveConcurrencyLatencyTolerance = 2.0; // multiple of the baseline latency
+static const double kAdaptiveConcurrencyBaselineDrift = 0.02; // how quickly the baseline follows rising latency
+static const NSTimeInterval kAdaptiveConcurrencyMinimumDecreaseInterval = 0.1;
+
+/**
+ Rate limiter for a backoff key (see `TNLGlobalConfigurationBackoffMode`).
+
+ The `backoffDuration` of a `TNLBackoffBehavior` closes a gate that nothing is admitted through until it expires.
+ While backing off or within the `serializeDuration`, enqueued operations are admitted like a leaky
+ bucket: one per `serialDelayDuration`.  Admission is O(1) and no `NSOperation` dependencies are built;
+ operations that cannot be admitted yet wait in a FIFO that is drained by a single timer per key.
+ Waiting operations are not stamped with admission times: the head is admitted against the current
+ gate and serial schedule, so a backoff signal that arrives while they wait delays and paces them all.
+
+ When `adaptsConcurrency`, the number of concurrent (non long poll) operations is also capped by a limit
+ that increases additively as operations complete in good health and decreases multiplicatively
+ (at most once per baseline round trip) when they fail or take much longer than the baseline latency.
+ Only access from the synchronize queue.
+ */
+TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
+@interface TNLBackoffLimiter : NSObject
+@property (nonatomic, nullable) dispatch_source_t drainTimerSource;
+@property (nonatomic, readonly) NSUInteger pendingOperationCount;
+@property (nonatomic, readonly) BOOL adaptsConcurrency;
+@property (nonatomic, readonly) NSUInteger concurrencyLimit;
+- (instancetype)initWithAdaptiveConcurrency:(BOOL)adaptsConcurrency;
+- (void)applyBackoffBehavior:(TNLBackoffBehavior)behavior machTime:(uint64_t)machTime;
+- (uint64_t)reserveAdmissionMachTimeForMachTime:(uint64_t)machTime isLongPoll:(BOOL)isLongPoll;
+- (BOOL)canAdmitImmediatelyAtMachTime:(uint64_t)machTime isLongPoll:(BOOL)isLongPoll;
+- (void)noteAdmittedOperation:(NSOperation *)op machTime:(uint64_t)machTime isLongPoll:(BOOL)isLongPoll;
+- (BOOL)completeOperation:(NSOperation *)op
+              withLatency:(NSTimeInterval)latency
+                   failed:(BOOL)failed
+                 machTime:(uint64_t)machTime;
+- (BOOL)abandonOperation:(NSOperation *)op;
+- (BOOL)isExpiredAtMachTime:(uint64_t)machTime;
+- (void)enqueuePendingOperation:(NSOperation *)op
+                       machTime:(uint64_t)machTime
+                     isLongPoll:(BOOL)isLongPoll;
+- (NSArray<NSOperation *> *)dequeueAdmittedOperationsAtMachTime:(uint64_t)machTime
+                                          nextAdmissionMachTime:(out uint64_t *)nextAdmissionMachTimeOut;
+- (NSArray<NSOperation *> *)dequeueAllPendingOperations;
+@end
+
+TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
+@interface TNLBackoffPendingOperation : NSObject
+{
+@public
+    NSOperation *_operation;
+    BOOL _isLongPoll;
+    BOOL _isSerialized; // enqueued while serializing, paced even if the serialize duration ends
+
+}
+@end
+
 #pragma mark - Session Manager Interfaces
 
 @interface TNLURLSessionManagerV1 : NSObject <TNLURLSessionManager>
@@ -122,23 +211,42 @@ TNL_OBJC_DIRECT_MEMBERS
 - (void)_synchronize_findURLSessionTaskOperationForRequestOperationQueue:(TNLRequestOperationQueue *)requestOperationQueue
                                                         requestOperation:(TNLRequestOperation *)requestOperation
                                                               completion:(TNLRequestOperationQueueFindTaskOperationCompleteBlock)complete;
+- (void)_synchronize_createURLSessionTaskOperationForRequestOperationQueue:(TNLRequestOperationQueue *)requestOperationQueue
+                                                          requestOperation:(TNLRequestOperation *)requestOperation
+                                                             coalescingKey:(nullable NSString *)coalescingKey
+                                                                completion:(TNLRequestOperationQueueFindTaskOperationCompleteBlock)complete;
+- (nullable TNLURLSessionTaskOperation *)_synchronize_coalescableTaskOperationForRequestOperation:(TNLRequestOperation *)requestOperation
+                                                                                    coalescingKey:(NSString *)coalescingKey;
 - (NSURLSession *)_synchronize_associateTaskOperation:(TNLURLSessionTaskOperation *)taskOperation
                                             withQueue:(TNLRequestOperationQueue *)requestOperationQueue
                                   supportsTaskMetrics:(BOOL)supportsTaskMetrics;
 - (void)_synchronize_dissassociateTaskOperation:(TNLURLSessionTaskOperation *)op;
+- (void)_synchronize_removeCoalescableTaskOperation:(TNLURLSessionTaskOperation *)op;
 - (nullable TNLURLSessionContext *)_synchronize_sessionContextWithQueueId:(nullable NSString *)operationQueueId
                                                      requestConfiguration:(TNLRequestConfiguration *)requestConfiguration
                                                             executionMode:(TNLRequestExecutionMode)executionMode
                                                            createIfNeeded:(BOOL)createIfNeeded;
-- (nullable TNLURLSessionContext *)_synchronize_sessionContextFromURLSession:(NSURLSession *)session;
 - (nullable TNLURLSessionContext *)_synchronize_sessionContextWithConfigurationIdentifier:(NSString *)identifier;
 - (void)_synchronize_removeSessionContext:(TNLURLSessionContext *)context;
 - (void)_synchronize_storeSessionContext:(TNLURLSessionContext *)context;
+- (void)_synchronize_updateCostOfSessionContext:(TNLURLSessionContext *)context;
 
+- (nullable TNLBackoffLimiter *)_synchronize_backoffLimiterForURL:(NSURL *)URL
+                                                             host:(nullable NSString *)host
+                                                         machTime:(uint64_t)machTime
+                                                   createIfNeeded:(BOOL)createIfNeeded;
 - (void)_synchronize_applyBackoffDependenciesToOperation:(NSOperation *)op
                                              matchingURL:(NSURL *)URL
                                                     host:(nullable NSString *)host
                                               isLongPoll:(BOOL)isLongPoll;
+- (void)_synchronize_admitURLSessionTaskOperation:(TNLURLSessionTaskOperation *)op
+                                      matchingURL:(NSURL *)URL
+                                             host:(nullable NSString *)host
+                                       isLongPoll:(BOOL)isLongPoll;
+- (void)_synchronize_drainBackoffLimiter:(TNLBackoffLimiter *)limiter;
+- (void)_synchronize_resetBackoffLimiters;
+- (void)_synchronize_URLSessionTaskOperation:(TNLURLSessionTaskOperation *)op
+                 didCompleteAttemptWithMetrics:(nullable TNLAttemptMetrics *)metrics;
 - (void)_synchronize_backoffSignalEncounteredForURL:(NSURL *)URL
                                                host:(nullable NSString *)host
                                             headers:(nullable NSDictionary<NSString *, NSString *> *)headers;
@@ -147,8 +255,6 @@ TNL_OBJC_DIRECT_MEMBERS
 - (void)_synchronize_pruneSessionWithConfig:(TNLRequestConfiguration *)config
                            operationQueueId:(nullable NSString *)operationQueueId;
 
-static void _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(dispatch_block_t block);
-
 @end
 
 /**
@@ -225,6 +331,20 @@ static void _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(dispatch_
     });
 }
 
+- (void)createHedgeURLSessionTaskOperationForRequestOperationQueue:(TNLRequestOperationQueue *)queue
+                                                  requestOperation:(TNLRequestOperation *)op
+                                                          complete:(TNLRequestOperationQueueFindTaskOperationCompleteBlock)complete
+{
+    TNLAssert(op.URLSessionTaskOperation != nil);
+    tnl_dispatch_async_autoreleasing(sSynchronizeQueue, ^{
+        // a hedge races the task operation already in flight, it is never coalesced
+        [self _synchronize_createURLSessionTaskOperationForRequestOperationQueue:queue
+                                                                requestOperation:op
+                                                                   coalescingKey:nil
+                                                                      completion:complete];
+    });
+}
+
 - (void)getAllURLSessions:(TNLURLSessionManagerGetAllSessionsCallback)callback
 {
     tnl_dispatch_async_autoreleasing(sSynchronizeQueue, ^{
@@ -324,6 +444,22 @@ static void _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(dispatch_
     });
 }
 
+- (void)syncURLSessionTaskOperation:(TNLURLSessionTaskOperation *)op
+                      didChangeTask:(nullable NSURLSessionTask *)oldTask
+                             toTask:(NSURLSessionTask *)newTask
+{
+    NSURLSession *session = op.URLSession;
+    TNLAssert(session != nil);
+    if (!session) {
+        return;
+    }
+
+    // synchronous so the task is indexed before it is resumed (and before any delegate callbacks)
+    _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
+        [context changeOperation:op fromTask:oldTask toTask:newTask];
+    });
+}
+
 - (void)syncAddURLSessionTaskOperation:(TNLURLSessionTaskOperation *)op
 {
     dispatch_sync(sSynchronizeQueue, ^{
@@ -334,11 +470,10 @@ static void _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(dispatch_
         if ([TNLGlobalConfiguration sharedInstance].shouldBackoffUseOriginalRequestHost) {
             host = op.originalURLRequest.URL.host;
         }
-        [self _synchronize_applyBackoffDependenciesToOperation:op
-                                                   matchingURL:URL
-                                                          host:host
-                                                    isLongPoll:isLongPollRequest];
-        [sURLSessionTaskOperationQueue addOperation:op];
+        [self _synchronize_admitURLSessionTaskOperation:op
+                                            matchingURL:URL
+                                                   host:host
+                                             isLongPoll:isLongPollRequest];
     });
 }
 
@@ -369,9 +504,7 @@ static void _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(dispatch_
     tnl_dispatch_async_autoreleasing(sSynchronizeQueue, ^{
         if (sBackoffMode != mode) {
             sBackoffMode = mode;
-            // reset our backoffs
-            [sOutstandingBackoffOperations removeAllObjects];
-            [sOutstandingSerializeOperations removeAllObjects];
+            [self _synchronize_resetBackoffLimiters];
         }
     });
 }
@@ -385,6 +518,48 @@ static void _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(dispatch_
     return mode;
 }
 
+- (void)setAdaptiveConcurrencyEnabled:(BOOL)enabled
+{
+    tnl_dispatch_async_autoreleasing(sSynchronizeQueue, ^{
+        if (sAdaptiveConcurrencyEnabled != enabled) {
+            sAdaptiveConcurrencyEnabled = enabled;
+            [self _synchronize_resetBackoffLimiters];
+        }
+    });
+}
+
+- (BOOL)isAdaptiveConcurrencyEnabled
+{
+    __block BOOL enabled;
+    dispatch_sync(sSynchronizeQueue, ^{
+        enabled = sAdaptiveConcurrencyEnabled;
+    });
+    return enabled;
+}
+
+- (void)getAdaptiveConcurrencyLimits:(TNLGlobalConfigurationGetAdaptiveConcurrencyLimitsCallback)callback
+{
+    tnl_dispatch_async_autoreleasing(sSynchronizeQueue, ^{
+        NSMutableDictionary<NSString *, NSNumber *> *limits = [[NSMutableDictionary alloc] initWithCapacity:sBackoffLimiters.count];
+        [sBackoffLimiters enumerateKeysAndObjectsUsingBlock:^(NSString *key, TNLBackoffLimiter *limiter, BOOL *stop) {
+            if (limiter.adaptsConcurrency) {
+                limits[key] = @(limiter.concurrencyLimit);
+            }
+        }];
+        tnl_dispatch_async_autoreleasing(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            callback(limits);
+        });
+    });
+}
+
+- (void)URLSessionTaskOperation:(TNLURLSessionTaskOperation *)op
+  didCompleteAttemptWithMetrics:(nullable TNLAttemptMetrics *)metrics
+{
+    tnl_dispatch_async_autoreleasing(sSynchronizeQueue, ^{
+        [self _synchronize_URLSessionTaskOperation:op didCompleteAttemptWithMetrics:metrics];
+    });
+}
+
 - (void)setBackoffBehaviorProvider:(nullable id<TNLBackoffBehaviorProvider>)provider
 {
     tnl_dispatch_async_autoreleasing(sSynchronizeQueue, ^{
@@ -402,6 +577,24 @@ static void _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(dispatch_
     return provider;
 }
 
+- (void)setMaximumURLSessionCount:(NSUInteger)count
+{
+    tnl_dispatch_async_autoreleasing(sSynchronizeQueue, ^{
+        const NSUInteger countLimit = MAX(count, (NSUInteger)1);
+        sAppSessionContexts.countLimit = countLimit;
+        sAppSessionContexts.totalCostLimit = countLimit * kURLSessionContextCostLimitPerSession;
+    });
+}
+
+- (NSUInteger)maximumURLSessionCount
+{
+    __block NSUInteger count;
+    dispatch_sync(sSynchronizeQueue, ^{
+        count = sAppSessionContexts.countLimit;
+    });
+    return count;
+}
+
 - (void)pruneUnusedURLSessions
 {
     tnl_dispatch_async_autoreleasing(sSynchronizeQueue, ^{
@@ -422,27 +615,87 @@ static void _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(dispatch_
 
 @implementation TNLURLSessionManagerV1 (Synchronize)
 
-static void _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(dispatch_block_t block)
+- (void)_synchronize_findURLSessionTaskOperationForRequestOperationQueue:(TNLRequestOperationQueue *)requestOperationQueue
+                                                        requestOperation:(TNLRequestOperation *)requestOperation
+                                                              completion:(TNLRequestOperationQueueFindTaskOperationCompleteBlock)complete
 {
-    @autoreleasepool {
-        if (dispatch_queue_get_label(sSynchronizeQueue) == dispatch_queue_get_label(DISPATCH_CURRENT_QUEUE_LABEL)) {
-            block();
-        } else {
-            dispatch_sync(sSynchronizeQueue, block);
+    TNLAssert(requestOperation.URLSessionTaskOperation == nil);
+
+    NSString *coalescingKey = _CoalescingKeyForRequestOperation(requestOperation, requestOperationQueue);
+    if (coalescingKey) {
+        TNLURLSessionTaskOperation *taskOperation = [self _synchronize_coalescableTaskOperationForRequestOperation:requestOperation
+                                                                                                     coalescingKey:coalescingKey];
+        if (taskOperation) {
+            [taskOperation attachCoalescedRequestOperation:requestOperation
+                                                completion:^(BOOL attached) {
+                if (attached) {
+                    TNLLogDebug(@"Coalesced %@ onto %@", requestOperation, taskOperation);
+                    complete(taskOperation);
+                    return;
+                }
+
+                // the task operation finished before the request operation could attach
+                tnl_dispatch_async_autoreleasing(sSynchronizeQueue, ^{
+                    [self _synchronize_removeCoalescableTaskOperation:taskOperation];
+                    [self _synchronize_findURLSessionTaskOperationForRequestOperationQueue:requestOperationQueue
+                                                                          requestOperation:requestOperation
+                                                                                completion:complete];
+                });
+            }];
+            return;
         }
     }
+
+    [self _synchronize_createURLSessionTaskOperationForRequestOperationQueue:requestOperationQueue
+                                                            requestOperation:requestOperation
+                                                               coalescingKey:coalescingKey
+                                                                  completion:complete];
 }
 
-- (void)_synchronize_findURLSessionTaskOperationForRequestOperationQueue:(TNLRequestOperationQueue *)requestOperationQueue
-                                                        requestOperation:(TNLRequestOperation *)requestOperation
-                                                              completion:(TNLRequestOperationQueueFindTaskOperationCompleteBlock)complete
+- (nullable TNLURLSessionTaskOperation *)_synchronize_coalescableTaskOperationForRequestOperation:(TNLRequestOperation *)requestOperation
+                                                                                    coalescingKey:(NSString *)coalescingKey
+{
+    TNLRequestConfiguration *config = requestOperation.requestConfiguration;
+    NSURLRequest *request = requestOperation.hydratedURLRequest;
+    for (TNLURLSessionTaskOperation *taskOperation in sCoalescableURLSessionTaskOperations[coalescingKey]) {
+        if ([taskOperation.requestConfiguration isEqual:config] && _CoalescingRequestsAreIdentical(taskOperation.hydratedURLRequest, request, config.requestCoalescingHTTPHeaderFieldAllowList)) {
+            return taskOperation;
+        }
+    }
+    return nil;
+}
+
+- (void)_synchronize_removeCoalescableTaskOperation:(TNLURLSessionTaskOperation *)op
+{
+    NSString *coalescingKey = op.coalescingKey;
+    if (coalescingKey) {
+        NSMutableArray<TNLURLSessionTaskOperation *> *taskOperations = sCoalescableURLSessionTaskOperations[coalescingKey];
+        [taskOperations removeObjectIdenticalTo:op];
+        if (!taskOperations.count) {
+            [sCoalescableURLSessionTaskOperations removeObjectForKey:coalescingKey];
+        }
+    }
+}
+
+- (void)_synchronize_createURLSessionTaskOperationForRequestOperationQueue:(TNLRequestOperationQueue *)requestOperationQueue
+                                                          requestOperation:(TNLRequestOperation *)requestOperation
+                                                             coalescingKey:(nullable NSString *)coalescingKey
+                                                                completion:(TNLRequestOperationQueueFindTaskOperationCompleteBlock)complete
 {
-    TNLAssert(requestOperation.URLSessionTaskOperation == nil);
     TNLURLSessionTaskOperation *taskOperation = nil;
 
     // This NEEDS to be the ONLY place we create a TNLURLSessionTaskOperation.
     taskOperation = [[TNLURLSessionTaskOperation alloc] initWithRequestOperation:requestOperation
                                                                             sessionManager:self];
+    if (coalescingKey) {
+        taskOperation.coalescingKey = coalescingKey;
+        NSMutableArray<TNLURLSessionTaskOperation *> *taskOperations = sCoalescableURLSessionTaskOperations[coalescingKey];
+        if (!taskOperations) {
+            taskOperations = [[NSMutableArray alloc] init];
+            sCoalescableURLSessionTaskOperations[coalescingKey] = taskOperations;
+        }
+        [taskOperations addObject:taskOperation];
+    }
     NSURLSession *session = [self _synchronize_associateTaskOperation:taskOperation
                                                             withQueue:requestOperationQueue
                                                   supportsTaskMetrics:[self respondsToSelector:@selector(URLSession:task:didFinishCollectingMetrics:)]];
@@ -479,6 +732,7 @@ static void _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(dispatch_
     TNLAssert(context.URLSession != nil);
     [taskOperation setURLSession:context.URLSession supportsTaskMetrics:supportsTaskMetrics];
     [context addOperation:taskOperation];
+    [self _synchronize_updateCostOfSessionContext:context];
     [sActiveURLSessionTaskOperations addObject:taskOperation];
 
     return context.URLSession;
@@ -500,6 +754,7 @@ static void _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(dispatch_
         if (context) {
             // remove the operation from the context
             [context removeOperation:op];
+            [self _synchronize_updateCostOfSessionContext:context];
 
             // did the operation fail due to an invalidated NSURLSession?
             const BOOL opHadAnInvalidSession = op.error &&
@@ -526,6 +781,7 @@ static void _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(dispatch_
     }
 
     [sActiveURLSessionTaskOperations removeObject:op];
+    [self _synchronize_removeCoalescableTaskOperation:op];
 }
 
 - (nullable TNLURLSessionContext *)_synchronize_sessionContextWithQueueId:(nullable NSString *)operationQueueId
@@ -535,6 +791,22 @@ static void _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(dispatch_
 {
     TNLAssert(requestConfiguration);
 
+    TNLURLSessionIdentity *identity = nil;
+    if (executionMode != TNLRequestExecutionModeBackground) {
+        // Fast path: in-app sessions are found with the compact identity that the (immutable)
+        // request configuration caches, avoiding building the identification string on every lookup
+        identity = requestConfiguration.URLSessionIdentity;
+        TNLURLSessionContext *context = sAppSessionContextsByIdentity[identity];
+        if (context) {
+            // access via the LRU cache to keep the context most-recently-used
+            (void)[sAppSessionContexts entryWithIdentifier:context.reuseId];
+            return context;
+        }
+        if (!createIfNeeded) {
+            return nil;
+        }
+    }
+
     NSURLCache *canonicalCache = nil;
     NSURLCredentialStorage *canonicalCredentialStorage = nil;
     NSHTTPCookieStorage *canonicalCookieStorage = nil;
@@ -575,15 +847,27 @@ static void _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(dispatch_
             TNLAssert([reuseId isEqualToString:canonicalConfiguration.identifier]);
         }
 #endif
+
+        // Each session context is its own synchronization shard.
+        // Delegate callbacks for different sessions run in parallel on their own serial queues
+        // instead of all contending on the sSynchronizeQueue.
+        dispatch_queue_t contextQueue = dispatch_queue_create("TNLURLSessionContext.queue", DISPATCH_QUEUE_SERIAL);
+        NSOperationQueue *delegateQueue = [[NSOperationQueue alloc] init];
+        delegateQueue.name = @"TNLURLSessionContext.delegate.operation.queue";
+        delegateQueue.maxConcurrentOperationCount = 1;
+        delegateQueue.qualityOfService = (NSQualityOfServiceUtility + NSQualityOfServiceUserInitiated / 2);
+        delegateQueue.underlyingQueue = contextQueue;
         NSURLSession *session = [NSURLSession sessionWithConfiguration:canonicalConfiguration
                                                               delegate:self
-                                                         delegateQueue:sSynchronizeOperationQueue];
+                                                         delegateQueue:delegateQueue];
 
         static volatile atomic_int_fast64_t __attribute__((aligned(8))) sSessionId = ATOMIC_VAR_INIT(0);
         const int64_t sessionId = atomic_fetch_add(&sSessionId, 1);
 
         context = [[TNLURLSessionContext alloc] initWithURLSession:session
+                                                             queue:contextQueue
                                                            reuseId:reuseId
+                                                          identity:identity
                                                      executionMode:executionMode];
         NSString *sessionDescription = [NSString stringWithFormat:@"%@#%lli", reuseId, sessionId];
         session.sessionDescription = sessionDescription;
@@ -594,25 +878,6 @@ static void _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(dispatch_
     return context;
 }
 
-static NSString *_stripSessionIdentifierFromSessionDescription(NSString *sessionDescription)
-{
-    const NSRange range = [sessionDescription rangeOfString:@"#" options:NSBackwardsSearch];
-    if (range.location == NSNotFound) {
-        return sessionDescription;
-    }
-    return [sessionDescription substringToIndex:range.location];
-}
-
-- (nullable TNLURLSessionContext *)_synchronize_sessionContextFromURLSession:(NSURLSession *)session
-{
-    if (!self) {
-        return nil;
-    }
-
-    NSString *reuseId = _stripSessionIdentifierFromSessionDescription(session.sessionDescription);
-    return [self _synchronize_sessionContextWithConfigurationIdentifier:reuseId];
-}
-
 - (nullable TNLURLSessionContext *)_synchronize_sessionContextWithConfigurationIdentifier:(NSString *)identifier
 {
     return [sAppSessionContexts entryWithIdentifier:identifier] ?: [sBackgroundSessionContexts entryWithIdentifier:identifier];
@@ -625,10 +890,19 @@ static NSString *_stripSessionIdentifierFromSessionDescription(NSString *session
         // We don't cap the number of background sessions
     } else {
         [sAppSessionContexts addEntry:context];
-        [self _synchronize_pruneSessionsToLimit];
+        if (context.identity) {
+            sAppSessionContextsByIdentity[context.identity] = context;
+        }
+        // adding the entry enforces the sAppSessionContexts budget
     }
 }
 
+- (void)_synchronize_updateCostOfSessionContext:(TNLURLSessionContext *)context
+{
+    // the cost changes with the outstanding operations, which is not an access (recency is left alone)
+    [sAppSessionContexts updateCostOfEntry:context];
+}
+
 - (void)_synchronize_removeSessionContext:(TNLURLSessionContext *)context
 {
     if (context.executionMode == TNLRequestExecutionModeBackground) {
@@ -640,20 +914,9 @@ static NSString *_stripSessionIdentifierFromSessionDescription(NSString *session
 
 - (void)_synchronize_pruneSessionsToLimit
 {
-    if (sAppSessionContexts.numberOfEntries > kMaxURLSessionContextCount) {
-
-        // Get the least recently used context that doesn't have an associated operation
-        TNLURLSessionContext *tail = sAppSessionContexts.tailEntry;
-        while (tail && tail.operationCount > 0) {
-            tail = tail.previousLRUEntry;
-        }
-
-        // If we found an unused context, remove it
-        if (tail) {
-            [sAppSessionContexts removeEntry:tail];
-        }
-
-    }
+    // Contexts with operations cannot be evicted (see TNLURLSessionContextLRUCacheDelegate),
+    // so re-enforce the budget as operations complete
+    [sAppSessionContexts enforceBudgets];
 }
 
 - (void)_synchronize_pruneUnusedSessions
@@ -693,125 +956,178 @@ static NSString *_stripSessionIdentifierFromSessionDescription(NSString *session
     }
 }
 
-- (void)_synchronize_applyBackoffDependenciesToOperation:(NSOperation *)op
-                                             matchingURL:(NSURL *)URL
-                                                    host:(nullable NSString *)host
-                                              isLongPoll:(BOOL)isLongPoll
+- (nullable TNLBackoffLimiter *)_synchronize_backoffLimiterForURL:(NSURL *)URL
+                                                             host:(nullable NSString *)host
+                                                         machTime:(uint64_t)machTime
+                                                   createIfNeeded:(BOOL)createIfNeeded
 {
     // get the key (depends on the mode)
     NSString *key = _BackoffKeyFromURL(sBackoffMode, URL, host);
     if (!key) {
-        // no key, no dependencies to apply
-        return;
+        // no key, no backoff
+        return nil;
     }
 
-    NSHashTable<NSOperation *> *serialOps = sOutstandingSerializeOperations[key];
-    NSArray<NSOperation *> *serialOpsArray = _FilterArray(serialOps.allObjects, ^BOOL(NSOperation * obj){
-        return !obj.isFinished;
-    });
-    if (!serialOpsArray.count) {
-        // no serial ops left, clear it
-        [sOutstandingSerializeOperations removeObjectForKey:key];
-        serialOps = nil;
-        serialOpsArray = nil;
+    TNLBackoffLimiter *limiter = sBackoffLimiters[key];
+    if (limiter && !createIfNeeded && [limiter isExpiredAtMachTime:machTime]) {
+        // nothing left to limit, clear it
+        [sBackoffLimiters removeObjectForKey:key];
+        limiter = nil;
+    } else if (!limiter && createIfNeeded) {
+        limiter = [[TNLBackoffLimiter alloc] initWithAdaptiveConcurrency:sAdaptiveConcurrencyEnabled];
+        sBackoffLimiters[key] = limiter;
     }
+    return limiter;
+}
 
-    NSHashTable<NSOperation *> *backoffOps = sOutstandingBackoffOperations[key];
-    NSArray<NSOperation *> *backoffOpsArray = _FilterArray(backoffOps.allObjects, ^BOOL(NSOperation * obj){
-        return !obj.isFinished;
-    });
-    if (!backoffOpsArray.count) {
-        if (!serialOps) {
-            // no backoff ops left, clear it
-            [sOutstandingBackoffOperations removeObjectForKey:key];
-            backoffOps = nil;
-            backoffOpsArray = nil;
-        } else if (!backoffOps) {
-            // serial ops but no backoff ops, establish an empty hash-table to populate
-            backoffOps = [NSHashTable weakObjectsHashTable];
-            sOutstandingBackoffOperations[key] = backoffOps;
-        }
+- (void)_synchronize_applyBackoffDependenciesToOperation:(NSOperation *)op
+                                             matchingURL:(NSURL *)URL
+                                                    host:(nullable NSString *)host
+                                              isLongPoll:(BOOL)isLongPoll
+{
+    const uint64_t machTime = mach_absolute_time();
+    TNLBackoffLimiter *limiter = [self _synchronize_backoffLimiterForURL:URL
+                                                                    host:host
+                                                                machTime:machTime
+                                                          createIfNeeded:NO];
+    if (!limiter) {
+        return;
     }
 
-    // No backoff ops or serializing ops to back off with
-    if (!serialOps && !backoffOps) {
-        return;
+    // the caller enqueues the operation itself, so delay it with a single dependency
+    const uint64_t admissionMachTime = [limiter reserveAdmissionMachTimeForMachTime:machTime isLongPoll:isLongPoll];
+    if (admissionMachTime > machTime) {
+        NSOperation *timeoutOperation = [[TNLTimeoutOperation alloc] initWithTimeoutDuration:TNLComputeDuration(machTime, admissionMachTime)];
+        [op addDependency:timeoutOperation];
+        [sURLSessionTaskOperationQueue addOperation:timeoutOperation];
     }
-    TNLAssert(backoffOps != nil);
+}
 
-    // make this new operation dependent on prior backoff ops
-    for (NSOperation *otherOp in backoffOpsArray) {
-        [op addDependency:otherOp];
+- (void)_synchronize_admitURLSessionTaskOperation:(TNLURLSessionTaskOperation *)op
+                                      matchingURL:(NSURL *)URL
+                                             host:(nullable NSString *)host
+                                       isLongPoll:(BOOL)isLongPoll
+{
+    const uint64_t machTime = mach_absolute_time();
+    TNLBackoffLimiter *limiter = [self _synchronize_backoffLimiterForURL:URL
+                                                                    host:host
+                                                                machTime:machTime
+                                                          createIfNeeded:sAdaptiveConcurrencyEnabled && !isLongPoll];
+    if (!limiter) {
+        [sURLSessionTaskOperationQueue addOperation:op];
+        return;
     }
 
-    // add serial delay to slow things down while running serially
-    if (sSerialDelayDuration > 0 && serialOps.count > 0) {
-        NSOperation *timeoutOperation = [[TNLTimeoutOperation alloc] initWithTimeoutDuration:sSerialDelayDuration];
-        for (NSOperation *dep in op.dependencies) {
-            [timeoutOperation addDependency:dep];
-        }
-        [backoffOps addObject:timeoutOperation];
-        [sURLSessionTaskOperationQueue addOperation:timeoutOperation];
+    if ([limiter canAdmitImmediatelyAtMachTime:machTime isLongPoll:isLongPoll]) {
+        [limiter noteAdmittedOperation:op machTime:machTime isLongPoll:isLongPoll];
+        [sURLSessionTaskOperationQueue addOperation:op];
+        return;
     }
 
-    // store the op if not a long poll request AND we are still in a serialization mode
-    if (!isLongPoll && serialOps.count > 0) {
-        [backoffOps addObject:op];
+    [limiter enqueuePendingOperation:op machTime:machTime isLongPoll:isLongPoll];
+    if (!limiter.drainTimerSource) {
+        [self _synchronize_drainBackoffLimiter:limiter];
     }
 }
 
-- (void)_synchronize_backoffSignalEncounteredForURL:(NSURL *)URL
-                                               host:(nullable NSString *)host
-                                            headers:(nullable NSDictionary<NSString *, NSString *> *)headers
+- (void)_synchronize_drainBackoffLimiter:(TNLBackoffLimiter *)limiter
 {
-    NSString *key = _BackoffKeyFromURL(sBackoffMode, URL, host);
-    if (!key) {
-        // no key, no backoff to apply
-        return;
+    tnl_dispatch_timer_invalidate(limiter.drainTimerSource);
+    limiter.drainTimerSource = nil;
+
+    const uint64_t machTime = mach_absolute_time();
+    uint64_t nextAdmissionMachTime = 0;
+    for (NSOperation *op in [limiter dequeueAdmittedOperationsAtMachTime:machTime
+                                                   nextAdmissionMachTime:&nextAdmissionMachTime]) {
+        [sURLSessionTaskOperationQueue addOperation:op];
     }
 
-    const TNLBackoffBehavior backoffBehavior = [sBackoffBehaviorProvider tnl_backoffBehaviorForURL:URL
-                                                                                   responseHeaders:headers];
+    // with no next admission time, the limiter is waiting on in flight operations to complete
+    if (limiter.pendingOperationCount > 0 && nextAdmissionMachTime > 0) {
+        __weak typeof(self) weakSelf = self;
+        limiter.drainTimerSource = tnl_dispatch_timer_create_and_start(sSynchronizeQueue,
+                                                                       TNLComputeDuration(machTime, nextAdmissionMachTime),
+                                                                       0.005 /*leeway*/,
+                                                                       NO /*repeats*/,
+                                                                       ^{
+            [weakSelf _synchronize_drainBackoffLimiter:limiter];
+        });
+    }
+}
 
-    if (backoffBehavior.backoffDuration > 0) {
-        NSOperation *timeoutOperation = [[TNLTimeoutOperation alloc] initWithTimeoutDuration:backoffBehavior.backoffDuration];
-        NSHashTable<NSOperation *> *ops = sOutstandingBackoffOperations[key];
-        if (!ops) {
-            ops = [NSHashTable weakObjectsHashTable];
-            sOutstandingBackoffOperations[key] = ops;
+- (void)_synchronize_resetBackoffLimiters
+{
+    // release any operations that are still waiting
+    for (TNLBackoffLimiter *limiter in sBackoffLimiters.allValues) {
+        tnl_dispatch_timer_invalidate(limiter.drainTimerSource);
+        limiter.drainTimerSource = nil;
+        for (NSOperation *op in [limiter dequeueAllPendingOperations]) {
+            [sURLSessionTaskOperationQueue addOperation:op];
         }
+    }
+    [sBackoffLimiters removeAllObjects];
+}
 
-        // make all outstanding backed off ops depend on this new backoff op
-        for (NSOperation *op in ops.allObjects) {
-            [op addDependency:timeoutOperation];
-        }
+- (void)_synchronize_URLSessionTaskOperation:(TNLURLSessionTaskOperation *)op
+                 didCompleteAttemptWithMetrics:(nullable TNLAttemptMetrics *)metrics
+{
+    if (!sAdaptiveConcurrencyEnabled) {
+        return;
+    }
 
-        [ops addObject:timeoutOperation];
-        [sURLSessionTaskOperationQueue addOperation:timeoutOperation];
+    NSURL *URL = op.hydratedURLRequest.URL;
+    NSString *host = nil;
+    if ([TNLGlobalConfiguration sharedInstance].shouldBackoffUseOriginalRequestHost) {
+        host = op.originalURLRequest.URL.host;
+    }
+    const uint64_t machTime = mach_absolute_time();
+    TNLBackoffLimiter *limiter = [self _synchronize_backoffLimiterForURL:URL
+                                                                    host:host
+                                                                machTime:machTime
+                                                          createIfNeeded:NO];
+    if (!limiter) {
+        return;
+    }
 
-        // also add to the outstanding serialization ops
-        NSHashTable<NSOperation *> *serialOps = sOutstandingSerializeOperations[key];
-        if (!serialOps) {
-            serialOps = [NSHashTable weakObjectsHashTable];
-            sOutstandingSerializeOperations[key] = serialOps;
-        }
-        [serialOps addObject:timeoutOperation];
+    NSError *error = metrics.operationError;
+    const BOOL cancelled = [error.domain isEqualToString:TNLErrorDomain] && error.code == TNLErrorCodeRequestOperationCancelled;
+    BOOL completed;
+    if (!metrics || cancelled) {
+        // not a measurement of the backend
+        completed = [limiter abandonOperation:op];
+    } else {
+        const TNLHTTPStatusCode statusCode = metrics.URLResponse.statusCode;
+        const BOOL failed = (error != nil)
+                         || TNLHTTPStatusCodeIsServerError(statusCode)
+                         || (TNLHTTPStatusCodeTooManyRequests == statusCode);
+        completed = [limiter completeOperation:op
+                                   withLatency:_BackoffLatencyFromAttemptMetrics(metrics)
+                                        failed:failed
+                                      machTime:machTime];
     }
 
-    if (backoffBehavior.serializeDuration > 0) {
-        NSOperation *timeoutOperation = [[TNLTimeoutOperation alloc] initWithTimeoutDuration:backoffBehavior.serializeDuration];
-        NSHashTable<NSOperation *> *ops = sOutstandingSerializeOperations[key];
-        if (!ops) {
-            ops = [NSHashTable weakObjectsHashTable];
-            sOutstandingSerializeOperations[key] = ops;
-        }
+    if (completed && limiter.pendingOperationCount > 0) {
+        [self _synchronize_drainBackoffLimiter:limiter];
+    }
+}
 
-        // track the new serialize timer
-        [ops addObject:timeoutOperation];
-        [sURLSessionTaskOperationQueue addOperation:timeoutOperation];
+- (void)_synchronize_backoffSignalEncounteredForURL:(NSURL *)URL
+                                               host:(nullable NSString *)host
+                                            headers:(nullable NSDictionary<NSString *, NSString *> *)headers
+{
+    const TNLBackoffBehavior backoffBehavior = [sBackoffBehaviorProvider tnl_backoffBehaviorForURL:URL
+                                                                                   responseHeaders:headers];
+    if (backoffBehavior.backoffDuration <= 0 && backoffBehavior.serializeDuration <= 0) {
+        // nothing to apply
+        return;
     }
 
-    sSerialDelayDuration = backoffBehavior.serialDelayDuration;
+    const uint64_t machTime = mach_absolute_time();
+    TNLBackoffLimiter *limiter = [self _synchronize_backoffLimiterForURL:URL
+                                                                    host:host
+                                                                machTime:machTime
+                                                          createIfNeeded:YES];
+    [limiter applyBackoffBehavior:backoffBehavior machTime:machTime];
 }
 
 @end
@@ -827,8 +1143,7 @@ static NSString *_stripSessionIdentifierFromSessionDescription(NSString *session
 
     // TODO: do we need to propogate this event to operations at all?
 
-    _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(^{
-        TNLURLSessionContext *context = [self _synchronize_sessionContextFromURLSession:session];
+    _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
 
         for (TNLURLSessionTaskOperation *op in context.URLSessionTaskOperations) {
             [op URLSession:session didBecomeInvalidWithError:error];
@@ -869,8 +1184,7 @@ static NSString *_stripSessionIdentifierFromSessionDescription(NSString *session
     }
 
      // all the downstream operations
-     _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(^{
-         TNLURLSessionContext *context = [self _synchronize_sessionContextFromURLSession:session];
+     _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
          for (TNLURLSessionTaskOperation *op in context.URLSessionTaskOperations) {
              [op handler:handler
                  didCancelAuthenticationChallenge:challenge
@@ -969,8 +1283,7 @@ static NSString *_stripSessionIdentifierFromSessionDescription(NSString *session
         taskIsWaitingForConnectivity:(NSURLSessionTask *)task
 {
     METHOD_LOG();
-    _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(^{
-        TNLURLSessionContext *context = [self _synchronize_sessionContextFromURLSession:session];
+    _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
         TNLURLSessionTaskOperation *op = [context operationForTask:task];
 
         if (op) {
@@ -988,8 +1301,7 @@ static NSString *_stripSessionIdentifierFromSessionDescription(NSString *session
         completionHandler:(void (^)(NSURLRequest *))completionHandler
 {
     METHOD_LOG();
-    _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(^{
-        TNLURLSessionContext *context = [self _synchronize_sessionContextFromURLSession:session];
+    _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
         TNLURLSessionTaskOperation *op = [context operationForTask:task];
 
         if (op) {
@@ -1012,8 +1324,7 @@ willPerformHTTPRedirection:response
     METHOD_LOG();
 
     __block TNLURLSessionTaskOperation *op = nil;
-    _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(^{
-        TNLURLSessionContext *context = [self _synchronize_sessionContextFromURLSession:session];
+    _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
         op = [context operationForTask:task];
     });
 
@@ -1043,8 +1354,7 @@ willPerformHTTPRedirection:response
  needNewBodyStream:(void (^)(NSInputStream * __nullable bodyStream))completionHandler
 {
     METHOD_LOG();
-    _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(^{
-        TNLURLSessionContext *context = [self _synchronize_sessionContextFromURLSession:session];
+    _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
         TNLURLSessionTaskOperation *op = [context operationForTask:task];
 
         if (op) {
@@ -1063,8 +1373,7 @@ willPerformHTTPRedirection:response
         totalBytesSent:(int64_t)totalBytesSent
         totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend
 {
-    _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(^{
-        TNLURLSessionContext *context = [self _synchronize_sessionContextFromURLSession:session];
+    _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
         TNLURLSessionTaskOperation *op = [context operationForTask:task];
 
         if (op) {
@@ -1082,8 +1391,7 @@ willPerformHTTPRedirection:response
         task:(NSURLSessionTask *)task
         didCompleteWithError:(nullable NSError *)error
 {
-    _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(^{
-        TNLURLSessionContext *context = [self _synchronize_sessionContextFromURLSession:session];
+    _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
         TNLURLSessionTaskOperation *op = [context operationForTask:task];
 
         if (op) {
@@ -1106,8 +1414,7 @@ willPerformHTTPRedirection:response
 didReceiveResponse:(NSURLResponse *)response
  completionHandler:(void (^)(NSURLSessionResponseDisposition disposition))completionHandler
 {
-    _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(^{
-        TNLURLSessionContext *context = [self _synchronize_sessionContextFromURLSession:session];
+    _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
         TNLURLSessionTaskOperation *op = [context operationForTask:dataTask];
 
         if (op) {
@@ -1130,8 +1437,7 @@ didReceiveResponse:(NSURLResponse *)response
           dataTask:(NSURLSessionDataTask *)dataTask
     didReceiveData:(NSData *)data
 {
-    _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(^{
-        TNLURLSessionContext *context = [self _synchronize_sessionContextFromURLSession:session];
+    _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
         TNLURLSessionTaskOperation *op = [context operationForTask:dataTask];
 
         if (op) {
@@ -1145,8 +1451,7 @@ didReceiveResponse:(NSURLResponse *)response
  willCacheResponse:(NSCachedURLResponse *)proposedResponse
  completionHandler:(void (^)(NSCachedURLResponse *cachedResponse))completionHandler
 {
-    _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(^{
-        TNLURLSessionContext *context = [self _synchronize_sessionContextFromURLSession:session];
+    _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
         TNLURLSessionTaskOperation *op = [context operationForTask:dataTask];
         NSCachedURLResponse *flaggedResponse = [proposedResponse tnl_flaggedCachedResponse];
 
@@ -1167,8 +1472,7 @@ didReceiveResponse:(NSURLResponse *)response
       downloadTask:(NSURLSessionDownloadTask *)downloadTask
 didFinishDownloadingToURL:(NSURL *)location
 {
-    _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(^{
-        TNLURLSessionContext *context = [self _synchronize_sessionContextFromURLSession:session];
+    _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
         TNLURLSessionTaskOperation *op = [context operationForTask:downloadTask];
 
         if (op) {
@@ -1185,8 +1489,7 @@ didFinishDownloadingToURL:(NSURL *)location
         totalBytesWritten:(int64_t)totalBytesWritten
         totalBytesExpectedToWrite:(int64_t)totalBytesExpectedToWrite
 {
-    _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(^{
-        TNLURLSessionContext *context = [self _synchronize_sessionContextFromURLSession:session];
+    _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
         TNLURLSessionTaskOperation *op = [context operationForTask:downloadTask];
 
         if (op) {
@@ -1204,8 +1507,7 @@ didFinishDownloadingToURL:(NSURL *)location
  didResumeAtOffset:(int64_t)fileOffset
 expectedTotalBytes:(int64_t)expectedTotalBytes
 {
-    _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(^{
-        TNLURLSessionContext *context = [self _synchronize_sessionContextFromURLSession:session];
+    _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
         TNLURLSessionTaskOperation *op = [context operationForTask:downloadTask];
 
         if (op) {
@@ -1221,7 +1523,25 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
 
 static volatile atomic_int_fast32_t sSessionContextCount = ATOMIC_VAR_INIT(0);
 
+@implementation TNLURLSessionContextReference
+@end
+
+static void _ReleaseURLSessionContextReference(void * __nullable reference)
+{
+    if (reference) {
+        CFRelease(reference);
+    }
+}
+
 @implementation TNLURLSessionContext
+{
+    TNLURLSessionContextReference *_reference;
+    NSMutableSet<TNLURLSessionTaskOperation *> *_operations;
+    NSMapTable<NSURLSessionTask *, TNLURLSessionTaskOperation *> *_operationsByTask;
+    NSMapTable<TNLURLSessionTaskOperation *, NSURLSessionTask *> *_tasksByOperation;
+    volatile atomic_uint_fast64_t _operationCount;
+    volatile atomic_uint_fast64_t _lastOperationRemovedMachTimeValue;
+}
 
 @synthesize nextLRUEntry = _nextLRUEntry;
 @synthesize previousLRUEntry = _previousLRUEntry;
@@ -1236,17 +1556,43 @@ static volatile atomic_int_fast32_t sSessionContextCount = ATOMIC_VAR_INIT(0);
     return YES;
 }
 
+- (NSUInteger)LRUEntryCost
+{
+    // the session itself plus the operations it is running
+    return 1 + self.operationCount;
+}
+
 - (instancetype)initWithURLSession:(NSURLSession *)URLSession
+                             queue:(dispatch_queue_t)queue
                            reuseId:(NSString *)reuseId
+                          identity:(nullable TNLURLSessionIdentity *)identity
                      executionMode:(TNLRequestExecutionMode)mode
 {
     if (self = [super init]) {
         TNLIncrementObjectCount([self class]);
 
         TNLAssert(reuseId != nil);
+        TNLAssert((identity != nil) == (mode != TNLRequestExecutionModeBackground));
         _reuseId = [reuseId copy];
+        _identity = identity;
         _URLSession = URLSession;
-        _URLSessionTaskOperations = [[NSMutableArray alloc] init];
+        _operations = [[NSMutableSet alloc] init];
+        _operationsByTask = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                                  valueOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality];
+        _tasksByOperation = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                                  valueOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality];
+        atomic_init(&_operationCount, 0);
+        atomic_init(&_lastOperationRemovedMachTimeValue, 0);
+
+        // Tag our queue so that delegate callbacks can find this context without going through
+        // the global sSynchronizeQueue (the reference is weak and is released with the queue)
+        _queue = queue;
+        _reference = [[TNLURLSessionContextReference alloc] init];
+        _reference.context = self;
+        dispatch_queue_set_specific(_queue,
+                                    kURLSessionContextQueueKey,
+                                    (__bridge_retained void *)_reference,
+                                    _ReleaseURLSessionContextReference);
 
         const int32_t previousCount = atomic_fetch_add(&sSessionContextCount, 1);
         TNLLogInformation(@"+%@ (%i): %@", NSStringFromClass([self class]), previousCount, reuseId);
@@ -1272,69 +1618,110 @@ static volatile atomic_int_fast32_t sSessionContextCount = ATOMIC_VAR_INIT(0);
     TNLLogInformation(@"-%@ (%i): %@", NSStringFromClass([self class]), previousCount, _reuseId);
     // TNLLogDebug(@"Destroy %@", _URLSession);
 
-    TNLURLSessionTaskOperation *op = nil;
-    while ((op = _URLSessionTaskOperations.firstObject) != nil) {
-        [self removeOperation:op];
-    }
+    // Can be on any queue (including our own), just let the operations go without hopping queues
+    [_operationsByTask removeAllObjects];
+    [_tasksByOperation removeAllObjects];
+    [_operations removeAllObjects];
     [_URLSession finishTasksAndInvalidate];
     TNLDecrementObjectCount([self class]);
 }
 
+- (void)_executeOnQueue:(dispatch_block_t)block
+{
+    if (dispatch_get_specific(kURLSessionContextQueueKey) == (__bridge void *)_reference) {
+        block();
+    } else {
+        dispatch_sync(_queue, block);
+    }
+}
+
 - (NSUInteger)operationCount
 {
-    return _URLSessionTaskOperations.count;
+    return (NSUInteger)atomic_load(&_operationCount);
+}
+
+- (uint64_t)lastOperationRemovedMachTime
+{
+    return atomic_load(&_lastOperationRemovedMachTimeValue);
+}
+
+- (NSArray<TNLURLSessionTaskOperation *> *)URLSessionTaskOperations
+{
+    TNLAssert(dispatch_get_specific(kURLSessionContextQueueKey) == (__bridge void *)_reference);
+    return _operations.allObjects;
 }
 
 - (void)addOperation:(TNLURLSessionTaskOperation *)op
 {
     TNLAssert(op);
     TNLAssert([op isKindOfClass:[TNLURLSessionTaskOperation class]]);
-    [(NSMutableArray<TNLURLSessionTaskOperation *> *)_URLSessionTaskOperations addObject:op];
-    _lastOperationRemovedMachTime = 0;
+    [self _executeOnQueue:^{
+        [self->_operations addObject:op];
+        atomic_store(&self->_operationCount, self->_operations.count);
+        atomic_store(&self->_lastOperationRemovedMachTimeValue, 0);
+
+        // Normally the task is created after the operation is added (see changeOperation:fromTask:toTask:)
+        NSURLSessionTask *task = op.URLSessionTask;
+        if (task) {
+            [self->_operationsByTask setObject:op forKey:task];
+            [self->_tasksByOperation setObject:task forKey:op];
+        }
+    }];
 }
 
 - (void)removeOperation:(TNLURLSessionTaskOperation *)op
 {
-    NSUInteger idx = [_URLSessionTaskOperations indexOfObject:op];
-    if (NSNotFound != idx) {
-        [(NSMutableArray<TNLURLSessionTaskOperation *> *)_URLSessionTaskOperations removeObjectAtIndex:idx];
-        if (0 == _URLSessionTaskOperations.count) {
-            _lastOperationRemovedMachTime = mach_absolute_time();
+    [self _executeOnQueue:^{
+        if (![self->_operations containsObject:op]) {
+            return;
         }
-    }
+
+        [self->_operations removeObject:op];
+        NSURLSessionTask *task = [self->_tasksByOperation objectForKey:op];
+        if (task) {
+            [self->_tasksByOperation removeObjectForKey:op];
+            [self->_operationsByTask removeObjectForKey:task];
+        }
+
+        const NSUInteger count = self->_operations.count;
+        atomic_store(&self->_operationCount, count);
+        if (0 == count) {
+            atomic_store(&self->_lastOperationRemovedMachTimeValue, mach_absolute_time());
+        }
+    }];
 }
 
 - (nullable TNLURLSessionTaskOperation *)operationForTask:(NSURLSessionTask *)task
 {
     TNLAssert(task != nil);
-    for (TNLURLSessionTaskOperation *operation in _URLSessionTaskOperations) {
-        if (operation.URLSessionTask == task) {
-            return operation;
-        } else {
-            TNLAssert([operation isKindOfClass:[TNLURLSessionTaskOperation class]]);
-#if DEBUG
-            const NSUInteger taskIdentifier = task.taskIdentifier;
-            const NSUInteger opTaskIdentifier = operation.URLSessionTask.taskIdentifier; // not thread safe, thus DEBUG only
-            if (taskIdentifier == opTaskIdentifier) {
-                if (task != operation.URLSessionTask) {
-                    TNLLogError(@"Two tasks with the same identifier for the same session are not the same...?\n\tTask 1: %@ { taskIdentifier: %tu, request: %@ }\n\tTask 2: %@ { taskIdentifier: %tu, request: %@ }", task, taskIdentifier, task.currentRequest, operation.URLSessionTask, opTaskIdentifier, operation.URLSessionTask.currentRequest);
-                }
-            }
-#endif
-        }
-    }
-    return nil;
+    TNLAssert(dispatch_get_specific(kURLSessionContextQueueKey) == (__bridge void *)_reference);
+
+    // constant time lookup, this is called for every delegate callback (including each chunk of data)
+    return [_operationsByTask objectForKey:task];
 }
 
 - (void)changeOperation:(TNLURLSessionTaskOperation *)op
-               fromTask:(NSURLSessionTask *)oldTask
+               fromTask:(nullable NSURLSessionTask *)oldTask
                  toTask:(NSURLSessionTask *)newTask
 {
     TNLAssert(op != nil);
-    TNLAssert(oldTask != nil);
     TNLAssert(newTask != nil);
     TNLAssert(oldTask != newTask);
-    // TNLAssert(oldTask.taskIdentifier != newTask.taskIdentifier);
+    [self _executeOnQueue:^{
+        if (![self->_operations containsObject:op]) {
+            // not (or no longer) associated with this context
+            return;
+        }
+
+        NSURLSessionTask *previousTask = [self->_tasksByOperation objectForKey:op];
+        TNLAssert(!previousTask || !oldTask || previousTask == oldTask);
+        if (previousTask) {
+            [self->_operationsByTask removeObjectForKey:previousTask];
+        }
+        TNLAssert(![self->_operationsByTask objectForKey:newTask]);
+        [self->_operationsByTask setObject:op forKey:newTask];
+        [self->_tasksByOperation setObject:newTask forKey:op];
+    }];
 }
 
 @end
@@ -1561,8 +1948,7 @@ static volatile atomic_int_fast32_t sSessionContextCount = ATOMIC_VAR_INIT(0);
         task:(NSURLSessionTask *)task
         didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics
 {
-    _executeOnSynchronizeGCDQueueFromSynchronizeOperationQueue(^{
-        TNLURLSessionContext *context = [self _synchronize_sessionContextFromURLSession:session];
+    _ExecuteOnURLSessionContextQueue(session, ^(TNLURLSessionContext * __nullable context) {
         TNLURLSessionTaskOperation *op = [context operationForTask:task];
 
         if (op) {
@@ -1577,9 +1963,289 @@ static volatile atomic_int_fast32_t sSessionContextCount = ATOMIC_VAR_INIT(0);
 
 - (void)tnl_cache:(TNLLRUCache *)cache didEvictEntry:(TNLURLSessionContext *)entry
 {
+    TNLURLSessionIdentity *identity = entry.identity;
+    if (identity && sAppSessionContextsByIdentity[identity] == entry) {
+        [sAppSessionContextsByIdentity removeObjectForKey:identity];
+    }
     TNLLogInformation(@"Evicted TNLURLSessionContext with identifier: %@", entry.reuseId);
 }
 
+- (BOOL)tnl_cache:(TNLLRUCache *)cache canEvictEntry:(TNLURLSessionContext *)entry
+{
+    // only unused contexts can be evicted
+    return entry.operationCount == 0;
+}
+
+@end
+
+@implementation TNLBackoffPendingOperation
+@end
+
+@implementation TNLBackoffLimiter
+{
+    uint64_t _gateMachTime;
+    uint64_t _serializeEndMachTime;
+    uint64_t _serialIntervalMachTime;
+    uint64_t _nextSerialAdmissionMachTime;
+
+    // FIFO of pending operations
+    NSMutableArray<TNLBackoffPendingOperation *> *_pendingOperations;
+    NSUInteger _pendingHeadIndex;
+
+    // adaptive concurrency
+    NSMutableSet<NSOperation *> *_inFlightOperations;
+    double _concurrencyLimit;
+    NSTimeInterval _baselineLatency;
+    uint64_t _nextDecreaseMachTime;
+}
+
+- (instancetype)initWithAdaptiveConcurrency:(BOOL)adaptsConcurrency
+{
+    if (self = [super init]) {
+        _adaptsConcurrency = adaptsConcurrency;
+        _pendingOperations = [[NSMutableArray alloc] init];
+        _serialIntervalMachTime = TNLAbsoluteFromTimeInterval(kBackoffMinimumSerialAdmissionInterval);
+        if (adaptsConcurrency) {
+            _inFlightOperations = [[NSMutableSet alloc] init];
+            _concurrencyLimit = kAdaptiveConcurrencyInitialLimit;
+        }
+    }
+    return self;
+}
+
+- (NSUInteger)pendingOperationCount
+{
+    return _pendingOperations.count - _pendingHeadIndex;
+}
+
+- (NSUInteger)concurrencyLimit
+{
+    return (NSUInteger)_concurrencyLimit;
+}
+
+- (void)applyBackoffBehavior:(TNLBackoffBehavior)behavior machTime:(uint64_t)machTime
+{
+    const NSTimeInterval backoffDuration = MAX(behavior.backoffDuration, 0.0);
+    const NSTimeInterval serializeDuration = MAX(backoffDuration, behavior.serializeDuration);
+
+    _gateMachTime = MAX(_gateMachTime, machTime + TNLAbsoluteFromTimeInterval(backoffDuration));
+    _serializeEndMachTime = MAX(_serializeEndMachTime, machTime + TNLAbsoluteFromTimeInterval(serializeDuration));
+    _serialIntervalMachTime = TNLAbsoluteFromTimeInterval(MAX(behavior.serialDelayDuration, kBackoffMinimumSerialAdmissionInterval));
+
+    // queued operations are not stamped with admission times, pushing the next serial admission
+    // past the new gate keeps them paced (rather than released together) once it opens
+    _nextSerialAdmissionMachTime = MAX(_nextSerialAdmissionMachTime, _gateMachTime);
+}
+
+- (BOOL)_isSerializingAtMachTime:(uint64_t)machTime
+{
+    return machTime < _serializeEndMachTime;
+}
+
+- (uint64_t)reserveAdmissionMachTimeForMachTime:(uint64_t)machTime isLongPoll:(BOOL)isLongPoll
+{
+    uint64_t admissionMachTime = MAX(machTime, _gateMachTime);
+    if (!isLongPoll && [self _isSerializingAtMachTime:machTime]) {
+        // long polls sit idle on the server, they don't count toward serialization
+        admissionMachTime = MAX(admissionMachTime, _nextSerialAdmissionMachTime);
+        _nextSerialAdmissionMachTime = admissionMachTime + _serialIntervalMachTime;
+    }
+    return admissionMachTime;
+}
+
+- (BOOL)_hasConcurrencyAvailable
+{
+    return !_adaptsConcurrency || _inFlightOperations.count < (NSUInteger)_concurrencyLimit;
+}
+
+- (BOOL)canAdmitImmediatelyAtMachTime:(uint64_t)machTime isLongPoll:(BOOL)isLongPoll
+{
+    if (machTime < _gateMachTime) {
+        return NO;
+    }
+    if (isLongPoll) {
+        // long polls are neither serialized nor concurrency limited
+        return YES;
+    }
+    if ([self _isSerializingAtMachTime:machTime] && machTime < _nextSerialAdmissionMachTime) {
+        return NO;
+    }
+    // don't jump ahead of operations already waiting
+    return 0 == self.pendingOperationCount && [self _hasConcurrencyAvailable];
+}
+
+- (void)noteAdmittedOperation:(NSOperation *)op machTime:(uint64_t)machTime isLongPoll:(BOOL)isLongPoll
+{
+    [self _noteAdmittedOperation:op machTime:machTime isLongPoll:isLongPoll isSerialized:[self _isSerializingAtMachTime:machTime]];
+}
+
+- (void)_noteAdmittedOperation:(NSOperation *)op
+                      machTime:(uint64_t)machTime
+                    isLongPoll:(BOOL)isLongPoll
+                  isSerialized:(BOOL)isSerialized
+{
+    if (isLongPoll) {
+        return;
+    }
+    if (isSerialized) {
+        _nextSerialAdmissionMachTime = machTime + _serialIntervalMachTime;
+    }
+    if (_adaptsConcurrency) {
+        [_inFlightOperations addObject:op];
+    }
+}
+
+- (BOOL)abandonOperation:(NSOperation *)op
+{
+    if (![_inFlightOperations containsObject:op]) {
+        // an operation cancelled while waiting never gets admitted
+        [self _removePendingOperation:op];
+        return NO;
+    }
+    [_inFlightOperations removeObject:op];
+    return YES;
+}
+
+- (void)_removePendingOperation:(NSOperation *)op
+{
+    for (NSUInteger i = _pendingHeadIndex; i < _pendingOperations.count; i++) {
+        if (_pendingOperations[i]->_operation == op) {
+            [_pendingOperations removeObjectAtIndex:i];
+            return;
+        }
+    }
+}
+
+- (BOOL)completeOperation:(NSOperation *)op
+              withLatency:(NSTimeInterval)latency
+                   failed:(BOOL)failed
+                 machTime:(uint64_t)machTime
+{
+    if (![_inFlightOperations containsObject:op]) {
+        return NO;
+    }
+
+    const NSUInteger inFlightCount = _inFlightOperations.count;
+    [_inFlightOperations removeObject:op];
+
+    const BOOL congested = failed || (_baselineLatency > 0 && latency > _baselineLatency * kAdaptiveConcurrencyLatencyTolerance);
+    if (congested) {
+        // multiplicative decrease, at most once per round trip so a burst of slow responses counts once
+        if (machTime >= _nextDecreaseMachTime) {
+            _concurrencyLimit = MAX(kAdaptiveConcurrencyMinimumLimit, _concurrencyLimit * kAdaptiveConcurrencyDecreaseFactor);
+            _nextDecreaseMachTime = machTime + TNLAbsoluteFromTimeInterval(MAX(_baselineLatency, kAdaptiveConcurrencyMinimumDecreaseInterval));
+        }
+    } else if ((double)inFlightCount * 2.0 >= _concurrencyLimit) {
+        // additive increase (about +1 per limit's worth of completions), only when the limit is actually being used
+        _concurrencyLimit = MIN(kAdaptiveConcurrencyMaximumLimit, _concurrencyLimit + (1.0 / _concurrencyLimit));
+    }
+
+    if (!failed && latency > 0) {
+        // the baseline tracks the fastest responses, slowly following latency upward
+        if (_baselineLatency <= 0 || latency < _baselineLatency) {
+            _baselineLatency = latency;
+        } else {
+            _baselineLatency += (latency - _baselineLatency) * kAdaptiveConcurrencyBaselineDrift;
+        }
+    }
+
+    return YES;
+}
+
+- (BOOL)isExpiredAtMachTime:(uint64_t)machTime
+{
+    if (_adaptsConcurrency) {
+        // keep a reduced limit around, it is what protects the backend
+        if (_inFlightOperations.count > 0 || _concurrencyLimit < kAdaptiveConcurrencyInitialLimit) {
+            return NO;
+        }
+    }
+    return 0 == self.pendingOperationCount
+        && machTime >= _gateMachTime
+        && machTime >= _serializeEndMachTime
+        && machTime >= _nextSerialAdmissionMachTime;
+}
+
+- (void)enqueuePendingOperation:(NSOperation *)op
+                       machTime:(uint64_t)machTime
+                     isLongPoll:(BOOL)isLongPoll
+{
+    TNLBackoffPendingOperation *pendingOperation = [[TNLBackoffPendingOperation alloc] init];
+    pendingOperation->_operation = op;
+    pendingOperation->_isLongPoll = isLongPoll;
+    pendingOperation->_isSerialized = !isLongPoll && [self _isSerializingAtMachTime:machTime];
+    [_pendingOperations addObject:pendingOperation];
+}
+
+- (NSArray<NSOperation *> *)dequeueAdmittedOperationsAtMachTime:(uint64_t)machTime
+                                          nextAdmissionMachTime:(out uint64_t *)nextAdmissionMachTimeOut
+{
+    NSMutableArray<NSOperation *> *admittedOperations = [[NSMutableArray alloc] init];
+    uint64_t nextAdmissionMachTime = 0; // 0 == wait for an operation to complete
+
+    // admission is decided at the head of the FIFO against the current schedule,
+    // so a backoff signal that arrives while operations wait applies to all of them
+    const NSUInteger count = _pendingOperations.count;
+    while (_pendingHeadIndex < count) {
+        if (machTime < _gateMachTime) {
+            nextAdmissionMachTime = _gateMachTime;
+            break;
+        }
+        TNLBackoffPendingOperation *pendingOperation = _pendingOperations[_pendingHeadIndex];
+        NSOperation *op = pendingOperation->_operation;
+        if (op.isFinished || op.isCancelled) {
+            // cancelled while waiting, drop it without taking a serial admission or a concurrency slot
+            _pendingHeadIndex++;
+            continue;
+        }
+        const BOOL isSerialized = pendingOperation->_isSerialized || [self _isSerializingAtMachTime:machTime];
+        if (!pendingOperation->_isLongPoll) {
+            if (isSerialized && machTime < _nextSerialAdmissionMachTime) {
+                nextAdmissionMachTime = _nextSerialAdmissionMachTime;
+                break;
+            }
+            if (![self _hasConcurrencyAvailable]) {
+                break;
+            }
+        }
+        [self _noteAdmittedOperation:op
+                            machTime:machTime
+                          isLongPoll:pendingOperation->_isLongPoll
+                        isSerialized:isSerialized];
+        [admittedOperations addObject:op];
+        _pendingHeadIndex++;
+    }
+    [self _compactPendingOperations];
+
+    if (nextAdmissionMachTimeOut) {
+        *nextAdmissionMachTimeOut = nextAdmissionMachTime;
+    }
+    return admittedOperations;
+}
+
+- (NSArray<NSOperation *> *)dequeueAllPendingOperations
+{
+    NSMutableArray<NSOperation *> *operations = [[NSMutableArray alloc] initWithCapacity:self.pendingOperationCount];
+    for (NSUInteger i = _pendingHeadIndex; i < _pendingOperations.count; i++) {
+        NSOperation *op = _pendingOperations[i]->_operation;
+        if (!op.isFinished && !op.isCancelled) {
+            [operations addObject:op];
+        }
+    }
+    [_pendingOperations removeAllObjects];
+    _pendingHeadIndex = 0;
+    return operations;
+}
+
+- (void)_compactPendingOperations
+{
+    // only shift the FIFO once the consumed head dominates it, keeping dequeues amortized O(1)
+    if (_pendingHeadIndex > 0 && _pendingHeadIndex * 2 >= _pendingOperations.count) {
+        [_pendingOperations removeObjectsInRange:NSMakeRange(0, _pendingHeadIndex)];
+        _pendingHeadIndex = 0;
+    }
+}
+
 @end
 
 #pragma mark Exposed Functions
@@ -1687,48 +2353,81 @@ static void TNLMutableParametersStripOverriddenURLSessionProperties(TNLMutablePa
     params[TNLRequestConfigurationPropertyKeyNetworkServiceType] = nil;
 }
 
-static NSArray *_FilterArray(NSArray *source, _FilterBlock filterBlock)
+BOOL TNLURLSessionIdentifierIsTaggedForTNL(NSString *identifier)
 {
-    NSMutableIndexSet *set = [[NSMutableIndexSet alloc] init];
-    [source enumerateObjectsUsingBlock:^(id  _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
-        if (filterBlock(obj)) {
-            [set addIndex:idx];
-        }
-    }];
+    return [identifier hasPrefix:[TNLTwitterNetworkLayerURLScheme stringByAppendingString:@"://"]];
+}
 
-    if (set.count == 0) {
-        // no matches
-        return nil;
-    }
+#pragma mark Private Functions
 
-    if (((set.lastIndex - set.firstIndex) + 1) == set.count) {
-        // contiguous!
+static void _ExecuteOnURLSessionContextQueue(NSURLSession *session, _URLSessionContextBlock block)
+{
+    @autoreleasepool {
+        // The session's delegate queue is the context's queue, which is tagged with a weak reference
+        // to the context.  No global lookup (and no global lock) is needed.
+        dispatch_queue_t queue = session.delegateQueue.underlyingQueue;
+        void *specific = (queue) ? dispatch_queue_get_specific(queue, kURLSessionContextQueueKey) : NULL;
+        if (!specific) {
+            // not a session managed by a context
+            block(nil);
+            return;
+        }
 
-        if (set.firstIndex == 0 && set.lastIndex == (source.count - 1)) {
-            // same as source
-            return [source copy];
+        TNLURLSessionContextReference *reference = (__bridge TNLURLSessionContextReference *)specific;
+        if (dispatch_get_specific(kURLSessionContextQueueKey) == specific) {
+            block(reference.context);
         } else {
-            return [source subarrayWithRange:NSMakeRange(set.firstIndex, set.count)];
+            dispatch_sync(queue, ^{
+                block(reference.context);
+            });
         }
     }
+}
 
-    // non-contiguous
+static NSString * __nullable _CoalescingKeyForRequestOperation(TNLRequestOperation *op, TNLRequestOperationQueue *queue)
+{
+    TNLRequestConfiguration *config = op.requestConfiguration;
+    if (!config.coalescesIdenticalRequests) {
+        return nil;
+    }
+    if (config.executionMode == TNLRequestExecutionModeBackground) {
+        return nil;
+    }
+    if (config.responseDataConsumptionMode != TNLResponseDataConsumptionModeStoreInMemory) {
+        return nil;
+    }
 
-    NSMutableArray *destination = [[NSMutableArray alloc] initWithCapacity:set.count];
-    [source enumerateObjectsAtIndexes:set
-                              options:0
-                           usingBlock:^(id  _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
-        [destination addObject:obj];
-    }];
-    return [destination copy];
+    NSURLRequest *request = op.hydratedURLRequest;
+    if (TNLHTTPMethodValueGET != TNLRequestGetHTTPMethodValue(request) || TNLRequestHasBody(request)) {
+        return nil;
+    }
+
+    NSString *URLString = request.URL.absoluteString;
+    if (!URLString) {
+        return nil;
+    }
+
+    return [NSString stringWithFormat:@"%@ %@", queue.identifier, URLString];
 }
 
-BOOL TNLURLSessionIdentifierIsTaggedForTNL(NSString *identifier)
+static BOOL _CoalescingRequestsAreIdentical(NSURLRequest *request1, NSURLRequest *request2, NSSet<NSString *> * __nullable allowList)
 {
-    return [identifier hasPrefix:[TNLTwitterNetworkLayerURLScheme stringByAppendingString:@"://"]];
-}
+    if (allowList.count) {
+        NSMutableURLRequest *mRequest1 = [request1 mutableCopy];
+        NSMutableURLRequest *mRequest2 = [request2 mutableCopy];
+        for (NSMutableURLRequest *mRequest in @[mRequest1, mRequest2]) {
+            for (NSString *field in mRequest.allHTTPHeaderFields.allKeys) {
+                if ([allowList containsObject:field.lowercaseString]) {
+                    [mRequest setValue:nil forHTTPHeaderField:field];
+                }
+            }
+        }
+        request1 = mRequest1;
+        request2 = mRequest2;
+    }
 
-#pragma mark Private Functions
+    return TNLRequestEqualToRequest(request1, request2, YES /*quickBodyCheck*/);
+}
 
 static NSString *_GenerateReuseIdentifier(NSString * __nullable operationQueueId,
                                           NSString *URLSessionConfigurationIdentificationString,
@@ -1814,6 +2513,23 @@ static void _ConfigureSessionConfigurationWithRequestConfiguration(NSURLSessionC
     sessionConfig.timeoutIntervalForResource = (requestConfig.attemptTimeout < MIN_TIMER_INTERVAL) ? NSTimeIntervalSince1970 : requestConfig.attemptTimeout;
 }
 
+static NSTimeInterval _BackoffLatencyFromAttemptMetrics(TNLAttemptMetrics *metrics)
+{
+    // measure the backend (time to response headers), not the body transfer
+    NSURLSessionTaskTransactionMetrics *transactionMetrics = metrics.taskTransactionMetrics;
+    NSDate *requestStartDate = transactionMetrics.requestStartDate;
+    NSDate *responseStartDate = transactionMetrics.responseStartDate;
+    if (requestStartDate && responseStartDate) {
+        const NSTimeInterval latency = [responseStartDate timeIntervalSinceDate:requestStartDate];
+        if (latency >= 0.0) {
+            return latency;
+        }
+    }
+
+    // no transaction metrics (or they are incoherent), fall back to the attempt duration
+    return metrics.duration;
+}
+
 static NSString * __nullable _BackoffKeyFromURL(const TNLGlobalConfigurationBackoffMode mode,
                                                 NSURL *URL,
                                                 NSString * __nullable host)
@@ -1865,12 +2581,9 @@ static void _PrepareSessionManagement()
 
         // Threading
 
+        // Global session bookkeeping is serialized on the synchronize queue.
+        // NSURLSession delegate callbacks are serialized per session context (see TNLURLSessionContext.queue).
         sSynchronizeQueue = dispatch_queue_create("TNLURLSessionManager.synchronize.queue", DISPATCH_QUEUE_SERIAL);
-        sSynchronizeOperationQueue = [[NSOperationQueue alloc] init];
-        sSynchronizeOperationQueue.name = @"TNLURLSessionManager.synchronize.operation.queue";
-        sSynchronizeOperationQueue.maxConcurrentOperationCount = 1;
-        sSynchronizeOperationQueue.qualityOfService = (NSQualityOfServiceUtility + NSQualityOfServiceUserInitiated / 2);
-        sSynchronizeOperationQueue.underlyingQueue = sSynchronizeQueue;
         sURLSessionTaskOperationQueue = [[NSOperationQueue alloc] init];
         sURLSessionTaskOperationQueue.name = @"TNLURLSessionManager.task.operation.queue";
         sURLSessionTaskOperationQueue.maxConcurrentOperationCount = NSOperationQueueDefaultMaxConcurrentOperationCount;
@@ -1878,12 +2591,15 @@ static void _PrepareSessionManagement()
 
         // State
 
-        sOutstandingBackoffOperations = [[NSMutableDictionary alloc] init];
-        sOutstandingSerializeOperations = [[NSMutableDictionary alloc] init];
+        sBackoffLimiters = [[NSMutableDictionary alloc] init];
         sSessionContextsDelegate = [[TNLURLSessionContextLRUCacheDelegate alloc] init];
         sAppSessionContexts = [[TNLLRUCache alloc] initWithEntries:nil delegate:sSessionContextsDelegate];
+        sAppSessionContexts.countLimit = TNLGlobalConfigurationMaximumURLSessionCountDefault;
+        sAppSessionContexts.totalCostLimit = TNLGlobalConfigurationMaximumURLSessionCountDefault * kURLSessionContextCostLimitPerSession;
+        sAppSessionContextsByIdentity = [[NSMutableDictionary alloc] init];
         sBackgroundSessionContexts = [[TNLLRUCache alloc] initWithEntries:nil delegate:sSessionContextsDelegate];
         sActiveURLSessionTaskOperations = [[NSMutableSet alloc] init];
+        sCoalescableURLSessionTaskOperations = [[NSMutableDictionary alloc] init];
         sBackgroundSessionCompletionHandlerDictionary = [[NSMutableDictionary alloc] init];
         sBackoffBehaviorProvider = [[TNLSimpleBackoffBehaviorProvider alloc] init];
     });
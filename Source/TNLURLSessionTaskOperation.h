@@ -73,7 +73,15 @@ TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
         forURLSession:(NSURLSession *)session
         context:(nullable id)cancelContext;
 
-// Methods for TNLRequestOperation - call these from tnl_network_queue()
+// Request coalescing (see `[TNLRequestConfiguration coalescesIdenticalRequests]`)
+// A coalesced request operation shares the receiver with the request operation that created it.
+// It is told of the receiver's state transitions and is finalized with its own response when the receiver finishes.
+@property (nonatomic, copy, nullable) NSString *coalescingKey; // only accessed by TNLURLSessionManager
+- (void)attachCoalescedRequestOperation:(TNLRequestOperation *)op
+                             completion:(void (^)(BOOL attached))completion; // called by TNLURLSessionManager
+- (void)coalescedRequestOperationDidAttach:(TNLRequestOperation *)op; // called by the coalesced request operation once it adopts the receiver
+
+// Methods for TNLRequestOperation - call these from the request operation's network lane
 
 - (void)network_priorityDidChangeForRequestOperation:(TNLRequestOperation *)op;
 
@@ -82,7 +90,7 @@ TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
 // TODO: clean these up to be correctly located so they can be direct
 @interface TNLURLSessionTaskOperation (NonDirect)
 
-// Methods for TNLRequestOperation - call these from tnl_network_queue()
+// Methods for TNLRequestOperation - call these from the request operation's network lane
 
 - (TNLAttemptMetaData *)network_metaDataWithLowerCaseHeaderFields:(nullable NSDictionary *)lowerCaseHeaderFields;
 - (nullable NSURLSessionTaskMetrics *)network_taskMetrics;
@@ -93,8 +101,8 @@ TNL_OBJC_FINAL TNL_OBJC_DIRECT_MEMBERS
 
 typedef void(^TNLRequestMakeFinalResponseCompletionBlock)(TNLResponse * __nullable response);
 
-// All calls are made from tnl_network_queue()
-// All completion blocks MUST be made from tnl_network_queue()
+// All calls are made from the request operation's network lane
+// All completion blocks MUST be made from the request operation's network lane
 @protocol TNLURLSessionTaskOperationDelegate <NSObject>
 @required
 - (void)network_URLSessionTaskOperation:(TNLURLSessionTaskOperation *)taskOp
@@ -39,7 +39,6 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-#define EXTRA_DOWNLOAD_BYTES_BUFFER (16)
 
 #define kTaskMetricsNotSeenOnCompletionDelayCompletionDuration (0.300)
 
@@ -111,7 +110,7 @@ TNL_OBJC_DIRECT_MEMBERS
 TNL_OBJC_DIRECT_MEMBERS
 @interface TNLURLSessionTaskOperation (Network)
 
-// Methods that can only be called from the tnl_network_queue()
+// Methods that can only be called from the network lane (shared with the request operation)
 
 #pragma mark Properties
 
@@ -125,6 +124,10 @@ TNL_OBJC_DIRECT_MEMBERS
 #pragma mark Update State
 
 - (void)_network_updatePriorities;
+- (BOOL)_network_hasCoalescedRequestOperations;
+- (void)_network_forEachCoalescedRequestOperation:(void (^)(TNLRequestOperation *op))block;
+- (void)_network_finalizeCoalescedRequestOperation:(TNLRequestOperation *)op
+                                         withState:(TNLRequestOperationState)state;
 - (void)_network_updateUploadProgress:(float)progress;
 - (void)_network_updateDownloadProgress:(float)progress;
 - (void)_network_transitionToState:(TNLRequestOperationState)state;
@@ -231,19 +234,28 @@ TNL_OBJC_DIRECT_MEMBERS
 
     // Gathered State
 
-    void *_hashContextRef;
+    void *_hashContextRef; // only accessed from the hash lane once created
+    dispatch_queue_t _hashLane;
     NSData *_hashData;
     TNLResponseHashComputeAlgorithm _hashAlgo;
     NSDictionary *_authChallengeCancelledUserInfo;
-    NSMutableData *_storedData;
+    TNLSegmentedDataBuffer *_storedData;
     TNLTemporaryFile *_tempFile;
     SInt64 _layer8BodyBytesReceived; // count after uncompressing
 
     // Metrics
 
     NSTimeInterval _responseDecodeLatency;
+    NSTimeInterval _responseDecodeQueueLatency;
+    dispatch_queue_t _networkLane;
+    dispatch_queue_t _codingLane;
     NSURLSessionTaskMetrics *_taskMetrics;
 
+    // Coalescing
+
+    NSHashTable<TNLRequestOperation *> *_coalescedRequestOperations; // receive events
+    NSHashTable<TNLRequestOperation *> *_pendingCoalescedRequestOperations; // attached but not yet adopted the receiver
+
     // State
 
     TNLRequestOperationState_AtomicT _internalState;
@@ -291,6 +303,8 @@ TNL_OBJC_DIRECT_MEMBERS
         TNLIncrementObjectCount([self class]);
 
         _sessionManager = sessionManager;
+        _networkLane = op.networkLane;
+        _codingLane = tnl_coding_lane_create();
 
         _originalRequest = op.originalRequest;
         _hydratedRequest = op.hydratedRequest;
@@ -314,7 +328,7 @@ TNL_OBJC_DIRECT_MEMBERS
         TNLAssert(_hydratedRequest != nil);
         TNLAssert(_hydratedURLRequest != nil);
         TNLAssert(_requestConfiguration != nil);
-        TNLAssert(op.URLSessionTaskOperation == nil);
+        TNLAssert(op.URLSessionTaskOperation == nil || op.requestConfiguration.hedgeDelayPercentile > 0.0); // hedges race an associated task operation
         TNLAssert(![_requestConfiguration respondsToSelector:@selector(setExecutionMode:)] && "MUST be immutable");
 
         [self _network_updatePriorities];
@@ -417,7 +431,7 @@ TNL_OBJC_DIRECT_MEMBERS
     TNLAssert(URLSession != nil);
     _URLSession = URLSession;
     if (!taskMetrics) {
-        tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+        tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
             // Task metrics are explicity not supported
             self->_flags.encounteredCompletionBeforeTaskMetrics = 1;
         });
@@ -433,7 +447,7 @@ TNL_OBJC_DIRECT_MEMBERS
         return;
     }
 
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         if (!self->_requestOperationQueue) {
             if (gTwitterNetworkLayerAssertEnabled) {
                 TNLAssert(!self->_requestOperationQueue || self->_requestOperationQueue == requestOperationQueue);
@@ -455,18 +469,35 @@ TNL_OBJC_DIRECT_MEMBERS
 - (void)cancelWithSource:(nullable id)optionalSource
          underlyingError:(nullable NSError *)optionalUnderlyingError
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         TNLRequestOperation *strongRequestOp = self->_requestOperation;
         if (strongRequestOp) {
             [strongRequestOp cancelWithSource:optionalSource
                               underlyingError:optionalUnderlyingError];
         }
+        NSArray<TNLRequestOperation *> *coalescedOps = [self->_coalescedRequestOperations.allObjects arrayByAddingObjectsFromArray:self->_pendingCoalescedRequestOperations.allObjects];
+        for (TNLRequestOperation *coalescedOp in coalescedOps) {
+            [coalescedOp cancelWithSource:optionalSource
+                          underlyingError:optionalUnderlyingError];
+        }
     });
 }
 
 - (void)dissassociateRequestOperation:(TNLRequestOperation *)op
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
+        if ([self->_coalescedRequestOperations containsObject:op] || [self->_pendingCoalescedRequestOperations containsObject:op]) {
+            // a coalesced request operation leaving does not affect the others
+            [self->_coalescedRequestOperations removeObject:op];
+            [self->_pendingCoalescedRequestOperations removeObject:op];
+            if ([self _network_shouldCancel]) {
+                [self _network_cancel];
+            } else {
+                [self _network_updatePriorities];
+            }
+            return;
+        }
+
         TNLRequestOperation *strongRequestOp = self->_requestOperation;
         if (strongRequestOp == op) {
             TNLResponse *response = strongRequestOp.response;
@@ -489,16 +520,115 @@ TNL_OBJC_DIRECT_MEMBERS
     return [[TNLFakeRequestOperation alloc] initWithURLSessionTaskOperation:self];
 }
 
-#pragma mark Helpers
+#pragma mark Coalescing
 
-- (void)network_priorityDidChangeForRequestOperation:(TNLRequestOperation *)op
+- (void)attachCoalescedRequestOperation:(TNLRequestOperation *)op
+                             completion:(void (^)(BOOL attached))completion
 {
-    TNLRequestOperation *requestOperation = _requestOperation;
-    if (requestOperation == op) {
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
+        if (self.isComplete || self.isFinalizing || self->_flags.didCancel || [self _network_shouldCancel]) {
+            completion(NO);
+            return;
+        }
+
+        if (!self->_pendingCoalescedRequestOperations) {
+            self->_pendingCoalescedRequestOperations = [NSHashTable weakObjectsHashTable];
+            self->_coalescedRequestOperations = [NSHashTable weakObjectsHashTable];
+        }
+        [self->_pendingCoalescedRequestOperations addObject:op];
         [self _network_updatePriorities];
+        completion(YES);
+    });
+}
+
+- (void)coalescedRequestOperationDidAttach:(TNLRequestOperation *)op
+{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
+        if (![self->_pendingCoalescedRequestOperations containsObject:op]) {
+            return;
+        }
+        [self->_pendingCoalescedRequestOperations removeObject:op];
+
+        const TNLRequestOperationState state = atomic_load(&self->_internalState);
+        if (TNLRequestOperationStateIsFinal(state)) {
+            [self _network_finalizeCoalescedRequestOperation:op withState:state];
+            return;
+        }
+
+        // catch up on the transitions that already happened
+        [self->_coalescedRequestOperations addObject:op];
+        if (state >= TNLRequestOperationStateStarting) {
+            NSURLRequest *taskRequest = self->_taskRequest;
+            tnl_dispatch_async_autoreleasing(op.networkLane, ^{
+                [op network_URLSessionTaskOperation:self
+                               didTransitionToState:TNLRequestOperationStateStarting
+                                       withResponse:nil];
+                if (taskRequest) {
+                    [op network_URLSessionTaskOperation:self
+                         didStartSessionTaskWithRequest:taskRequest];
+                }
+                if (state >= TNLRequestOperationStateRunning) {
+                    [op network_URLSessionTaskOperation:self
+                                   didTransitionToState:TNLRequestOperationStateRunning
+                                           withResponse:nil];
+                }
+            });
+        }
+    });
+}
+
+- (BOOL)_network_hasCoalescedRequestOperations
+{
+    return _coalescedRequestOperations.allObjects.count > 0 || _pendingCoalescedRequestOperations.allObjects.count > 0;
+}
+
+- (void)_network_forEachCoalescedRequestOperation:(void (^)(TNLRequestOperation *op))block
+{
+    for (TNLRequestOperation *op in _coalescedRequestOperations.allObjects) {
+        tnl_dispatch_async_autoreleasing(op.networkLane, ^{
+            block(op);
+        });
     }
 }
 
+- (void)_network_finalizeCoalescedRequestOperation:(TNLRequestOperation *)op
+                                         withState:(TNLRequestOperationState)state
+{
+    TNLAssert(TNLRequestOperationStateIsFinal(state));
+
+    // each coalesced request operation builds its own response from the shared response info
+    TNLResponseInfo *responseInfo = _responseInfo;
+    NSError *responseError = _error;
+    NSURLSessionTaskMetrics *taskMetrics = _taskMetrics;
+    TNLAttemptMetaData *metaData = [self network_metaDataWithLowerCaseHeaderFields:responseInfo.allHTTPHeaderFieldsWithLowerCaseKeys];
+    tnl_dispatch_async_autoreleasing(op.networkLane, ^{
+        [op network_URLSessionTaskOperation:self
+                   finalizeWithResponseInfo:responseInfo
+                              responseError:responseError
+                                   metaData:metaData
+                                taskMetrics:taskMetrics
+                                 completion:^(TNLResponse * __nullable response) {
+            if (response) {
+                [op network_URLSessionTaskOperation:self
+                               didTransitionToState:state
+                                       withResponse:response];
+            }
+        }];
+    });
+}
+
+#pragma mark Helpers
+
+- (void)network_priorityDidChangeForRequestOperation:(TNLRequestOperation *)op
+{
+    // called from the request operation's lane, which is not the receiver's lane
+    tnl_dispatch_async_autoreleasing(_networkLane, ^{
+        if (self->_requestOperation == op || [self->_coalescedRequestOperations containsObject:op]) {
+            [self _network_updatePriorities];
+        }
+    });
+}
+
 #pragma mark NSOperation
 
 - (BOOL)isConcurrent
@@ -538,7 +668,7 @@ TNL_OBJC_DIRECT_MEMBERS
 
 - (void)start
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         TNLAssert(!self->_flags.didStart);
 
         self->_flags.didStart = YES;
@@ -623,7 +753,7 @@ TNL_OBJC_DIRECT_MEMBERS
 - (void)URLSession:(NSURLSession *)session
         didBecomeInvalidWithError:(nullable NSError *)error
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         if (self.isComplete || self.isFinalizing) {
             return;
         }
@@ -649,7 +779,7 @@ TNL_OBJC_DIRECT_MEMBERS
         failedResponse = nil;
     }
 
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         NSMutableDictionary *userInfo = [[NSMutableDictionary alloc] init];
         if (protectionSpaceHost) {
             userInfo[TNLErrorProtectionSpaceHostKey] = protectionSpaceHost;
@@ -683,7 +813,7 @@ TNL_OBJC_DIRECT_MEMBERS
 - (void)URLSession:(NSURLSession *)session
         taskIsWaitingForConnectivity:(NSURLSessionTask *)task
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         [self _network_restartIdleTimer];
 
         const TNLRequestConnectivityOptions options = self->_requestConfiguration.connectivityOptions;
@@ -716,7 +846,7 @@ TNL_OBJC_DIRECT_MEMBERS
     NSURLRequest *fromRequest = task.currentRequest;
     NSURLRequest *originalRequest = task.originalRequest;
 
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
 
         // redirects yield either a completion or a new attempt,
         // stop our idle timer (if we have one running)
@@ -729,7 +859,7 @@ TNL_OBJC_DIRECT_MEMBERS
                                              withHTTPResponse:response
                                                     toRequest:toRequest
                                                    completion:^(id<TNLRequest> __nullable callbackRequest) {
-                TNLAssertIsNetworkQueue();
+                TNLAssertIsNetworkLane(self->_networkLane);
                 [self _network_willPerformHTTPRedirectionFromRequest:fromRequest
                                                             response:response
                                                      originalRequest:originalRequest
@@ -784,7 +914,7 @@ TNL_OBJC_DIRECT_MEMBERS
     void (^block)(NSURLRequest * __nullable, NSError * __nullable);
     block = ^void(NSURLRequest * __nullable sanitizedRequest, NSError * __nullable sanitiziationError) {
 
-        TNLAssertIsNetworkQueue();
+        TNLAssertIsNetworkLane(self->_networkLane);
         NSURLRequest *finalToRequest = (sanitiziationError) ? nil : [sanitizedRequest copy];
 
         if (!finalToRequest) {
@@ -861,7 +991,7 @@ TNL_OBJC_DIRECT_MEMBERS
               task:(NSURLSessionTask *)task
  needNewBodyStream:(void (^)(NSInputStream * __nullable bodyStream))completionHandler
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
 
         if (self->_flags.useIdleTimeoutForInitialConnection) {
             [self _network_restartIdleTimer];
@@ -884,7 +1014,7 @@ TNL_OBJC_DIRECT_MEMBERS
         totalBytesSent:(int64_t)totalBytesSent
         totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         if (self.isComplete || self.finalizing) {
             return;
         } else if ([self _network_shouldCancel]) {
@@ -905,7 +1035,7 @@ TNL_OBJC_DIRECT_MEMBERS
 {
     TNLAssertMessage(theError != nil || task.response != nil, @"task: %@\n%@", task, task.currentRequest);
 
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
 
         if (!self->_completionCallbackDate && !self->_flags.encounteredCompletionBeforeTaskMetrics) {
             self->_completionCallbackDate = [NSDate date];
@@ -937,7 +1067,7 @@ TNL_OBJC_DIRECT_MEMBERS
             self->_cachedCompletionTask = task;
             self->_cachedCompletionError = theError;
 
-            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kTaskMetricsNotSeenOnCompletionDelayCompletionDuration * NSEC_PER_SEC)), tnl_network_queue(), ^{
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kTaskMetricsNotSeenOnCompletionDelayCompletionDuration * NSEC_PER_SEC)), self->_networkLane, ^{
                 @autoreleasepool {
                     [self _network_completeCachedCompletionIfPossible];
                 }
@@ -974,12 +1104,17 @@ TNL_OBJC_DIRECT_MEMBERS
 - (void)_finishDecodingWithURLSession:(NSURLSession *)completedURLSession
                              dataTask:(NSURLSessionDataTask *)dataTask
 {
-    tnl_dispatch_async_autoreleasing(tnl_coding_queue(), ^{
+    const uint64_t enqueueMachTime = mach_absolute_time();
+    tnl_dispatch_async_autoreleasing(_codingLane, ^{
+        const uint64_t finalizeStartMachTime = mach_absolute_time();
         NSError *decodingError = nil;
         if (![self->_contentDecoder tnl_finalizeDecoding:self->_contentDecoderContext error:&decodingError]) {
             decodingError = TNLErrorCreateWithCodeAndUnderlyingError(TNLErrorCodeRequestOperationRequestContentDecodingFailed, decodingError);
         }
-        tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+        const uint64_t finalizeEndMachTime = mach_absolute_time();
+        tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
+            self->_responseDecodeQueueLatency += TNLComputeDuration(enqueueMachTime, finalizeStartMachTime);
+            self->_responseDecodeLatency += TNLComputeDuration(finalizeStartMachTime, finalizeEndMachTime);
             const BOOL hasRecentData = self->_contentDecoderRecentData.length > 0;
             if (hasRecentData) {
                 // flush is synchronous
@@ -1078,7 +1213,7 @@ TNL_OBJC_DIRECT_MEMBERS
         task:(NSURLSessionTask *)task
         didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         self->_taskMetricsCallbackDate = [NSDate date];
         self->_taskMetrics = metrics;
 
@@ -1111,7 +1246,7 @@ TNL_OBJC_DIRECT_MEMBERS
 didReceiveResponse:(NSURLResponse *)response
  completionHandler:(void (^)(NSURLSessionResponseDisposition disposition))completionHandler
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         [self _network_didReceiveResponse:response URLSession:session task:dataTask];
         completionHandler(NSURLSessionResponseAllow);
     });
@@ -1166,7 +1301,7 @@ didReceiveResponse:(NSURLResponse *)response
  completionHandler:(void (^)(NSCachedURLResponse *cachedResponse))completionHandler
 {
     // TODO:[nobrien] - expose this via one of the request delegates or configuration (NSURLCacheStoragePolicy)
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         [self _network_restartIdleTimer];
         completionHandler(proposedResponse);
     });
@@ -1184,7 +1319,7 @@ didReceiveResponse:(NSURLResponse *)response
                                                                                error:&error];
     TNLAssert(tempFile != nil || error != nil);
 
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         self->_tempFile = tempFile;
         if (!self->_tempFile) {
             [self _network_fail:error];
@@ -1201,7 +1336,7 @@ didReceiveResponse:(NSURLResponse *)response
         totalBytesWritten:(int64_t)totalBytesWritten
         totalBytesExpectedToWrite:(int64_t)totalBytesExpectedToWrite
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         [self _network_didUpdateTotalBytesReceived:totalBytesWritten
                                      expectedBytes:totalBytesExpectedToWrite
                                         URLSession:session
@@ -1214,7 +1349,7 @@ didReceiveResponse:(NSURLResponse *)response
  didResumeAtOffset:(int64_t)fileOffset
 expectedTotalBytes:(int64_t)expectedTotalBytes
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         [self _network_didUpdateTotalBytesReceived:fileOffset
                                      expectedBytes:expectedTotalBytes
                                         URLSession:session
@@ -1228,14 +1363,16 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
          completion:(void(^)(NSData * __nullable decodedData, NSError * __nullable decodeError))completion
 {
     if (!_contentDecoderContext) {
-        tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+        tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
             completion(data, nil);
         });
         return;
     }
 
-    const uint64_t decodeStartMachTime = mach_absolute_time();
-    tnl_dispatch_async_autoreleasing(tnl_coding_queue(), ^{
+    // the lane is serial, so chunks are decoded in the order they were received
+    const uint64_t enqueueMachTime = mach_absolute_time();
+    tnl_dispatch_async_autoreleasing(_codingLane, ^{
+        const uint64_t decodeStartMachTime = mach_absolute_time();
         NSError *error = nil;
         const BOOL decodeSuccess = [self->_contentDecoder tnl_decode:self->_contentDecoderContext
                                                       additionalData:data
@@ -1243,9 +1380,10 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
         if (!decodeSuccess) {
             error = TNLErrorCreateWithCodeAndUnderlyingError(TNLErrorCodeRequestOperationRequestContentDecodingFailed, error);
         }
-        tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
-            const NSTimeInterval decodeLatency = TNLComputeDuration(decodeStartMachTime, mach_absolute_time());
-            self->_responseDecodeLatency += decodeLatency;
+        const uint64_t decodeEndMachTime = mach_absolute_time();
+        tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
+            self->_responseDecodeQueueLatency += TNLComputeDuration(enqueueMachTime, decodeStartMachTime);
+            self->_responseDecodeLatency += TNLComputeDuration(decodeStartMachTime, decodeEndMachTime);
             [self _network_flushDecoding:error completion:completion];
         });
     });
@@ -1268,7 +1406,7 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
 
 - (BOOL)tnl_dataWasDecoded:(NSData *)data error:(out NSError **)error
 {
-    tnl_dispatch_async_autoreleasing(tnl_network_queue(), ^{
+    tnl_dispatch_async_autoreleasing(self->_networkLane, ^{
         if (!self->_contentDecoderRecentData) {
             self->_contentDecoderRecentData = [data mutableCopy];
         } else {
@@ -1338,6 +1476,7 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
 
         if (_responseDecodeLatency > 0) {
             metaData.responseDecodingLatency = _responseDecodeLatency;
+            metaData.responseDecodingQueueLatency = _responseDecodeQueueLatency;
         }
         if (_layer8BodyBytesReceived > 0) {
             metaData.responseDecodedContentLength = _layer8BodyBytesReceived;
@@ -1435,6 +1574,10 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
         return NO;
     }
 
+    if ([self _network_hasCoalescedRequestOperations]) {
+        return NO;
+    }
+
     if ([_error.domain isEqualToString:TNLErrorDomain] && _error.code == TNLErrorCodeRequestOperationCancelled) {
         // Already cancelling
         return NO;
@@ -1499,6 +1642,12 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
             pri = opPri;
         }
     }
+    for (TNLRequestOperation *coalescedOp in _coalescedRequestOperations) {
+        TNLPriority opPri = coalescedOp.priority;
+        if (opPri > pri) {
+            pri = opPri;
+        }
+    }
     _requestPriority = pri;
     self.URLSessionTask.priority = TNLConvertTNLPriorityToURLSessionTaskPriority(self->_requestPriority);
 
@@ -1518,7 +1667,7 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
         _responseInfo = [[TNLResponseInfo alloc] initWithFinalURLRequest:self.currentURLRequest
                                                              URLResponse:self.URLResponse
                                                                   source:self.responseSource
-                                                                    data:_storedData
+                                                                    data:_storedData.data
                                                       temporarySavedFile:_tempFile];
     }
 }
@@ -1720,6 +1869,10 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
 
     [_requestOperation network_URLSessionTaskOperation:self
                                didUpdateUploadProgress:progress];
+    [self _network_forEachCoalescedRequestOperation:^(TNLRequestOperation *coalescedOp) {
+        [coalescedOp network_URLSessionTaskOperation:self
+                             didUpdateUploadProgress:progress];
+    }];
 }
 
 - (void)_network_updateDownloadProgress:(float)progress
@@ -1733,6 +1886,10 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
 
     [_requestOperation network_URLSessionTaskOperation:self
                              didUpdateDownloadProgress:progress];
+    [self _network_forEachCoalescedRequestOperation:^(TNLRequestOperation *coalescedOp) {
+        [coalescedOp network_URLSessionTaskOperation:self
+                           didUpdateDownloadProgress:progress];
+    }];
 }
 
 - (nullable NSError *)_network_appendDecodedData:(nullable NSData *)data
@@ -1748,8 +1905,6 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
     [self _network_transitionToState:TNLRequestOperationStateRunning];
     [self _network_updateHashWithData:data];
 
-    NSHTTPURLResponse *URLResponse = self.URLResponse;
-
     _layer8BodyBytesReceived += data.length;
 
     switch (_requestConfiguration.responseDataConsumptionMode) {
@@ -1759,24 +1914,11 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
 
             @try {
                 if (!_storedData) {
-                    // We want the buffer of the mutable data to be the best guess we can offer to
-                    // prevent continuous reallocs.
-                    NSUInteger capacity = 0;
-                    long long expectedDataSize = [URLResponse tnl_expectedResponseBodyExpandedDataSize];
-
-                    // NOTE - it is possible that the expectedDataSize is the Content-Length which
-                    // is the compressed size so it will be too small for the decompressed size.
-                    // However, we know that the content will be at least as much as the
-                    // Content-Length when decompressed so setting the capacity to the
-                    // Content-Length will avoid the initial reallocs, but will still incur later
-                    // reallocs so it is no worse than not setting the capacity.
-
-                    if (expectedDataSize >= (LONG_MAX - EXTRA_DOWNLOAD_BYTES_BUFFER)) {
-                        capacity = LONG_MAX;
-                    } else if (expectedDataSize > 0) {
-                        capacity = (NSUInteger)expectedDataSize + EXTRA_DOWNLOAD_BYTES_BUFFER;
-                    }
-                    _storedData = (capacity > 0) ? [NSMutableData dataWithCapacity:capacity] : [NSMutableData data];
+                    // Segments are retained without copying, so there is no need to guess the
+                    // final size up front (the Content-Length can be the compressed size or be
+                    // absent altogether).  The bytes are only flattened if the consumer of the
+                    // response's data asks for contiguous bytes.
+                    _storedData = [[TNLSegmentedDataBuffer alloc] init];
                 }
                 if (data) {
                     [_storedData appendData:data];
@@ -1804,7 +1946,7 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
 - (void)_network_finalizeWithState:(TNLRequestOperationState)state
 {
     [self _network_finalizeWithResponseCompletion:^(TNLResponse * __nullable finalResponse) {
-        TNLAssertIsNetworkQueue();
+        TNLAssertIsNetworkLane(self->_networkLane);
         if (finalResponse) {
             self->_finalResponse = finalResponse;
         }
@@ -1935,6 +2077,10 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
                                                       host:host
                                        responseHTTPHeaders:headers];
             }
+
+            // feed the adaptive concurrency limit
+            [_sessionManager URLSessionTaskOperation:self
+                       didCompleteAttemptWithMetrics:_finalResponse.metrics.attemptMetrics.lastObject];
         }
 
         if (executingDidChange) {
@@ -1977,6 +2123,18 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
         [strongRequestOp network_URLSessionTaskOperation:self
                                     didTransitionToState:state
                                             withResponse:_finalResponse];
+        if (finishedDidChange) {
+            for (TNLRequestOperation *coalescedOp in _coalescedRequestOperations.allObjects) {
+                [self _network_finalizeCoalescedRequestOperation:coalescedOp withState:state];
+            }
+            [_coalescedRequestOperations removeAllObjects];
+        } else {
+            [self _network_forEachCoalescedRequestOperation:^(TNLRequestOperation *coalescedOp) {
+                [coalescedOp network_URLSessionTaskOperation:self
+                                        didTransitionToState:state
+                                                withResponse:nil];
+            }];
+        }
 
         if (executingDidChange) {
             [self didChangeValueForKey:@"isExecuting"];
@@ -2072,6 +2230,9 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
         task.priority = TNLConvertTNLPriorityToURLSessionTaskPriority(self->_requestPriority);
 
         TNLRequestConfigurationAssociateWithRequest(self.requestConfiguration, task.originalRequest ?: self->_taskRequest);
+
+        // index the task with the session manager so delegate callbacks can find this operation
+        [_sessionManager syncURLSessionTaskOperation:self didChangeTask:nil toTask:task];
     }
 
     TNLAssert((nil == error) ^ (nil == task));
@@ -2204,7 +2365,7 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
         const NSTimeInterval idleTimeout = _requestConfiguration.idleTimeout;
         if (idleTimeout >= MIN_TIMER_INTERVAL) {
             __weak typeof(self) weakSelf = self;
-            _idleTimer = tnl_dispatch_timer_create_and_start(tnl_network_queue(), idleTimeout, TIMER_LEEWAY_WITH_FIRE_INTERVAL(MAX(deferral, 0.0) + idleTimeout), NO, ^{
+            _idleTimer = tnl_dispatch_timer_create_and_start(self->_networkLane, idleTimeout, TIMER_LEEWAY_WITH_FIRE_INTERVAL(MAX(deferral, 0.0) + idleTimeout), NO, ^{
                 [weakSelf _network_idleTimerFired];
             });
         }
@@ -2385,13 +2546,24 @@ NS_INLINE NSData * __nullable _finalizeHash(TNLResponseHashComputeAlgorithm algo
 {
     if (!_flags.isComputingHash && _flags.shouldComputeHash) {
         _hashContextRef = _mallocAndInitHashContext(_hashAlgo);
+        if (!_hashLane) {
+            // hashing is serialized per operation, but kept off the network lane
+            dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+            _hashLane = dispatch_queue_create("tnl.hash.lane", attr);
+        }
         _flags.isComputingHash = YES;
     }
 
-    if (_flags.isComputingHash) {
-        [data enumerateByteRangesUsingBlock:^(const void * _Nonnull bytes, NSRange byteRange, BOOL * _Nonnull stop) {
-            _updateHash(self->_hashAlgo, self->_hashContextRef, bytes, (CC_LONG)byteRange.length);
-        }];
+    if (_flags.isComputingHash && data.length > 0) {
+        // the chunk is retained (not copied), it is the same data the response body is accumulated from
+        NSData *chunk = [data copy];
+        const TNLResponseHashComputeAlgorithm algo = _hashAlgo;
+        void *contextRef = _hashContextRef;
+        tnl_dispatch_async_autoreleasing(_hashLane, ^{
+            [chunk enumerateByteRangesUsingBlock:^(const void * _Nonnull bytes, NSRange byteRange, BOOL * _Nonnull stop) {
+                _updateHash(algo, contextRef, bytes, (CC_LONG)byteRange.length);
+            }];
+        });
     }
 }
 
@@ -2399,8 +2571,15 @@ NS_INLINE NSData * __nullable _finalizeHash(TNLResponseHashComputeAlgorithm algo
 {
     if (_flags.isComputingHash) {
         if (_hashContextRef) {
-            _hashData = _finalizeHash(_hashAlgo, _hashContextRef, success);
-            free(_hashContextRef);
+            // join with the pending updates (only this operation's network lane waits)
+            __block NSData *hashData = nil;
+            const TNLResponseHashComputeAlgorithm algo = _hashAlgo;
+            void *contextRef = _hashContextRef;
+            dispatch_sync(_hashLane, ^{
+                hashData = _finalizeHash(algo, contextRef, success);
+                free(contextRef);
+            });
+            _hashData = hashData;
             _hashContextRef = NULL;
         }
         _flags.isComputingHash = NO;
@@ -13,6 +13,185 @@ NS_ASSUME_NONNULL_BEGIN
 
 static const char kHexDigits[] = "0123456789ABCDEF";
 
+// The unreserved characters (RFC 3986, Section 2.3) are the only bytes that are not percent encoded
+static const BOOL kURLUnreservedBytes[256] = {
+    ['0' ... '9'] = YES,
+    ['A' ... 'Z'] = YES,
+    ['a' ... 'z'] = YES,
+    ['-'] = YES,
+    ['.'] = YES,
+    ['_'] = YES,
+    ['~'] = YES,
+};
+
+static size_t _URLUnreservedPrefixLength(const unsigned char *bytes,
+                                         size_t length);
+static size_t _URLDecodePassthroughPrefixLength(const unsigned char *bytes,
+                                                size_t length,
+                                                BOOL stopAtPlusses);
+static size_t _URLEncodeBytes(const unsigned char *bytes,
+                              size_t length,
+                              char *outBytes);
+static NSString * __nullable _URLDecodeUTF8String(NSString *string,
+                                                  const unsigned char *bytes,
+                                                  size_t length,
+                                                  BOOL replacePlussesWithSpaces);
+
+#pragma mark Vector Kernels
+
+// Classify 16 bytes at a time (SSE2 is the x86_64 baseline, NEON the arm64 baseline).
+// AVX2 is not used since it is not available on every x86_64 device/simulator host and would need
+// runtime dispatch, for the short strings that make up most URLs 16 byte blocks are already the sweet spot.
+#if defined(__SSE2__)
+#define TNL_URL_CODING_VECTOR_SIZE (16)
+#include <emmintrin.h>
+
+// 0xFF for each byte in [lo, hi]
+static inline __m128i _VectorInRange(__m128i v, unsigned char lo, unsigned char hi)
+{
+    // shift the range to start at the smallest signed value so that a single signed compare can be used
+    const __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - lo)));
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8((char)(0x80 + (hi - lo + 1))));
+}
+
+// bit i is set when byte i is unreserved
+static inline uint32_t _VectorUnreservedMask(const unsigned char *bytes)
+{
+    const __m128i v = _mm_loadu_si128((const __m128i *)bytes);
+    __m128i unreserved = _VectorInRange(v, '0', '9');
+    unreserved = _mm_or_si128(unreserved, _VectorInRange(v, 'A', 'Z'));
+    unreserved = _mm_or_si128(unreserved, _VectorInRange(v, 'a', 'z'));
+    unreserved = _mm_or_si128(unreserved, _VectorInRange(v, '-', '.'));
+    unreserved = _mm_or_si128(unreserved, _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+    unreserved = _mm_or_si128(unreserved, _mm_cmpeq_epi8(v, _mm_set1_epi8('~')));
+    return (uint32_t)_mm_movemask_epi8(unreserved);
+}
+
+// bit i is set when byte i is a '%' (or a '+' when `matchPlusses`)
+static inline uint32_t _VectorPercentMask(const unsigned char *bytes, BOOL matchPlusses)
+{
+    const __m128i v = _mm_loadu_si128((const __m128i *)bytes);
+    __m128i matches = _mm_cmpeq_epi8(v, _mm_set1_epi8('%'));
+    if (matchPlusses) {
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(v, _mm_set1_epi8('+')));
+    }
+    return (uint32_t)_mm_movemask_epi8(matches);
+}
+
+#define _VectorMaskAll ((uint32_t)0xFFFF)
+#define _VectorMaskFirstSetIndex(mask) ((size_t)__builtin_ctz(mask))
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define TNL_URL_CODING_VECTOR_SIZE (16)
+#include <arm_neon.h>
+
+// 0xFF for each byte in [lo, hi]
+static inline uint8x16_t _VectorInRange(uint8x16_t v, unsigned char lo, unsigned char hi)
+{
+    return vcleq_u8(vsubq_u8(v, vdupq_n_u8(lo)), vdupq_n_u8((uint8_t)(hi - lo)));
+}
+
+// NEON has no movemask, narrow each 0x00/0xFF byte to a nibble instead (nibble i is set when byte i matched)
+static inline uint64_t _VectorNibbleMask(uint8x16_t matches)
+{
+    const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+static inline uint64_t _VectorUnreservedMask(const unsigned char *bytes)
+{
+    const uint8x16_t v = vld1q_u8(bytes);
+    uint8x16_t unreserved = _VectorInRange(v, '0', '9');
+    unreserved = vorrq_u8(unreserved, _VectorInRange(v, 'A', 'Z'));
+    unreserved = vorrq_u8(unreserved, _VectorInRange(v, 'a', 'z'));
+    unreserved = vorrq_u8(unreserved, _VectorInRange(v, '-', '.'));
+    unreserved = vorrq_u8(unreserved, vceqq_u8(v, vdupq_n_u8('_')));
+    unreserved = vorrq_u8(unreserved, vceqq_u8(v, vdupq_n_u8('~')));
+    return _VectorNibbleMask(unreserved);
+}
+
+static inline uint64_t _VectorPercentMask(const unsigned char *bytes, BOOL matchPlusses)
+{
+    const uint8x16_t v = vld1q_u8(bytes);
+    uint8x16_t matches = vceqq_u8(v, vdupq_n_u8('%'));
+    if (matchPlusses) {
+        matches = vorrq_u8(matches, vceqq_u8(v, vdupq_n_u8('+')));
+    }
+    return _VectorNibbleMask(matches);
+}
+
+#define _VectorMaskAll (UINT64_MAX)
+#define _VectorMaskFirstSetIndex(mask) ((size_t)__builtin_ctzll(mask) / 4)
+
+#endif // vector kernels
+
+// Number of leading bytes that do not need to be percent encoded
+static size_t _URLUnreservedPrefixLength(const unsigned char *bytes,
+                                         size_t length)
+{
+    size_t i = 0;
+#if TNL_URL_CODING_VECTOR_SIZE
+    for (; i + TNL_URL_CODING_VECTOR_SIZE <= length; i += TNL_URL_CODING_VECTOR_SIZE) {
+        const __typeof__(_VectorMaskAll) mask = _VectorUnreservedMask(bytes + i);
+        if (mask != _VectorMaskAll) {
+            return i + _VectorMaskFirstSetIndex(~mask);
+        }
+    }
+#endif
+    while (i < length && kURLUnreservedBytes[bytes[i]]) {
+        i++;
+    }
+    return i;
+}
+
+// Number of leading bytes that decode to themselves
+static size_t _URLDecodePassthroughPrefixLength(const unsigned char *bytes,
+                                                size_t length,
+                                                BOOL stopAtPlusses)
+{
+    size_t i = 0;
+#if TNL_URL_CODING_VECTOR_SIZE
+    for (; i + TNL_URL_CODING_VECTOR_SIZE <= length; i += TNL_URL_CODING_VECTOR_SIZE) {
+        const __typeof__(_VectorMaskAll) mask = _VectorPercentMask(bytes + i, stopAtPlusses);
+        if (mask != 0) {
+            return i + _VectorMaskFirstSetIndex(mask);
+        }
+    }
+#endif
+    while (i < length && bytes[i] != '%' && !(stopAtPlusses && bytes[i] == '+')) {
+        i++;
+    }
+    return i;
+}
+
+#pragma mark Encoding
+
+static size_t _URLEncodeBytes(const unsigned char *bytes,
+                              size_t length,
+                              char *outBytes)
+{
+    char *outPtr = outBytes;
+    size_t i = 0;
+    while (i < length) {
+        // copy runs that need no encoding in bulk
+        const size_t runLength = _URLUnreservedPrefixLength(bytes + i, length - i);
+        if (runLength) {
+            memcpy(outPtr, bytes + i, runLength);
+            outPtr += runLength;
+            i += runLength;
+        }
+
+        // encode bytes until the next unreserved byte
+        for (; i < length && !kURLUnreservedBytes[bytes[i]]; i++) {
+            const unsigned char c = bytes[i];
+            *outPtr++ = '%';
+            *outPtr++ = kHexDigits[(c>>4)&0xf];
+            *outPtr++ = kHexDigits[c&0xf];
+        }
+    }
+    return (size_t)(outPtr - outBytes);
+}
+
 NSString * __nullable TNLURLEncodeString(NSString * __nullable string)
 {
     if (0 == string.length) {
@@ -30,53 +209,25 @@ NSString * __nullable TNLURLEncodeString(NSString * __nullable string)
         return nil;
     }
 
-    NSUInteger encodedLength = 0;
-    BOOL needsEncoding = NO;
-    for (const char *c = stringAsUTF8; *c; c++) {
-        switch (*c) {
-            case '0' ... '9':
-            case 'A' ... 'Z':
-            case 'a' ... 'z':
-            case '-':
-            case '.':
-            case '_':
-            case '~':
-                encodedLength++;
-                break;
-            default:
-                encodedLength += 3;
-                needsEncoding = YES;
-                break;
-        }
-    }
-    if (!needsEncoding) {
+    const unsigned char *bytes = (const unsigned char *)stringAsUTF8;
+    const size_t byteLength = strlen(stringAsUTF8);
+    const size_t prefixLength = _URLUnreservedPrefixLength(bytes, byteLength);
+    if (prefixLength == byteLength) {
         return string;
     }
 
-    char *encodedBytes = malloc(encodedLength);
+    // Encode in a single pass into a worst case sized buffer, then give back the excess
+    char *encodedBytes = malloc(prefixLength + ((byteLength - prefixLength) * 3));
     if (NULL == encodedBytes) {
         TNLLogError(@"Out of memory");
         return nil;
     }
 
-    char *outPtr = encodedBytes;
-    for (const unsigned char *c = (const unsigned char *)stringAsUTF8; *c; c++) {
-        switch (*c) {
-            case '0' ... '9':
-            case 'A' ... 'Z':
-            case 'a' ... 'z':
-            case '-':
-            case '.':
-            case '_':
-            case '~':
-                *outPtr++ = (char)*c;
-                break;
-            default:
-                *outPtr++ = '%';
-                *outPtr++ = kHexDigits[(*c>>4)&0xf];
-                *outPtr++ = kHexDigits[*c&0xf];
-                break;
-        }
+    memcpy(encodedBytes, bytes, prefixLength);
+    const size_t encodedLength = prefixLength + _URLEncodeBytes(bytes + prefixLength, byteLength - prefixLength, encodedBytes + prefixLength);
+    char *shrunkBytes = realloc(encodedBytes, encodedLength);
+    if (shrunkBytes) {
+        encodedBytes = shrunkBytes;
     }
 
     NSString *encodedString = [[NSString alloc] initWithBytesNoCopy:encodedBytes length:encodedLength encoding:NSASCIIStringEncoding freeWhenDone:YES];
@@ -87,19 +238,212 @@ NSString * __nullable TNLURLEncodeString(NSString * __nullable string)
     return encodedString;
 }
 
+#pragma mark Decoding
+
+static inline int _HexDigitValue(unsigned char c)
+{
+    switch (c) {
+        case '0' ... '9':
+            return c - '0';
+        case 'A' ... 'F':
+            return c - 'A' + 10;
+        case 'a' ... 'f':
+            return c - 'a' + 10;
+        default:
+            return -1;
+    }
+}
+
+static NSString * __nullable _URLDecodeUTF8String(NSString *string,
+                                                  const unsigned char *bytes,
+                                                  size_t length,
+                                                  BOOL replacePlussesWithSpaces)
+{
+    size_t i = _URLDecodePassthroughPrefixLength(bytes, length, replacePlussesWithSpaces);
+    if (i == length) {
+        // nothing to decode
+        return string;
+    }
+
+    // decoding never grows the bytes
+    char *decodedBytes = malloc(length);
+    if (NULL == decodedBytes) {
+        TNLLogError(@"Out of memory");
+        return nil;
+    }
+
+    memcpy(decodedBytes, bytes, i);
+    char *outPtr = decodedBytes + i;
+    while (i < length) {
+        const unsigned char c = bytes[i];
+        if ('+' == c) {
+            // '+' is only a stop byte when replacing plusses
+            *outPtr++ = ' ';
+            i++;
+        } else {
+            TNLAssert('%' == c);
+            const int hi = (i + 2 < length) ? _HexDigitValue(bytes[i + 1]) : -1;
+            const int lo = (hi >= 0) ? _HexDigitValue(bytes[i + 2]) : -1;
+            if (lo < 0) {
+                // invalid percent encoding sequence (matches `stringByRemovingPercentEncoding`)
+                free(decodedBytes);
+                return nil;
+            }
+            *outPtr++ = (char)((hi << 4) | lo);
+            i += 3;
+        }
+
+        const size_t runLength = _URLDecodePassthroughPrefixLength(bytes + i, length - i, replacePlussesWithSpaces);
+        memcpy(outPtr, bytes + i, runLength);
+        outPtr += runLength;
+        i += runLength;
+    }
+
+    // decoded bytes that are not valid UTF-8 yield nil (matches `stringByRemovingPercentEncoding`)
+    NSString *decodedString = [[NSString alloc] initWithBytesNoCopy:decodedBytes
+                                                             length:(NSUInteger)(outPtr - decodedBytes)
+                                                           encoding:NSUTF8StringEncoding
+                                                       freeWhenDone:YES];
+    if (!decodedString) {
+        free(decodedBytes);
+    }
+    return decodedString;
+}
+
 NSString * __nullable TNLURLDecodeString(NSString * __nullable string, BOOL replacePlussesWithSpaces)
 {
+    // the deprecated [s stringByReplacingPercentExcapesUsingEncoding:NSUTF8StringEncoding]
+    // used to return @"" for @"" .  the replacement method returns nil.
+    //
+    // by checking length, we preserve the old behavior for this caller in case anything depended upon it.
+    if (!string.length) {
+        return string;
+    }
+
+    const char *stringAsUTF8 = [string UTF8String];
+    if (stringAsUTF8 != NULL) {
+        // use the UTF-8 length rather than `strlen` so that embedded NULs are decoded through
+        const size_t byteLength = [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        return _URLDecodeUTF8String(string, (const unsigned char *)stringAsUTF8, byteLength, replacePlussesWithSpaces);
+    }
+
+    // not representable as UTF-8, fall back to Foundation
     NSString *s = string;
     // replace the '+' first since if the '+' is encoded we want to preserve its value
     if (replacePlussesWithSpaces) {
         s = [s stringByReplacingOccurrencesOfString:@"+" withString:@" "];
     }
+    return [s stringByRemovingPercentEncoding];
+}
 
-    // the deprecated [s stringByReplacingPercentExcapesUsingEncoding:NSUTF8StringEncoding]
-    // used to return @"" for @"" .  the replacement method returns nil.
-    //
-    // by checking length, we preserve the old behavior for this caller in case anything depended upon it.
-    return s.length ? [s stringByRemovingPercentEncoding] : s;
+#pragma mark URL Encoding Buffer
+
+BOOL TNLURLEncodingBufferReserve(TNLURLEncodingBuffer *buffer,
+                                 size_t additionalLength)
+{
+    const size_t requiredCapacity = buffer->length + additionalLength;
+    if (requiredCapacity <= buffer->capacity) {
+        return YES;
+    }
+
+    size_t capacity = MAX(buffer->capacity, (size_t)64);
+    while (capacity < requiredCapacity) {
+        capacity *= 2;
+    }
+
+    char *bytes = realloc(buffer->bytes, capacity);
+    if (NULL == bytes) {
+        TNLLogError(@"Out of memory");
+        return NO;
+    }
+
+    buffer->bytes = bytes;
+    buffer->capacity = capacity;
+    return YES;
+}
+
+BOOL TNLURLEncodingBufferAppendBytes(TNLURLEncodingBuffer *buffer,
+                                     const char *bytes,
+                                     size_t length)
+{
+    if (!TNLURLEncodingBufferReserve(buffer, length)) {
+        return NO;
+    }
+    memcpy(buffer->bytes + buffer->length, bytes, length);
+    buffer->length += length;
+    return YES;
+}
+
+BOOL TNLURLEncodingBufferAppendEncodedString(TNLURLEncodingBuffer *buffer,
+                                             NSString *string)
+{
+    const NSUInteger length = string.length;
+    if (!length) {
+        return YES;
+    }
+
+    // Avoid transcoding when the string already has a UTF-8 backing store (common for ASCII keys and values)
+    const char *cString = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingUTF8);
+    if (cString) {
+        const size_t byteLength = strlen(cString);
+        if (!TNLURLEncodingBufferReserve(buffer, byteLength * 3)) {
+            return NO;
+        }
+        buffer->length += _URLEncodeBytes((const unsigned char *)cString, byteLength, buffer->bytes + buffer->length);
+        return YES;
+    }
+
+    // Transcode to UTF-8 through a small stack buffer, encoding each chunk straight into the buffer
+    unsigned char chunk[256];
+    NSRange remainingRange = NSMakeRange(0, length);
+    while (remainingRange.length > 0) {
+        NSUInteger usedLength = 0;
+        const BOOL didConvert = [string getBytes:chunk
+                                       maxLength:sizeof(chunk)
+                                      usedLength:&usedLength
+                                        encoding:NSUTF8StringEncoding
+                                         options:0
+                                           range:remainingRange
+                                  remainingRange:&remainingRange];
+        if (!didConvert || 0 == usedLength) {
+            // not representable as UTF-8 (such as an unpaired surrogate)
+            return NO;
+        }
+        if (!TNLURLEncodingBufferReserve(buffer, usedLength * 3)) {
+            return NO;
+        }
+        buffer->length += _URLEncodeBytes(chunk, usedLength, buffer->bytes + buffer->length);
+    }
+    return YES;
+}
+
+NSString *TNLURLEncodingBufferCopyString(TNLURLEncodingBuffer *buffer)
+{
+    if (!buffer->length) {
+        TNLURLEncodingBufferFree(buffer);
+        return @"";
+    }
+
+    NSString *string = [[NSString alloc] initWithBytesNoCopy:buffer->bytes
+                                                      length:buffer->length
+                                                    encoding:NSASCIIStringEncoding
+                                                freeWhenDone:YES];
+    if (string) {
+        // ownership of the bytes moved to the string
+        buffer->bytes = NULL;
+        buffer->length = buffer->capacity = 0;
+    } else {
+        TNLLogError(@"Can't create string from URL encoding buffer");
+        TNLURLEncodingBufferFree(buffer);
+    }
+    return string ?: @"";
+}
+
+void TNLURLEncodingBufferFree(TNLURLEncodingBuffer *buffer)
+{
+    free(buffer->bytes);
+    buffer->bytes = NULL;
+    buffer->length = buffer->capacity = 0;
 }
 
 NS_ASSUME_NONNULL_END
@@ -106,10 +106,53 @@ NS_INLINE void tnl_dispatch_timer_invalidate(dispatch_source_t __nullable timerS
 
 FOUNDATION_EXTERN NSOperationQueue *TNLNetworkOperationQueue(void);
 FOUNDATION_EXTERN dispatch_queue_t tnl_network_queue(void);
-FOUNDATION_EXTERN dispatch_queue_t tnl_coding_queue(void);
+
+/**
+ Create a serial queue for the network state machine of a single operation.
+ Each `TNLRequestOperation` (and its `TNLURLSessionTaskOperation`) has its own lane so that its
+ state transitions, timers and data handling are serialized, while independent operations
+ make progress in parallel on a shared concurrent pool.
+ Global state that is not owned by a single operation stays on `tnl_network_queue()`.
+ */
+FOUNDATION_EXTERN dispatch_queue_t tnl_network_lane_create(void);
+FOUNDATION_EXTERN BOOL tnl_network_lane_is_current(dispatch_queue_t lane);
+
+/**
+ Create a serial queue for encoding/decoding work of a single operation.
+ Work on a lane executes in order, but every lane targets a shared concurrent coding pool
+ so that one large body being encoded/decoded cannot stall the coding work of any other operation.
+ Concurrency across all lanes is bounded by the pool, which GCD limits to the active cores.
+ */
+FOUNDATION_EXTERN dispatch_queue_t tnl_coding_lane_create(void);
+FOUNDATION_EXTERN BOOL tnl_coding_lane_is_current(dispatch_queue_t lane);
 
 #define TNLAssertIsNetworkQueue() TNLAssert(dispatch_queue_get_label(tnl_network_queue()) == dispatch_queue_get_label(DISPATCH_CURRENT_QUEUE_LABEL))
-#define TNLAssertIsCodingQueue() TNLAssert(dispatch_queue_get_label(tnl_coding_queue()) == dispatch_queue_get_label(DISPATCH_CURRENT_QUEUE_LABEL))
+#define TNLAssertIsNetworkLane(lane) TNLAssert(tnl_network_lane_is_current(lane))
+#define TNLAssertIsCodingLane(lane) TNLAssert(tnl_coding_lane_is_current(lane))
+
+#pragma mark - URL Encoding
+
+/**
+ Growable byte buffer for writing percent encoded output in a single pass.
+ Zero initialize, append, then either copy the result into an `NSString` (which takes
+ ownership of the bytes) or free it.
+ */
+typedef struct TNLURLEncodingBuffer {
+    char * __nullable bytes;
+    size_t length;
+    size_t capacity;
+} TNLURLEncodingBuffer;
+
+FOUNDATION_EXTERN BOOL TNLURLEncodingBufferReserve(TNLURLEncodingBuffer *buffer,
+                                                   size_t additionalLength);
+FOUNDATION_EXTERN BOOL TNLURLEncodingBufferAppendBytes(TNLURLEncodingBuffer *buffer,
+                                                       const char *bytes,
+                                                       size_t length);
+// returns `NO` if the string cannot be represented as UTF-8, the buffer may hold partial output in that case
+FOUNDATION_EXTERN BOOL TNLURLEncodingBufferAppendEncodedString(TNLURLEncodingBuffer *buffer,
+                                                               NSString *string);
+FOUNDATION_EXTERN NSString *TNLURLEncodingBufferCopyString(TNLURLEncodingBuffer *buffer);
+FOUNDATION_EXTERN void TNLURLEncodingBufferFree(TNLURLEncodingBuffer *buffer);
 
 #pragma mark - Dynamic Linking
 
@@ -63,16 +63,58 @@ dispatch_queue_t tnl_network_queue()
     return sQueue;
 }
 
-dispatch_queue_t tnl_coding_queue()
+static const char kNetworkLaneKey[] = "tnl.network.lane";
+
+static dispatch_queue_t _NetworkPoolQueue(void)
+{
+    static dispatch_queue_t sQueue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sQueue = dispatch_queue_create("tnl.network.pool", DISPATCH_QUEUE_CONCURRENT);
+    });
+    return sQueue;
+}
+
+dispatch_queue_t tnl_network_lane_create()
+{
+    dispatch_queue_t lane = dispatch_queue_create_with_target("tnl.network.lane", DISPATCH_QUEUE_SERIAL, _NetworkPoolQueue());
+    // lanes share a label, identify them by their specific (the lane itself, unretained)
+    dispatch_queue_set_specific(lane, kNetworkLaneKey, (__bridge void *)lane, NULL);
+    return lane;
+}
+
+BOOL tnl_network_lane_is_current(dispatch_queue_t lane)
+{
+    return dispatch_get_specific(kNetworkLaneKey) == (__bridge void *)lane;
+}
+
+static const char kCodingLaneKey[] = "tnl.encode.decode.lane";
+
+static dispatch_queue_t _CodingPoolQueue(void)
 {
     static dispatch_queue_t sQueue;
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
-        sQueue = dispatch_queue_create("tnl.encode.decode.queue", DISPATCH_QUEUE_SERIAL);
+        // a non-overcommitting utility queue, GCD bounds its concurrency to the active cores
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_CONCURRENT, QOS_CLASS_UTILITY, 0);
+        sQueue = dispatch_queue_create("tnl.encode.decode.pool", attr);
     });
     return sQueue;
 }
 
+dispatch_queue_t tnl_coding_lane_create()
+{
+    dispatch_queue_t lane = dispatch_queue_create_with_target("tnl.encode.decode.lane", DISPATCH_QUEUE_SERIAL, _CodingPoolQueue());
+    // lanes share a label, identify them by their specific (the lane itself, unretained)
+    dispatch_queue_set_specific(lane, kCodingLaneKey, (__bridge void *)lane, NULL);
+    return lane;
+}
+
+BOOL tnl_coding_lane_is_current(dispatch_queue_t lane)
+{
+    return dispatch_get_specific(kCodingLaneKey) == (__bridge void *)lane;
+}
+
 #pragma mark - Dynamic Loading
 
 #if TARGET_OS_IOS || TARGET_OS_TV
@@ -0,0 +1,43 @@
+//
+//  TNLCLIBenchmark.h
+//  tnlcli
+//
+//  Created on 10/16/26.
+//  Copyright © 2020 Twitter. All rights reserved.
+//
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Headless benchmark of the TNL request pipeline.
+
+ Every scenario runs its requests concurrently against `TNLPseudoURLProtocol` endpoints, so the
+ results measure TNL (and `NSURLSession`) rather than a network.
+ Each scenario reports requests/sec, p50/p99 enqueue-to-complete latency,
+ CPU time per request and (in DEBUG builds only, as an approximation) allocations per request.
+ */
+@interface TNLCLIBenchmark : NSObject
+
+/** `tiny_json_get`, `large_download`, `retries`, `redirects` and `header_providers` */
+@property (class, nonatomic, readonly) NSArray<NSString *> *allScenarioNames;
+
+/**
+ @param scenarioNames   the scenarios to run, `@"all"` runs `allScenarioNames`
+ @param iterations      the number of requests per scenario, `0` uses each scenario's default
+ */
+- (instancetype)initWithScenarioNames:(NSArray<NSString *> *)scenarioNames
+                           iterations:(NSUInteger)iterations NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+/**
+ Run the benchmark (blocking)
+ @return a JSON serializable dictionary of results, `nil` on error
+ */
+- (nullable NSDictionary<NSString *, id> *)run:(out NSError * __nullable * __nullable)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,401 @@
+//
+//  TNLCLIBenchmark.m
+//  tnlcli
+//
+//  Created on 10/16/26.
+//  Copyright © 2020 Twitter. All rights reserved.
+//
+
+#include <mach/mach_time.h>
+#include <stdatomic.h>
+#include <sys/resource.h>
+
+#import <TwitterNetworkLayer/TwitterNetworkLayer.h>
+
+#import "TNLCLIBenchmark.h"
+#import "TNLCLIError.h"
+
+#define BENCHMARK_ORIGIN @"https://benchmark.tnlcli.pseudo"
+
+#pragma mark - Allocation Counting
+
+// Allocation counting is a DEBUG only approximation:
+// malloc calls this hook (the same one malloc stack logging uses) for every allocation and free,
+// but it is a private global that is swapped without synchronization against threads that are
+// mid-allocation (or against malloc stack logging owning the hook), so it is never installed in release builds.
+#define TNLCLI_COUNT_ALLOCATIONS DEBUG
+
+#if TNLCLI_COUNT_ALLOCATIONS
+
+typedef void (TNLCLIMallocLogger)(uint32_t type,
+                                  uintptr_t arg1,
+                                  uintptr_t arg2,
+                                  uintptr_t arg3,
+                                  uintptr_t result,
+                                  uint32_t numberOfHotFramesToSkip);
+extern TNLCLIMallocLogger *malloc_logger;
+
+#define TNLCLI_MALLOC_LOG_TYPE_ALLOCATE (2)
+
+static _Atomic(uint64_t) sAllocationCount = 0;
+
+static void TNLCLICountingMallocLogger(uint32_t type,
+                                       uintptr_t arg1,
+                                       uintptr_t arg2,
+                                       uintptr_t arg3,
+                                       uintptr_t result,
+                                       uint32_t numberOfHotFramesToSkip)
+{
+    if (type & TNLCLI_MALLOC_LOG_TYPE_ALLOCATE) {
+        atomic_fetch_add_explicit(&sAllocationCount, 1, memory_order_relaxed);
+    }
+}
+
+#endif // TNLCLI_COUNT_ALLOCATIONS
+
+static NSTimeInterval TNLCLICPUTime()
+{
+    struct rusage usage;
+    if (0 != getrusage(RUSAGE_SELF, &usage)) {
+        return 0;
+    }
+    return (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + ((double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / (double)USEC_PER_SEC);
+}
+
+static double TNLCLIPercentile(NSArray<NSNumber *> *sortedValues, double percentile)
+{
+    if (!sortedValues.count) {
+        return 0;
+    }
+    // nearest rank
+    NSUInteger rank = (NSUInteger)ceil(percentile * (double)sortedValues.count);
+    rank = MIN(MAX(rank, 1UL), sortedValues.count);
+    return sortedValues[rank - 1].doubleValue;
+}
+
+#pragma mark - Helpers
+
+@interface TNLCLIBenchmarkRetryPolicyProvider : NSObject <TNLRequestRetryPolicyProvider>
+@end
+
+@interface TNLCLIBenchmarkHeaderProvider : NSObject <TNLHTTPHeaderProvider>
+- (instancetype)initWithIndex:(NSUInteger)index;
+@end
+
+@interface TNLCLIBenchmarkScenario : NSObject
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic) NSUInteger defaultIterations;
+@property (nonatomic, copy) TNLRequestConfiguration *configuration;
+@property (nonatomic, copy, nullable) dispatch_block_t setUpBlock;
+@property (nonatomic, copy, nullable) dispatch_block_t tearDownBlock;
+@property (nonatomic, copy) NSURL *(^URLBlock)(NSUInteger index);
+@end
+
+#pragma mark - TNLCLIBenchmark
+
+@implementation TNLCLIBenchmark
+{
+    NSArray<NSString *> *_scenarioNames;
+    NSUInteger _iterations;
+}
+
++ (NSArray<NSString *> *)allScenarioNames
+{
+    return @[ @"tiny_json_get", @"large_download", @"retries", @"redirects", @"header_providers" ];
+}
+
+- (instancetype)initWithScenarioNames:(NSArray<NSString *> *)scenarioNames
+                           iterations:(NSUInteger)iterations
+{
+    if (self = [super init]) {
+        _scenarioNames = ([scenarioNames containsObject:@"all"]) ? [[self class] allScenarioNames] : [scenarioNames copy];
+        _iterations = iterations;
+    }
+    return self;
+}
+
+- (nullable NSDictionary<NSString *, id> *)run:(out NSError * __nullable * __nullable)error
+{
+    NSMutableArray<TNLCLIBenchmarkScenario *> *scenarios = [[NSMutableArray alloc] init];
+    for (NSString *name in _scenarioNames) {
+        TNLCLIBenchmarkScenario *scenario = [self _scenarioWithName:name];
+        if (!scenario) {
+            if (error) {
+                *error = TNLCLICreateError(TNLCLIErrorUnknownBenchmarkScenario,
+                                           @{
+                                               NSDebugDescriptionErrorKey : @"Unknown benchmark scenario",
+                                               @"scenario" : name,
+                                               @"available_scenarios" : [[self class] allScenarioNames]
+                                           });
+            }
+            return nil;
+        }
+        [scenarios addObject:scenario];
+    }
+
+    NSMutableArray<NSDictionary *> *results = [[NSMutableArray alloc] init];
+    for (TNLCLIBenchmarkScenario *scenario in scenarios) {
+        @autoreleasepool {
+            [results addObject:[self _runScenario:scenario]];
+        }
+    }
+
+    NSProcessInfo *processInfo = [NSProcessInfo processInfo];
+    return @{
+                @"tnl_version" : [TNLGlobalConfiguration version],
+                @"os_version" : processInfo.operatingSystemVersionString,
+                @"processor_count" : @(processInfo.activeProcessorCount),
+                @"date" : @((int64_t)[NSDate date].timeIntervalSince1970),
+                @"scenarios" : [results copy],
+            };
+}
+
+- (NSDictionary<NSString *, id> *)_runScenario:(TNLCLIBenchmarkScenario *)scenario
+{
+    const NSUInteger iterations = _iterations ?: scenario.defaultIterations;
+    NSString *queueIdentifier = [@"tnlcli.benchmark." stringByAppendingString:scenario.name];
+    TNLRequestOperationQueue *queue = [[TNLRequestOperationQueue alloc] initWithIdentifier:queueIdentifier];
+
+    if (scenario.setUpBlock) {
+        scenario.setUpBlock();
+    }
+
+    // warm up, so one time costs (like creating the NSURLSession) are not measured
+    TNLRequestOperation *warmUpOp = [TNLRequestOperation operationWithURL:scenario.URLBlock(NSUIntegerMax)
+                                                            configuration:scenario.configuration
+                                                                 delegate:nil];
+    [queue enqueueRequestOperation:warmUpOp];
+    [warmUpOp waitUntilFinishedWithoutBlockingRunLoop];
+
+    NSMutableArray<TNLRequestOperation *> *ops = [[NSMutableArray alloc] initWithCapacity:iterations];
+
+#if TNLCLI_COUNT_ALLOCATIONS
+    TNLCLIMallocLogger *previousMallocLogger = malloc_logger;
+    atomic_store(&sAllocationCount, 0);
+    malloc_logger = TNLCLICountingMallocLogger;
+#endif
+    const NSTimeInterval startCPUTime = TNLCLICPUTime();
+    const uint64_t startMachTime = mach_absolute_time();
+
+    for (NSUInteger i = 0; i < iterations; i++) {
+        TNLRequestOperation *op = [TNLRequestOperation operationWithURL:scenario.URLBlock(i)
+                                                          configuration:scenario.configuration
+                                                               delegate:nil];
+        [ops addObject:op];
+        [queue enqueueRequestOperation:op];
+    }
+    for (TNLRequestOperation *op in ops) {
+        [op waitUntilFinishedWithoutBlockingRunLoop];
+    }
+
+    const uint64_t endMachTime = mach_absolute_time();
+    const NSTimeInterval cpuTime = TNLCLICPUTime() - startCPUTime;
+#if TNLCLI_COUNT_ALLOCATIONS
+    malloc_logger = previousMallocLogger;
+    const uint64_t allocationCount = atomic_load(&sAllocationCount);
+#endif
+
+    if (scenario.tearDownBlock) {
+        scenario.tearDownBlock();
+    }
+
+    NSUInteger failureCount = 0;
+    NSUInteger attemptCount = 0;
+    NSMutableArray<NSNumber *> *latencies = [[NSMutableArray alloc] initWithCapacity:iterations];
+    for (TNLRequestOperation *op in ops) {
+        TNLResponse *response = op.response;
+        if (response.operationError || response.info.statusCode >= 400) {
+            failureCount++;
+        }
+        attemptCount += response.metrics.attemptCount;
+        [latencies addObject:@(response.metrics.totalDuration)];
+    }
+    [latencies sortUsingSelector:@selector(compare:)];
+
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    const NSTimeInterval duration = (double)((endMachTime - startMachTime) * timebase.numer / timebase.denom) / (double)NSEC_PER_SEC;
+    const double count = (double)MAX(iterations, 1UL);
+
+    NSMutableDictionary<NSString *, id> *results = [@{
+                @"name" : scenario.name,
+                @"requests" : @(iterations),
+                @"attempts" : @(attemptCount),
+                @"failures" : @(failureCount),
+                @"duration_s" : @(duration),
+                @"requests_per_second" : @((duration > 0) ? (double)iterations / duration : 0),
+                @"latency_p50_ms" : @(TNLCLIPercentile(latencies, 0.50) * 1000.0),
+                @"latency_p99_ms" : @(TNLCLIPercentile(latencies, 0.99) * 1000.0),
+                @"cpu_time_per_request_ms" : @(cpuTime * 1000.0 / count),
+            } mutableCopy];
+#if TNLCLI_COUNT_ALLOCATIONS
+    results[@"allocations_per_request"] = @((double)allocationCount / count);
+#endif
+    return results;
+}
+
+#pragma mark Scenarios
+
+- (nullable TNLCLIBenchmarkScenario *)_scenarioWithName:(NSString *)name
+{
+    TNLMutableRequestConfiguration *config = [TNLMutableRequestConfiguration defaultConfiguration];
+    config.protocolOptions = TNLRequestProtocolOptionPseudo;
+    config.URLCache = nil;
+
+    NSHTTPURLResponse *(^makeResponse)(NSString *, NSInteger, NSDictionary *) = ^(NSString *path, NSInteger statusCode, NSDictionary *headers) {
+        return [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:[BENCHMARK_ORIGIN stringByAppendingString:path]]
+                                           statusCode:statusCode
+                                          HTTPVersion:@"HTTP/1.1"
+                                         headerFields:headers];
+    };
+    NSURL *(^makeURL)(NSString *) = ^(NSString *path) {
+        return [NSURL URLWithString:[BENCHMARK_ORIGIN stringByAppendingString:path]];
+    };
+    NSDictionary *JSONHeaders = @{ @"Content-Type" : @"application/json" };
+    NSData *tinyJSON = [@"{\"id\":1,\"name\":\"tiny\",\"ok\":true}" dataUsingEncoding:NSUTF8StringEncoding];
+
+    TNLCLIBenchmarkScenario *scenario = [[TNLCLIBenchmarkScenario alloc] init];
+    scenario.name = name;
+    scenario.tearDownBlock = ^{
+        [TNLPseudoURLProtocol unregisterAllEndpoints];
+    };
+
+    if ([name isEqualToString:@"tiny_json_get"]) {
+        scenario.defaultIterations = 5000;
+        scenario.setUpBlock = ^{
+            [TNLPseudoURLProtocol registerURLResponse:makeResponse(@"/tiny/", 200, JSONHeaders)
+                                                 body:tinyJSON
+                                               config:nil
+                                   withEndpointPrefix:makeURL(@"/tiny/")];
+        };
+        scenario.URLBlock = ^NSURL *(NSUInteger index) {
+            return makeURL([NSString stringWithFormat:@"/tiny/%tu", index]);
+        };
+    } else if ([name isEqualToString:@"large_download"]) {
+        scenario.defaultIterations = 20;
+        scenario.setUpBlock = ^{
+            NSMutableData *body = [NSMutableData dataWithLength:8 * 1024 * 1024];
+            arc4random_buf(body.mutableBytes, body.length);
+            [TNLPseudoURLProtocol registerURLResponse:makeResponse(@"/large/", 200, @{ @"Content-Type" : @"application/octet-stream" })
+                                                 body:body
+                                               config:nil
+                                   withEndpointPrefix:makeURL(@"/large/")];
+        };
+        scenario.URLBlock = ^NSURL *(NSUInteger index) {
+            return makeURL([NSString stringWithFormat:@"/large/%tu", index]);
+        };
+    } else if ([name isEqualToString:@"retries"]) {
+        scenario.defaultIterations = 200;
+        config.retryPolicyProvider = [[TNLCLIBenchmarkRetryPolicyProvider alloc] init];
+        scenario.setUpBlock = ^{
+            TNLPseudoURLResponseConfig *pseudoConfig = [[TNLPseudoURLResponseConfig alloc] init];
+            pseudoConfig.failureRate = 0.5;
+            // 500 rather than 503, which would trigger backoff and measure the backoff delays instead
+            pseudoConfig.failureStatusCode = 500;
+            [TNLPseudoURLProtocol registerURLResponse:makeResponse(@"/flaky/", 200, JSONHeaders)
+                                                 body:tinyJSON
+                                               config:pseudoConfig
+                                   withEndpointPrefix:makeURL(@"/flaky/")];
+        };
+        scenario.URLBlock = ^NSURL *(NSUInteger index) {
+            return makeURL([NSString stringWithFormat:@"/flaky/%tu", index]);
+        };
+    } else if ([name isEqualToString:@"redirects"]) {
+        scenario.defaultIterations = 1000;
+        scenario.setUpBlock = ^{
+            [TNLPseudoURLProtocol registerURLResponse:makeResponse(@"/redirect/", 302, @{ @"Location" : BENCHMARK_ORIGIN @"/redirect-target" })
+                                                 body:nil
+                                               config:nil
+                                   withEndpointPrefix:makeURL(@"/redirect/")];
+            [TNLPseudoURLProtocol registerURLResponse:makeResponse(@"/redirect-target", 200, JSONHeaders)
+                                                 body:tinyJSON
+                                         withEndpoint:makeURL(@"/redirect-target")];
+        };
+        scenario.URLBlock = ^NSURL *(NSUInteger index) {
+            return makeURL([NSString stringWithFormat:@"/redirect/%tu", index]);
+        };
+    } else if ([name isEqualToString:@"header_providers"]) {
+        scenario.defaultIterations = 2000;
+        NSMutableArray<TNLCLIBenchmarkHeaderProvider *> *headerProviders = [[NSMutableArray alloc] init];
+        for (NSUInteger i = 0; i < 16; i++) {
+            [headerProviders addObject:[[TNLCLIBenchmarkHeaderProvider alloc] initWithIndex:i]];
+        }
+        scenario.setUpBlock = ^{
+            for (TNLCLIBenchmarkHeaderProvider *headerProvider in headerProviders) {
+                [[TNLGlobalConfiguration sharedInstance] addHeaderProvider:headerProvider];
+            }
+            [TNLPseudoURLProtocol registerURLResponse:makeResponse(@"/headers/", 200, JSONHeaders)
+                                                 body:tinyJSON
+                                               config:nil
+                                   withEndpointPrefix:makeURL(@"/headers/")];
+        };
+        scenario.tearDownBlock = ^{
+            for (TNLCLIBenchmarkHeaderProvider *headerProvider in headerProviders) {
+                [[TNLGlobalConfiguration sharedInstance] removeHeaderProvider:headerProvider];
+            }
+            [TNLPseudoURLProtocol unregisterAllEndpoints];
+        };
+        scenario.URLBlock = ^NSURL *(NSUInteger index) {
+            return makeURL([NSString stringWithFormat:@"/headers/%tu", index]);
+        };
+    } else {
+        return nil;
+    }
+
+    scenario.configuration = config;
+    return scenario;
+}
+
+@end
+
+#pragma mark - Helper Implementations
+
+@implementation TNLCLIBenchmarkScenario
+@end
+
+@implementation TNLCLIBenchmarkRetryPolicyProvider
+
+- (BOOL)tnl_shouldRetryRequestOperation:(TNLRequestOperation *)op
+                           withResponse:(TNLResponse *)response
+{
+    // retry each 500 up to twice, the minimum retry delay (0.1 seconds) applies
+    return TNLHTTPStatusCodeInternalServerError == response.info.statusCode && response.metrics.attemptCount < 3;
+}
+
+@end
+
+@implementation TNLCLIBenchmarkHeaderProvider
+{
+    NSDictionary<NSString *, NSString *> *_defaultHeaders;
+    NSDictionary<NSString *, NSString *> *_overrideHeaders;
+}
+
+- (instancetype)initWithIndex:(NSUInteger)index
+{
+    if (self = [super init]) {
+        NSMutableDictionary<NSString *, NSString *> *defaultHeaders = [[NSMutableDictionary alloc] init];
+        for (NSUInteger i = 0; i < 8; i++) {
+            defaultHeaders[[NSString stringWithFormat:@"X-Benchmark-Default-%tu-%tu", index, i]] = [NSUUID UUID].UUIDString;
+        }
+        _defaultHeaders = [defaultHeaders copy];
+        _overrideHeaders = @{
+                                [NSString stringWithFormat:@"X-Benchmark-Override-%tu", index] : [NSUUID UUID].UUIDString,
+                                @"X-Benchmark-Override" : [NSString stringWithFormat:@"%tu", index],
+                            };
+    }
+    return self;
+}
+
+- (nullable NSDictionary<NSString *, NSString *> *)tnl_allDefaultHTTPHeaderFieldsForRequest:(id<TNLRequest>)request
+                                                                                 URLRequest:(NSURLRequest *)URLRequest
+{
+    return _defaultHeaders;
+}
+
+- (nullable NSDictionary<NSString *, NSString *> *)tnl_allOverrideHTTPHeaderFieldsForRequest:(id<TNLRequest>)request
+                                                                                  URLRequest:(NSURLRequest *)URLRequest
+{
+    return _overrideHeaders;
+}
+
+@end
@@ -22,6 +22,8 @@ typedef NS_ENUM(NSInteger, TNLCLIError)
     TNLCLIErrorJSONParseFailure,
     TNLCLIErrorResponseBodyCannotPrint,
     TNLCLIErrorInvalidRequestConfigurationFileFormat, // needs to be JSON of key=value pairs (all strings, even numeric values!)
+    TNLCLIErrorUnknownBenchmarkScenario,
+    TNLCLIErrorBenchmarkOutputCannotBeWritten,
 };
 
 FOUNDATION_EXTERN NSString * const TNLCLIErrorDomain;
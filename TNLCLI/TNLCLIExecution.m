@@ -8,6 +8,7 @@
 
 #import <TwitterNetworkLayer/TwitterNetworkLayer.h>
 
+#import "TNLCLIBenchmark.h"
 #import "TNLCLIError.h"
 #import "TNLCLIExecution.h"
 #import "TNLCLIPrint.h"
@@ -116,6 +117,13 @@
         }
     }
 
+    /// Benchmark?
+
+    if (context.benchmarkScenarios) {
+        [self _executeBenchmark];
+        return;
+    }
+
     /// Construct the request
 
     TNLMutableRequestConfiguration *configuration = nil;
@@ -328,6 +336,43 @@
     }
 }
 
+- (void)_executeBenchmark
+{
+    TNLCLIExecutionContext *context = _context;
+
+    if (context.verbose) {
+        tnlcli_printf("Running benchmark scenarios: %s\n", [context.benchmarkScenarios componentsJoinedByString:@", "].UTF8String);
+    }
+
+    NSError *error;
+    TNLCLIBenchmark *benchmark = [[TNLCLIBenchmark alloc] initWithScenarioNames:context.benchmarkScenarios
+                                                                     iterations:context.benchmarkIterations];
+    NSDictionary<NSString *, id> *results = [benchmark run:&error];
+    if (!results) {
+        FAIL(error);
+    }
+
+    NSData *data = [NSJSONSerialization dataWithJSONObject:results
+                                                   options:NSJSONWritingPrettyPrinted | NSJSONWritingSortedKeys
+                                                     error:&error];
+    if (!data) {
+        FAIL(error);
+    }
+
+    if (context.benchmarkOutputFilePath) {
+        if (![data writeToFile:[self sanitizePath:context.benchmarkOutputFilePath] options:NSDataWritingAtomic error:&error]) {
+            FAIL(TNLCLICreateError(TNLCLIErrorBenchmarkOutputCannotBeWritten,
+                                   @{
+                                       NSDebugDescriptionErrorKey : @"Benchmark results could not be written",
+                                       NSUnderlyingErrorKey : error
+                                   }));
+        }
+    } else {
+        data = TNLCLIEnsureDataIsNullTerminated(data);
+        tnlcli_printf("%s\n", (const char *)data.bytes);
+    }
+}
+
 @end
 
 @implementation TNLCLIExecution (TNLDelegate)
@@ -48,6 +48,12 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic, readonly, copy, nullable) NSString *certificateChainDumpDirectory;
 
+#pragma mark Benchmark Info
+
+@property (nonatomic, readonly, copy, nullable) NSArray<NSString *> *benchmarkScenarios; // @"all" or scenario names, non-nil when benchmarking
+@property (nonatomic, readonly) NSUInteger benchmarkIterations; // 0 == each scenario's default
+@property (nonatomic, readonly, copy, nullable) NSString *benchmarkOutputFilePath; // nil == print
+
 #pragma mark Other Info
 
 @property (nonatomic, readonly) BOOL verbose;
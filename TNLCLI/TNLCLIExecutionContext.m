@@ -89,6 +89,11 @@ static NSArray<NSString *> *parseArgs(int argc, const char * argv[])
         return;
     }
 
+    if ([args[1] isEqualToString:@"--benchmark"]) {
+        [self digestBenchmarkArgs:args];
+        return;
+    }
+
     NSMutableArray<NSString *> *headers = [[NSMutableArray alloc] init];
     NSMutableArray<NSString *> *configs = [[NSMutableArray alloc] init];
     NSMutableArray<NSString *> *globals = [[NSMutableArray alloc] init];
@@ -155,5 +160,38 @@ static NSArray<NSString *> *parseArgs(int argc, const char * argv[])
     _requestURLString = [args.lastObject copy];
 }
 
+- (void)digestBenchmarkArgs:(NSArray<NSString *> *)args
+{
+    // benchmarks have no request `url`, every argument is an option
+    for (NSUInteger i = 1; i < args.count; ) {
+        NSString *option = args[i++];
+
+        if ([option isEqualToString:@"--verbose"]) {
+            _verbose = YES;
+            continue;
+        }
+
+        if (i == args.count) {
+            FAIL(TNLCLICreateError(TNLCLIErrorUnknown, [NSString stringWithFormat:@"Missing value for `%@`", option]));
+        }
+        NSString *value = args[i++];
+
+        if ([option isEqualToString:@"--benchmark"]) {
+            _benchmarkScenarios = [value componentsSeparatedByString:@","];
+            continue;
+        }
+        if ([option isEqualToString:@"--benchmark-iterations"]) {
+            _benchmarkIterations = (NSUInteger)MAX(value.integerValue, 0);
+            continue;
+        }
+        if ([option isEqualToString:@"--benchmark-output"]) {
+            _benchmarkOutputFilePath = [value copy];
+            continue;
+        }
+
+        TNLCLIPrintWarning([NSString stringWithFormat:@"`%@` is an unknown benchmark argument.  Skipping it and its value `%@`", option, value]);
+    }
+}
+
 @end
 
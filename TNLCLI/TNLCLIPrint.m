@@ -44,7 +44,8 @@ void TNLCLIPrintUsage(NSString * __nullable cliName)
     // NOTE: when updating the usage, update the README.md too.
 
     cliName = cliName ?: @"tnlcli";
-    tnlcli_fprintf(stderr, "Usage: %s [options] url\n\n", cliName.UTF8String);
+    tnlcli_fprintf(stderr, "Usage: %s [options] url\n", cliName.UTF8String);
+    tnlcli_fprintf(stderr, "       %s --benchmark <scenarios> [benchmark options]\n\n", cliName.UTF8String);
     tnlcli_fprintf(stderr, "\tExample: %s --request-method HEAD --response-header-mode file,print --response-header-file response_headers.json https://google.com\n\n", cliName.UTF8String);
     tnlcli_fprintf(stderr, "Argument Options:\n-----------------\n\n");
     tnlcli_fprintf(stderr, "\t--request-config-file <filepath>     TNLRequestConfiguration as a json file\n");
@@ -65,5 +66,10 @@ void TNLCLIPrintUsage(NSString * __nullable cliName)
     tnlcli_fprintf(stderr, "\t--verbose                            Will print verbose information and force the --response-body-mode and --responde-headers-mode to have \"print\".\n");
     tnlcli_fprintf(stderr, "\t--version                            Will print ther version information.\n");
     tnlcli_fprintf(stderr, "\n");
+    tnlcli_fprintf(stderr, "Benchmark Options:\n------------------\n\n");
+    tnlcli_fprintf(stderr, "\t--benchmark <scenarios>              Run benchmark scenarios against pseudo endpoints instead of a request: \"all\" or a combo using commas of tiny_json_get, large_download, retries, redirects and header_providers\n");
+    tnlcli_fprintf(stderr, "\t--benchmark-iterations <count>       Number of requests per scenario (defaults per scenario)\n");
+    tnlcli_fprintf(stderr, "\t--benchmark-output <filepath>        file for the results to save to (as json), otherwise they are printed\n");
+    tnlcli_fprintf(stderr, "\n");
 }
 
@@ -113,6 +113,7 @@ do { \
 
     BOOL_SETTING(contributeToExecutingNetworkConnectionsCount);
     BOOL_SETTING(skipHostSanitization);
+    BOOL_SETTING(coalescesIdenticalRequests);
     BOOL_SETTING(shouldSetCookies);
     BOOL_SETTING(allowsCellularAccess);
     BOOL_SETTING(discretionary);
@@ -126,6 +127,8 @@ do { \
     NUMBER_SETTING(attemptTimeout, double);
     NUMBER_SETTING(operationTimeout, double);
     NUMBER_SETTING(deferrableInterval, double);
+    NUMBER_SETTING(hedgeDelayPercentile, double);
+    NUMBER_SETTING(hedgeMinimumDelay, double);
 
 
     /// Integer settings
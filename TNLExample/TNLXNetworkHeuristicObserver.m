@@ -77,6 +77,8 @@
             case TNLAttemptTypeRetry:
                 self->_retryCount++;
                 break;
+            case TNLAttemptTypeHedge:
+                break;
         }
         self->_attemptCount++;
     });
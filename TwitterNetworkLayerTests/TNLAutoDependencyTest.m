@@ -25,6 +25,8 @@
 {
     [TNLPseudoURLProtocol unregisterAllEndpoints];
     [TNLGlobalConfiguration sharedInstance].operationAutomaticDependencyPriorityThreshold = (TNLPriority)NSIntegerMax;
+    [TNLGlobalConfiguration sharedInstance].maximumConcurrentRequestOperationCount = 0;
+    [TNLGlobalConfiguration sharedInstance].requestOperationAdmissionAgingInterval = 3.0;
 
     [super tearDown];
 }
@@ -143,4 +145,165 @@ cancelMidway:(BOOL)cancelMidway
     XCTAssertEqualObjects([completionOrder objectAtIndex:0], slowOp, @"%@", completionOrder);
 }
 
+- (void)testAutoDependencyGateWithManyHighPriorityOperations
+{
+    // A low priority operation waits on all high priority operations in flight via a single gate dependency
+
+    NSURL *slowURL = [NSURL URLWithString:@"http://www.dummy.com/slow/many"];
+    NSURL *fastURL = [NSURL URLWithString:@"http://www.dummy.com/fast/many"];
+    NSHTTPURLResponse *slowResponse = [[NSHTTPURLResponse alloc] initWithURL:slowURL statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:nil];
+    NSHTTPURLResponse *fastResponse = [[NSHTTPURLResponse alloc] initWithURL:fastURL statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:nil];
+    TNLPseudoURLResponseConfig *slowConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    slowConfig.delay = 500 /*ms*/;
+    [TNLPseudoURLProtocol registerURLResponse:slowResponse body:nil config:slowConfig withEndpoint:slowURL];
+    [TNLPseudoURLProtocol registerURLResponse:fastResponse body:nil config:nil withEndpoint:fastURL];
+
+    TNLMutableRequestConfiguration *requestConfig = [TNLMutableRequestConfiguration defaultConfiguration];
+    requestConfig.protocolOptions = TNLRequestProtocolOptionPseudo;
+    TNLRequestOperationQueue *queue = [TNLRequestOperationQueue defaultOperationQueue];
+
+    [TNLGlobalConfiguration sharedInstance].operationAutomaticDependencyPriorityThreshold = TNLPriorityHigh;
+
+    const NSUInteger highPriorityCount = 50;
+    NSMutableArray<TNLRequestOperation *> *slowOps = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < highPriorityCount; i++) {
+        TNLRequestOperation *slowOp = [TNLRequestOperation operationWithURL:slowURL configuration:requestConfig delegate:nil];
+        slowOp.priority = TNLPriorityVeryHigh;
+        [slowOps addObject:slowOp];
+        [queue enqueueRequestOperation:slowOp];
+    }
+
+    TNLRequestOperation *fastOp = [TNLRequestOperation operationWithURL:fastURL configuration:requestConfig delegate:nil];
+    [queue enqueueRequestOperation:fastOp];
+    SLEEP_LOOP(0.1);
+    XCTAssertEqual(fastOp.dependencies.count, (NSUInteger)1);
+
+    [fastOp waitUntilFinishedWithoutBlockingRunLoop];
+    for (TNLRequestOperation *slowOp in slowOps) {
+        XCTAssertTrue(slowOp.isFinished);
+    }
+
+    // once the epoch is over, new low priority operations are not gated
+    TNLRequestOperation *fastOp2 = [TNLRequestOperation operationWithURL:fastURL configuration:requestConfig delegate:nil];
+    [queue enqueueRequestOperation:fastOp2];
+    SLEEP_LOOP(0.1);
+    XCTAssertEqual(fastOp2.dependencies.count, (NSUInteger)0);
+    [fastOp2 waitUntilFinishedWithoutBlockingRunLoop];
+}
+
+- (void)testAutoDependencyIgnoresLaterHighPriorityOperations
+{
+    // A low priority operation waits on the high priority operations in flight when it is enqueued,
+    // but not on the ones enqueued after it
+
+    NSURL *slowURL = [NSURL URLWithString:@"http://www.dummy.com/slow/epoch"];
+    NSURL *slowerURL = [NSURL URLWithString:@"http://www.dummy.com/slower/epoch"];
+    NSURL *fastURL = [NSURL URLWithString:@"http://www.dummy.com/fast/epoch"];
+    TNLPseudoURLResponseConfig *slowConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    slowConfig.delay = 500 /*ms*/;
+    TNLPseudoURLResponseConfig *slowerConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    slowerConfig.delay = 3000 /*ms*/;
+    [TNLPseudoURLProtocol registerURLResponse:[[NSHTTPURLResponse alloc] initWithURL:slowURL statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:nil] body:nil config:slowConfig withEndpoint:slowURL];
+    [TNLPseudoURLProtocol registerURLResponse:[[NSHTTPURLResponse alloc] initWithURL:slowerURL statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:nil] body:nil config:slowerConfig withEndpoint:slowerURL];
+    [TNLPseudoURLProtocol registerURLResponse:[[NSHTTPURLResponse alloc] initWithURL:fastURL statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:nil] body:nil config:nil withEndpoint:fastURL];
+
+    TNLMutableRequestConfiguration *requestConfig = [TNLMutableRequestConfiguration defaultConfiguration];
+    requestConfig.protocolOptions = TNLRequestProtocolOptionPseudo;
+    TNLRequestOperationQueue *queue = [TNLRequestOperationQueue defaultOperationQueue];
+
+    [TNLGlobalConfiguration sharedInstance].operationAutomaticDependencyPriorityThreshold = TNLPriorityHigh;
+
+    TNLRequestOperation *slowOp = [TNLRequestOperation operationWithURL:slowURL configuration:requestConfig delegate:nil];
+    slowOp.priority = TNLPriorityVeryHigh;
+    [queue enqueueRequestOperation:slowOp];
+
+    TNLRequestOperation *fastOp = [TNLRequestOperation operationWithURL:fastURL configuration:requestConfig delegate:nil];
+    [queue enqueueRequestOperation:fastOp];
+
+    TNLRequestOperation *slowerOp = [TNLRequestOperation operationWithURL:slowerURL configuration:requestConfig delegate:nil];
+    slowerOp.priority = TNLPriorityVeryHigh;
+    [queue enqueueRequestOperation:slowerOp];
+
+    SLEEP_LOOP(0.1);
+    XCTAssertEqual(fastOp.dependencies.count, (NSUInteger)1);
+
+    [fastOp waitUntilFinishedWithoutBlockingRunLoop];
+    XCTAssertTrue(slowOp.isFinished);
+    XCTAssertFalse(slowerOp.isFinished);
+
+    // a low priority operation enqueued now waits on the later high priority operation
+    TNLRequestOperation *fastOp2 = [TNLRequestOperation operationWithURL:fastURL configuration:requestConfig delegate:nil];
+    [queue enqueueRequestOperation:fastOp2];
+    [fastOp2 waitUntilFinishedWithoutBlockingRunLoop];
+    XCTAssertTrue(slowerOp.isFinished);
+}
+
+- (void)testAdmissionByPriority
+{
+    // With a single admission slot, queued operations are admitted by priority
+    // and a priority change re-orders an operation that is already queued
+
+    NSURL *slowURL = [NSURL URLWithString:@"http://www.dummy.com/slow/admission"];
+    NSURL *fastURL = [NSURL URLWithString:@"http://www.dummy.com/fast/admission"];
+    NSHTTPURLResponse *slowResponse = [[NSHTTPURLResponse alloc] initWithURL:slowURL statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:nil];
+    NSHTTPURLResponse *fastResponse = [[NSHTTPURLResponse alloc] initWithURL:fastURL statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:nil];
+    TNLPseudoURLResponseConfig *slowConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    slowConfig.delay = 500 /*ms*/;
+    [TNLPseudoURLProtocol registerURLResponse:slowResponse body:nil config:slowConfig withEndpoint:slowURL];
+    [TNLPseudoURLProtocol registerURLResponse:fastResponse body:nil config:nil withEndpoint:fastURL];
+
+    TNLMutableRequestConfiguration *requestConfig = [TNLMutableRequestConfiguration defaultConfiguration];
+    requestConfig.protocolOptions = TNLRequestProtocolOptionPseudo;
+    TNLRequestOperationQueue *queue = [TNLRequestOperationQueue defaultOperationQueue];
+
+    [TNLGlobalConfiguration sharedInstance].maximumConcurrentRequestOperationCount = 1;
+    [TNLGlobalConfiguration sharedInstance].requestOperationAdmissionAgingInterval = 0;
+
+    NSMutableArray<TNLRequestOperation *> *completionOrder = [[NSMutableArray alloc] init];
+    TNLRequestDidCompleteBlock completeBlock = ^(TNLRequestOperation *op, TNLResponse *response) {
+        @synchronized (completionOrder) {
+            [completionOrder addObject:op];
+        }
+    };
+
+    TNLRequestOperation *slowOp = [TNLRequestOperation operationWithRequest:[NSURLRequest requestWithURL:slowURL] configuration:requestConfig completion:completeBlock];
+    [queue enqueueRequestOperation:slowOp];
+    SLEEP_LOOP(0.1);
+
+    TNLRequestOperation *lowOp = [TNLRequestOperation operationWithRequest:[NSURLRequest requestWithURL:fastURL] configuration:requestConfig completion:completeBlock];
+    lowOp.priority = TNLPriorityVeryLow;
+    TNLRequestOperation *normalOp = [TNLRequestOperation operationWithRequest:[NSURLRequest requestWithURL:fastURL] configuration:requestConfig completion:completeBlock];
+    normalOp.priority = TNLPriorityNormal;
+    TNLRequestOperation *highOp = [TNLRequestOperation operationWithRequest:[NSURLRequest requestWithURL:fastURL] configuration:requestConfig completion:completeBlock];
+    highOp.priority = TNLPriorityHigh;
+    [queue enqueueRequestOperation:lowOp];
+    [queue enqueueRequestOperation:normalOp];
+    [queue enqueueRequestOperation:highOp];
+    SLEEP_LOOP(0.1);
+
+    TNLRequestOperationAdmissionStatistics *stats = [TNLRequestOperationQueue admissionStatistics];
+    XCTAssertEqual(stats.queuedOperationCount, (NSUInteger)3, @"%@", stats);
+    XCTAssertEqual(stats.admittedOperationCount, (NSUInteger)1, @"%@", stats);
+    XCTAssertEqual([stats queuedOperationCountForPriority:TNLPriorityVeryLow], (NSUInteger)1, @"%@", stats);
+
+    lowOp.priority = TNLPriorityVeryHigh;
+    SLEEP_LOOP(0.1);
+    stats = [TNLRequestOperationQueue admissionStatistics];
+    XCTAssertEqual([stats queuedOperationCountForPriority:TNLPriorityVeryLow], (NSUInteger)0, @"%@", stats);
+    XCTAssertEqual([stats queuedOperationCountForPriority:TNLPriorityVeryHigh], (NSUInteger)1, @"%@", stats);
+
+    [slowOp waitUntilFinishedWithoutBlockingRunLoop];
+    [lowOp waitUntilFinishedWithoutBlockingRunLoop];
+    [normalOp waitUntilFinishedWithoutBlockingRunLoop];
+    [highOp waitUntilFinishedWithoutBlockingRunLoop];
+    SLEEP_LOOP(0.1);
+
+    NSArray<TNLRequestOperation *> *expectedOrder = @[slowOp, lowOp, highOp, normalOp];
+    XCTAssertEqualObjects(completionOrder, expectedOrder);
+
+    stats = [TNLRequestOperationQueue admissionStatistics];
+    XCTAssertEqual(stats.queuedOperationCount, (NSUInteger)0, @"%@", stats);
+    XCTAssertGreaterThan(stats.maximumWaitTime, 0.4, @"%@", stats);
+}
+
 @end
@@ -148,4 +148,32 @@ static id<TNLContentDecoder> sBase64Decoder = nil;
     XCTAssertEqualObjects(decoded ?: op.hydratedURLRequest.HTTPBody, sJSONData);
 }
 
+- (void)testConcurrentBase64Decoding
+{
+    // Many responses decoding at once: each operation's chunks must be decoded in order
+    // even though decoding for different operations runs concurrently.
+
+    sConfig.additionalContentDecoders = @[ sBase64Decoder ];
+    TNLRequestConfiguration *config = [sConfig copy];
+    const NSUInteger operationCount = 16;
+
+    NSMutableArray<TNLRequestOperation *> *ops = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < operationCount; i++) {
+        TNLRequestOperation *op = [TNLRequestOperation operationWithURL:sBase64URL configuration:config delegate:nil];
+        [ops addObject:op];
+        [[TNLRequestOperationQueue defaultOperationQueue] enqueueRequestOperation:op];
+    }
+
+    for (TNLRequestOperation *op in ops) {
+        [op waitUntilFinishedWithoutBlockingRunLoop];
+        XCTAssertEqual(op.response.info.statusCode, 200);
+        XCTAssertEqualObjects(op.response.info.data, sJSONData);
+
+        TNLAttemptMetaData *metaData = op.response.metrics.attemptMetrics.lastObject.metaData;
+        XCTAssertTrue(metaData.hasResponseDecodingLatency);
+        XCTAssertTrue(metaData.hasResponseDecodingQueueLatency);
+        XCTAssertGreaterThanOrEqual(metaData.responseDecodingQueueLatency, 0.0);
+    }
+}
+
 @end
@@ -0,0 +1,355 @@
+//
+//  TNLLRUCacheTest.m
+//  TwitterNetworkLayer
+//
+//  Created on 10/16/26.
+//  Copyright © 2020 Twitter. All rights reserved.
+//
+
+#import "TNLLRUCache.h"
+
+@import XCTest;
+
+@interface TNLLRUCacheTestEntry : NSObject <TNLLRUEntry>
+@property (nonatomic, copy, readonly) NSString *LRUEntryIdentifier;
+@property (nonatomic) NSUInteger LRUEntryCost;
+@property (nonatomic) BOOL pinned;
+- (instancetype)initWithIdentifier:(NSString *)identifier cost:(NSUInteger)cost;
+@end
+
+@interface TNLLRUCacheTest : XCTestCase <TNLLRUCacheDelegate, TNLConcurrentLRUCacheDelegate>
+@end
+
+@implementation TNLLRUCacheTest
+{
+    NSMutableArray<NSString *> *_evictedIdentifiers;
+}
+
+- (void)setUp
+{
+    [super setUp];
+    _evictedIdentifiers = [NSMutableArray array];
+}
+
+- (void)tnl_cache:(TNLLRUCache *)cache didEvictEntry:(TNLLRUCacheTestEntry *)entry
+{
+    [_evictedIdentifiers addObject:entry.LRUEntryIdentifier];
+}
+
+- (BOOL)tnl_cache:(TNLLRUCache *)cache canEvictEntry:(TNLLRUCacheTestEntry *)entry
+{
+    return !entry.pinned;
+}
+
+- (void)tnl_concurrentCache:(TNLConcurrentLRUCache *)cache didEvictEntry:(TNLLRUCacheTestEntry *)entry
+{
+    @synchronized (_evictedIdentifiers) {
+        [_evictedIdentifiers addObject:entry.LRUEntryIdentifier];
+    }
+}
+
+- (BOOL)tnl_concurrentCache:(TNLConcurrentLRUCache *)cache canEvictEntry:(TNLLRUCacheTestEntry *)entry
+{
+    return !entry.pinned;
+}
+
+- (void)testCountLimit
+{
+    [self _runCountLimit:TNLLRUCacheStorageModeLinkedEntries];
+    [_evictedIdentifiers removeAllObjects];
+    [self _runCountLimit:TNLLRUCacheStorageModeIndexedNodes];
+}
+
+- (void)_runCountLimit:(TNLLRUCacheStorageMode)storageMode
+{
+    TNLLRUCache *cache = [[TNLLRUCache alloc] initWithEntries:nil delegate:self storageMode:storageMode];
+    XCTAssertEqual(cache.storageMode, storageMode);
+    cache.countLimit = 3;
+    for (NSUInteger i = 0; i < 5; i++) {
+        [cache addEntry:[[TNLLRUCacheTestEntry alloc] initWithIdentifier:@(i).stringValue cost:0]];
+    }
+    XCTAssertEqual(cache.numberOfEntries, 3UL);
+    XCTAssertEqualObjects(_evictedIdentifiers, (@[@"0", @"1"]));
+    XCTAssertEqual(cache.evictionCount, 2UL);
+
+    // pinned entries are skipped
+    ((TNLLRUCacheTestEntry *)cache.tailEntry).pinned = YES;
+    [cache addEntry:[[TNLLRUCacheTestEntry alloc] initWithIdentifier:@"5" cost:0]];
+    XCTAssertEqualObjects(_evictedIdentifiers.lastObject, @"3");
+    XCTAssertEqualObjects(cache.tailEntry.LRUEntryIdentifier, @"2");
+
+    // lowering the limit evicts immediately, but never the head
+    ((TNLLRUCacheTestEntry *)cache.tailEntry).pinned = NO;
+    cache.countLimit = 1;
+    XCTAssertEqual(cache.numberOfEntries, 1UL);
+    XCTAssertEqualObjects(cache.headEntry.LRUEntryIdentifier, @"5");
+}
+
+- (void)testCostLimit
+{
+    [self _runCostLimit:TNLLRUCacheStorageModeLinkedEntries];
+    [_evictedIdentifiers removeAllObjects];
+    [self _runCostLimit:TNLLRUCacheStorageModeIndexedNodes];
+}
+
+- (void)_runCostLimit:(TNLLRUCacheStorageMode)storageMode
+{
+    TNLLRUCache *cache = [[TNLLRUCache alloc] initWithEntries:nil delegate:self storageMode:storageMode];
+    XCTAssertEqual(cache.storageMode, storageMode);
+    cache.totalCostLimit = 100;
+    [cache addEntry:[[TNLLRUCacheTestEntry alloc] initWithIdentifier:@"a" cost:40]];
+    [cache addEntry:[[TNLLRUCacheTestEntry alloc] initWithIdentifier:@"b" cost:40]];
+    XCTAssertEqual(cache.totalCost, 80UL);
+
+    // touch "a" so that "b" is the least recently used
+    XCTAssertNotNil([cache entryWithIdentifier:@"a"]);
+    [cache addEntry:[[TNLLRUCacheTestEntry alloc] initWithIdentifier:@"c" cost:30]];
+    XCTAssertEqualObjects(_evictedIdentifiers, (@[@"b"]));
+    XCTAssertEqual(cache.totalCost, 70UL);
+
+    // an entry over the budget on its own is kept as the head
+    [cache addEntry:[[TNLLRUCacheTestEntry alloc] initWithIdentifier:@"d" cost:200]];
+    XCTAssertEqual(cache.numberOfEntries, 1UL);
+    XCTAssertEqual(cache.totalCost, 200UL);
+
+    [cache clearAllEntries];
+    XCTAssertEqual(cache.totalCost, 0UL);
+}
+
+- (void)testUpdateCost
+{
+    [self _runUpdateCost:TNLLRUCacheStorageModeLinkedEntries];
+    [_evictedIdentifiers removeAllObjects];
+    [self _runUpdateCost:TNLLRUCacheStorageModeIndexedNodes];
+}
+
+- (void)_runUpdateCost:(TNLLRUCacheStorageMode)storageMode
+{
+    TNLLRUCache *cache = [[TNLLRUCache alloc] initWithEntries:nil delegate:self storageMode:storageMode];
+    cache.totalCostLimit = 100;
+    TNLLRUCacheTestEntry *a = [[TNLLRUCacheTestEntry alloc] initWithIdentifier:@"a" cost:10];
+    TNLLRUCacheTestEntry *b = [[TNLLRUCacheTestEntry alloc] initWithIdentifier:@"b" cost:10];
+    TNLLRUCacheTestEntry *c = [[TNLLRUCacheTestEntry alloc] initWithIdentifier:@"c" cost:10];
+    [cache addEntry:a];
+    [cache addEntry:b];
+    [cache addEntry:c];
+
+    // a cost change is not an access, "a" stays the least recently used
+    a.LRUEntryCost = 20;
+    [cache updateCostOfEntry:a];
+    XCTAssertEqual(cache.totalCost, 40UL);
+    XCTAssertEqualObjects(cache.headEntry.LRUEntryIdentifier, @"c");
+    XCTAssertEqualObjects(cache.tailEntry.LRUEntryIdentifier, @"a");
+
+    // going over budget evicts from the tail
+    b.LRUEntryCost = 80;
+    [cache updateCostOfEntry:b];
+    XCTAssertEqualObjects(_evictedIdentifiers, (@[@"a"]));
+    XCTAssertEqual(cache.totalCost, 90UL);
+    XCTAssertEqualObjects(cache.headEntry.LRUEntryIdentifier, @"c");
+
+    // entries that are not in the cache are ignored
+    a.LRUEntryCost = 50;
+    [cache updateCostOfEntry:a];
+    XCTAssertEqual(cache.numberOfEntries, 2UL);
+    XCTAssertEqual(cache.totalCost, 90UL);
+}
+
+- (void)testStatistics
+{
+    [self _runStatistics:TNLLRUCacheStorageModeLinkedEntries];
+    [_evictedIdentifiers removeAllObjects];
+    [self _runStatistics:TNLLRUCacheStorageModeIndexedNodes];
+}
+
+- (void)_runStatistics:(TNLLRUCacheStorageMode)storageMode
+{
+    TNLLRUCache *cache = [[TNLLRUCache alloc] initWithEntries:nil delegate:self storageMode:storageMode];
+    XCTAssertEqual(cache.storageMode, storageMode);
+    [cache addEntry:[[TNLLRUCacheTestEntry alloc] initWithIdentifier:@"a" cost:1]];
+    [cache addEntry:[[TNLLRUCacheTestEntry alloc] initWithIdentifier:@"b" cost:1]];
+    (void)[cache entryWithIdentifier:@"a"];
+    (void)[cache entryWithIdentifier:@"a"];
+    (void)[cache entryWithIdentifier:@"z"];
+    (void)[cache removeTailEntry];
+    XCTAssertEqual(cache.hitCount, 2UL);
+    XCTAssertEqual(cache.missCount, 1UL);
+    XCTAssertEqual(cache.evictionCount, 1UL);
+    XCTAssertEqual(cache.totalCost, 1UL);
+
+    [cache resetStatistics];
+    XCTAssertEqual(cache.hitCount, 0UL);
+    XCTAssertEqual(cache.missCount, 0UL);
+    XCTAssertEqual(cache.evictionCount, 0UL);
+}
+
+- (void)testEnumeration
+{
+    for (NSNumber *storageMode in @[@(TNLLRUCacheStorageModeLinkedEntries), @(TNLLRUCacheStorageModeIndexedNodes)]) {
+        NSMutableArray<TNLLRUCacheTestEntry *> *entries = [NSMutableArray array];
+        for (NSUInteger i = 0; i < 40; i++) {
+            [entries addObject:[[TNLLRUCacheTestEntry alloc] initWithIdentifier:@(i).stringValue cost:0]];
+        }
+        TNLLRUCache *cache = [[TNLLRUCache alloc] initWithEntries:entries
+                                                         delegate:self
+                                                      storageMode:storageMode.integerValue];
+        XCTAssertEqualObjects(cache.allEntries, entries);
+
+        // move "20" to the head, remove "10"
+        (void)[cache entryWithIdentifier:@"20"];
+        [cache removeEntry:entries[10]];
+        NSMutableArray<TNLLRUCacheTestEntry *> *expectedEntries = [entries mutableCopy];
+        [expectedEntries removeObjectAtIndex:20];
+        [expectedEntries insertObject:entries[20] atIndex:0];
+        [expectedEntries removeObject:entries[10]];
+
+        NSMutableArray<id<TNLLRUEntry>> *enumeratedEntries = [NSMutableArray array];
+        for (id<TNLLRUEntry> entry in cache) {
+            [enumeratedEntries addObject:entry];
+        }
+        XCTAssertEqualObjects(enumeratedEntries, expectedEntries);
+        XCTAssertEqualObjects(cache.allEntries, expectedEntries);
+        XCTAssertEqual(cache.headEntry, entries[20]);
+        XCTAssertEqual(cache.tailEntry, entries.lastObject);
+
+        [cache clearAllEntries];
+        XCTAssertEqual(cache.numberOfEntries, 0UL);
+        XCTAssertNil(cache.headEntry);
+        XCTAssertNil(cache.tailEntry);
+        for (id<TNLLRUEntry> entry in cache) {
+            XCTFail(@"unexpected entry %@", entry);
+        }
+
+        // the freed nodes are reused
+        [cache addEntry:entries[0]];
+        XCTAssertEqual([cache entryWithIdentifier:@"0"], entries[0]);
+    }
+}
+
+- (NSTimeInterval)_runMixedOperations:(NSUInteger)operationCount
+                          storageMode:(TNLLRUCacheStorageMode)storageMode
+{
+    const NSUInteger identifierCount = 4096;
+    NSMutableArray<TNLLRUCacheTestEntry *> *entries = [NSMutableArray arrayWithCapacity:identifierCount];
+    for (NSUInteger i = 0; i < identifierCount; i++) {
+        [entries addObject:[[TNLLRUCacheTestEntry alloc] initWithIdentifier:[NSString stringWithFormat:@"entry-%tu", i] cost:1]];
+    }
+
+    TNLLRUCache *cache = [[TNLLRUCache alloc] initWithEntries:nil delegate:nil storageMode:storageMode];
+    cache.countLimit = identifierCount / 2;
+
+    uint32_t seed = 7;
+    const CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    @autoreleasepool {
+        for (NSUInteger i = 0; i < operationCount; i++) {
+            seed = seed * 1664525 + 1013904223;
+            TNLLRUCacheTestEntry *entry = entries[(seed >> 8) % identifierCount];
+            if ((seed & 0xff) < 64) {
+                [cache addEntry:entry];
+            } else {
+                (void)[cache entryWithIdentifier:entry.LRUEntryIdentifier];
+            }
+        }
+    }
+    const NSTimeInterval duration = CFAbsoluteTimeGetCurrent() - start;
+
+    XCTAssertEqual(cache.numberOfEntries, identifierCount / 2);
+    XCTAssertGreaterThan(cache.hitCount, 0UL);
+    return duration;
+}
+
+- (void)testStorageModeSpeed
+{
+    // 1M mixed operations: 25% add, 75% get over a key space twice the size of the cache
+    const NSUInteger operationCount = 1000000;
+    const NSTimeInterval linkedDuration = [self _runMixedOperations:operationCount
+                                                        storageMode:TNLLRUCacheStorageModeLinkedEntries];
+    NSLog(@"TNLLRUCacheStorageModeLinkedEntries: %tu ops = %fs", operationCount, linkedDuration);
+    const NSTimeInterval indexedDuration = [self _runMixedOperations:operationCount
+                                                         storageMode:TNLLRUCacheStorageModeIndexedNodes];
+    NSLog(@"TNLLRUCacheStorageModeIndexedNodes: %tu ops = %fs", operationCount, indexedDuration);
+    NSLog(@"Indexed nodes vs linked entries: %.2fx", linkedDuration / indexedDuration);
+}
+
+- (void)testConcurrentCacheSecondChance
+{
+    // one shard makes the CLOCK order deterministic
+    TNLConcurrentLRUCache *cache = [[TNLConcurrentLRUCache alloc] initWithShardCount:1 delegate:self];
+    XCTAssertEqual(cache.shardCount, 1UL);
+    cache.countLimit = 3;
+    for (NSString *identifier in @[@"a", @"b", @"c"]) {
+        [cache addEntry:[[TNLLRUCacheTestEntry alloc] initWithIdentifier:identifier cost:1]];
+    }
+
+    // "a" was used, so "b" is evicted instead
+    XCTAssertNotNil([cache entryWithIdentifier:@"a"]);
+    [cache addEntry:[[TNLLRUCacheTestEntry alloc] initWithIdentifier:@"d" cost:1]];
+    XCTAssertEqualObjects(_evictedIdentifiers, (@[@"b"]));
+    XCTAssertNotNil([cache entryWithIdentifier:@"a"]);
+    XCTAssertNil([cache entryWithIdentifier:@"b"]);
+    XCTAssertEqual(cache.numberOfEntries, 3UL);
+    XCTAssertEqual(cache.totalCost, 3UL);
+    XCTAssertEqual(cache.hitCount, 2UL);
+    XCTAssertEqual(cache.missCount, 1UL);
+    XCTAssertEqual(cache.evictionCount, 1UL);
+
+    // pinned entries are skipped, the added entry is never evicted
+    for (TNLLRUCacheTestEntry *entry in cache.allEntries) {
+        entry.pinned = YES;
+    }
+    cache.countLimit = 1;
+    XCTAssertEqual(cache.numberOfEntries, 3UL);
+    [cache addEntry:[[TNLLRUCacheTestEntry alloc] initWithIdentifier:@"e" cost:1]];
+    XCTAssertEqual(cache.numberOfEntries, 4UL);
+    XCTAssertNotNil([cache entryWithIdentifier:@"e"]);
+
+    [cache clearAllEntries];
+    XCTAssertEqual(cache.numberOfEntries, 0UL);
+    XCTAssertEqual(cache.totalCost, 0UL);
+}
+
+- (void)testConcurrentCacheConcurrentAccess
+{
+    TNLConcurrentLRUCache *cache = [[TNLConcurrentLRUCache alloc] initWithShardCount:4 delegate:self];
+    cache.countLimit = 64;
+    const NSUInteger iterations = 20000;
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t worker) {
+        for (NSUInteger i = 0; i < iterations; i++) {
+            NSString *identifier = @((i * 7 + worker) % 256).stringValue;
+            if (i % 8 == 0) {
+                [cache addEntry:[[TNLLRUCacheTestEntry alloc] initWithIdentifier:identifier cost:1]];
+            } else {
+                id<TNLLRUEntry> entry = [cache entryWithIdentifier:identifier];
+                XCTAssertTrue(!entry || [entry.LRUEntryIdentifier isEqualToString:identifier]);
+            }
+        }
+    });
+
+    XCTAssertLessThanOrEqual(cache.numberOfEntries, 64UL);
+    XCTAssertEqual(cache.numberOfEntries, cache.allEntries.count);
+    XCTAssertEqual(cache.totalCost, cache.numberOfEntries);
+    XCTAssertEqual(cache.hitCount + cache.missCount, 8 * iterations - 8 * (iterations / 8));
+}
+
+@end
+
+@implementation TNLLRUCacheTestEntry
+
+@synthesize nextLRUEntry = _nextLRUEntry;
+@synthesize previousLRUEntry = _previousLRUEntry;
+
+- (instancetype)initWithIdentifier:(NSString *)identifier cost:(NSUInteger)cost
+{
+    if (self = [super init]) {
+        _LRUEntryIdentifier = [identifier copy];
+        _LRUEntryCost = cost;
+    }
+    return self;
+}
+
+- (BOOL)shouldAccessMoveLRUEntryToHead
+{
+    return YES;
+}
+
+@end
@@ -218,6 +218,48 @@ static void TestSwizzle(Class cls, SEL originalSelector, SEL swizzledSelector)
     [self runCategoryTest:self.allPartsURL expectParamCount:ARG_COUNT expectQueryCount:ARG_COUNT expectFragmentCount:ARG_COUNT];
 }
 
+- (void)testLazyParsing
+{
+    NSArray<NSString *> *URLStrings = @[
+        PATH PARAMS_STRING QUERY_STRING FRAGMENT_STRING,
+        PATH @"?a=1&b=2&a=3&&=4&c&d=&%61=5&e=%zz&e=6&f=a+b&g%2Bh=%2B",
+        PATH @"?snowman=%E2%98%83&caf%C3%A9=cr%C3%A8me&x=1#x=2",
+        PATH,
+    ];
+    NSArray<NSString *> *keys = @[ @"one", @"two", @"three", @"une", @"deux", @"char", @"inner_url", @"z", @"a", @"b", @"c", @"d", @"e", @"f", @"g+h", @"snowman", @"café", @"x", @"missing", @"" ];
+    const TNLURLDecodingOptions optionsToTest[] = { TNLURLDecodingOptionsNone, TNLURLDecodingOptionOmitEmptyValues, TNLURLDecodingOptionPreservePlusses };
+    const TNLParameterTypes allTypes = TNLParameterTypeURLParameterString | TNLParameterTypeURLQuery | TNLParameterTypeURLFragment;
+
+    for (NSString *URLString in URLStrings) {
+        NSURL *URL = [NSURL URLWithString:URLString];
+        for (size_t i = 0; i < sizeof(optionsToTest) / sizeof(optionsToTest[0]); i++) {
+            TNLMutableParameterCollection *eager = [[TNLMutableParameterCollection alloc] initWithURL:URL parsingParameterTypes:allTypes options:optionsToTest[i]];
+            TNLParameterCollection *lazy = [[TNLParameterCollection alloc] initWithURL:URL parsingParameterTypes:allTypes options:optionsToTest[i]];
+
+            // lookups decode only what they need
+            for (NSString *key in keys) {
+                XCTAssertEqualObjects(lazy[key], eager[key], @"key='%@' URL='%@' options=%ld", key, URLString, (long)optionsToTest[i]);
+            }
+
+            // anything else materializes the same parameters as an eager parse
+            XCTAssertEqual(lazy.count, eager.count);
+            XCTAssertEqualObjects(lazy, eager);
+            XCTAssertEqualObjects(lazy.stableURLEncodedStringValue, eager.stableURLEncodedStringValue);
+            for (NSString *key in keys) {
+                XCTAssertEqualObjects(lazy[key], eager[key], @"key='%@' URL='%@' options=%ld", key, URLString, (long)optionsToTest[i]);
+            }
+
+            TNLMutableParameterCollection *mutableLazy = [[[TNLParameterCollection alloc] initWithURL:URL parsingParameterTypes:allTypes options:optionsToTest[i]] mutableCopy];
+            mutableLazy[@"added"] = @"value";
+            eager[@"added"] = @"value";
+            XCTAssertEqualObjects(mutableLazy, eager);
+        }
+    }
+
+    TNLParameterCollection *combined = [[TNLParameterCollection alloc] initWithURLEncodedString:@"a=1&a=2" options:TNLURLDecodingOptionCombineRepeatingKeysIntoArray];
+    XCTAssertEqualObjects(combined[@"a"], (@[ @"1", @"2" ]));
+}
+
 - (void)testMutation
 {
     TNLMutableParameterCollection *params;
@@ -6,13 +6,17 @@
 //  Copyright © 2020 Twitter. All rights reserved.
 //
 
+#import <CommonCrypto/CommonDigest.h>
+
 #import "NSDictionary+TNLAdditions.h"
 #import "TNLError.h"
 #import "TNLHTTPRequest.h"
+#import "TNLNetworkObserver.h"
 #import "TNLPseudoURLProtocol.h"
 #import "TNLRequestDelegate.h"
 #import "TNLRequestOperationCancelSource.h"
 #import "TNLRequestOperationQueue.h"
+#import "TNLRequestOperation_Project.h"
 #import "TNLRequestRetryPolicyProvider.h"
 #import "TNLResponse.h"
 
@@ -27,6 +31,10 @@
 @interface TNLPseudoRequestOperationTest : XCTestCase <TNLRequestRetryPolicyProvider, TNLRequestDelegate>
 @end
 
+@interface TNLTestAttemptDispositionObserver : NSObject <TNLNetworkObserver>
+@property (atomic, copy, readonly) NSArray<NSNumber *> *dispositions;
+@end
+
 #define PSEUDO_ORIGIN @"http://www.pseudo.com"
 #define PSEUDO_REDIRECT PSEUDO_ORIGIN @"/redirect"
 #if ENABLE_TIMING_TESTS
@@ -977,6 +985,735 @@ static NSData *sData;
     XCTAssertEqual(response, op.response);
 }
 
+- (void)testOperation200_PrefixAndPatternEndpoints
+{
+    NSData *prefixData = [@"prefix" dataUsingEncoding:NSUTF8StringEncoding];
+    NSData *patternData = [@"pattern" dataUsingEncoding:NSUTF8StringEncoding];
+    NSRegularExpression *pattern = [NSRegularExpression regularExpressionWithPattern:@"/items/[0-9]+$"
+                                                                             options:0
+                                                                               error:NULL];
+    [TNLPseudoURLProtocol registerURLResponse:sResponse
+                                         body:prefixData
+                                       config:nil
+                           withEndpointPrefix:[NSURL URLWithString:PSEUDO_ORIGIN @"/prefix/"]];
+    [TNLPseudoURLProtocol registerURLResponse:sResponse
+                                         body:patternData
+                                       config:nil
+                          withEndpointPattern:pattern];
+    [self registerCannedResponseWithConfig:nil];
+
+    NSDictionary<NSString *, NSData *> *expectations = @{
+        PSEUDO_ORIGIN : sData,
+        PSEUDO_ORIGIN @"/prefix/one" : prefixData,
+        PSEUDO_ORIGIN @"/PREFIX/two?query=1" : prefixData,
+        PSEUDO_ORIGIN @"/items/42" : patternData,
+        // prefix takes precedence over pattern
+        PSEUDO_ORIGIN @"/prefix/items/42" : prefixData,
+    };
+    for (NSString *URLString in expectations) {
+        TNLHTTPRequest *request = [TNLHTTPRequest GETRequestWithURL:[NSURL URLWithString:URLString]
+                                                   HTTPHeaderFields:nil];
+        TNLRequestOperation *op = [TNLRequestOperation operationWithRequest:request
+                                                              configuration:sConfig
+                                                                   delegate:nil];
+        [sQueue enqueueRequestOperation:op];
+        [op waitUntilFinishedWithoutBlockingRunLoop];
+        XCTAssertEqual(op.response.info.statusCode, 200, @"%@", URLString);
+        XCTAssertEqualObjects(op.response.info.data, expectations[URLString], @"%@", URLString);
+        XCTAssertEqualObjects(op.response.info.finalURL.absoluteString, URLString);
+    }
+
+    // unregistered URLs still fail
+    TNLHTTPRequest *request = [TNLHTTPRequest GETRequestWithURL:[NSURL URLWithString:PSEUDO_ORIGIN @"/items/abc"]
+                                               HTTPHeaderFields:nil];
+    TNLRequestOperation *op = [TNLRequestOperation operationWithRequest:request
+                                                          configuration:sConfig
+                                                               delegate:nil];
+    [sQueue enqueueRequestOperation:op];
+    [op waitUntilFinishedWithoutBlockingRunLoop];
+    XCTAssertNotNil(op.response.operationError);
+
+    [TNLPseudoURLProtocol unregisterEndpointPattern:pattern];
+    XCTAssertTrue([TNLPseudoURLProtocol isEndpointRegistered:sURL]);
+}
+
+- (void)testOperation_FailureInjection
+{
+    TNLPseudoURLResponseConfig *pseudoConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    pseudoConfig.latency = 10;
+    pseudoConfig.latencyDeviation = 5;
+    pseudoConfig.latencyDistribution = TNLPseudoURLLatencyDistributionLongTail;
+    pseudoConfig.failureRate = 1.0;
+    pseudoConfig.failureStatusCode = 503;
+    [self registerCannedResponseWithConfig:pseudoConfig];
+
+    TNLRequestOperation *op = [TNLRequestOperation operationWithURL:sURL
+                                                      configuration:sConfig
+                                                           delegate:nil];
+    [sQueue enqueueRequestOperation:op];
+    [op waitUntilFinishedWithoutBlockingRunLoop];
+    XCTAssertEqual(op.response.info.statusCode, 503);
+    XCTAssertEqual(op.response.info.data.length, 0UL);
+    XCTAssertNil(op.response.operationError);
+
+    // no status code, fail with an error
+    pseudoConfig.failureStatusCode = 0;
+    [self registerCannedResponseWithConfig:pseudoConfig];
+    op = [TNLRequestOperation operationWithURL:sURL configuration:sConfig delegate:nil];
+    [sQueue enqueueRequestOperation:op];
+    [op waitUntilFinishedWithoutBlockingRunLoop];
+    XCTAssertEqual(op.state, TNLRequestOperationStateFailed);
+    XCTAssertEqualObjects(op.response.operationError.domain, NSURLErrorDomain);
+    XCTAssertEqual(op.response.operationError.code, NSURLErrorNetworkConnectionLost);
+
+    // never fail
+    pseudoConfig.failureRate = 0.0;
+    [self registerCannedResponseWithConfig:pseudoConfig];
+    op = [TNLRequestOperation operationWithURL:sURL configuration:sConfig delegate:nil];
+    [sQueue enqueueRequestOperation:op];
+    [op waitUntilFinishedWithoutBlockingRunLoop];
+    XCTAssertEqual(op.response.info.statusCode, 200);
+    XCTAssertEqualObjects(op.response.info.data, sData);
+}
+
+- (void)testOperation200_SharedBandwidthPool
+{
+    // 4 concurrent loads of 16KB each share a 256kbps (32KB/s) pool, so all 64KB take ~2 seconds
+    NSMutableData *data = [NSMutableData dataWithLength:16 * 1024];
+    [TNLPseudoURLProtocol registerURLResponse:sResponse
+                                         body:data
+                                       config:nil
+                           withEndpointPrefix:[NSURL URLWithString:PSEUDO_ORIGIN @"/pool/"]];
+    TNLPseudoURLProtocol.sharedBandwidthPoolBPS = 256 * 1024;
+
+    const CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    NSMutableArray<TNLRequestOperation *> *ops = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < 4; i++) {
+        NSURL *URL = [NSURL URLWithString:[NSString stringWithFormat:PSEUDO_ORIGIN @"/pool/%tu", i]];
+        TNLRequestOperation *op = [TNLRequestOperation operationWithURL:URL
+                                                          configuration:sConfig
+                                                               delegate:nil];
+        [ops addObject:op];
+        [sQueue enqueueRequestOperation:op];
+    }
+    for (TNLRequestOperation *op in ops) {
+        [op waitUntilFinishedWithoutBlockingRunLoop];
+        XCTAssertEqual(op.response.info.statusCode, 200);
+        XCTAssertEqual(op.response.info.data.length, data.length);
+    }
+    const CFAbsoluteTime duration = CFAbsoluteTimeGetCurrent() - start;
+    TNLPseudoURLProtocol.sharedBandwidthPoolBPS = 0;
+
+    NSLog(@"Shared bandwidth pool loaded %tu bytes in %.3fs", data.length * ops.count, duration);
+    XCTAssertGreaterThan(duration, 1.5);
+}
+
+- (void)testOperation200_RecordAndReplay
+{
+    NSMutableData *data = [NSMutableData dataWithLength:32 * 1024];
+    arc4random_buf(data.mutableBytes, data.length);
+    TNLPseudoURLResponseConfig *pseudoConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    pseudoConfig.delay = 300;
+    pseudoConfig.bps = 256 * 1024; // 32KB/s
+    [TNLPseudoURLProtocol registerURLResponse:sResponse body:data config:pseudoConfig withEndpoint:sURL];
+
+    // record
+
+    NSString *archivePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    TNLPseudoURLTrafficRecorder *recorder = [[TNLPseudoURLTrafficRecorder alloc] initWithArchiveFilePath:archivePath];
+    TNLRequestOperationQueue *queue = [[TNLRequestOperationQueue alloc] initWithIdentifier:@"pseudo.request.test.record.queue"];
+    queue.networkObserver = recorder;
+
+    TNLRequestOperation *op = [TNLRequestOperation operationWithURL:sURL configuration:sConfig delegate:nil];
+    [queue enqueueRequestOperation:op];
+    [op waitUntilFinishedWithoutBlockingRunLoop];
+    TNLResponse *recordedResponse = op.response;
+    XCTAssertEqual(recordedResponse.info.statusCode, 200);
+
+    const CFAbsoluteTime deadline = CFAbsoluteTimeGetCurrent() + 2.0;
+    while (recorder.recordedResponseCount < 1 && CFAbsoluteTimeGetCurrent() < deadline) {
+        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.05]];
+    }
+    XCTAssertEqual(recorder.recordedResponseCount, 1UL);
+
+    NSError *error = nil;
+    XCTAssertTrue([recorder saveArchive:&error]);
+    XCTAssertNil(error);
+
+    // replay
+
+    [TNLPseudoURLProtocol unregisterAllEndpoints];
+    XCTAssertFalse([TNLPseudoURLProtocol isEndpointRegistered:sURL]);
+    XCTAssertEqual([TNLPseudoURLProtocol registerRecordedResponsesWithArchiveFilePath:archivePath error:&error], 1UL);
+    XCTAssertNil(error);
+    XCTAssertTrue([TNLPseudoURLProtocol isEndpointRegistered:sURL]);
+
+    op = [TNLRequestOperation operationWithURL:sURL configuration:sConfig delegate:nil];
+    [sQueue enqueueRequestOperation:op];
+    [op waitUntilFinishedWithoutBlockingRunLoop];
+    TNLResponse *replayedResponse = op.response;
+    XCTAssertEqual(replayedResponse.info.statusCode, 200);
+    XCTAssertEqualObjects(replayedResponse.info.data, data);
+    XCTAssertEqualObjects([replayedResponse.info.allHTTPHeaderFields tnl_objectForCaseInsensitiveKey:@"Header1"], @"Value1");
+    NSLog(@"Recorded %.3fs, replayed %.3fs", recordedResponse.metrics.totalDuration, replayedResponse.metrics.totalDuration);
+    XCTAssertGreaterThan(replayedResponse.metrics.totalDuration, recordedResponse.metrics.totalDuration * 0.5);
+
+    [[NSFileManager defaultManager] removeItemAtPath:archivePath error:NULL];
+
+    // a missing archive is an error
+    XCTAssertEqual([TNLPseudoURLProtocol registerRecordedResponsesWithArchiveFilePath:archivePath error:&error], 0UL);
+    XCTAssertNotNil(error);
+}
+
+- (void)testOperation200_ManyConcurrentChunkedLoads
+{
+    // every load is delivered in several chunks paced by the shared chunk scheduler
+    NSMutableData *data = [NSMutableData dataWithLength:64 * 1024];
+    arc4random_buf(data.mutableBytes, data.length);
+    TNLPseudoURLResponseConfig *pseudoConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    pseudoConfig.bps = 1024 * 1024; // 32KB per 250ms chunk
+    pseudoConfig.latency = 10;
+    [TNLPseudoURLProtocol registerURLResponse:sResponse
+                                         body:data
+                                       config:pseudoConfig
+                           withEndpointPrefix:[NSURL URLWithString:PSEUDO_ORIGIN @"/chunked/"]];
+
+    TNLRequestOperationQueue *queue = [[TNLRequestOperationQueue alloc] initWithIdentifier:@"pseudo.request.test.chunked.queue"];
+    NSMutableArray<TNLRequestOperation *> *ops = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < 200; i++) {
+        NSURL *URL = [NSURL URLWithString:[NSString stringWithFormat:PSEUDO_ORIGIN @"/chunked/%tu", i]];
+        TNLRequestOperation *op = [TNLRequestOperation operationWithURL:URL
+                                                          configuration:sConfig
+                                                               delegate:nil];
+        [ops addObject:op];
+        [queue enqueueRequestOperation:op];
+    }
+
+    for (TNLRequestOperation *op in ops) {
+        [op waitUntilFinishedWithoutBlockingRunLoop];
+        XCTAssertNil(op.response.operationError);
+        XCTAssertEqual(op.response.info.statusCode, 200);
+        XCTAssertEqualObjects(op.response.info.data, data);
+    }
+}
+
+- (void)testOperation500_AdaptiveConcurrencyLimit
+{
+    TNLPseudoURLResponseConfig *pseudoConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    pseudoConfig.latency = 10;
+    pseudoConfig.failureRate = 1.0;
+    pseudoConfig.failureStatusCode = 500; // not a backoff signal, only the adaptive limit reacts
+    [TNLPseudoURLProtocol registerURLResponse:sResponse
+                                         body:sData
+                                       config:pseudoConfig
+                           withEndpointPrefix:[NSURL URLWithString:PSEUDO_ORIGIN @"/overloaded/"]];
+
+    TNLGlobalConfiguration *globalConfig = [TNLGlobalConfiguration sharedInstance];
+    const TNLGlobalConfigurationBackoffMode oldBackoffMode = globalConfig.backoffMode;
+    globalConfig.backoffMode = TNLGlobalConfigurationBackoffModeKeyOffHost;
+    globalConfig.adaptiveConcurrencyEnabled = YES;
+
+    NSMutableArray<TNLRequestOperation *> *ops = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < 20; i++) {
+        NSURL *URL = [NSURL URLWithString:[NSString stringWithFormat:PSEUDO_ORIGIN @"/overloaded/%tu", i]];
+        TNLRequestOperation *op = [TNLRequestOperation operationWithURL:URL
+                                                          configuration:sConfig
+                                                               delegate:nil];
+        [ops addObject:op];
+        [sQueue enqueueRequestOperation:op];
+    }
+    for (TNLRequestOperation *op in ops) {
+        [op waitUntilFinishedWithoutBlockingRunLoop];
+        XCTAssertEqual(op.response.info.statusCode, 500);
+    }
+
+    __block NSDictionary<NSString *, NSNumber *> *limits = nil;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"limits"];
+    [globalConfig getAdaptiveConcurrencyLimits:^(NSDictionary<NSString *, NSNumber *> *limitsByBackoffKey) {
+        limits = limitsByBackoffKey;
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+
+    NSNumber *limit = limits[sURL.host];
+    XCTAssertNotNil(limit);
+    XCTAssertLessThan(limit.unsignedIntegerValue, 8UL);
+    XCTAssertGreaterThanOrEqual(limit.unsignedIntegerValue, 1UL);
+
+    globalConfig.adaptiveConcurrencyEnabled = NO;
+    globalConfig.backoffMode = oldBackoffMode;
+}
+
+- (void)testOperation200_AdaptiveConcurrencyCancelWhileQueued
+{
+    // a dedicated host so that the limit isn't shared with other tests
+    NSURL *prefix = [NSURL URLWithString:@"http://adaptive.pseudo.com/cancel/"];
+    TNLPseudoURLResponseConfig *failureConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    failureConfig.latency = 10;
+    failureConfig.failureRate = 1.0;
+    failureConfig.failureStatusCode = 500;
+    [TNLPseudoURLProtocol registerURLResponse:sResponse
+                                         body:sData
+                                       config:failureConfig
+                           withEndpointPrefix:prefix];
+
+    TNLGlobalConfiguration *globalConfig = [TNLGlobalConfiguration sharedInstance];
+    const TNLGlobalConfigurationBackoffMode oldBackoffMode = globalConfig.backoffMode;
+    globalConfig.backoffMode = TNLGlobalConfigurationBackoffModeKeyOffHost;
+    globalConfig.adaptiveConcurrencyEnabled = YES;
+
+    TNLMutableRequestConfiguration *mConfig = [sConfig mutableCopy];
+    mConfig.operationTimeout = 10.0; // a wedged limiter fails the test instead of hanging it
+
+    // lower the limit with failures
+    NSMutableArray<TNLRequestOperation *> *ops = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < 20; i++) {
+        NSURL *URL = [NSURL URLWithString:[NSString stringWithFormat:@"%@fail/%tu", prefix.absoluteString, i]];
+        TNLRequestOperation *op = [TNLRequestOperation operationWithURL:URL configuration:mConfig delegate:nil];
+        [ops addObject:op];
+        [sQueue enqueueRequestOperation:op];
+    }
+    for (TNLRequestOperation *op in ops) {
+        [op waitUntilFinishedWithoutBlockingRunLoop];
+    }
+
+    TNLPseudoURLResponseConfig *slowConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    slowConfig.latency = 200;
+    [TNLPseudoURLProtocol registerURLResponse:sResponse
+                                         body:sData
+                                       config:slowConfig
+                           withEndpointPrefix:prefix];
+
+    // more operations than the (lowered) limit, cancelling the ones that have to wait
+    [ops removeAllObjects];
+    for (NSUInteger i = 0; i < 16; i++) {
+        NSURL *URL = [NSURL URLWithString:[NSString stringWithFormat:@"%@queued/%tu", prefix.absoluteString, i]];
+        TNLRequestOperation *op = [TNLRequestOperation operationWithURL:URL configuration:mConfig delegate:nil];
+        [ops addObject:op];
+        [sQueue enqueueRequestOperation:op];
+    }
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.05]];
+    for (NSUInteger i = 8; i < ops.count; i++) {
+        [ops[i] cancelWithSource:@"Cancel"];
+    }
+    for (TNLRequestOperation *op in ops) {
+        [op waitUntilFinishedWithoutBlockingRunLoop];
+    }
+
+    // the cancelled operations must not hold on to concurrency slots
+    [ops removeAllObjects];
+    for (NSUInteger i = 0; i < 4; i++) {
+        NSURL *URL = [NSURL URLWithString:[NSString stringWithFormat:@"%@later/%tu", prefix.absoluteString, i]];
+        TNLRequestOperation *op = [TNLRequestOperation operationWithURL:URL configuration:mConfig delegate:nil];
+        [ops addObject:op];
+        [sQueue enqueueRequestOperation:op];
+    }
+    for (TNLRequestOperation *op in ops) {
+        [op waitUntilFinishedWithoutBlockingRunLoop];
+        XCTAssertNil(op.response.operationError);
+        XCTAssertEqual(op.response.info.statusCode, 200);
+    }
+
+    globalConfig.adaptiveConcurrencyEnabled = NO;
+    globalConfig.backoffMode = oldBackoffMode;
+}
+
+- (void)testOperationHedge
+{
+    TNLPseudoURLResponseConfig *pseudoConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    pseudoConfig.latency = 300;
+    [TNLPseudoURLProtocol registerURLResponse:sResponse
+                                         body:sData
+                                       config:pseudoConfig
+                           withEndpointPrefix:[NSURL URLWithString:PSEUDO_ORIGIN @"/slow/"]];
+
+    TNLMutableRequestConfiguration *mConfig = [sConfig mutableCopy];
+    mConfig.hedgeDelayPercentile = 99.0;
+    mConfig.hedgeMinimumDelay = 0.1;
+
+    // every attempt is equally slow, so the primary attempt wins and the hedge is abandoned
+    TNLRequestOperation *op = [TNLRequestOperation operationWithURL:[NSURL URLWithString:PSEUDO_ORIGIN @"/slow/get"]
+                                                      configuration:mConfig
+                                                           delegate:nil];
+    [sQueue enqueueRequestOperation:op];
+    [op waitUntilFinishedWithoutBlockingRunLoop];
+
+    TNLResponse *response = op.response;
+    XCTAssertNil(response.operationError);
+    XCTAssertEqual(response.info.statusCode, 200);
+    XCTAssertEqualObjects(response.info.data, sData);
+    XCTAssertEqual(response.metrics.hedgeCount, 1UL);
+    XCTAssertEqual(response.metrics.attemptCount, 2UL);
+    XCTAssertEqual(response.metrics.attemptMetrics.firstObject.attemptType, TNLAttemptTypeHedge);
+    XCTAssertEqual(response.metrics.attemptMetrics.lastObject.attemptType, TNLAttemptTypeInitial);
+
+    // POST is not retriable by the default retry policy configuration, so it isn't hedged
+    NSMutableURLRequest *postRequest = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:PSEUDO_ORIGIN @"/slow/post"]];
+    postRequest.HTTPMethod = @"POST";
+    op = [TNLRequestOperation operationWithRequest:postRequest
+                                     configuration:mConfig
+                                          delegate:nil];
+    [sQueue enqueueRequestOperation:op];
+    [op waitUntilFinishedWithoutBlockingRunLoop];
+    XCTAssertEqual(op.response.metrics.hedgeCount, 0UL);
+    XCTAssertEqual(op.response.metrics.attemptCount, 1UL);
+}
+
+- (void)testOperationHedgeWins
+{
+    TNLPseudoURLResponseConfig *stallConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    stallConfig.latency = 5000;
+    // a dedicated host so that latencies sampled by other tests don't affect the hedge delay
+    NSURL *prefix = [NSURL URLWithString:@"http://hedge.pseudo.com/stall/"];
+    [TNLPseudoURLProtocol registerURLResponse:sResponse
+                                         body:sData
+                                       config:stallConfig
+                           withEndpointPrefix:prefix];
+
+    TNLMutableRequestConfiguration *mConfig = [sConfig mutableCopy];
+    mConfig.hedgeDelayPercentile = 99.0;
+    mConfig.hedgeMinimumDelay = 0.5;
+
+    TNLTestAttemptDispositionObserver *observer = [[TNLTestAttemptDispositionObserver alloc] init];
+    sQueue.networkObserver = observer;
+
+    TNLRequestOperation *op = [TNLRequestOperation operationWithURL:[NSURL URLWithString:@"http://hedge.pseudo.com/stall/get"]
+                                                      configuration:mConfig
+                                                           delegate:nil];
+    [sQueue enqueueRequestOperation:op];
+
+    // once the primary attempt is stalled, the endpoint recovers so the hedge responds first
+    while (op.state < TNLRequestOperationStateStarting) {
+        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    [TNLPseudoURLProtocol registerURLResponse:sResponse
+                                         body:sData
+                                       config:nil
+                           withEndpointPrefix:prefix];
+
+    const CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    [op waitUntilFinishedWithoutBlockingRunLoop];
+    sQueue.networkObserver = nil;
+    XCTAssertLessThan(CFAbsoluteTimeGetCurrent() - start, 4.0);
+
+    TNLResponse *response = op.response;
+    XCTAssertNil(response.operationError);
+    XCTAssertEqual(response.info.statusCode, 200);
+    XCTAssertEqualObjects(response.info.data, sData);
+    XCTAssertEqual(response.metrics.hedgeCount, 1UL);
+    XCTAssertEqual(response.metrics.attemptCount, 2UL);
+
+    // the stalled primary attempt lost to the hedge
+    TNLAttemptMetrics *primaryMetrics = response.metrics.attemptMetrics.firstObject;
+    TNLAttemptMetrics *hedgeMetrics = response.metrics.attemptMetrics.lastObject;
+    XCTAssertEqual(primaryMetrics.attemptType, TNLAttemptTypeInitial);
+    XCTAssertEqual(primaryMetrics.operationError.code, TNLErrorCodeRequestOperationCancelled);
+    XCTAssertNil(primaryMetrics.URLResponse);
+    XCTAssertEqual(hedgeMetrics.attemptType, TNLAttemptTypeHedge);
+    XCTAssertEqual(hedgeMetrics.URLResponse.statusCode, 200);
+
+    NSArray<NSNumber *> *expectedDispositions = @[ @(TNLAttemptCompleteDispositionHedged), @(TNLAttemptCompleteDispositionCompleting) ];
+    XCTAssertEqualObjects(observer.dispositions, expectedDispositions);
+}
+
+- (void)testOperation503_RetryBudget
+{
+    TNLPseudoURLResponseConfig *pseudoConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    pseudoConfig.failureRate = 1.0;
+    pseudoConfig.failureStatusCode = 503;
+    [TNLPseudoURLProtocol registerURLResponse:sResponse
+                                         body:sData
+                                       config:pseudoConfig
+                           withEndpointPrefix:[NSURL URLWithString:PSEUDO_ORIGIN @"/unavailable/"]];
+
+    TNLGlobalConfiguration *globalConfig = [TNLGlobalConfiguration sharedInstance];
+    const NSTimeInterval oldWindow = globalConfig.retryBudgetWindow;
+    const NSUInteger oldMinimumRetryCount = globalConfig.retryBudgetMinimumRetryCount;
+    globalConfig.retryBudgetWindow = oldWindow + 1.0; // changing the window resets the budget
+    globalConfig.retryBudgetMinimumRetryCount = 1;
+    globalConfig.retryBudgetRatio = 0.1;
+    const NSUInteger oldDeniedRetryCount = [TNLRequestOperationQueue retryBudgetStatistics].totalDeniedRetryCount;
+
+    // the first retry is within the minimum, the second is denied
+    TNLMutableRequestConfiguration *mConfig = [sConfig mutableCopy];
+    mConfig.retryPolicyProvider = self;
+    TNLRequestOperation *op = [TNLRequestOperation operationWithURL:[NSURL URLWithString:PSEUDO_ORIGIN @"/unavailable/get"]
+                                                      configuration:mConfig
+                                                           delegate:nil];
+    [sQueue enqueueRequestOperation:op];
+    [op waitUntilFinishedWithoutBlockingRunLoop];
+
+    TNLResponse *response = op.response;
+    XCTAssertEqualObjects(response.operationError.domain, TNLErrorDomain);
+    XCTAssertEqual(response.operationError.code, TNLErrorCodeRequestOperationRetryBudgetExhausted);
+    XCTAssertEqual(response.metrics.attemptCount, 2UL);
+    XCTAssertEqual(response.metrics.retryCount, 1UL);
+
+    TNLRequestOperationRetryBudgetStatistics *stats = [TNLRequestOperationQueue retryBudgetStatistics];
+    XCTAssertEqual(stats.requestCount, 1UL);
+    XCTAssertEqual(stats.retryCount, 1UL);
+    XCTAssertEqual(stats.availableRetryCount, 0UL);
+    XCTAssertEqual(stats.totalDeniedRetryCount, oldDeniedRetryCount + 1);
+
+    globalConfig.retryBudgetRatio = 0.0;
+    globalConfig.retryBudgetMinimumRetryCount = oldMinimumRetryCount;
+    globalConfig.retryBudgetWindow = oldWindow;
+}
+
+#pragma mark Coalescing
+
+- (void)testOperation200_Coalesced
+{
+    TNLMutableRequestConfiguration *mConfig = [sConfig mutableCopy];
+    mConfig.coalescesIdenticalRequests = YES;
+    mConfig.requestCoalescingHTTPHeaderFieldAllowList = [NSSet setWithObject:@"X-Trace-Id"];
+    TNLPseudoURLResponseConfig *pseudoConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    pseudoConfig.delay = 500;
+    [self registerCannedResponseWithConfig:pseudoConfig];
+
+    NSMutableArray<TNLRequestOperation *> *ops = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < 4; i++) {
+        TNLMutableHTTPRequest *mRequest = [[TNLMutableHTTPRequest alloc] initWithURL:sURL];
+        [mRequest setValue:[NSString stringWithFormat:@"%tu", i] forHTTPHeaderField:@"X-Trace-Id"];
+        TNLRequestOperation *op = [TNLRequestOperation operationWithRequest:mRequest
+                                                              configuration:mConfig
+                                                                 completion:nil];
+        [ops addObject:op];
+        [sQueue enqueueRequestOperation:op];
+    }
+
+    // all the request operations share the one task operation in flight
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.2]];
+    TNLURLSessionTaskOperation *taskOp = ops.firstObject.URLSessionTaskOperation;
+    XCTAssertNotNil(taskOp);
+    for (TNLRequestOperation *op in ops) {
+        XCTAssertEqual(op.URLSessionTaskOperation, taskOp);
+    }
+
+    // cancelling one coalesced request operation does not affect the others
+    TNLRequestOperation *cancelledOp = ops.lastObject;
+    [ops removeLastObject];
+    [cancelledOp cancelWithSource:@"FORCE_CANCEL_SOURCE"];
+
+    for (TNLRequestOperation *op in ops) {
+        [op waitUntilFinishedWithoutBlockingRunLoop];
+        XCTAssertEqual(op.state, TNLRequestOperationStateSucceeded);
+        XCTAssertEqual(op.response.info.statusCode, 200);
+        XCTAssertEqualObjects(op.response.info.data, sData);
+        XCTAssertNil(op.response.operationError);
+    }
+    [cancelledOp waitUntilFinishedWithoutBlockingRunLoop];
+    XCTAssertEqual(cancelledOp.state, TNLRequestOperationStateCancelled);
+    XCTAssertEqual(cancelledOp.response.operationError.code, TNLErrorCodeRequestOperationCancelled);
+
+    // each coalesced request operation has its own response
+    XCTAssertNotEqual(ops[0].response, ops[1].response);
+}
+
+- (void)testOperation200_CoalescedLeaderCancelled
+{
+    TNLMutableRequestConfiguration *mConfig = [sConfig mutableCopy];
+    mConfig.coalescesIdenticalRequests = YES;
+    TNLPseudoURLResponseConfig *pseudoConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    pseudoConfig.delay = 200;
+    [self registerCannedResponseWithConfig:pseudoConfig];
+
+    // cancel the leader right away, possibly before it enqueues the task operation the follower attached to
+    TNLRequestOperation *leaderOp = [TNLRequestOperation operationWithURL:sURL
+                                                            configuration:mConfig
+                                                                 delegate:nil];
+    TNLRequestOperation *followerOp = [TNLRequestOperation operationWithURL:sURL
+                                                              configuration:mConfig
+                                                                   delegate:nil];
+    [sQueue enqueueRequestOperation:leaderOp];
+    [sQueue enqueueRequestOperation:followerOp];
+    [leaderOp cancelWithSource:@"FORCE_CANCEL_SOURCE"];
+
+    [leaderOp waitUntilFinishedWithoutBlockingRunLoop];
+    XCTAssertEqual(leaderOp.state, TNLRequestOperationStateCancelled);
+    [followerOp waitUntilFinishedWithoutBlockingRunLoop];
+    XCTAssertEqual(followerOp.state, TNLRequestOperationStateSucceeded);
+    XCTAssertEqual(followerOp.response.info.statusCode, 200);
+    XCTAssertEqualObjects(followerOp.response.info.data, sData);
+
+    // a later identical request does not attach to an abandoned task operation
+    TNLRequestOperation *laterOp = [TNLRequestOperation operationWithURL:sURL
+                                                           configuration:mConfig
+                                                                delegate:nil];
+    [sQueue enqueueRequestOperation:laterOp];
+    [laterOp waitUntilFinishedWithoutBlockingRunLoop];
+    XCTAssertEqual(laterOp.state, TNLRequestOperationStateSucceeded);
+    XCTAssertEqualObjects(laterOp.response.info.data, sData);
+}
+
+#pragma mark Large Body
+
+- (void)testLargeBodyStoredInMemoryPerformance
+{
+    // Response body chunks are retained as segments and only flattened when contiguous bytes are needed.
+    // Measures the time and peak memory of accumulating a 50 MB body, then verifies the content.
+
+    const NSUInteger bodyLength = 50 * 1024 * 1024;
+    NSMutableData *mBody = [NSMutableData dataWithLength:bodyLength];
+    uint8_t *bodyBytes = (uint8_t *)mBody.mutableBytes;
+    for (NSUInteger i = 0; i < bodyLength; i++) {
+        bodyBytes[i] = (uint8_t)(i % 251);
+    }
+    NSData *body = [mBody copy];
+    mBody = nil;
+
+    NSURL *URL = [NSURL URLWithString:PSEUDO_ORIGIN @"/large"];
+    NSHTTPURLResponse *URLResponse = [[NSHTTPURLResponse alloc] initWithURL:URL
+                                                                statusCode:200
+                                                               HTTPVersion:@"HTTP/1.1"
+                                                              headerFields:nil];
+    [TNLPseudoURLProtocol registerURLResponse:URLResponse body:body withEndpoint:URL];
+
+    __block NSData *responseData = nil;
+    dispatch_block_t block = ^{
+        TNLRequestOperation *op = [TNLRequestOperation operationWithURL:URL
+                                                          configuration:sConfig
+                                                               delegate:nil];
+        [sQueue enqueueRequestOperation:op];
+        [op waitUntilFinishedWithoutBlockingRunLoop];
+        responseData = op.response.info.data;
+    };
+
+    if (@available(iOS 13.0, macOS 10.15, tvOS 13.0, watchOS 6.0, *)) {
+        [self measureWithMetrics:@[[[XCTClockMetric alloc] init], [[XCTMemoryMetric alloc] init]] block:block];
+    } else {
+        [self measureBlock:block];
+    }
+
+    XCTAssertEqual(responseData.length, bodyLength);
+
+    // more than one region means the segments were never copied into a single buffer
+    __block NSUInteger regionCount = 0;
+    [responseData enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        regionCount++;
+    }];
+    XCTAssertGreaterThan(regionCount, 1UL);
+
+    // touching the bytes flattens the segments
+    XCTAssertEqual(memcmp(responseData.bytes, body.bytes, bodyLength), 0);
+    XCTAssertEqualObjects(responseData, body);
+}
+
+#pragma mark Throughput
+
+- (void)_runThroughputTestWithQueueCount:(NSUInteger)queueCount
+{
+    // Independent operations each have their own network lane, so spreading requests across
+    // queues should scale with the available cores instead of serializing on one queue.
+
+    const NSUInteger requestCount = 400;
+    NSMutableData *mBody = [NSMutableData dataWithLength:64 * 1024];
+    arc4random_buf(mBody.mutableBytes, mBody.length);
+    NSURL *URL = [NSURL URLWithString:[NSString stringWithFormat:@"%@/throughput/%tu", PSEUDO_ORIGIN, queueCount]];
+    NSHTTPURLResponse *URLResponse = [[NSHTTPURLResponse alloc] initWithURL:URL
+                                                                statusCode:200
+                                                               HTTPVersion:@"HTTP/1.1"
+                                                              headerFields:nil];
+    [TNLPseudoURLProtocol registerURLResponse:URLResponse body:mBody withEndpoint:URL];
+
+    TNLMutableRequestConfiguration *mConfig = [sConfig mutableCopy];
+    mConfig.responseComputeHashAlgorithm = TNLResponseHashComputeAlgorithmSHA256; // per operation CPU work
+    TNLRequestConfiguration *config = [mConfig copy];
+
+    NSMutableArray<TNLRequestOperationQueue *> *queues = [[NSMutableArray alloc] initWithCapacity:queueCount];
+    for (NSUInteger i = 0; i < queueCount; i++) {
+        NSString *identifier = [NSString stringWithFormat:@"pseudo.throughput.%tu.of.%tu", i, queueCount];
+        [queues addObject:[[TNLRequestOperationQueue alloc] initWithIdentifier:identifier]];
+    }
+
+    [self measureBlock:^{
+        NSMutableArray<TNLRequestOperation *> *ops = [[NSMutableArray alloc] initWithCapacity:requestCount];
+        for (NSUInteger i = 0; i < requestCount; i++) {
+            TNLRequestOperation *op = [TNLRequestOperation operationWithURL:URL
+                                                              configuration:config
+                                                                   delegate:nil];
+            [ops addObject:op];
+            [queues[i % queueCount] enqueueRequestOperation:op];
+        }
+        for (TNLRequestOperation *op in ops) {
+            [op waitUntilFinishedWithoutBlockingRunLoop];
+            XCTAssertEqual(op.response.info.statusCode, 200);
+        }
+    }];
+
+    [TNLPseudoURLProtocol unregisterEndpoint:URL];
+}
+
+- (void)testThroughput_1Queue
+{
+    [self _runThroughputTestWithQueueCount:1];
+}
+
+- (void)testThroughput_4Queues
+{
+    [self _runThroughputTestWithQueueCount:4];
+}
+
+- (void)testThroughput_8Queues
+{
+    [self _runThroughputTestWithQueueCount:8];
+}
+
+#pragma mark Hashing
+
+- (void)testResponseHashWhileOtherRequestsInFlightPerformance
+{
+    // Hash a large body while 100 other requests are in flight.
+    // Hashing happens on the operation's own hash lane, so it should neither stall nor be stalled by the other requests.
+
+    const NSUInteger bodyLength = 8 * 1024 * 1024;
+    NSMutableData *mBody = [NSMutableData dataWithLength:bodyLength];
+    arc4random_buf(mBody.mutableBytes, mBody.length);
+    NSData *body = [mBody copy];
+    mBody = nil;
+
+    NSMutableData *expectedHash = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256(body.bytes, (CC_LONG)body.length, (unsigned char *)expectedHash.mutableBytes);
+
+    NSURL *hashURL = [NSURL URLWithString:PSEUDO_ORIGIN @"/hash"];
+    NSURL *otherURL = [NSURL URLWithString:PSEUDO_ORIGIN @"/other"];
+    NSHTTPURLResponse *hashResponse = [[NSHTTPURLResponse alloc] initWithURL:hashURL statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:nil];
+    NSHTTPURLResponse *otherResponse = [[NSHTTPURLResponse alloc] initWithURL:otherURL statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:nil];
+    TNLPseudoURLResponseConfig *otherConfig = [[TNLPseudoURLResponseConfig alloc] init];
+    otherConfig.bps = 8 * 64 * 1024;
+    otherConfig.latency = 10;
+    NSMutableData *otherBody = [NSMutableData dataWithLength:32 * 1024];
+    [TNLPseudoURLProtocol registerURLResponse:hashResponse body:body withEndpoint:hashURL];
+    [TNLPseudoURLProtocol registerURLResponse:otherResponse body:otherBody config:otherConfig withEndpoint:otherURL];
+
+    TNLMutableRequestConfiguration *mConfig = [sConfig mutableCopy];
+    mConfig.responseComputeHashAlgorithm = TNLResponseHashComputeAlgorithmSHA256;
+    TNLRequestConfiguration *hashConfig = [mConfig copy];
+
+    __block NSData *hash = nil;
+    [self measureBlock:^{
+        NSMutableArray<TNLRequestOperation *> *otherOps = [[NSMutableArray alloc] initWithCapacity:100];
+        for (NSUInteger i = 0; i < 100; i++) {
+            TNLRequestOperation *otherOp = [TNLRequestOperation operationWithURL:otherURL configuration:sConfig delegate:nil];
+            [otherOps addObject:otherOp];
+            [sQueue enqueueRequestOperation:otherOp];
+        }
+
+        TNLRequestOperation *op = [TNLRequestOperation operationWithURL:hashURL configuration:hashConfig delegate:nil];
+        [sQueue enqueueRequestOperation:op];
+        [op waitUntilFinishedWithoutBlockingRunLoop];
+        XCTAssertEqual(op.response.info.statusCode, 200);
+        hash = op.response.metrics.attemptMetrics.lastObject.metaData.responseBodyHash;
+
+        for (TNLRequestOperation *otherOp in otherOps) {
+            [otherOp waitUntilFinishedWithoutBlockingRunLoop];
+        }
+    }];
+
+    XCTAssertEqualObjects(hash, expectedHash);
+}
+
 #pragma mark Retry Policy
 
 - (BOOL)tnl_shouldRetryRequestOperation:(TNLRequestOperation *)op withResponse:(TNLResponse *)response
@@ -1008,4 +1745,35 @@ static NSData *sData;
 
 @end
 
+@implementation TNLTestAttemptDispositionObserver
+{
+    NSMutableArray<NSNumber *> *_dispositions;
+}
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        _dispositions = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+- (NSArray<NSNumber *> *)dispositions
+{
+    @synchronized (self) {
+        return [_dispositions copy];
+    }
+}
+
+- (void)tnl_requestOperation:(TNLRequestOperation *)op
+        didCompleteAttemptWithIntermediateResponse:(TNLResponse *)response
+        disposition:(TNLAttemptCompleteDisposition)disposition
+{
+    @synchronized (self) {
+        [_dispositions addObject:@(disposition)];
+    }
+}
+
+@end
+
 #endif // ENABLE_PSEUDO_REQUEST_TESTS
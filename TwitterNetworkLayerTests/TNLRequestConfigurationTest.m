@@ -160,4 +160,72 @@
     XCTAssertEqualObjects(roundTripConfig, config);
 }
 
+- (void)testURLSessionIdentity
+{
+    TNLMutableRequestConfiguration *mConfig = [TNLMutableRequestConfiguration defaultConfiguration];
+    TNLRequestConfiguration *config1 = [mConfig copy];
+
+    // cached for immutable configs
+    XCTAssertEqual(config1.URLSessionIdentity, config1.URLSessionIdentity);
+    XCTAssertEqualObjects(config1.URLSessionIdentity, mConfig.URLSessionIdentity);
+
+    // stripped & overridden properties don't affect identity
+    mConfig.idleTimeout = 11.0;
+    mConfig.attemptTimeout = 22.0;
+    mConfig.operationTimeout = 33.0;
+    mConfig.allowsCellularAccess = !mConfig.allowsCellularAccess;
+    mConfig.networkServiceType = NSURLNetworkServiceTypeBackground;
+    mConfig.redirectPolicy = TNLRequestRedirectPolicyDontRedirect;
+    mConfig.responseDataConsumptionMode = TNLResponseDataConsumptionModeChunkToDelegateCallback;
+    XCTAssertEqualObjects(config1.URLSessionIdentity, mConfig.URLSessionIdentity);
+    XCTAssertEqual(config1.URLSessionIdentity.hash, mConfig.URLSessionIdentity.hash);
+
+    // session properties do affect identity
+    mConfig.protocolOptions = TNLRequestProtocolOptionPseudo;
+    XCTAssertNotEqualObjects(config1.URLSessionIdentity, mConfig.URLSessionIdentity);
+    mConfig.protocolOptions = config1.protocolOptions;
+    mConfig.sharedContainerIdentifier = @"container.id";
+    XCTAssertNotEqualObjects(config1.URLSessionIdentity, mConfig.URLSessionIdentity);
+    mConfig.sharedContainerIdentifier = config1.sharedContainerIdentifier;
+    mConfig.discretionary = !config1.isDiscretionary;
+    XCTAssertNotEqualObjects(config1.URLSessionIdentity, mConfig.URLSessionIdentity);
+    mConfig.discretionary = config1.isDiscretionary;
+    XCTAssertEqualObjects(config1.URLSessionIdentity, mConfig.URLSessionIdentity);
+}
+
+- (void)testURLSessionLookupWithIdentificationStringPerformance
+{
+    TNLMutableRequestConfiguration *mConfig = [TNLMutableRequestConfiguration defaultConfiguration];
+    mConfig.protocolOptions = TNLRequestProtocolOptionPseudo;
+    TNLRequestConfiguration *config = [mConfig copy];
+    NSMutableDictionary<NSString *, id> *contexts = [[NSMutableDictionary alloc] init];
+    contexts[TNLMutableParametersFromRequestConfiguration(config, nil, nil, nil).stableURLEncodedStringValue] = config;
+
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10000; i++) {
+            @autoreleasepool {
+                TNLMutableParameterCollection *params = TNLMutableParametersFromRequestConfiguration(config, nil, nil, nil);
+                XCTAssertNotNil(contexts[params.stableURLEncodedStringValue]);
+            }
+        }
+    }];
+}
+
+- (void)testURLSessionLookupWithIdentityPerformance
+{
+    TNLMutableRequestConfiguration *mConfig = [TNLMutableRequestConfiguration defaultConfiguration];
+    mConfig.protocolOptions = TNLRequestProtocolOptionPseudo;
+    TNLRequestConfiguration *config = [mConfig copy];
+    NSMutableDictionary<TNLURLSessionIdentity *, id> *contexts = [[NSMutableDictionary alloc] init];
+    contexts[config.URLSessionIdentity] = config;
+
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10000; i++) {
+            @autoreleasepool {
+                XCTAssertNotNil(contexts[config.URLSessionIdentity]);
+            }
+        }
+    }];
+}
+
 @end
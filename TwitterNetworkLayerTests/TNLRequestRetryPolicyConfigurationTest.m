@@ -75,6 +75,40 @@
     XCTAssertFalse([testConfig requestCanBeRetriedForResponse:testRequest.response]);
 }
 
+- (void)testBackoffRetryPolicyProvider
+{
+    TNLBackoffRetryPolicyProvider *provider = [[TNLBackoffRetryPolicyProvider alloc] initWithConfiguration:[TNLRequestRetryPolicyConfiguration defaultConfiguration]
+                                                                                                 baseDelay:0.5
+                                                                                              maximumDelay:10.0
+                                                                                       maximumAttemptCount:4];
+    TNLTestRetryPolicyConfigurationRequestOperation *testRequest = [[TNLTestRetryPolicyConfigurationRequestOperation alloc] initWithRequest:[[TNLMutableHTTPRequest alloc] initWithURL:[NSURL URLWithString:@"http://www.dummy.com"]] responseClass:Nil configuration:nil delegate:nil];
+
+    testRequest.statusCodeOverride = TNLHTTPStatusCodeInternalServerError; // 500
+    XCTAssertFalse([provider tnl_shouldRetryRequestOperation:testRequest withResponse:testRequest.response]);
+    testRequest.statusCodeOverride = TNLHTTPStatusCodeServiceUnavailable; // 503
+    XCTAssertTrue([provider tnl_shouldRetryRequestOperation:testRequest withResponse:testRequest.response]);
+
+    // each delay is between the base delay and 3x the previous delay, capped at the maximum delay
+    NSTimeInterval previousDelay = provider.baseDelay;
+    BOOL hitMaximumDelay = NO;
+    for (NSUInteger i = 0; i < 50; i++) {
+        const NSTimeInterval delay = [provider tnl_delayBeforeRetryForRequestOperation:testRequest withResponse:testRequest.response];
+        XCTAssertGreaterThanOrEqual(delay, provider.baseDelay);
+        XCTAssertLessThanOrEqual(delay, MIN(provider.maximumDelay, previousDelay * 3.0));
+        hitMaximumDelay = hitMaximumDelay || (delay > provider.maximumDelay * 0.5);
+        previousDelay = delay;
+    }
+    XCTAssertTrue(hitMaximumDelay);
+
+    // Retry-After is honored, even beyond the maximum delay
+    NSHTTPURLResponse *httpResponse = [[NSHTTPURLResponse alloc] initWithURL:testRequest.hydratedRequest.URL statusCode:TNLHTTPStatusCodeServiceUnavailable HTTPVersion:@"HTTP/1.1" headerFields:@{ @"Retry-After" : @"60" }];
+    TNLResponseInfo *info = [[TNLResponseInfo alloc] initWithFinalURLRequest:TNLRequestToNSURLRequest(testRequest.hydratedRequest, nil /*config*/, NULL /*error*/) URLResponse:httpResponse source:TNLResponseSourceNetworkRequest data:[NSData data] temporarySavedFile:nil];
+    TNLResponse *response = [TNLResponse responseWithRequest:testRequest.hydratedRequest operationError:nil info:info metrics:[[TNLResponseMetrics alloc] init]];
+    const NSTimeInterval retryAfterDelay = [provider tnl_delayBeforeRetryForRequestOperation:testRequest withResponse:response];
+    XCTAssertGreaterThan(retryAfterDelay, 55.0);
+    XCTAssertLessThanOrEqual(retryAfterDelay, 60.0);
+}
+
 @end
 
 @implementation TNLTestRetryPolicyConfigurationRequestOperation
@@ -265,6 +265,56 @@
     XCTAssertEqual(operation.response.info.statusCode, 503);
 }
 
+- (void)testBackoffRetryPolicyMaximumAttemptCount
+{
+    NSURL *URL = [NSURL URLWithString:@"https://fake.domain.com/backoff"];
+    TNLMutableHTTPRequest *request = [TNLMutableHTTPRequest GETRequestWithURL:URL HTTPHeaderFields:nil];
+
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:URL statusCode:503 HTTPVersion:@"HTTP/1.1" headerFields:nil];
+    [TNLPseudoURLProtocol registerURLResponse:response body:nil withEndpoint:URL];
+    tnl_defer(^{
+        [TNLPseudoURLProtocol unregisterEndpoint:URL];
+    });
+
+    TNLBackoffRetryPolicyProvider *retryPolicy = [[TNLBackoffRetryPolicyProvider alloc] initWithConfiguration:nil
+                                                                                                    baseDelay:0.1
+                                                                                                 maximumDelay:0.2
+                                                                                          maximumAttemptCount:3];
+
+    TNLMutableRequestConfiguration *config = [TNLMutableRequestConfiguration defaultConfiguration];
+    config.retryPolicyProvider = retryPolicy;
+    config.protocolOptions = TNLRequestProtocolOptionPseudo;
+
+    TNLRequestOperation *operation = [TNLRequestOperation operationWithRequest:request configuration:config delegate:self];
+    [[TNLRequestOperationQueue defaultOperationQueue] enqueueRequestOperation:operation];
+    [operation waitUntilFinishedWithoutBlockingRunLoop];
+
+    XCTAssertEqual(operation.attemptCount, 3);
+    XCTAssertEqual(operation.retryCount, 2);
+    XCTAssertEqual(operation.response.info.statusCode, 503);
+    XCTAssertGreaterThanOrEqual(operation.response.metrics.totalDuration, 0.2);
+
+    // redirect attempts don't count toward the maximum attempt count
+    NSURL *redirectURL = [NSURL URLWithString:@"https://fake.domain.com/backoff/redirect"];
+    NSHTTPURLResponse *redirectResponse = [[NSHTTPURLResponse alloc] initWithURL:redirectURL
+                                                                      statusCode:302
+                                                                     HTTPVersion:@"HTTP/1.1"
+                                                                    headerFields:@{ @"Location" : URL.absoluteString }];
+    [TNLPseudoURLProtocol registerURLResponse:redirectResponse body:nil withEndpoint:redirectURL];
+    tnl_defer(^{
+        [TNLPseudoURLProtocol unregisterEndpoint:redirectURL];
+    });
+
+    request = [TNLMutableHTTPRequest GETRequestWithURL:redirectURL HTTPHeaderFields:nil];
+    operation = [TNLRequestOperation operationWithRequest:request configuration:config delegate:self];
+    [[TNLRequestOperationQueue defaultOperationQueue] enqueueRequestOperation:operation];
+    [operation waitUntilFinishedWithoutBlockingRunLoop];
+
+    XCTAssertEqual(operation.retryCount, 2);
+    XCTAssertGreaterThan(operation.attemptCount, 3);
+    XCTAssertEqual(operation.response.info.statusCode, 503);
+}
+
 #pragma mark - TNLRequestDelegate
 
 - (void)tnl_requestOperation:(TNLRequestOperation *)op
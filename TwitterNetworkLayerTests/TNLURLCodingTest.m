@@ -15,6 +15,145 @@
 
 @end
 
+// Encodes the way TNLURLEncodeDictionary did before it wrote into a single byte buffer:
+// one NSString per encoded key and value, appended to an NSMutableString.
+// Only supports strings, numbers and arrays of those.
+static NSString *_ReferenceURLEncodeDictionary(NSDictionary<NSString *, id> *params,
+                                               TNLURLEncodingOptions options)
+{
+    NSMutableString *parameterString = [NSMutableString string];
+    NSArray<NSString *> *allKeys = params.allKeys;
+    if (options & TNLURLEncodingOptionStableOrder) {
+        allKeys = [allKeys sortedArrayUsingSelector:@selector(compare:)];
+    }
+
+    BOOL firstEntry = YES;
+    for (NSString *key in allKeys) {
+        NSString *encodedKey = TNLURLEncodeString(key);
+        if (!encodedKey.length) {
+            continue;
+        }
+
+        id value = params[key];
+        const BOOL isArray = (options & TNLURLEncodingOptionDuplicateEntriesForArrayValues) && [value isKindOfClass:[NSArray class]] && [value count] > 0;
+        NSArray *values = isArray ? value : @[value];
+        NSMutableArray<NSString *> *encodedValues = [NSMutableArray arrayWithCapacity:values.count];
+        for (id subvalue in values) {
+            NSString *stringValue = [subvalue isKindOfClass:[NSNumber class]] ? [subvalue tnl_quickStringValue] : subvalue;
+            [encodedValues addObject:TNLURLEncodeString(stringValue)];
+        }
+        if (isArray && (options & TNLURLEncodingOptionStableOrder)) {
+            [encodedValues sortUsingSelector:@selector(compare:)];
+        }
+
+        for (NSString *encodedValue in encodedValues) {
+            if ((options & TNLURLEncodingOptionDiscardEmptyValues) && !encodedValue.length) {
+                continue;
+            }
+            if (!firstEntry) {
+                [parameterString appendString:@"&"];
+            }
+            firstEntry = NO;
+            [parameterString appendString:encodedKey];
+            if (encodedValue.length || !(options & TNLURLEncodingOptionTrimEmptyValueDelimiter)) {
+                [parameterString appendString:@"="];
+                [parameterString appendString:encodedValue];
+            }
+        }
+    }
+
+    return parameterString;
+}
+
+// The byte at a time encoder that the vectorized TNLURLEncodeString replaced
+static NSString *_ScalarURLEncodeString(NSString *string)
+{
+    static const char kHexDigits[] = "0123456789ABCDEF";
+    NSMutableString *encoded = [NSMutableString string];
+    for (const unsigned char *c = (const unsigned char *)string.UTF8String; *c; c++) {
+        switch (*c) {
+            case '0' ... '9':
+            case 'A' ... 'Z':
+            case 'a' ... 'z':
+            case '-':
+            case '.':
+            case '_':
+            case '~':
+                [encoded appendFormat:@"%c", *c];
+                break;
+            default:
+                [encoded appendFormat:@"%%%c%c", kHexDigits[(*c>>4)&0xf], kHexDigits[*c&0xf]];
+                break;
+        }
+    }
+    return encoded;
+}
+
+// The Foundation based decoder that the vectorized TNLURLDecodeString replaced
+static NSString *_FoundationURLDecodeString(NSString *string, BOOL replacePlussesWithSpaces)
+{
+    if (replacePlussesWithSpaces) {
+        string = [string stringByReplacingOccurrencesOfString:@"+" withString:@" "];
+    }
+    return string.length ? [string stringByRemovingPercentEncoding] : string;
+}
+
+static NSString *_RandomURLCodingString(NSUInteger maxLength)
+{
+    static NSArray<NSString *> *sFragments;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sFragments = @[
+            @"a", @"Z", @"0", @"-", @".", @"_", @"~",
+            @"abcdefghijklmnopqrstuvwxyz", @"ABCDEFGHIJKLMNOP0123456789",
+            @" ", @"+", @"&", @"=", @"/", @"?", @"#", @"[]",
+            @"%", @"%2", @"%20", @"%2B", @"%2b", @"%zz", @"%E2%98%83", @"%FF", @"%C3",
+            @"\u00e9", @"\u2603", @"\u6c49\u5b57", @"\U0001F600",
+        ];
+    });
+
+    NSMutableString *string = [NSMutableString string];
+    const NSUInteger length = arc4random_uniform((uint32_t)maxLength + 1);
+    while (string.length < length) {
+        [string appendString:sFragments[arc4random_uniform((uint32_t)sFragments.count)]];
+    }
+    return string;
+}
+
+static NSDictionary<NSString *, id> *_RealisticParameters(NSUInteger keyCount, NSUInteger seed)
+{
+    NSArray<NSString *> *texts = @[
+        @"hello world",
+        @"caf\u00e9 & cr\u00e8me br\u00fbl\u00e9e",
+        @"\u2603 \u6c49\u5b57/\u6f22\u5b57",
+        @"DAABCgABF__-_abcdefgKAAIXhDQ1tFpQAQgAAwAAAAIAAA",
+        @"",
+        @"a+b=c;d",
+    ];
+    NSMutableDictionary<NSString *, id> *params = [NSMutableDictionary dictionaryWithCapacity:keyCount];
+    for (NSUInteger i = 0; i < keyCount; i++) {
+        NSString *key = [NSString stringWithFormat:@"%@_%tu", (i % 3) ? @"include_entities" : @"ext[]", i];
+        switch ((i + seed) % 5) {
+            case 0:
+                params[key] = @(1234567890123ULL + i);
+                break;
+            case 1:
+                params[key] = texts[(i + seed) % texts.count];
+                break;
+            case 2:
+                params[key] = @[ @"mediaStats", texts[i % texts.count], @"highlightedLabel", @(i) ];
+                break;
+            case 3:
+                params[key] = @(i % 2);
+                break;
+            default:
+                params[key] = [texts[seed % texts.count] stringByAppendingFormat:@"-%tu", i];
+                break;
+        }
+    }
+    return params;
+}
+
 @implementation TNLURLCodingTest
 
 - (void)testURLEncodedString
@@ -32,6 +171,27 @@
     XCTAssertEqualObjects(decoded, original);
 }
 
+- (void)testURLStringCodingMatchesScalarImplementation
+{
+    // Fuzz the vectorized kernels against the scalar (and Foundation) implementations they replaced.
+    // Lengths straddle the 16 byte vector size so that both the vector loop and the scalar tail are covered.
+    for (NSUInteger i = 0; i < 20000; i++) {
+        NSString *string = _RandomURLCodingString((i % 2) ? 24 : 160);
+
+        NSString *encoded = TNLURLEncodeString(string);
+        XCTAssertEqualObjects(encoded, _ScalarURLEncodeString(string), @"'%@'", string);
+        XCTAssertEqualObjects(TNLURLDecodeString(encoded, NO), string, @"'%@'", string);
+
+        XCTAssertEqualObjects(TNLURLDecodeString(string, NO), _FoundationURLDecodeString(string, NO), @"'%@'", string);
+        XCTAssertEqualObjects(TNLURLDecodeString(string, YES), _FoundationURLDecodeString(string, YES), @"'%@'", string);
+    }
+
+    XCTAssertEqualObjects(TNLURLDecodeString(@"", NO), @"");
+    XCTAssertNil(TNLURLDecodeString(nil, NO));
+    XCTAssertNil(TNLURLDecodeString(@"100%", NO));
+    XCTAssertNil(TNLURLDecodeString(@"%C3", NO)); // not UTF-8
+}
+
 - (void)testURLParameterParsing
 {
     NSString *query = @"log%5B%5D=%7B%22foo%22%3A%22bar%22%7D";
@@ -78,6 +238,93 @@
     XCTAssertEqualObjects(query, @"ok=not-empty");
 }
 
+- (void)testURLEncodeDictionaryMatchesReference
+{
+    const TNLURLEncodingOptions optionsToTest[] = {
+        TNLURLEncodingOptionsNone,
+        TNLURLEncodingOptionStableOrder,
+        TNLURLEncodingOptionStableOrder | TNLURLEncodingOptionDuplicateEntriesForArrayValues,
+        TNLURLEncodingOptionStableOrder | TNLURLEncodingOptionDiscardEmptyValues,
+        TNLURLEncodingOptionStableOrder | TNLURLEncodingOptionTrimEmptyValueDelimiter | TNLURLEncodingOptionDuplicateEntriesForArrayValues,
+    };
+    for (NSUInteger keyCount = 20; keyCount <= 50; keyCount += 10) {
+        for (size_t i = 0; i < sizeof(optionsToTest) / sizeof(optionsToTest[0]); i++) {
+            const TNLURLEncodingOptions options = optionsToTest[i];
+            NSDictionary<NSString *, id> *params = _RealisticParameters(keyCount, i);
+            if (!(options & TNLURLEncodingOptionDuplicateEntriesForArrayValues)) {
+                // without duplicate entries, arrays are unsupported values
+                NSMutableDictionary *mParams = [params mutableCopy];
+                for (NSString *key in params) {
+                    if ([params[key] isKindOfClass:[NSArray class]]) {
+                        [mParams removeObjectForKey:key];
+                    }
+                }
+                params = mParams;
+            }
+            NSString *expected = _ReferenceURLEncodeDictionary(params, options);
+            NSString *actual = TNLURLEncodeDictionary(params, options);
+            if (options & TNLURLEncodingOptionStableOrder) {
+                XCTAssertEqualObjects(actual, expected, @"options=%ld", (long)options);
+            } else {
+                NSArray *expectedPairs = [[expected componentsSeparatedByString:@"&"] sortedArrayUsingSelector:@selector(compare:)];
+                NSArray *actualPairs = [[actual componentsSeparatedByString:@"&"] sortedArrayUsingSelector:@selector(compare:)];
+                XCTAssertEqualObjects(actualPairs, expectedPairs, @"options=%ld", (long)options);
+            }
+        }
+    }
+}
+
+- (void)_runDictionaryEncoding:(BOOL)testTiming
+{
+    NSMutableArray<NSDictionary<NSString *, id> *> *collections = [NSMutableArray array];
+    for (NSUInteger keyCount = 20; keyCount <= 50; keyCount += 5) {
+        [collections addObject:_RealisticParameters(keyCount, keyCount)];
+    }
+    const TNLURLEncodingOptions options = TNLURLEncodingOptionStableOrder | TNLURLEncodingOptionDuplicateEntriesForArrayValues;
+    const NSUInteger iterations = 2000;
+
+    NSTimeInterval referenceDuration, tnlDuration;
+    {
+        const CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        for (NSUInteger i = 0; i < iterations; i++) {
+            for (NSDictionary *params in collections) {
+                @autoreleasepool {
+                    (void)_ReferenceURLEncodeDictionary(params, options);
+                }
+            }
+        }
+        referenceDuration = CFAbsoluteTimeGetCurrent() - start;
+        NSLog(@"NSMutableString URL encoding = %fs", referenceDuration);
+    }
+
+    {
+        const CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        for (NSUInteger i = 0; i < iterations; i++) {
+            for (NSDictionary *params in collections) {
+                @autoreleasepool {
+                    (void)TNLURLEncodeDictionary(params, options);
+                }
+            }
+        }
+        tnlDuration = CFAbsoluteTimeGetCurrent() - start;
+        NSLog(@"TNLURLEncodeDictionary = %fs", tnlDuration);
+    }
+
+    if (testTiming) {
+        XCTAssertLessThan(tnlDuration, referenceDuration, @"TNLURLEncodeDictionary ought to be faster than encoding through an NSMutableString!");
+    }
+}
+
+- (void)testDictionaryEncoding
+{
+    [self _runDictionaryEncoding:NO];
+}
+
+- (void)testDictionaryEncodingSpeed
+{
+    [self _runDictionaryEncoding:YES];
+}
+
 - (void)_runNumberCoding:(BOOL)testTiming
 {
     NSArray<NSNumber *> *numbers = @[
@@ -8,9 +8,13 @@
 
 #import <XCTest/XCTest.h>
 
+#import "TNLBackoff.h"
+#import "TNLGlobalConfiguration.h"
+#import "TNLNetwork.h"
 #import "TNLPseudoURLProtocol.h"
 #import "TNLRequestOperation.h"
 #import "TNLRequestOperationQueue.h"
+#import "TNLResponse.h"
 #import "TNLURLSessionManager.h"
 
 
@@ -19,6 +23,10 @@
 @interface TNLURLSessionManagerTest : XCTestCase
 @end
 
+@interface TNLTestBackoffBehaviorProvider : NSObject <TNLBackoffBehaviorProvider>
+@property (atomic) TNLBackoffBehavior behavior;
+@end
+
 @implementation TNLURLSessionManagerTest
 
 + (void)setUp
@@ -50,6 +58,8 @@
 {
     [TNLGlobalConfiguration sharedInstance].URLSessionInactivityThreshold = -1;
     [TNLGlobalConfiguration sharedInstance].URLSessionPruneOptions = 0;
+    [TNLGlobalConfiguration sharedInstance].backoffMode = TNLGlobalConfigurationBackoffModeDisabled;
+    [TNLGlobalConfiguration sharedInstance].backoffBehaviorProvider = nil;
 }
 
 - (void)testAddingAndPruningSessions
@@ -336,5 +346,185 @@
     prevBackgroundSessionCount = currentBackgroundSessionCount;
 }
 
+#pragma mark Backoff
+
+- (TNLTestBackoffBehaviorProvider *)_enableBackoffWithBehavior:(TNLBackoffBehavior)behavior
+{
+    TNLTestBackoffBehaviorProvider *provider = [[TNLTestBackoffBehaviorProvider alloc] init];
+    provider.behavior = behavior;
+    [TNLGlobalConfiguration sharedInstance].backoffBehaviorProvider = provider;
+    [TNLGlobalConfiguration sharedInstance].backoffMode = TNLGlobalConfigurationBackoffModeKeyOffHost;
+    return provider;
+}
+
+- (NSArray<TNLRequestOperation *> *)_enqueueBackoffOperations:(NSUInteger)count
+{
+    TNLMutableRequestConfiguration *config = [TNLMutableRequestConfiguration defaultConfiguration];
+    config.protocolOptions = TNLRequestProtocolOptionPseudo;
+    NSMutableArray<TNLRequestOperation *> *ops = [[NSMutableArray alloc] initWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        TNLRequestOperation *op = [TNLRequestOperation operationWithURL:[NSURL URLWithString:kFAKE_URL]
+                                                          configuration:config
+                                                               delegate:nil];
+        [ops addObject:op];
+        [[TNLRequestOperationQueue defaultOperationQueue] enqueueRequestOperation:op];
+    }
+    return ops;
+}
+
+- (NSArray<NSDate *> *)_waitForBackoffOperations:(NSArray<TNLRequestOperation *> *)ops
+{
+    NSMutableArray<NSDate *> *startDates = [[NSMutableArray alloc] initWithCapacity:ops.count];
+    for (TNLRequestOperation *op in ops) {
+        [op waitUntilFinishedWithoutBlockingRunLoop];
+        XCTAssertEqual(op.response.info.statusCode, 200);
+        [startDates addObject:op.response.metrics.firstAttemptStartDate];
+    }
+    [startDates sortUsingSelector:@selector(compare:)];
+    return startDates;
+}
+
+- (void)testBackoffGateDelaysAdmission
+{
+    [self _enableBackoffWithBehavior:TNLBackoffBehaviorMake(0.5 /*backoff*/, 0 /*serialize*/, 0 /*delay*/)];
+    [TNLNetwork backoffSignalEncounteredForURL:[NSURL URLWithString:kFAKE_URL] host:nil responseHTTPHeaders:nil];
+
+    const CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    NSArray<NSDate *> *startDates = [self _waitForBackoffOperations:[self _enqueueBackoffOperations:2]];
+    for (NSDate *startDate in startDates) {
+        XCTAssertGreaterThan(startDate.timeIntervalSinceReferenceDate - start, 0.4);
+    }
+}
+
+- (void)testBackoffSerializesAdmission
+{
+    const NSTimeInterval serialDelay = 0.2;
+    [self _enableBackoffWithBehavior:TNLBackoffBehaviorMake(0 /*backoff*/, 5.0 /*serialize*/, serialDelay)];
+    [TNLNetwork backoffSignalEncounteredForURL:[NSURL URLWithString:kFAKE_URL] host:nil responseHTTPHeaders:nil];
+
+    NSArray<NSDate *> *startDates = [self _waitForBackoffOperations:[self _enqueueBackoffOperations:4]];
+    for (NSUInteger i = 1; i < startDates.count; i++) {
+        XCTAssertGreaterThan([startDates[i] timeIntervalSinceDate:startDates[i - 1]], serialDelay * 0.75);
+    }
+}
+
+- (void)testBackoffResignalWhileOperationsAreQueued
+{
+    const NSTimeInterval serialDelay = 0.2;
+    TNLTestBackoffBehaviorProvider *provider = [self _enableBackoffWithBehavior:TNLBackoffBehaviorMake(0.3 /*backoff*/, 5.0 /*serialize*/, serialDelay)];
+    [TNLNetwork backoffSignalEncounteredForURL:[NSURL URLWithString:kFAKE_URL] host:nil responseHTTPHeaders:nil];
+
+    const CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    NSArray<TNLRequestOperation *> *ops = [self _enqueueBackoffOperations:4];
+
+    // a second signal closes the gate past when every queued operation would have been admitted
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    provider.behavior = TNLBackoffBehaviorMake(1.0 /*backoff*/, 5.0 /*serialize*/, serialDelay);
+    [TNLNetwork backoffSignalEncounteredForURL:[NSURL URLWithString:kFAKE_URL] host:nil responseHTTPHeaders:nil];
+
+    // once the gate opens, the queued operations are still admitted one at a time
+    NSArray<NSDate *> *startDates = [self _waitForBackoffOperations:ops];
+    XCTAssertGreaterThan(startDates.firstObject.timeIntervalSinceReferenceDate - start, 1.0);
+    for (NSUInteger i = 1; i < startDates.count; i++) {
+        XCTAssertGreaterThan([startDates[i] timeIntervalSinceDate:startDates[i - 1]], serialDelay * 0.75);
+    }
+}
+
+- (void)testBackoffModeChangeReleasesQueuedOperations
+{
+    [self _enableBackoffWithBehavior:TNLBackoffBehaviorMake(10.0 /*backoff*/, 0 /*serialize*/, 0 /*delay*/)];
+    [TNLNetwork backoffSignalEncounteredForURL:[NSURL URLWithString:kFAKE_URL] host:nil responseHTTPHeaders:nil];
+
+    const CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    NSArray<TNLRequestOperation *> *ops = [self _enqueueBackoffOperations:3];
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.2]];
+    for (TNLRequestOperation *op in ops) {
+        XCTAssertFalse(op.isFinished);
+    }
+
+    [TNLGlobalConfiguration sharedInstance].backoffMode = TNLGlobalConfigurationBackoffModeDisabled;
+    [self _waitForBackoffOperations:ops];
+    XCTAssertLessThan(CFAbsoluteTimeGetCurrent() - start, 5.0);
+}
+
+#pragma mark Performance
+
+- (void)testConcurrentSessionsContentionPerformance
+{
+    // Drive many concurrent pseudo requests across several distinct NSURLSession instances.
+    // Delegate callbacks for different sessions are serialized per session (not globally),
+    // so this measures how well the session manager scales under contention.
+
+    NSURL *url = [NSURL URLWithString:kFAKE_URL];
+    NSMutableArray<TNLRequestConfiguration *> *configs = [[NSMutableArray alloc] init];
+    const NSURLRequestCachePolicy cachePolicies[] = { NSURLRequestUseProtocolCachePolicy, NSURLRequestReloadIgnoringLocalCacheData };
+    for (size_t i = 0; i < (sizeof(cachePolicies) / sizeof(cachePolicies[0])); i++) {
+        for (NSUInteger discretionary = 0; discretionary < 2; discretionary++) {
+            TNLMutableRequestConfiguration *config = [TNLMutableRequestConfiguration defaultConfiguration];
+            config.protocolOptions = TNLRequestProtocolOptionPseudo;
+            config.cachePolicy = cachePolicies[i];
+            config.discretionary = (discretionary != 0);
+            [configs addObject:[config copy]];
+        }
+    }
+
+    TNLRequestOperationQueue *queue = [[TNLRequestOperationQueue alloc] initWithIdentifier:@"session.manager.contention.test"];
+    const NSUInteger requestCount = 400;
+
+    [self measureBlock:^{
+        NSMutableArray<TNLRequestOperation *> *ops = [[NSMutableArray alloc] initWithCapacity:requestCount];
+        for (NSUInteger i = 0; i < requestCount; i++) {
+            TNLRequestOperation *op = [TNLRequestOperation operationWithURL:url
+                                                              configuration:configs[i % configs.count]
+                                                                   delegate:nil];
+            [ops addObject:op];
+            [queue enqueueRequestOperation:op];
+        }
+        for (TNLRequestOperation *op in ops) {
+            [op waitUntilFinishedWithoutBlockingRunLoop];
+            XCTAssertEqual(op.response.info.statusCode, 200);
+        }
+    }];
+}
+
+- (void)testManyConcurrentTasksOnOneSessionPerformance
+{
+    // Drive many concurrent pseudo requests through a single NSURLSession.
+    // Every delegate callback has to map its NSURLSessionTask back to the owning operation,
+    // so this measures the task lookup cost as the number of in flight tasks grows.
+
+    NSURL *url = [NSURL URLWithString:kFAKE_URL];
+    TNLMutableRequestConfiguration *mConfig = [TNLMutableRequestConfiguration defaultConfiguration];
+    mConfig.protocolOptions = TNLRequestProtocolOptionPseudo;
+    TNLRequestConfiguration *config = [mConfig copy];
+
+    TNLRequestOperationQueue *queue = [[TNLRequestOperationQueue alloc] initWithIdentifier:@"session.manager.many.tasks.test"];
+    const NSUInteger requestCount = 1000;
+
+    [self measureBlock:^{
+        NSMutableArray<TNLRequestOperation *> *ops = [[NSMutableArray alloc] initWithCapacity:requestCount];
+        for (NSUInteger i = 0; i < requestCount; i++) {
+            TNLRequestOperation *op = [TNLRequestOperation operationWithURL:url
+                                                              configuration:config
+                                                                   delegate:nil];
+            [ops addObject:op];
+            [queue enqueueRequestOperation:op];
+        }
+        for (TNLRequestOperation *op in ops) {
+            [op waitUntilFinishedWithoutBlockingRunLoop];
+            XCTAssertEqual(op.response.info.statusCode, 200);
+        }
+    }];
+}
+
 @end
 
+@implementation TNLTestBackoffBehaviorProvider
+
+- (TNLBackoffBehavior)tnl_backoffBehaviorForURL:(NSURL *)URL
+                                responseHeaders:(nullable NSDictionary<NSString *, NSString *> *)headers
+{
+    return self.behavior;
+}
+
+@end